@@ -85,6 +85,10 @@ CommandLineHandler::CommandLineHandler()
     m_threads.set_exact_value_count(1);
     parser().add_option_handler(&m_threads);
 
+    m_pin_threads.add_name("--pin-threads");
+    m_pin_threads.set_description("bind rendering threads to CPU cores, spreading them across NUMA nodes");
+    parser().add_option_handler(&m_pin_threads);
+
     m_output.add_name("--output");
     m_output.add_name("-o");
     m_output.set_description("set the name of the output file");
@@ -96,6 +100,24 @@ CommandLineHandler::CommandLineHandler()
     m_continuous_saving.set_description("write each tile to disk as soon as it is rendered");
     parser().add_option_handler(&m_continuous_saving);
 
+    m_checkpoint.add_name("--checkpoint");
+    m_checkpoint.set_description("periodically save the rendering state to a checkpoint file");
+    m_checkpoint.set_syntax("filename");
+    m_checkpoint.set_exact_value_count(1);
+    parser().add_option_handler(&m_checkpoint);
+
+    m_resume.add_name("--resume");
+    m_resume.set_description("resume rendering from a checkpoint file and keep updating it");
+    m_resume.set_syntax("filename");
+    m_resume.set_exact_value_count(1);
+    parser().add_option_handler(&m_resume);
+
+    m_sequence.add_name("--sequence");
+    m_sequence.set_description("render the frames described in a frame sequence file, loading the project only once");
+    m_sequence.set_syntax("filename");
+    m_sequence.set_exact_value_count(1);
+    parser().add_option_handler(&m_sequence);
+
     m_resolution.add_name("--resolution");
     m_resolution.add_name("-r");
     m_resolution.set_description("set the resolution of the rendered image");
@@ -159,9 +181,27 @@ CommandLineHandler::CommandLineHandler()
     m_benchmark_mode.set_description("enable benchmark mode");
     parser().add_option_handler(&m_benchmark_mode);
 
+    m_run_render_benchmarks.add_name("--run-render-benchmarks");
+    m_run_render_benchmarks.set_description("run end-to-end rendering benchmarks on generated scenes; filter them based on the optional regular expression argument");
+    m_run_render_benchmarks.set_min_value_count(0);
+    m_run_render_benchmarks.set_max_value_count(1);
+    parser().add_option_handler(&m_run_render_benchmarks);
+
+    m_compare_render_benchmarks.add_name("--compare-render-benchmarks");
+    m_compare_render_benchmarks.set_description("compare the results of --run-render-benchmarks against a previous result file");
+    m_compare_render_benchmarks.set_syntax("filename");
+    m_compare_render_benchmarks.set_exact_value_count(1);
+    parser().add_option_handler(&m_compare_render_benchmarks);
+
     m_dump_input_metadata.add_name("--dump-input-metadata");
     m_dump_input_metadata.set_description("dump the input metadata of all known entities to stderr (as xml)");
     parser().add_option_handler(&m_dump_input_metadata);
+
+    m_trace_events.add_name("--trace-events");
+    m_trace_events.set_description("record a timeline of rendering events and write it to a file in the chrome trace event format");
+    m_trace_events.set_syntax("filename");
+    m_trace_events.set_exact_value_count(1);
+    parser().add_option_handler(&m_trace_events);
 }
 
 void CommandLineHandler::print_program_usage(
@@ -66,8 +66,12 @@ class CommandLineHandler
 
     // Aliases for rendering options.
     foundation::ValueOptionHandler<int>             m_threads;
+    foundation::FlagOptionHandler                   m_pin_threads;
     foundation::ValueOptionHandler<std::string>     m_output;
     foundation::FlagOptionHandler                   m_continuous_saving;
+    foundation::ValueOptionHandler<std::string>     m_checkpoint;
+    foundation::ValueOptionHandler<std::string>     m_resume;
+    foundation::ValueOptionHandler<std::string>     m_sequence;
     foundation::ValueOptionHandler<int>             m_resolution;
     foundation::ValueOptionHandler<int>             m_window;
     foundation::ValueOptionHandler<int>             m_samples;
@@ -83,7 +87,10 @@ class CommandLineHandler
     foundation::ValueOptionHandler<std::string>     m_run_unit_benchmarks;
     foundation::FlagOptionHandler                   m_verbose_unit_tests;
     foundation::FlagOptionHandler                   m_benchmark_mode;
+    foundation::ValueOptionHandler<std::string>     m_run_render_benchmarks;
+    foundation::ValueOptionHandler<std::string>     m_compare_render_benchmarks;
     foundation::FlagOptionHandler                   m_dump_input_metadata;
+    foundation::ValueOptionHandler<std::string>     m_trace_events;
 
     // Constructor.
     CommandLineHandler();
@@ -0,0 +1,431 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "framesequence.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/camera.h"
+#include "renderer/api/frame.h"
+#include "renderer/api/light.h"
+#include "renderer/api/material.h"
+#include "renderer/api/object.h"
+#include "renderer/api/project.h"
+#include "renderer/api/scene.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/matrix.h"
+#include "foundation/utility/foreach.h"
+#include "foundation/utility/log.h"
+#include "foundation/utility/otherwise.h"
+#include "foundation/utility/string.h"
+
+// boost headers.
+#include "boost/filesystem/path.hpp"
+
+// Standard headers.
+#include <cassert>
+#include <fstream>
+#include <sstream>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+namespace bf = boost::filesystem;
+
+namespace appleseed {
+namespace cli {
+
+//
+// FrameSequence class implementation.
+//
+
+FrameSequence::FrameSequence(Logger& logger)
+  : m_logger(logger)
+{
+}
+
+namespace
+{
+    bool read_transform(istream& input, Transformd& transform)
+    {
+        Matrix4d m;
+
+        for (size_t i = 0; i < 16; ++i)
+        {
+            if (!(input >> m[i]))
+                return false;
+        }
+
+        transform = Transformd::from_local_to_parent(m);
+
+        return true;
+    }
+}
+
+bool FrameSequence::load(const char* filename)
+{
+    m_frames.clear();
+
+    ifstream file(filename);
+
+    if (!file.is_open())
+    {
+        LOG_ERROR(m_logger, "could not read frame sequence file %s.", filename);
+        return false;
+    }
+
+    string line;
+
+    for (size_t line_number = 1; getline(file, line); ++line_number)
+    {
+        istringstream input(line);
+
+        string keyword;
+        if (!(input >> keyword) || keyword[0] == '#')
+            continue;
+
+        bool valid = true;
+
+        if (keyword == "frame")
+        {
+            Frame frame;
+            valid = (input >> frame.m_number) && (m_frames.empty() || frame.m_number > m_frames.back().m_number);
+            if (valid)
+                m_frames.push_back(frame);
+        }
+        else if (m_frames.empty())
+        {
+            LOG_ERROR(
+                m_logger,
+                "while reading frame sequence file %s: at line " FMT_SIZE_T ": expected frame declaration.",
+                filename,
+                line_number);
+            return false;
+        }
+        else
+        {
+            Change change;
+
+            if (keyword == "camera")
+            {
+                change.m_type = CameraTransform;
+                valid = read_transform(input, change.m_transform);
+            }
+            else if (keyword == "assembly_instance")
+            {
+                change.m_type = AssemblyInstanceTransform;
+                valid =
+                    (input >> change.m_entity_name) &&
+                    read_transform(input, change.m_transform);
+            }
+            else if (keyword == "object_instance")
+            {
+                change.m_type = ObjectInstanceObject;
+                valid =
+                    static_cast<bool>(
+                        input >> change.m_assembly_name >> change.m_entity_name >> change.m_object_name);
+            }
+            else valid = false;
+
+            if (valid)
+                m_frames.back().m_changes.push_back(change);
+        }
+
+        string trailing;
+        if (!valid || input >> trailing)
+        {
+            LOG_ERROR(
+                m_logger,
+                "while reading frame sequence file %s: at line " FMT_SIZE_T ": parse error.",
+                filename,
+                line_number);
+            return false;
+        }
+    }
+
+    if (m_frames.empty())
+    {
+        LOG_ERROR(m_logger, "frame sequence file %s does not define any frame.", filename);
+        return false;
+    }
+
+    LOG_INFO(
+        m_logger,
+        "read " FMT_SIZE_T " frame%s from frame sequence file %s.",
+        m_frames.size(),
+        m_frames.size() > 1 ? "s" : "",
+        filename);
+
+    return true;
+}
+
+size_t FrameSequence::size() const
+{
+    return m_frames.size();
+}
+
+const FrameSequence::Frame& FrameSequence::operator[](const size_t index) const
+{
+    assert(index < m_frames.size());
+    return m_frames[index];
+}
+
+
+//
+// FrameSequenceRendererController class implementation.
+//
+
+FrameSequenceRendererController::FrameSequenceRendererController(
+    Project&                project,
+    const FrameSequence&    sequence,
+    const string&           output_path,
+    Logger&                 logger)
+  : m_project(project)
+  , m_sequence(sequence)
+  , m_output_path(output_path)
+  , m_logger(logger)
+  , m_frame_index(0)
+  , m_applied_frame_count(0)
+{
+    assert(m_sequence.size() > 0);
+}
+
+void FrameSequenceRendererController::on_frame_setup()
+{
+    DefaultRendererController::on_frame_setup();
+
+    // Apply the changes of the current frame only once, even if rendering is reinitialized.
+    if (m_applied_frame_count == m_frame_index)
+    {
+        const FrameSequence::Frame& frame = m_sequence[m_frame_index];
+
+        LOG_INFO(
+            m_logger,
+            "rendering frame " FMT_SIZE_T " (" FMT_SIZE_T "/" FMT_SIZE_T ")...",
+            frame.m_number,
+            m_frame_index + 1,
+            m_sequence.size());
+
+        apply_changes(frame);
+        ++m_applied_frame_count;
+    }
+}
+
+FrameSequenceRendererController::Status FrameSequenceRendererController::on_frame_complete()
+{
+    write_frame(m_sequence[m_frame_index]);
+
+    if (++m_frame_index == m_sequence.size())
+        return TerminateRendering;
+
+    // The changes of the next frame are applied by on_frame_setup(). The light sampler captures
+    // light-emitting geometry in world space: rebuild the rendering components if the next frame
+    // may alter it. Otherwise keep them alive; the trace context only rebuilds the acceleration
+    // structures of the assemblies that were modified.
+    return
+        affects_lighting(m_sequence[m_frame_index])
+            ? ReinitializeRendering
+            : RestartRendering;
+}
+
+void FrameSequenceRendererController::apply_changes(const FrameSequence::Frame& frame) const
+{
+    Scene& scene = *m_project.get_scene();
+
+    for (const_each<vector<FrameSequence::Change> > i = frame.m_changes; i; ++i)
+    {
+        const FrameSequence::Change& change = *i;
+
+        switch (change.m_type)
+        {
+          case FrameSequence::CameraTransform:
+            {
+                Camera* camera = scene.get_camera();
+
+                if (camera == 0)
+                {
+                    LOG_ERROR(m_logger, "cannot transform the camera: the scene does not have a camera.");
+                    break;
+                }
+
+                camera->transform_sequence().clear();
+                camera->transform_sequence().set_transform(0.0, change.m_transform);
+            }
+            break;
+
+          case FrameSequence::AssemblyInstanceTransform:
+            {
+                AssemblyInstance* assembly_instance =
+                    scene.assembly_instances().get_by_name(change.m_entity_name.c_str());
+
+                if (assembly_instance == 0)
+                {
+                    LOG_ERROR(
+                        m_logger,
+                        "cannot transform assembly instance \"%s\": no such assembly instance.",
+                        change.m_entity_name.c_str());
+                    break;
+                }
+
+                // The assembly tree is rebuilt for every frame, no version bump required.
+                assembly_instance->transform_sequence().clear();
+                assembly_instance->transform_sequence().set_transform(0.0, change.m_transform);
+            }
+            break;
+
+          case FrameSequence::ObjectInstanceObject:
+            {
+                Assembly* assembly =
+                    scene.assemblies().get_by_name(change.m_assembly_name.c_str());
+
+                ObjectInstance* object_instance =
+                    assembly
+                        ? assembly->object_instances().get_by_name(change.m_entity_name.c_str())
+                        : 0;
+
+                if (object_instance == 0 || assembly->objects().get_by_name(change.m_object_name.c_str()) == 0)
+                {
+                    LOG_ERROR(
+                        m_logger,
+                        "cannot bind object \"%s\" to object instance \"%s\" of assembly \"%s\": no such entity.",
+                        change.m_object_name.c_str(),
+                        change.m_entity_name.c_str(),
+                        change.m_assembly_name.c_str());
+                    break;
+                }
+
+                // Object instances are bound to their object by name: replace the instance by
+                // an identical one referencing the new object. The master renderer binds it and
+                // rebuilds the acceleration structures of this assembly only.
+                const string name = object_instance->get_name();
+                auto_release_ptr<ObjectInstance> new_object_instance(
+                    ObjectInstanceFactory::create(
+                        name.c_str(),
+                        object_instance->get_parameters(),
+                        change.m_object_name.c_str(),
+                        object_instance->get_transform(),
+                        object_instance->get_front_material_mappings(),
+                        object_instance->get_back_material_mappings()));
+
+                assembly->object_instances().remove(object_instance);
+                assembly->object_instances().insert(new_object_instance);
+                assembly->bump_version_id();
+            }
+            break;
+
+          assert_otherwise;
+        }
+    }
+}
+
+namespace
+{
+    bool may_emit_light(const Assembly& assembly)
+    {
+        if (!assembly.lights().empty())
+            return true;
+
+        for (const_each<MaterialContainer> i = assembly.materials(); i; ++i)
+        {
+            if (i->get_edf_name() || i->get_parameters().strings().exist("osl_surface"))
+                return true;
+        }
+
+        for (const_each<AssemblyContainer> i = assembly.assemblies(); i; ++i)
+        {
+            if (may_emit_light(*i))
+                return true;
+        }
+
+        return false;
+    }
+}
+
+bool FrameSequenceRendererController::affects_lighting(const FrameSequence::Frame& frame) const
+{
+    const Scene& scene = *m_project.get_scene();
+
+    for (const_each<vector<FrameSequence::Change> > i = frame.m_changes; i; ++i)
+    {
+        const Assembly* assembly = 0;
+
+        switch (i->m_type)
+        {
+          case FrameSequence::CameraTransform:
+            break;
+
+          case FrameSequence::AssemblyInstanceTransform:
+            {
+                const AssemblyInstance* assembly_instance =
+                    scene.assembly_instances().get_by_name(i->m_entity_name.c_str());
+                if (assembly_instance)
+                    assembly = assembly_instance->find_assembly();
+            }
+            break;
+
+          case FrameSequence::ObjectInstanceObject:
+            assembly = scene.assemblies().get_by_name(i->m_assembly_name.c_str());
+            break;
+
+          assert_otherwise;
+        }
+
+        if (assembly && may_emit_light(*assembly))
+            return true;
+    }
+
+    return false;
+}
+
+void FrameSequenceRendererController::write_frame(const FrameSequence::Frame& frame) const
+{
+    if (m_output_path.empty())
+        return;
+
+    string file_path;
+
+    if (m_output_path.find('#') != string::npos)
+        file_path = get_numbered_string(m_output_path, frame.m_number);
+    else
+    {
+        const bf::path path(m_output_path);
+        file_path =
+            (path.parent_path() /
+                (path.stem().string() + "." + get_numbered_string("####", frame.m_number) + path.extension().string())).string();
+    }
+
+    LOG_INFO(m_logger, "writing frame " FMT_SIZE_T " to %s...", frame.m_number, file_path.c_str());
+
+    const renderer::Frame* image = m_project.get_frame();
+    image->write_main_image(file_path.c_str());
+    image->write_aov_images(file_path.c_str());
+}
+
+}       // namespace cli
+}       // namespace appleseed
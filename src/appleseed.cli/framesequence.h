@@ -0,0 +1,150 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_CLI_FRAMESEQUENCE_H
+#define APPLESEED_CLI_FRAMESEQUENCE_H
+
+// appleseed.renderer headers.
+#include "renderer/api/rendering.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/transform.h"
+#include "foundation/platform/compiler.h"
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declarations.
+namespace foundation    { class Logger; }
+namespace renderer      { class Project; }
+
+namespace appleseed {
+namespace cli {
+
+//
+// A sequence of frames to render from a single project, described by a text file of the form:
+//
+//   # Comments start with a hash sign.
+//   frame 1
+//   camera <16 matrix values>
+//   assembly_instance <name> <16 matrix values>
+//   object_instance <assembly name> <object instance name> <object name>
+//   frame 2
+//   ...
+//
+// Matrices are local-to-parent (local-to-world for the camera) and given in row-major order.
+// The changes listed under a frame are applied on top of the state of the previous frame.
+// Assembly instances are looked up in the scene, object instances in the given assembly.
+//
+
+class FrameSequence
+{
+  public:
+    enum ChangeType
+    {
+        CameraTransform,                    // set the transform of the camera
+        AssemblyInstanceTransform,          // set the transform of an assembly instance
+        ObjectInstanceObject                // bind an object instance to another object (e.g. a mesh pose)
+    };
+
+    struct Change
+    {
+        ChangeType              m_type;
+        std::string             m_assembly_name;
+        std::string             m_entity_name;
+        std::string             m_object_name;
+        foundation::Transformd  m_transform;
+    };
+
+    struct Frame
+    {
+        std::size_t             m_number;
+        std::vector<Change>     m_changes;
+    };
+
+    explicit FrameSequence(foundation::Logger& logger);
+
+    // Load a frame sequence from disk. Return true on success, false otherwise.
+    bool load(const char* filename);
+
+    // Return the number of frames in the sequence.
+    std::size_t size() const;
+
+    // Return a given frame.
+    const Frame& operator[](const std::size_t index) const;
+
+  private:
+    foundation::Logger&         m_logger;
+    std::vector<Frame>          m_frames;
+};
+
+
+//
+// A renderer controller that renders all the frames of a sequence in a row, applying the
+// changes of each frame to the scene and writing each completed frame to disk. The rendering
+// components are kept alive from one frame to the next unless the changes of the next frame
+// may affect light emission, in which case they are rebuilt.
+//
+
+class FrameSequenceRendererController
+  : public renderer::DefaultRendererController
+{
+  public:
+    // The output path may contain consecutive '#' characters, replaced by the frame number.
+    // If it doesn't, the frame number is inserted before the extension.
+    FrameSequenceRendererController(
+        renderer::Project&      project,
+        const FrameSequence&    sequence,
+        const std::string&      output_path,
+        foundation::Logger&     logger);
+
+    virtual void on_frame_setup() OVERRIDE;
+    virtual Status on_frame_complete() OVERRIDE;
+
+  private:
+    renderer::Project&          m_project;
+    const FrameSequence&        m_sequence;
+    const std::string           m_output_path;
+    foundation::Logger&         m_logger;
+    std::size_t                 m_frame_index;
+    std::size_t                 m_applied_frame_count;
+
+    void apply_changes(const FrameSequence::Frame& frame) const;
+
+    // Return true if the changes of a given frame may affect light emission.
+    bool affects_lighting(const FrameSequence::Frame& frame) const;
+
+    void write_frame(const FrameSequence::Frame& frame) const;
+};
+
+}       // namespace cli
+}       // namespace appleseed
+
+#endif  // !APPLESEED_CLI_FRAMESEQUENCE_H
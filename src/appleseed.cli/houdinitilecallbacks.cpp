@@ -150,6 +150,17 @@ namespace
                     send_tile(*frame, tx, ty);
         }
 
+        virtual void post_render(
+            const Frame*                frame,
+            const TileCoordinateArray&  tiles) OVERRIDE
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            send_header(*frame);
+
+            for (size_t i = 0; i < tiles.size(); ++i)
+                send_tile(*frame, tiles[i].x, tiles[i].y);
+        }
+
       private:
         static FILE* open_pipe(const char* command)
         {
@@ -30,8 +30,10 @@
 // appleseed.cli headers.
 #include "commandlinehandler.h"
 #include "continuoussavingtilecallback.h"
+#include "framesequence.h"
 #include "houdinitilecallbacks.h"
 #include "progresstilecallback.h"
+#include "renderbenchmarks.h"
 
 // appleseed.shared headers.
 #include "application/application.h"
@@ -52,15 +54,19 @@
 #include "renderer/api/scene.h"
 #include "renderer/api/surfaceshader.h"
 #include "renderer/api/texture.h"
+#include "renderer/api/tracecontext.h"
 #include "renderer/api/utility.h"
 
 // appleseed.foundation headers.
 #include "foundation/core/appleseed.h"
 #include "foundation/platform/path.h"
+#include "foundation/platform/system.h"
 #include "foundation/platform/thread.h"
+#include "foundation/platform/types.h"
 #include "foundation/platform/timer.h"
 #include "foundation/utility/autoreleaseptr.h"
 #include "foundation/utility/benchmark.h"
+#include "foundation/utility/eventtracer.h"
 #include "foundation/utility/filter.h"
 #include "foundation/utility/indenter.h"
 #include "foundation/utility/log.h"
@@ -78,6 +84,7 @@
 #include "boost/filesystem/path.hpp"
 
 // Standard headers.
+#include <algorithm>
 #include <cstddef>
 #include <cstdlib>
 #include <memory>
@@ -116,6 +123,39 @@ namespace
             g_logger.enable_message_coloring();
     }
 
+    // Return the path to the event trace file, or an empty string if event tracing is disabled.
+    string get_event_trace_file_path()
+    {
+        return g_cl.m_trace_events.is_set()
+            ? g_cl.m_trace_events.values()[0]
+            : g_settings.get_optional<string>("event_trace_file", "");
+    }
+
+    void start_event_tracing()
+    {
+        EventTracer::enable();
+        EventTracer::set_thread_name("main thread");
+    }
+
+    void write_event_trace(const string& path)
+    {
+        EventTracer::disable();
+
+        if (EventTracer::write(path.c_str()))
+        {
+            LOG_INFO(
+                g_logger,
+                "wrote %s event%s to %s.",
+                pretty_uint(EventTracer::get_event_count()).c_str(),
+                EventTracer::get_event_count() > 1 ? "s" : "",
+                path.c_str());
+        }
+        else
+        {
+            LOG_ERROR(g_logger, "failed to write event trace to %s.", path.c_str());
+        }
+    }
+
     void configure_renderer_logger()
     {
         global_logger().add_target(&g_logger.get_log_target());
@@ -513,6 +553,21 @@ namespace
                 g_cl.m_threads.string_values()[0]);
         }
 
+        // Apply --pin-threads option.
+        if (g_cl.m_pin_threads.is_set())
+            params.insert_path("pin_rendering_threads", true);
+
+        // Apply --checkpoint option.
+        if (g_cl.m_checkpoint.is_set())
+            params.insert_path("checkpoint_file", g_cl.m_checkpoint.values()[0]);
+
+        // Apply --resume option.
+        if (g_cl.m_resume.is_set())
+        {
+            params.insert_path("checkpoint_file", g_cl.m_resume.values()[0]);
+            params.insert_path("resume_from_checkpoint", true);
+        }
+
         // Apply --resolution option.
         apply_resolution_command_line_option(project);
 
@@ -542,6 +597,101 @@ namespace
         apply_parameter_command_line_options(params);
     }
 
+    bool run_render_benchmarks()
+    {
+        // Configure our logger.
+        SaveLogFormatterConfig save_g_logger_config(g_logger);
+        g_logger.reset_all_formats();
+        g_logger.set_format(LogMessage::Info, "{datetime-utc} | {message}");
+
+        // Configure the renderer's logger: mute all log messages except warnings and errors.
+        SaveLogFormatterConfig save_global_logger_config(global_logger());
+        global_logger().set_all_formats(string());
+        global_logger().reset_format(LogMessage::Warning);
+        global_logger().reset_format(LogMessage::Error);
+        global_logger().reset_format(LogMessage::Fatal);
+
+        const filesystem::path root_path =
+            filesystem::path(Application::get_tests_root_path()) / "render benchmarks";
+
+        const filesystem::path schema_path =
+              filesystem::path(Application::get_root_path())
+            / "schemas"
+            / "project.xsd";
+
+        // Apply the --threads, --pin-threads and --parameter options on top of the benchmark settings.
+        ParamArray params;
+        if (g_cl.m_threads.is_set())
+        {
+            params.insert_path(
+                "rendering_threads",
+                g_cl.m_threads.string_values()[0]);
+        }
+        if (g_cl.m_pin_threads.is_set())
+            params.insert_path("pin_rendering_threads", true);
+        apply_parameter_command_line_options(params);
+
+        RenderBenchmarks benchmarks(
+            (root_path / "scenes").string(),
+            schema_path.string(),
+            params,
+            g_logger);
+
+        // Run render benchmarks.
+        bool success;
+        if (g_cl.m_run_render_benchmarks.values().empty())
+            success = benchmarks.run(PassThroughFilter());
+        else
+        {
+            const char* regex = g_cl.m_run_render_benchmarks.values().front().c_str();
+            const RegExFilter filter(regex, RegExFilter::CaseInsensitive);
+
+            if (filter.is_valid())
+                success = benchmarks.run(filter);
+            else
+            {
+                LOG_ERROR(
+                    g_logger,
+                    "malformed regular expression '%s', disabling benchmark filtering.",
+                    regex);
+                success = benchmarks.run(PassThroughFilter());
+            }
+        }
+
+        // Archive the results, using the same file naming scheme as unit benchmarks.
+        const filesystem::path results_path = root_path / "results";
+        filesystem::create_directories(results_path);
+
+        const string results_name = "benchmark." + get_time_stamp_string();
+        const filesystem::path xmlfile_path = results_path / (results_name + ".xml");
+        const filesystem::path jsonfile_path = results_path / (results_name + ".json");
+
+        if (!benchmarks.write_xml(xmlfile_path.string()))
+        {
+            LOG_WARNING(
+                g_logger,
+                "automatic benchmark results archiving to %s failed: i/o error.",
+                xmlfile_path.string().c_str());
+        }
+
+        if (!benchmarks.write_json(jsonfile_path.string()))
+        {
+            LOG_WARNING(
+                g_logger,
+                "automatic benchmark results archiving to %s failed: i/o error.",
+                jsonfile_path.string().c_str());
+        }
+
+        // Compare with previous results.
+        if (g_cl.m_compare_render_benchmarks.is_set())
+        {
+            success =
+                benchmarks.compare(g_cl.m_compare_render_benchmarks.values()[0]) && success;
+        }
+
+        return success;
+    }
+
 #if defined __APPLE__ || defined _WIN32
 
     // Invoke a system command to open an image file.
@@ -630,6 +780,25 @@ namespace
         return value == "progressive";        
     }
     
+    // Return the number of threads to write the frame with, from the "rendering_threads" parameter.
+    size_t get_output_thread_count(const ParamArray& params)
+    {
+        const string value = params.get_optional<string>("rendering_threads", "auto");
+
+        if (value != "auto")
+        {
+            try
+            {
+                return max<size_t>(from_string<size_t>(value), 1);
+            }
+            catch (const ExceptionStringConversionError&)
+            {
+            }
+        }
+
+        return System::get_logical_cpu_core_count();
+    }
+
     void render(const string& project_filename)
     {
         // Load the project.
@@ -673,16 +842,49 @@ namespace
                 new ProgressTileCallbackFactory(g_logger));
         }
         
+        // Load the frame sequence.
+        FrameSequence sequence(g_logger);
+        if (g_cl.m_sequence.is_set())
+        {
+            if (!sequence.load(g_cl.m_sequence.values()[0].c_str()))
+                return;
+
+            if (!g_cl.m_output.is_set())
+                LOG_WARNING(g_logger, "no output file specified, the frames of the sequence will not be written to disk.");
+        }
+
+        // Create the renderer controller.
+        DefaultRendererController default_renderer_controller;
+        auto_ptr<FrameSequenceRendererController> sequence_renderer_controller;
+        if (g_cl.m_sequence.is_set())
+        {
+            sequence_renderer_controller.reset(
+                new FrameSequenceRendererController(
+                    project.ref(),
+                    sequence,
+                    g_cl.m_output.is_set() ? g_cl.m_output.values()[0] : string(),
+                    g_logger));
+        }
+
         // Create the master renderer.
-        DefaultRendererController renderer_controller;
         MasterRenderer renderer(
             project.ref(),
             params,
-            &renderer_controller,
+            sequence_renderer_controller.get()
+                ? static_cast<IRendererController*>(sequence_renderer_controller.get())
+                : &default_renderer_controller,
             tile_callback_factory.get());
 
-        // Render the frame.
-        LOG_INFO(g_logger, "rendering frame...");
+        // Render the frame or the frame sequence.
+        if (g_cl.m_sequence.is_set())
+        {
+            LOG_INFO(
+                g_logger,
+                "rendering " FMT_SIZE_T " frame%s...",
+                sequence.size(),
+                sequence.size() > 1 ? "s" : "");
+        }
+        else LOG_INFO(g_logger, "rendering frame...");
         Stopwatch<DefaultWallclockTimer> stopwatch;
         if (params.get_optional<bool>("background_mode", true))
         {
@@ -723,12 +925,13 @@ namespace
                 &archive_path);
         }
 
-        // Write the frame to disk.
-        if (g_cl.m_output.is_set() && !g_cl.m_continuous_saving.is_set())
+        // Write the frame to disk. The frames of a sequence were written as they completed.
+        if (g_cl.m_output.is_set() && !g_cl.m_continuous_saving.is_set() && !g_cl.m_sequence.is_set())
         {
             LOG_INFO(g_logger, "writing frame to disk...");
-            project->get_frame()->write_main_image(g_cl.m_output.values()[0].c_str());
-            project->get_frame()->write_aov_images(g_cl.m_output.values()[0].c_str());
+            const size_t thread_count = get_output_thread_count(params);
+            project->get_frame()->write_main_image(g_cl.m_output.values()[0].c_str(), thread_count);
+            project->get_frame()->write_aov_images(g_cl.m_output.values()[0].c_str(), thread_count);
         }
 
 #if defined __APPLE__ || defined _WIN32
@@ -791,17 +994,23 @@ namespace
         const double total_time_seconds = stopwatch.get_seconds();
 
         // Render a second time.
+        const uint64 initial_ray_count = project->get_trace_context().get_ray_count();
         if (!renderer.render())
             return;
         stopwatch.measure();
         const double render_time_seconds = stopwatch.get_seconds() - total_time_seconds;
+        const uint64 ray_count = project->get_trace_context().get_ray_count() - initial_ray_count;
+
+        // Retrieve the breakdown of the second rendering.
+        const MasterRenderer::PhaseTimes phase_times = renderer.get_phase_times();
 
         // Write the frame to disk.
         if (g_cl.m_output.is_set())
         {
             const char* file_path = g_cl.m_output.values()[0].c_str();
-            project->get_frame()->write_main_image(file_path);
-            project->get_frame()->write_aov_images(file_path);
+            const size_t thread_count = get_output_thread_count(params);
+            project->get_frame()->write_main_image(file_path, thread_count);
+            project->get_frame()->write_aov_images(file_path, thread_count);
         }
 
         // Force-unload the project.
@@ -812,6 +1021,16 @@ namespace
         LOG_INFO(g_logger, "setup_time=%.6f", total_time_seconds - render_time_seconds);
         LOG_INFO(g_logger, "render_time=%.6f", render_time_seconds);
         LOG_INFO(g_logger, "total_time=%.6f", total_time_seconds);
+        LOG_INFO(g_logger, "input_binding_time=%.6f", phase_times.m_input_binding);
+        LOG_INFO(g_logger, "trace_context_time=%.6f", phase_times.m_trace_context);
+        LOG_INFO(g_logger, "light_sampler_time=%.6f", phase_times.m_light_sampler);
+        LOG_INFO(g_logger, "frame_preparation_time=%.6f", phase_times.m_frame_preparation);
+        LOG_INFO(g_logger, "rendering_time=%.6f", phase_times.m_rendering);
+        LOG_INFO(g_logger, "ray_count=" FMT_UINT64, ray_count);
+        LOG_INFO(
+            g_logger,
+            "rays_per_second=%.1f",
+            phase_times.m_rendering > 0.0 ? ray_count / phase_times.m_rendering : 0.0);
     }
 }
 
@@ -836,6 +1055,11 @@ int main(int argc, const char* argv[])
     // Configure the renderer's global logger.
     configure_renderer_logger();
 
+    // Start recording events if requested.
+    const string event_trace_file_path = get_event_trace_file_path();
+    if (!event_trace_file_path.empty())
+        start_event_tracing();
+
     bool success = true;
 
     // Run unit tests.
@@ -846,6 +1070,10 @@ int main(int argc, const char* argv[])
     if (g_cl.m_run_unit_benchmarks.is_set())
         run_unit_benchmarks();
 
+    // Run render benchmarks.
+    if (g_cl.m_run_render_benchmarks.is_set())
+        success = run_render_benchmarks() && success;
+
     // Dump input metadata.
     if (g_cl.m_dump_input_metadata.is_set())
         dump_input_metadata();
@@ -860,5 +1088,9 @@ int main(int argc, const char* argv[])
         else render(project_filename);
     }
 
+    // Write the recorded events.
+    if (!event_trace_file_path.empty())
+        write_event_trace(event_trace_file_path);
+
     return success ? 0 : 1;
 }
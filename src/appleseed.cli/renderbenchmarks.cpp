@@ -0,0 +1,837 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "renderbenchmarks.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/bsdf.h"
+#include "renderer/api/color.h"
+#include "renderer/api/frame.h"
+#include "renderer/api/light.h"
+#include "renderer/api/material.h"
+#include "renderer/api/object.h"
+#include "renderer/api/project.h"
+#include "renderer/api/rendering.h"
+#include "renderer/api/scene.h"
+#include "renderer/api/texture.h"
+#include "renderer/api/tracecontext.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/appleseed.h"
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/color.h"
+#include "foundation/image/genericimagefilewriter.h"
+#include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
+#include "foundation/math/rng.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/timer.h"
+#include "foundation/utility/benchmark.h"
+#include "foundation/utility/containers/dictionary.h"
+#include "foundation/utility/filter.h"
+#include "foundation/utility/foreach.h"
+#include "foundation/utility/log.h"
+#include "foundation/utility/otherwise.h"
+#include "foundation/utility/searchpaths.h"
+#include "foundation/utility/stopwatch.h"
+#include "foundation/utility/string.h"
+#include "foundation/utility/uid.h"
+
+// boost headers.
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+
+// Standard headers.
+#include <cmath>
+#include <cstdio>
+
+using namespace boost;
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+namespace appleseed {
+namespace cli {
+
+namespace
+{
+    // Rendering settings shared by all benchmarks.
+    const size_t ImageWidth = 256;
+    const size_t ImageHeight = 256;
+    const size_t SamplesPerPixel = 4;
+
+    // Results are stored in the XML files as microseconds.
+    const double TicksPerSecond = 1.0e6;
+
+    typedef Stopwatch<DefaultWallclockTimer> StopwatchType;
+
+    void set_frame_resolution(Project& project)
+    {
+        ParamArray params = project.get_frame()->get_parameters();
+        params.insert("resolution", Vector2i(ImageWidth, ImageHeight));
+
+        auto_release_ptr<Frame> frame(
+            FrameFactory::create(project.get_frame()->get_name(), params));
+
+        project.set_frame(frame);
+    }
+
+    void set_camera_position(Project& project, const Vector3d& position)
+    {
+        project.get_scene()->get_camera()->transform_sequence().set_transform(
+            0.0,
+            Transformd::from_local_to_parent(
+                  Matrix4d::translation(position)
+                * Matrix4d::rotation_y(Pi)));
+    }
+
+    // Start from the built-in Cornell Box project, rendered at the benchmark resolution.
+    auto_release_ptr<Project> create_base_project()
+    {
+        auto_release_ptr<Project> project(CornellBoxProjectFactory::create());
+        set_frame_resolution(project.ref());
+        return project;
+    }
+
+    Assembly& get_base_assembly(Project& project)
+    {
+        Assembly* assembly = project.get_scene()->assemblies().get_by_name("assembly");
+        assert(assembly);
+        return *assembly;
+    }
+
+    // A square grid of Cornell Boxes, all instances of the same assembly.
+    auto_release_ptr<Project> generate_instanced_cornell_boxes(
+        const string&   directory,
+        const size_t    size)
+    {
+        const double Spacing = 0.6;
+
+        auto_release_ptr<Project> project(create_base_project());
+        Scene* scene = project->get_scene();
+
+        for (size_t y = 0; y < size; ++y)
+        {
+            for (size_t x = 0; x < size; ++x)
+            {
+                // The first cell of the grid is occupied by the original instance.
+                if (x == 0 && y == 0)
+                    continue;
+
+                auto_release_ptr<AssemblyInstance> assembly_instance(
+                    AssemblyInstanceFactory::create(
+                        ("assembly_inst_" + to_string(x) + "_" + to_string(y)).c_str(),
+                        ParamArray(),
+                        "assembly"));
+
+                assembly_instance->transform_sequence().set_transform(
+                    0.0,
+                    Transformd::from_local_to_parent(
+                        Matrix4d::translation(Vector3d(x * Spacing, y * Spacing, 0.0))));
+
+                scene->assembly_instances().insert(assembly_instance);
+            }
+        }
+
+        // Back off the camera so that the whole grid is visible.
+        const double half_extent = 0.5 * size * Spacing;
+        const double center = 0.5 * (size - 1) * Spacing;
+        set_camera_position(
+            project.ref(),
+            Vector3d(0.278 + center, 0.273 + center, -0.8 - 2.8 * (half_extent - 0.3)));
+
+        return project;
+    }
+
+    // Randomly placed and oriented small triangles filling the inside of the Cornell Box.
+    auto_release_ptr<Project> generate_triangle_soup(
+        const string&   directory,
+        const size_t    size)
+    {
+        const float TriangleSize = 20.0f;       // in millimeters, like the Cornell Box geometry
+
+        auto_release_ptr<Project> project(create_base_project());
+        Assembly& assembly = get_base_assembly(project.ref());
+
+        auto_release_ptr<MeshObject> object(
+            MeshObjectFactory::create("triangle_soup", ParamArray()));
+
+        object->reserve_vertices(3 * size);
+        object->reserve_triangles(size);
+
+        const size_t mat_slot = object->push_material_slot("white_material");
+
+        MersenneTwister rng;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            const GVector3 center(
+                rand_float1(rng, 50.0f, 500.0f),
+                rand_float1(rng, 50.0f, 500.0f),
+                rand_float1(rng, 50.0f, 500.0f));
+
+            for (size_t j = 0; j < 3; ++j)
+            {
+                object->push_vertex(
+                    center +
+                    GVector3(
+                        rand_float1(rng, -TriangleSize, TriangleSize),
+                        rand_float1(rng, -TriangleSize, TriangleSize),
+                        rand_float1(rng, -TriangleSize, TriangleSize)));
+            }
+
+            object->push_triangle(Triangle(3 * i, 3 * i + 1, 3 * i + 2, mat_slot));
+        }
+
+        assembly.objects().insert(auto_release_ptr<Object>(object));
+
+        assembly.object_instances().insert(
+            ObjectInstanceFactory::create(
+                "triangle_soup_inst",
+                ParamArray(),
+                "triangle_soup",
+                Transformd::from_local_to_parent(Matrix4d::scaling(Vector3d(0.001))),
+                StringDictionary()
+                    .insert("white_material", "white_material")));
+
+        return project;
+    }
+
+    // A grid of point lights just below the ceiling of the Cornell Box.
+    auto_release_ptr<Project> generate_many_lights(
+        const string&   directory,
+        const size_t    size)
+    {
+        auto_release_ptr<Project> project(create_base_project());
+        Assembly& assembly = get_base_assembly(project.ref());
+
+        {
+            ParamArray params;
+            params.insert("color_space", "linear_rgb");
+
+            static const float Radiance[] = { 1.0f, 0.9f, 0.8f };
+
+            assembly.colors().insert(
+                ColorEntityFactory::create(
+                    "point_light_radiance",
+                    params,
+                    ColorValueArray(3, Radiance)));
+        }
+
+        const size_t grid_size = static_cast<size_t>(ceil(sqrt(static_cast<double>(size))));
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            const double x = (i % grid_size + 0.5) / grid_size;
+            const double z = (i / grid_size + 0.5) / grid_size;
+
+            // Keep the total emitted power independent of the number of lights.
+            ParamArray params;
+            params.insert("radiance", "point_light_radiance");
+            params.insert("radiance_multiplier", 0.1 / size);
+
+            auto_release_ptr<Light> light(
+                PointLightFactory().create(
+                    ("point_light_" + to_string(i)).c_str(),
+                    params));
+
+            light->set_transform(
+                Transformd::from_local_to_parent(
+                    Matrix4d::translation(Vector3d(0.05 + 0.45 * x, 0.5, 0.05 + 0.45 * z))));
+
+            assembly.lights().insert(light);
+        }
+
+        return project;
+    }
+
+    void write_texture(const string& filepath, const size_t resolution, const size_t seed)
+    {
+        Image image(resolution, resolution, 64, 64, 3, PixelFormatUInt8);
+
+        MersenneTwister rng(static_cast<uint32>(seed));
+
+        for (size_t y = 0; y < resolution; ++y)
+        {
+            for (size_t x = 0; x < resolution; ++x)
+            {
+                // A checkerboard with per-texel noise, to defeat image compression.
+                const float base = ((x / 32) + (y / 32)) % 2 == 0 ? 0.2f : 0.8f;
+
+                image.set_pixel(
+                    x,
+                    y,
+                    Color3f(
+                        base * rand_float1(rng, 0.8f, 1.0f),
+                        base * rand_float1(rng, 0.8f, 1.0f),
+                        base * rand_float1(rng, 0.8f, 1.0f)));
+            }
+        }
+
+        GenericImageFileWriter writer;
+        writer.write(filepath.c_str(), image);
+    }
+
+    // A grid of quads in front of the back wall of the Cornell Box, each with its own large texture.
+    auto_release_ptr<Project> generate_heavy_textures(
+        const string&   directory,
+        const size_t    size)
+    {
+        const size_t TextureResolution = 2048;
+
+        auto_release_ptr<Project> project(create_base_project());
+        Assembly& assembly = get_base_assembly(project.ref());
+
+        const size_t grid_size = static_cast<size_t>(ceil(sqrt(static_cast<double>(size))));
+        const float cell_size = 450.0f / grid_size;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            const string suffix = to_string(i);
+            const string texture_name = "texture_" + suffix;
+            const string texture_instance_name = texture_name + "_inst";
+            const string bsdf_name = "textured_material_brdf_" + suffix;
+            const string material_name = "textured_material_" + suffix;
+            const string object_name = "textured_quad_" + suffix;
+
+            // Generate the texture file next to the project file.
+            const string texture_filepath =
+                (filesystem::path(directory) / (texture_name + ".png")).string();
+            write_texture(texture_filepath, TextureResolution, i);
+
+            {
+                ParamArray params;
+                params.insert("filename", texture_filepath);
+                params.insert("color_space", "srgb");
+                assembly.textures().insert(
+                    DiskTexture2dFactory().create(
+                        texture_name.c_str(),
+                        params,
+                        project->search_paths()));
+            }
+
+            {
+                ParamArray params;
+                params.insert("addressing_mode", "wrap");
+                params.insert("filtering_mode", "bilinear");
+                assembly.texture_instances().insert(
+                    TextureInstanceFactory::create(
+                        texture_instance_name.c_str(),
+                        params,
+                        texture_name.c_str()));
+            }
+
+            {
+                ParamArray params;
+                params.insert("reflectance", texture_instance_name);
+                assembly.bsdfs().insert(
+                    LambertianBRDFFactory().create(bsdf_name.c_str(), params));
+            }
+
+            {
+                ParamArray params;
+                params.insert("surface_shader", "physical_shader");
+                params.insert("bsdf", bsdf_name);
+                assembly.materials().insert(
+                    GenericMaterialFactory().create(material_name.c_str(), params));
+            }
+
+            auto_release_ptr<MeshObject> object(
+                MeshObjectFactory::create(object_name.c_str(), ParamArray()));
+
+            const float x0 = 50.0f + (i % grid_size) * cell_size;
+            const float y0 = 50.0f + (i / grid_size) * cell_size;
+            const float x1 = x0 + 0.9f * cell_size;
+            const float y1 = y0 + 0.9f * cell_size;
+            const float z = 550.0f;
+
+            object->push_vertex(GVector3(x0, y0, z));
+            object->push_vertex(GVector3(x1, y0, z));
+            object->push_vertex(GVector3(x1, y1, z));
+            object->push_vertex(GVector3(x0, y1, z));
+
+            object->push_vertex_normal(GVector3(0.0f, 0.0f, -1.0f));
+
+            // Repeat the texture so that texture lookups are spread over all mipmap levels.
+            object->push_tex_coords(GVector2(0.0f, 0.0f));
+            object->push_tex_coords(GVector2(4.0f, 0.0f));
+            object->push_tex_coords(GVector2(4.0f, 4.0f));
+            object->push_tex_coords(GVector2(0.0f, 4.0f));
+
+            const size_t mat_slot = object->push_material_slot(material_name.c_str());
+
+            object->push_triangle(Triangle(0, 1, 2,  0, 0, 0,  0, 1, 2,  mat_slot));
+            object->push_triangle(Triangle(0, 2, 3,  0, 0, 0,  0, 2, 3,  mat_slot));
+
+            assembly.objects().insert(auto_release_ptr<Object>(object));
+
+            assembly.object_instances().insert(
+                ObjectInstanceFactory::create(
+                    (object_name + "_inst").c_str(),
+                    ParamArray(),
+                    object_name.c_str(),
+                    Transformd::from_local_to_parent(Matrix4d::scaling(Vector3d(0.001))),
+                    StringDictionary()
+                        .insert(material_name, material_name)));
+        }
+
+        return project;
+    }
+
+    // Build the rendering parameters of a benchmark.
+    ParamArray get_rendering_parameters(const Project& project, const ParamArray& overrides)
+    {
+        ParamArray params;
+
+        const Configuration* configuration = project.configurations().get_by_name("final");
+
+        if (configuration)
+        {
+            if (configuration->get_base())
+                params = configuration->get_base()->get_parameters();
+
+            params.merge(configuration->get_parameters());
+        }
+
+        // Fix the sampling budget so that the number of samples is known in advance.
+        params.insert_path("frame_renderer", "generic");
+        params.insert_path("tile_renderer", "generic");
+        params.insert_path("pixel_renderer", "uniform");
+        params.insert_path("uniform_pixel_renderer.samples", SamplesPerPixel);
+        params.insert_path("sample_renderer", "generic");
+        params.insert_path("lighting_engine", "pt");
+
+        params.merge(overrides);
+
+        return params;
+    }
+
+    // A dummy benchmark case used to report the duration of a phase.
+    class PhaseCase
+      : public IBenchmarkCase
+    {
+      public:
+        explicit PhaseCase(const char* name)
+          : m_name(name)
+        {
+        }
+
+        virtual const char* get_name() const
+        {
+            return m_name;
+        }
+
+        virtual void run()
+        {
+        }
+
+      private:
+        const char* m_name;
+    };
+
+    string get_suite_name(const RenderBenchmarks::Result& result)
+    {
+        return "Render_" + result.m_name;
+    }
+
+    double get_rate(const uint64 count, const double seconds)
+    {
+        return seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0;
+    }
+}
+
+
+//
+// RenderBenchmarks class implementation.
+//
+
+struct RenderBenchmarks::SceneDefinition
+{
+    const char*     m_name;
+    const char*     m_description;
+    auto_release_ptr<Project> (*m_generate)(const string& directory, const size_t size);
+    size_t          m_size;
+};
+
+RenderBenchmarks::RenderBenchmarks(
+    const string&       scenes_directory,
+    const string&       schema_filepath,
+    const ParamArray&   params,
+    Logger&             logger)
+  : m_scenes_directory(scenes_directory)
+  , m_schema_filepath(schema_filepath)
+  , m_params(params)
+  , m_logger(logger)
+{
+}
+
+bool RenderBenchmarks::run(const IFilter& filter)
+{
+    static const SceneDefinition Scenes[] =
+    {
+        { "InstancedCornellBoxes", "8x8 instances of the Cornell Box", &generate_instanced_cornell_boxes, 8 },
+        { "TriangleSoup", "250,000 random triangles", &generate_triangle_soup, 250000 },
+        { "ManyLights", "256 point lights", &generate_many_lights, 256 },
+        { "HeavyTextures", "16 textures of 2048x2048 pixels", &generate_heavy_textures, 16 }
+    };
+
+    m_results.clear();
+
+    bool success = true;
+
+    for (size_t i = 0; i < sizeof(Scenes) / sizeof(Scenes[0]); ++i)
+    {
+        if (filter.accepts(Scenes[i].m_name))
+            success = run_benchmark(Scenes[i]) && success;
+    }
+
+    return success;
+}
+
+const char* RenderBenchmarks::get_phase_name(const Phase phase)
+{
+    switch (phase)
+    {
+      case PhaseParse:              return "Parse";
+      case PhaseMeshLoad:           return "MeshLoad";
+      case PhaseInputBinding:       return "InputBinding";
+      case PhaseTreeBuild:          return "TreeBuild";
+      case PhaseLightSamplerBuild:  return "LightSamplerBuild";
+      case PhaseFramePreparation:   return "FramePreparation";
+      case PhaseRendering:          return "Rendering";
+      case PhaseWrite:              return "Write";
+      assert_otherwise;
+    }
+
+    // Keep the compiler happy.
+    return "";
+}
+
+const vector<RenderBenchmarks::Result>& RenderBenchmarks::get_results() const
+{
+    return m_results;
+}
+
+bool RenderBenchmarks::run_benchmark(const SceneDefinition& definition)
+{
+    const filesystem::path directory = filesystem::path(m_scenes_directory) / definition.m_name;
+    const string project_filepath = (directory / (string(definition.m_name) + ".appleseed")).string();
+    const string image_filepath = (directory / (string(definition.m_name) + ".png")).string();
+
+    // Generate the scene and write it to disk.
+    LOG_INFO(m_logger, "generating scene %s (%s)...", definition.m_name, definition.m_description);
+    filesystem::create_directories(directory);
+
+    {
+        auto_release_ptr<Project> project(
+            definition.m_generate(directory.string(), definition.m_size));
+
+        if (!ProjectFileWriter::write(project.ref(), project_filepath.c_str()))
+        {
+            LOG_ERROR(m_logger, "failed to write project file %s.", project_filepath.c_str());
+            return false;
+        }
+    }
+
+    LOG_INFO(m_logger, "running benchmark %s...", definition.m_name);
+
+    Result result;
+    result.m_name = definition.m_name;
+    result.m_description = definition.m_description;
+    for (size_t i = 0; i < PhaseCount; ++i)
+        result.m_phase_times[i] = 0.0;
+
+    StopwatchType stopwatch;
+
+    // Load the project, including its mesh files.
+    MeshObjectReader::reset_total_read_time();
+    stopwatch.start();
+    ProjectFileReader reader;
+    auto_release_ptr<Project> project(
+        reader.read(project_filepath.c_str(), m_schema_filepath.c_str()));
+    stopwatch.measure();
+    const double load_time = stopwatch.get_seconds();
+    const double mesh_load_time = MeshObjectReader::get_total_read_time();
+
+    if (project.get() == 0)
+    {
+        LOG_ERROR(m_logger, "failed to load project file %s.", project_filepath.c_str());
+        return false;
+    }
+
+    // Mesh files are read while the project file is parsed.
+    result.m_phase_times[PhaseMeshLoad] = mesh_load_time;
+    result.m_phase_times[PhaseParse] = max(load_time - mesh_load_time, 0.0);
+
+    // Render the project.
+    const ParamArray params = get_rendering_parameters(project.ref(), m_params);
+    DefaultRendererController renderer_controller;
+    MasterRenderer renderer(project.ref(), params, &renderer_controller);
+
+    if (!renderer.render())
+    {
+        LOG_ERROR(m_logger, "failed to render project %s.", definition.m_name);
+        return false;
+    }
+
+    const MasterRenderer::PhaseTimes& phase_times = renderer.get_phase_times();
+    result.m_phase_times[PhaseInputBinding] = phase_times.m_input_binding;
+    result.m_phase_times[PhaseTreeBuild] = phase_times.m_trace_context;
+    result.m_phase_times[PhaseLightSamplerBuild] = phase_times.m_light_sampler;
+    result.m_phase_times[PhaseFramePreparation] = phase_times.m_frame_preparation;
+    result.m_phase_times[PhaseRendering] = phase_times.m_rendering;
+
+    // Rays are counted by the intersectors, samples follow from the fixed sampling budget.
+    result.m_ray_count = project->get_trace_context().get_ray_count();
+    result.m_sample_count =
+          static_cast<uint64>(project->get_frame()->image().properties().m_pixel_count)
+        * params.get_path_optional<size_t>("uniform_pixel_renderer.samples", SamplesPerPixel);
+
+    // Write the frame to disk.
+    stopwatch.start();
+    const bool written = project->get_frame()->write_main_image(image_filepath.c_str());
+    stopwatch.measure();
+    result.m_phase_times[PhaseWrite] = stopwatch.get_seconds();
+
+    if (!written)
+        LOG_WARNING(m_logger, "failed to write image file %s.", image_filepath.c_str());
+
+    // Print the results of this benchmark.
+    for (size_t i = 0; i < PhaseCount; ++i)
+    {
+        LOG_INFO(
+            m_logger,
+            "  %-20s %s",
+            get_phase_name(static_cast<Phase>(i)),
+            pretty_time(result.m_phase_times[i], 3).c_str());
+    }
+
+    const double rendering_time = result.m_phase_times[PhaseRendering];
+
+    LOG_INFO(
+        m_logger,
+        "  %-20s %s (%s rays/s)\n"
+        "  %-20s %s (%s samples/s)",
+        "Rays",
+        pretty_uint(result.m_ray_count).c_str(),
+        pretty_scalar(get_rate(result.m_ray_count, rendering_time), 0).c_str(),
+        "Samples",
+        pretty_uint(result.m_sample_count).c_str(),
+        pretty_scalar(get_rate(result.m_sample_count, rendering_time), 0).c_str());
+
+    m_results.push_back(result);
+
+    return true;
+}
+
+bool RenderBenchmarks::write_xml(const string& filepath) const
+{
+    auto_release_ptr<XMLFileBenchmarkListener> listener(
+        create_xmlfile_benchmark_listener());
+
+    if (!listener->open(filepath.c_str()))
+        return false;
+
+    for (size_t i = 0; i < m_results.size(); ++i)
+    {
+        const Result& result = m_results[i];
+        const BenchmarkSuite suite(get_suite_name(result).c_str());
+
+        listener->begin_suite(suite);
+
+        for (size_t j = 0; j < PhaseCount; ++j)
+        {
+            const PhaseCase phase_case(get_phase_name(static_cast<Phase>(j)));
+
+            listener->begin_case(suite, phase_case);
+
+            TimingResult timing_result;
+            timing_result.m_iteration_count = 1;
+            timing_result.m_measurement_count = 1;
+            timing_result.m_frequency = TicksPerSecond;
+            timing_result.m_ticks = result.m_phase_times[j] * TicksPerSecond;
+            listener->write(suite, phase_case, __FILE__, __LINE__, timing_result);
+
+            // Throughputs are attached to the rendering phase as messages.
+            if (j == PhaseRendering)
+            {
+                const double rendering_time = result.m_phase_times[j];
+
+                listener->write(
+                    suite,
+                    phase_case,
+                    __FILE__,
+                    __LINE__,
+                    ("rays/s: " + to_string(get_rate(result.m_ray_count, rendering_time))).c_str());
+
+                listener->write(
+                    suite,
+                    phase_case,
+                    __FILE__,
+                    __LINE__,
+                    ("samples/s: " + to_string(get_rate(result.m_sample_count, rendering_time))).c_str());
+            }
+
+            listener->end_case(suite, phase_case);
+        }
+
+        listener->end_suite(suite);
+    }
+
+    listener->close();
+
+    return true;
+}
+
+bool RenderBenchmarks::write_json(const string& filepath) const
+{
+    FILE* file = fopen(filepath.c_str(), "wt");
+
+    if (file == 0)
+        return false;
+
+    fprintf(file, "{\n");
+    fprintf(file, "    \"version\": \"%s\",\n", Appleseed::get_synthetic_version_string());
+    fprintf(file, "    \"configuration\": \"%s\",\n", Appleseed::get_lib_configuration());
+    fprintf(file, "    \"image_width\": " FMT_SIZE_T ",\n", ImageWidth);
+    fprintf(file, "    \"image_height\": " FMT_SIZE_T ",\n", ImageHeight);
+    fprintf(file, "    \"benchmarks\": [\n");
+
+    for (size_t i = 0; i < m_results.size(); ++i)
+    {
+        const Result& result = m_results[i];
+        const double rendering_time = result.m_phase_times[PhaseRendering];
+
+        fprintf(file, "        {\n");
+        fprintf(file, "            \"name\": \"%s\",\n", result.m_name.c_str());
+        fprintf(file, "            \"description\": \"%s\",\n", result.m_description.c_str());
+        fprintf(file, "            \"phases\": {\n");
+
+        for (size_t j = 0; j < PhaseCount; ++j)
+        {
+            fprintf(
+                file,
+                "                \"%s\": %f%s\n",
+                get_phase_name(static_cast<Phase>(j)),
+                result.m_phase_times[j],
+                j + 1 < PhaseCount ? "," : "");
+        }
+
+        fprintf(file, "            },\n");
+        fprintf(file, "            \"rays\": " FMT_UINT64 ",\n", result.m_ray_count);
+        fprintf(file, "            \"samples\": " FMT_UINT64 ",\n", result.m_sample_count);
+        fprintf(file, "            \"rays_per_second\": %f,\n", get_rate(result.m_ray_count, rendering_time));
+        fprintf(file, "            \"samples_per_second\": %f\n", get_rate(result.m_sample_count, rendering_time));
+        fprintf(file, "        }%s\n", i + 1 < m_results.size() ? "," : "");
+    }
+
+    fprintf(file, "    ]\n");
+    fprintf(file, "}\n");
+
+    fclose(file);
+
+    return true;
+}
+
+bool RenderBenchmarks::compare(const string& filepath) const
+{
+    BenchmarkAggregator aggregator;
+
+    if (!aggregator.scan_file(filepath.c_str()))
+    {
+        LOG_ERROR(
+            m_logger,
+            "failed to read benchmark results from %s (the file name must be of the form "
+            "benchmark.YYYYMMDD.HHMMSS.mmm.xml).",
+            filepath.c_str());
+        return false;
+    }
+
+    LOG_INFO(m_logger, "comparison with %s:", filepath.c_str());
+
+    const Dictionary& benchmarks = aggregator.get_benchmarks();
+
+    for (size_t i = 0; i < m_results.size(); ++i)
+    {
+        const Result& result = m_results[i];
+        const string suite_name = get_suite_name(result);
+
+        // Use the first configuration in which this benchmark was found.
+        const Dictionary* cases = 0;
+        for (const_each<DictionaryDictionary> j = benchmarks.dictionaries(); j; ++j)
+        {
+            if (j->value().dictionaries().exist(suite_name))
+            {
+                cases = &j->value().dictionaries().get(suite_name);
+                break;
+            }
+        }
+
+        if (cases == 0)
+        {
+            LOG_INFO(m_logger, "  %s: no reference result.", result.m_name.c_str());
+            continue;
+        }
+
+        LOG_INFO(m_logger, "  %s:", result.m_name.c_str());
+
+        for (size_t j = 0; j < PhaseCount; ++j)
+        {
+            const char* phase_name = get_phase_name(static_cast<Phase>(j));
+
+            if (!cases->strings().exist(phase_name))
+                continue;
+
+            const BenchmarkSerie& serie = aggregator.get_serie(cases->get<UniqueID>(phase_name));
+
+            if (serie.empty())
+                continue;
+
+            const double reference_time = serie[serie.size() - 1].get_ticks() / TicksPerSecond;
+            const double current_time = result.m_phase_times[j];
+
+            LOG_INFO(
+                m_logger,
+                "    %-20s %s -> %s (%s)",
+                phase_name,
+                pretty_time(reference_time, 3).c_str(),
+                pretty_time(current_time, 3).c_str(),
+                reference_time > 0.0
+                    ? ("x" + pretty_scalar(current_time / reference_time, 2)).c_str()
+                    : "n/a");
+        }
+    }
+
+    return true;
+}
+
+}   // namespace cli
+}   // namespace appleseed
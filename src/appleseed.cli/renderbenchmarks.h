@@ -0,0 +1,127 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_CLI_RENDERBENCHMARKS_H
+#define APPLESEED_CLI_RENDERBENCHMARKS_H
+
+// appleseed.renderer headers.
+#include "renderer/api/utility.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declarations.
+namespace foundation    { class IFilter; }
+namespace foundation    { class Logger; }
+
+namespace appleseed {
+namespace cli {
+
+//
+// End-to-end rendering benchmarks.
+//
+// Each benchmark procedurally generates a scene of controlled size, writes it to disk,
+// loads it back, renders it with a fixed sampling budget and writes the resulting image.
+// The duration of each phase is reported, together with ray and sample throughputs.
+//
+
+class RenderBenchmarks
+  : public foundation::NonCopyable
+{
+  public:
+    // Phases of a benchmark.
+    enum Phase
+    {
+        PhaseParse,                     // reading the project file, excluding mesh files
+        PhaseMeshLoad,                  // reading mesh files
+        PhaseInputBinding,              // binding entity inputs
+        PhaseTreeBuild,                 // building acceleration structures
+        PhaseLightSamplerBuild,         // building the light sampler
+        PhaseFramePreparation,          // preparing the scene for rendering
+        PhaseRendering,                 // rendering the frame
+        PhaseWrite,                     // writing the frame to disk
+        PhaseCount
+    };
+
+    // Result of a benchmark.
+    struct Result
+    {
+        std::string         m_name;
+        std::string         m_description;
+        double              m_phase_times[PhaseCount];  // in seconds
+        foundation::uint64  m_ray_count;
+        foundation::uint64  m_sample_count;
+    };
+
+    // Constructor.
+    RenderBenchmarks(
+        const std::string&          scenes_directory,   // where scenes and images are written
+        const std::string&          schema_filepath,    // path to the project file schema
+        const renderer::ParamArray& params,             // merged on top of the benchmark rendering parameters
+        foundation::Logger&         logger);
+
+    // Run the benchmarks whose name pass a given filter. Return true if they all succeeded.
+    bool run(const foundation::IFilter& filter);
+
+    // Return the name of a phase.
+    static const char* get_phase_name(const Phase phase);
+
+    // Return the results of the last call to run().
+    const std::vector<Result>& get_results() const;
+
+    // Write the results of the last call to run() in the XML format of unit benchmarks.
+    bool write_xml(const std::string& filepath) const;
+
+    // Write the results of the last call to run() in JSON format.
+    bool write_json(const std::string& filepath) const;
+
+    // Compare the results of the last call to run() with those stored in a XML result file.
+    bool compare(const std::string& filepath) const;
+
+  private:
+    const std::string           m_scenes_directory;
+    const std::string           m_schema_filepath;
+    const renderer::ParamArray  m_params;
+    foundation::Logger&         m_logger;
+    std::vector<Result>         m_results;
+
+    struct SceneDefinition;
+
+    bool run_benchmark(const SceneDefinition& definition);
+};
+
+}       // namespace cli
+}       // namespace appleseed
+
+#endif  // !APPLESEED_CLI_RENDERBENCHMARKS_H
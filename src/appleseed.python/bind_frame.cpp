@@ -62,6 +62,16 @@ namespace detail
         frame->transform_to_output_color_space(*image);
     }
 
+    bool write_main_image(const Frame* frame, const char* file_path)
+    {
+        return frame->write_main_image(file_path);
+    }
+
+    bool write_aov_images(const Frame* frame, const char* file_path)
+    {
+        return frame->write_aov_images(file_path);
+    }
+
     bpy::object archive_frame(const Frame* frame, const char* directory)
     {
         char* output = 0;
@@ -83,14 +93,14 @@ void bind_frame()
     bpy::class_<Frame, auto_release_ptr<Frame>, bpy::bases<Entity>, boost::noncopyable>("Frame", bpy::no_init)
         .def("__init__", bpy::make_constructor(detail::create_frame))
 
-        .def("image", &Frame::image, bpy::return_value_policy<bpy::reference_existing_object>())
-        .def("aov_images", &Frame::aov_images, bpy::return_value_policy<bpy::reference_existing_object>())
+        .def("image", &Frame::image, bpy::return_internal_reference<>())
+        .def("aov_images", &Frame::aov_images, bpy::return_internal_reference<>())
 
         .def("transform_tile_to_output_color_space", detail::transform_tile_to_output_color_space)
         .def("transform_image_to_output_color_space", detail::transform_image_to_output_color_space)
 
         .def("clear_main_image", &Frame::clear_main_image)
-        .def("write_main_image", &Frame::write_main_image)
-        .def("write_aov_images", &Frame::write_aov_images)
+        .def("write_main_image", detail::write_main_image)
+        .def("write_aov_images", detail::write_aov_images)
         .def("archive", detail::archive_frame);
 }
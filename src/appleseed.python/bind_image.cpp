@@ -40,6 +40,7 @@
 #include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
 #include "foundation/platform/types.h"
+#include "foundation/utility/otherwise.h"
 
 // Standard headers.
 #include <algorithm>
@@ -65,16 +66,14 @@ namespace detail
 
     void copy_tile_data_to_py_array(const Tile& tile, bpy::object& buffer)
     {
-        void* array = 0;
-        Py_ssize_t len;
+        Py_buffer view;
 
-        const int success = PyObject_AsWriteBuffer(buffer.ptr(), &array, &len);
-
-        if (success != 0)
+        if (PyObject_GetBuffer(buffer.ptr(), &view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0)
             bpy::throw_error_already_set();
 
-        if (static_cast<size_t>(len) < tile.get_size())
+        if (static_cast<size_t>(view.len) < tile.get_size())
         {
+            PyBuffer_Release(&view);
             PyErr_SetString(PyExc_IndexError, "Buffer size is smaller than data size");
             bpy::throw_error_already_set();
         }
@@ -82,7 +81,98 @@ namespace detail
         std::copy(
             tile.get_storage(),
             tile.get_storage() + tile.get_size(),
-            reinterpret_cast<uint8*>(array));
+            reinterpret_cast<uint8*>(view.buf));
+
+        PyBuffer_Release(&view);
+    }
+
+    //
+    // Buffer protocol support for tiles.
+    //
+    // Tiles export their pixel storage without copying it, as a writable
+    // three-dimensional buffer of shape (height, width, channel count), e.g.
+    // numpy.asarray(tile). The buffer keeps the Python tile object alive.
+    //
+
+    const char* get_buffer_format(const PixelFormat pixel_format)
+    {
+        switch (pixel_format)
+        {
+          case PixelFormatUInt8:  return "B";
+          case PixelFormatUInt16: return "H";
+          case PixelFormatUInt32: return "I";
+          case PixelFormatHalf:   return "e";
+          case PixelFormatFloat:  return "f";
+          case PixelFormatDouble: return "d";
+          assert_otherwise;
+        }
+
+        return 0;
+    }
+
+    struct TileBufferInfo
+    {
+        Py_ssize_t  m_shape[3];
+        Py_ssize_t  m_strides[3];
+    };
+
+    int tile_get_buffer(PyObject* obj, Py_buffer* view, int flags)
+    {
+        bpy::extract<Tile*> extractor(obj);
+
+        if (!extractor.check())
+        {
+            PyErr_SetString(PyExc_BufferError, "Object does not hold a tile");
+            view->obj = 0;
+            return -1;
+        }
+
+        const Tile* tile = extractor();
+        const size_t channel_size = Pixel::size(tile->get_pixel_format());
+
+        TileBufferInfo* info = new TileBufferInfo();
+        info->m_shape[0] = static_cast<Py_ssize_t>(tile->get_height());
+        info->m_shape[1] = static_cast<Py_ssize_t>(tile->get_width());
+        info->m_shape[2] = static_cast<Py_ssize_t>(tile->get_channel_count());
+        info->m_strides[2] = static_cast<Py_ssize_t>(channel_size);
+        info->m_strides[1] = info->m_strides[2] * info->m_shape[2];
+        info->m_strides[0] = info->m_strides[1] * info->m_shape[1];
+
+        view->buf = tile->get_storage();
+        view->obj = obj;
+        view->len = static_cast<Py_ssize_t>(tile->get_size());
+        view->readonly = 0;
+        view->itemsize = static_cast<Py_ssize_t>(channel_size);
+        view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(get_buffer_format(tile->get_pixel_format())) : 0;
+        view->shape = (flags & PyBUF_ND) == PyBUF_ND ? info->m_shape : 0;
+        view->ndim = view->shape ? 3 : 1;
+        view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? info->m_strides : 0;
+        view->suboffsets = 0;
+        view->internal = info;
+
+        Py_INCREF(obj);
+
+        return 0;
+    }
+
+    void tile_release_buffer(PyObject* obj, Py_buffer* view)
+    {
+        delete static_cast<TileBufferInfo*>(view->internal);
+    }
+
+    void enable_buffer_protocol(const bpy::object& class_object)
+    {
+        PyTypeObject* type = reinterpret_cast<PyTypeObject*>(class_object.ptr());
+
+        static PyBufferProcs buffer_procs;
+        buffer_procs.bf_getbuffer = tile_get_buffer;
+        buffer_procs.bf_releasebuffer = tile_release_buffer;
+
+        type->tp_as_buffer = &buffer_procs;
+
+#if PY_MAJOR_VERSION < 3
+        type->tp_flags |= Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
     }
 
     Image* copy_image(const Image* source)
@@ -131,7 +221,8 @@ void bind_image()
         .def("get_tile_width", &CanvasProperties::get_tile_width)
         .def("get_tile_height", &CanvasProperties::get_tile_height);
 
-    bpy::class_<Tile, boost::noncopyable>("Tile", bpy::init<size_t, size_t, size_t, PixelFormat>())
+    const bpy::object tile_class =
+        bpy::class_<Tile, boost::noncopyable>("Tile", bpy::init<size_t, size_t, size_t, PixelFormat>())
         .def("__copy__", detail::copy_tile, bpy::return_value_policy<bpy::manage_new_object>())
         .def("__deepcopy__", detail::deepcopy_tile, bpy::return_value_policy<bpy::manage_new_object>())
         .def("get_pixel_format", &Tile::get_pixel_format)
@@ -142,17 +233,19 @@ void bind_image()
         .def("get_size", &Tile::get_size)
         .def("copy_data_to", detail::copy_tile_data_to_py_array);   // todo: maybe this needs a better name
 
+    detail::enable_buffer_protocol(tile_class);
+
     const Tile& (Image::*image_get_tile)(const size_t, const size_t) const = &Image::tile;
 
     bpy::class_<Image, boost::noncopyable>("Image", bpy::no_init)
         .def("__copy__", detail::copy_image, bpy::return_value_policy<bpy::manage_new_object>())
         .def("__deepcopy__", detail::copy_image, bpy::return_value_policy<bpy::manage_new_object>())
         .def("properties", &Image::properties, bpy::return_value_policy<bpy::reference_existing_object>())
-        .def("tile", image_get_tile, bpy::return_value_policy<bpy::reference_existing_object>());
+        .def("tile", image_get_tile, bpy::return_internal_reference<>());
 
     bpy::class_<ImageStack, boost::noncopyable>("ImageStack", bpy::no_init)
         .def("empty", &ImageStack::empty)
         .def("size", &ImageStack::size)
         .def("get_name", detail::image_stack_get_name)
-        .def("get_image", &ImageStack::get_image, bpy::return_value_policy<bpy::reference_existing_object>());
+        .def("get_image", &ImageStack::get_image, bpy::return_internal_reference<>());
 }
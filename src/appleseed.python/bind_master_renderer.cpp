@@ -37,11 +37,13 @@
 // appleseed.renderer headers.
 #include "renderer/api/project.h"
 #include "renderer/api/rendering.h"
+#include "renderer/api/tracecontext.h"
 
 // appleseed.foundation headers.
 #include "foundation/platform/python.h"
 
 // Standard headers.
+#include <cstddef>
 #include <memory>
 
 namespace bpy = boost::python;
@@ -88,6 +90,36 @@ namespace detail
         m->get_parameters() = bpy_dict_to_param_array(params);
     }
 
+    bpy::dict master_renderer_get_ray_statistics(const MasterRenderer* m)
+    {
+        static const char* CategoryKeys[RayStatistics::CategoryCount] =
+        {
+            "camera_rays",
+            "indirect_rays",
+            "shadow_rays",
+            "light_rays",
+            "other_rays"
+        };
+
+        const RayStatistics& ray_stats = m->get_ray_statistics();
+        const double rendering_time = m->get_phase_times().m_rendering;
+        const uint64 total_ray_count = ray_stats.get_total_ray_count();
+
+        bpy::dict result;
+
+        for (size_t i = 0; i < RayStatistics::CategoryCount; ++i)
+            result[CategoryKeys[i]] = ray_stats.m_ray_counts[i];
+
+        result["total_rays"] = total_ray_count;
+        result["leaf_visits"] = ray_stats.m_leaf_visit_count;
+        result["triangle_tests"] = ray_stats.m_triangle_test_count;
+        result["rendering_time"] = rendering_time;
+        result["rays_per_second"] =
+            rendering_time > 0.0 ? static_cast<double>(total_ray_count) / rendering_time : 0.0;
+
+        return result;
+    }
+
     bool master_renderer_render(MasterRenderer* m)
     {
         // Unlock Python's global interpreter lock (GIL) while we do lenghty C++ computations.
@@ -105,5 +137,6 @@ void bind_master_renderer()
         .def("__init__", bpy::make_constructor(detail::create_master_renderer_with_tile_callback))
         .def("get_parameters", detail::master_renderer_get_parameters)
         .def("set_parameters", detail::master_renderer_set_parameters)
+        .def("get_ray_statistics", detail::master_renderer_get_ray_statistics)
         .def("render", detail::master_renderer_render);
 }
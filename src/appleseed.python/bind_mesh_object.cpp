@@ -33,17 +33,25 @@
 // appleseed.python headers.
 #include "bind_typed_entity_containers.h"
 #include "dict2dict.h"
+#include "gil_locks.h"
 
 // appleseed.renderer headers.
 #include "renderer/api/object.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/concepts/iunknown.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/autoreleaseptr.h"
 #include "foundation/utility/searchpaths.h"
 
+// boost headers.
+#include "boost/static_assert.hpp"
+
 // Standard headers.
 #include <cstddef>
+#include <cstring>
 #include <string>
+#include <vector>
 
 namespace bpy = boost::python;
 using namespace foundation;
@@ -98,6 +106,407 @@ namespace detail
         return py_objects;
     }
 
+    //
+    // Bulk insertion and adoption of mesh features from objects supporting
+    // the buffer protocol, such as NumPy arrays.
+    //
+
+    BOOST_STATIC_ASSERT(sizeof(GVector2) == 2 * sizeof(float));
+    BOOST_STATIC_ASSERT(sizeof(GVector3) == 3 * sizeof(float));
+    BOOST_STATIC_ASSERT(sizeof(Triangle) == 10 * sizeof(uint32));
+
+    enum ScalarType
+    {
+        ScalarTypeFloat,
+        ScalarTypeDouble,
+        ScalarTypeInt32,
+        ScalarTypeUInt32,
+        ScalarTypeInt64,
+        ScalarTypeUInt64,
+        ScalarTypeUnsupported
+    };
+
+    // Holds a Python buffer for as long as a mesh object references its memory.
+    class PythonBuffer
+      : public IUnknown
+    {
+      public:
+        explicit PythonBuffer(const Py_buffer& view)
+          : m_view(view)
+        {
+        }
+
+        virtual void release()
+        {
+            {
+                ScopedGILLock lock;
+                PyBuffer_Release(&m_view);
+            }
+
+            delete this;
+        }
+
+        void* get_data() const
+        {
+            return m_view.buf;
+        }
+
+        size_t get_scalar_count() const
+        {
+            return static_cast<size_t>(m_view.len / m_view.itemsize);
+        }
+
+        bool is_c_contiguous() const
+        {
+            return PyBuffer_IsContiguous(const_cast<Py_buffer*>(&m_view), 'C') != 0;
+        }
+
+        // Return the number of scalars in a row of a 2D buffer, or 0 for other buffers.
+        size_t get_row_size() const
+        {
+            return m_view.ndim == 2 ? static_cast<size_t>(m_view.shape[1]) : 0;
+        }
+
+        ScalarType get_scalar_type() const
+        {
+            const char* format = m_view.format ? m_view.format : "B";
+
+            // Accept native and little-endian byte orders.
+            if (format[0] == '@' || format[0] == '=' || format[0] == '<')
+                ++format;
+
+            if (std::strlen(format) != 1)
+                return ScalarTypeUnsupported;
+
+            switch (format[0])
+            {
+              case 'f': return m_view.itemsize == 4 ? ScalarTypeFloat : ScalarTypeUnsupported;
+              case 'd': return m_view.itemsize == 8 ? ScalarTypeDouble : ScalarTypeUnsupported;
+              case 'i': case 'l': case 'q':
+                return
+                    m_view.itemsize == 4 ? ScalarTypeInt32 :
+                    m_view.itemsize == 8 ? ScalarTypeInt64 :
+                    ScalarTypeUnsupported;
+              case 'I': case 'L': case 'Q':
+                return
+                    m_view.itemsize == 4 ? ScalarTypeUInt32 :
+                    m_view.itemsize == 8 ? ScalarTypeUInt64 :
+                    ScalarTypeUnsupported;
+              default: return ScalarTypeUnsupported;
+            }
+        }
+
+      private:
+        Py_buffer m_view;
+
+        ~PythonBuffer() {}
+    };
+
+    // Holds a private copy of a read-only Python buffer, adopted in place of the buffer.
+    template <typename T>
+    class PythonBufferCopy
+      : public IUnknown
+    {
+      public:
+        PythonBufferCopy(const void* data, const size_t count)
+          : m_values(static_cast<const T*>(data), static_cast<const T*>(data) + count)
+        {
+        }
+
+        virtual void release()
+        {
+            delete this;
+        }
+
+        T* get_data()
+        {
+            return m_values.empty() ? 0 : &m_values[0];
+        }
+
+      private:
+        std::vector<T> m_values;
+
+        ~PythonBufferCopy() {}
+    };
+
+    // RAII helper that releases a Python buffer unless ownership is transferred.
+    class PythonBufferPtr
+      : public NonCopyable
+    {
+      public:
+        // If @writable is true, a writable buffer is requested first; the buffer
+        // is acquired read-only if the object doesn't provide a writable one.
+        explicit PythonBufferPtr(const bpy::object& obj, const bool writable = false)
+          : m_writable(false)
+        {
+            const int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+            Py_buffer view;
+
+            if (writable)
+            {
+                if (PyObject_GetBuffer(obj.ptr(), &view, flags | PyBUF_WRITABLE) == 0)
+                    m_writable = true;
+                else PyErr_Clear();
+            }
+
+            if (!m_writable && PyObject_GetBuffer(obj.ptr(), &view, flags) != 0)
+                bpy::throw_error_already_set();
+
+            m_buffer = new PythonBuffer(view);
+        }
+
+        bool is_writable() const
+        {
+            return m_writable;
+        }
+
+        ~PythonBufferPtr()
+        {
+            if (m_buffer)
+                m_buffer->release();
+        }
+
+        const PythonBuffer& operator*() const
+        {
+            return *m_buffer;
+        }
+
+        PythonBuffer* operator->() const
+        {
+            return m_buffer;
+        }
+
+        PythonBuffer* transfer()
+        {
+            PythonBuffer* buffer = m_buffer;
+            m_buffer = 0;
+            return buffer;
+        }
+
+      private:
+        PythonBuffer*   m_buffer;
+        bool            m_writable;
+    };
+
+    void raise_type_error(const char* message)
+    {
+        PyErr_SetString(PyExc_TypeError, message);
+        bpy::throw_error_already_set();
+    }
+
+    template <typename Source, typename Dest>
+    void convert_scalars(const void* source, const size_t count, Dest* dest)
+    {
+        const Source* s = static_cast<const Source*>(source);
+
+        for (size_t i = 0; i < count; ++i)
+            dest[i] = static_cast<Dest>(s[i]);
+    }
+
+    // Return a pointer to the buffer's scalars as floats, converting them into storage if necessary.
+    const float* get_floats(const PythonBuffer& buffer, std::vector<float>& storage)
+    {
+        switch (buffer.get_scalar_type())
+        {
+          case ScalarTypeFloat:
+            return static_cast<const float*>(buffer.get_data());
+
+          case ScalarTypeDouble:
+            storage.resize(buffer.get_scalar_count());
+            convert_scalars<double>(buffer.get_data(), storage.size(), storage.empty() ? 0 : &storage[0]);
+            return storage.empty() ? 0 : &storage[0];
+
+          default:
+            raise_type_error("Expected a buffer of float32 or float64 values.");
+            return 0;
+        }
+    }
+
+    // Return a pointer to the buffer's scalars as 32-bit unsigned integers, converting them into storage if necessary.
+    const uint32* get_uint32s(const PythonBuffer& buffer, std::vector<uint32>& storage)
+    {
+        switch (buffer.get_scalar_type())
+        {
+          case ScalarTypeInt32:
+          case ScalarTypeUInt32:
+            return static_cast<const uint32*>(buffer.get_data());
+
+          case ScalarTypeInt64:
+            storage.resize(buffer.get_scalar_count());
+            convert_scalars<int64>(buffer.get_data(), storage.size(), storage.empty() ? 0 : &storage[0]);
+            return storage.empty() ? 0 : &storage[0];
+
+          case ScalarTypeUInt64:
+            storage.resize(buffer.get_scalar_count());
+            convert_scalars<uint64>(buffer.get_data(), storage.size(), storage.empty() ? 0 : &storage[0]);
+            return storage.empty() ? 0 : &storage[0];
+
+          default:
+            raise_type_error("Expected a buffer of 32-bit or 64-bit integer values.");
+            return 0;
+        }
+    }
+
+    size_t get_element_count(const PythonBuffer& buffer, const size_t scalars_per_element)
+    {
+        const size_t scalar_count = buffer.get_scalar_count();
+
+        if (scalar_count % scalars_per_element != 0)
+            raise_type_error("Buffer size is not a multiple of the number of components per element.");
+
+        return scalar_count / scalars_per_element;
+    }
+
+    size_t push_vertices(MeshObject* object, const bpy::object& array)
+    {
+        PythonBufferPtr buffer(array);
+        const size_t count = get_element_count(*buffer, 3);
+
+        std::vector<float> storage;
+        const float* values = get_floats(*buffer, storage);
+
+        return object->push_vertices(reinterpret_cast<const GVector3*>(values), count);
+    }
+
+    size_t push_vertex_normals(MeshObject* object, const bpy::object& array)
+    {
+        PythonBufferPtr buffer(array);
+        const size_t count = get_element_count(*buffer, 3);
+
+        std::vector<float> storage;
+        const float* values = get_floats(*buffer, storage);
+
+        return object->push_vertex_normals(reinterpret_cast<const GVector3*>(values), count);
+    }
+
+    size_t push_tex_coords(MeshObject* object, const bpy::object& array)
+    {
+        PythonBufferPtr buffer(array);
+        const size_t count = get_element_count(*buffer, 2);
+
+        std::vector<float> storage;
+        const float* values = get_floats(*buffer, storage);
+
+        return object->push_tex_coords(reinterpret_cast<const GVector2*>(values), count);
+    }
+
+    // Triangles are given as a 2D buffer of integers with 3 (v0 v1 v2), 4 (v0 v1 v2 pa),
+    // 7 (v0 v1 v2 n0 n1 n2 pa) or 10 (v0 v1 v2 n0 n1 n2 a0 a1 a2 pa) columns, mirroring
+    // the constructors of the Triangle class. Missing features are set to Triangle::None.
+    size_t push_triangles(MeshObject* object, const bpy::object& array)
+    {
+        PythonBufferPtr buffer(array);
+        const size_t row_size = buffer->get_row_size();
+
+        if (row_size != 3 && row_size != 4 && row_size != 7 && row_size != 10)
+            raise_type_error("Expected a 2D buffer with 3, 4, 7 or 10 columns.");
+
+        const size_t count = get_element_count(*buffer, row_size);
+
+        std::vector<uint32> storage;
+        const uint32* values = get_uint32s(*buffer, storage);
+
+        if (row_size == 10)
+            return object->push_triangles(reinterpret_cast<const Triangle*>(values), count);
+
+        std::vector<Triangle> triangles(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint32* row = values + i * row_size;
+
+            switch (row_size)
+            {
+              case 3: triangles[i] = Triangle(row[0], row[1], row[2]); break;
+              case 4: triangles[i] = Triangle(row[0], row[1], row[2], row[3]); break;
+              case 7: triangles[i] = Triangle(row[0], row[1], row[2], row[3], row[4], row[5], row[6]); break;
+            }
+        }
+
+        return object->push_triangles(triangles.empty() ? 0 : &triangles[0], count);
+    }
+
+    // The adopted buffer must be C-contiguous and hold float32 values (vertices and
+    // vertex normals) or 32-bit integers with 10 columns (triangles). The buffer is
+    // locked (it cannot be resized) for as long as the mesh object references it.
+    // Since the mesh object may write to the adopted memory, read-only buffers are
+    // copied instead of being adopted.
+
+    template <typename T>
+    void get_adoptable_buffer(
+        PythonBufferPtr&    buffer,
+        const size_t        count,
+        T*&                 values,
+        IUnknown*&          owner)
+    {
+        if (!buffer->is_c_contiguous())
+            raise_type_error("Expected a C-contiguous buffer.");
+
+        if (buffer.is_writable())
+        {
+            values = static_cast<T*>(buffer->get_data());
+            owner = buffer.transfer();
+        }
+        else
+        {
+            PythonBufferCopy<T>* copy = new PythonBufferCopy<T>(buffer->get_data(), count);
+            values = copy->get_data();
+            owner = copy;
+        }
+    }
+
+    void adopt_vertices(MeshObject* object, const bpy::object& array)
+    {
+        PythonBufferPtr buffer(array, true);
+
+        if (buffer->get_scalar_type() != ScalarTypeFloat)
+            raise_type_error("Expected a buffer of float32 values.");
+
+        const size_t count = get_element_count(*buffer, 3);
+
+        GVector3* values;
+        IUnknown* owner;
+        get_adoptable_buffer(buffer, count, values, owner);
+
+        object->adopt_vertices(values, count, owner);
+    }
+
+    void adopt_vertex_normals(MeshObject* object, const bpy::object& array)
+    {
+        PythonBufferPtr buffer(array, true);
+
+        if (buffer->get_scalar_type() != ScalarTypeFloat)
+            raise_type_error("Expected a buffer of float32 values.");
+
+        const size_t count = get_element_count(*buffer, 3);
+
+        GVector3* values;
+        IUnknown* owner;
+        get_adoptable_buffer(buffer, count, values, owner);
+
+        object->adopt_vertex_normals(values, count, owner);
+    }
+
+    void adopt_triangles(MeshObject* object, const bpy::object& array)
+    {
+        PythonBufferPtr buffer(array, true);
+
+        const ScalarType scalar_type = buffer->get_scalar_type();
+        if (scalar_type != ScalarTypeInt32 && scalar_type != ScalarTypeUInt32)
+            raise_type_error("Expected a buffer of 32-bit integer values.");
+
+        if (buffer->get_row_size() != 10)
+            raise_type_error("Expected a 2D buffer with 10 columns.");
+
+        const size_t count = get_element_count(*buffer, 10);
+
+        Triangle* values;
+        IUnknown* owner;
+        get_adoptable_buffer(buffer, count, values, owner);
+
+        object->adopt_triangles(values, count, owner);
+    }
+
     bool write_mesh_object(
         const MeshObject*   object,
         const std::string&  object_name,
@@ -133,20 +542,27 @@ void bind_mesh_object()
 
         .def("reserve_vertices", &MeshObject::reserve_vertices)
         .def("push_vertex", &MeshObject::push_vertex)
+        .def("push_vertices", detail::push_vertices)
+        .def("adopt_vertices", detail::adopt_vertices)
         .def("get_vertex_count", &MeshObject::get_vertex_count)
         .def("get_vertex", &MeshObject::get_vertex, bpy::return_value_policy<bpy::reference_existing_object>())
 
         .def("reserve_vertex_normals", &MeshObject::reserve_vertex_normals)
         .def("push_vertex_normal", &MeshObject::push_vertex_normal)
+        .def("push_vertex_normals", detail::push_vertex_normals)
+        .def("adopt_vertex_normals", detail::adopt_vertex_normals)
         .def("get_vertex_normal_count", &MeshObject::get_vertex_normal_count)
         .def("get_vertex_normal", &MeshObject::get_vertex_normal, bpy::return_value_policy<bpy::reference_existing_object>())
 
-        .def("push_tex_coords", &MeshObject::push_tex_coords)
+        .def("push_tex_coords", detail::push_tex_coords)
+        .def("push_tex_coords", static_cast<size_t (MeshObject::*)(const GVector2&)>(&MeshObject::push_tex_coords))
         .def("get_tex_coords_count", &MeshObject::get_tex_coords_count)
         .def("get_tex_coords", &MeshObject::get_tex_coords)
 
         .def("reserve_triangles", &MeshObject::reserve_triangles)
         .def("push_triangle", &MeshObject::push_triangle)
+        .def("push_triangles", detail::push_triangles)
+        .def("adopt_triangles", detail::adopt_triangles)
         .def("get_triangle_count", &MeshObject::get_triangle_count)
         .def("get_triangle", &MeshObject::get_triangle, bpy::return_value_policy<bpy::reference_existing_object>())
 
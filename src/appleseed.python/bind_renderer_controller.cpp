@@ -111,6 +111,30 @@ namespace detail
             }
         }
 
+        virtual void on_frame_setup() OVERRIDE
+        {
+            m_base_controller.on_frame_setup();
+
+            // Lock Python's global interpreter lock (GIL),
+            // it was released in MasterRenderer.render.
+            ScopedGILLock lock;
+
+            try
+            {
+                if (bpy::override f = get_override("on_frame_setup"))
+                    f();
+            }
+            catch (bpy::error_already_set)
+            {
+                PyErr_Print();
+            }
+        }
+
+        void default_on_frame_setup()
+        {
+            m_base_controller.on_frame_setup();
+        }
+
         virtual void on_frame_begin() OVERRIDE
         {
             m_base_controller.on_frame_begin();
@@ -165,7 +189,32 @@ namespace detail
                 return AbortRendering;
             }
         }
-        
+
+        virtual Status on_frame_complete() OVERRIDE
+        {
+            // Lock Python's global interpreter lock (GIL),
+            // it was released in MasterRenderer.render.
+            ScopedGILLock lock;
+
+            try
+            {
+                if (bpy::override f = get_override("on_frame_complete"))
+                    return f();
+            }
+            catch (bpy::error_already_set)
+            {
+                PyErr_Print();
+                return AbortRendering;
+            }
+
+            return m_base_controller.on_frame_complete();
+        }
+
+        Status default_on_frame_complete()
+        {
+            return m_base_controller.on_frame_complete();
+        }
+
       private:
         renderer::DefaultRendererController m_base_controller;
     };
@@ -184,9 +233,11 @@ void bind_renderer_controller()
         .def("on_rendering_begin", bpy::pure_virtual(&IRendererController::on_rendering_begin))
         .def("on_rendering_success", bpy::pure_virtual(&IRendererController::on_rendering_success))
         .def("on_rendering_abort", bpy::pure_virtual(&IRendererController::on_rendering_abort))
+        .def("on_frame_setup", &IRendererController::on_frame_setup, &detail::IRendererControllerWrapper::default_on_frame_setup)
         .def("on_frame_begin", bpy::pure_virtual(&IRendererController::on_frame_begin))
         .def("on_frame_end", bpy::pure_virtual(&IRendererController::on_frame_end))
-        .def("on_progress", bpy::pure_virtual(&IRendererController::on_progress));
+        .def("on_progress", bpy::pure_virtual(&IRendererController::on_progress))
+        .def("on_frame_complete", &IRendererController::on_frame_complete, &detail::IRendererControllerWrapper::default_on_frame_complete);
 
     bpy::class_<DefaultRendererController, boost::noncopyable>("DefaultRendererController");
 }
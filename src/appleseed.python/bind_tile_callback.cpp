@@ -104,6 +104,13 @@ namespace detail
                 PyErr_Print();
             }
         }
+
+        virtual void post_render(const Frame* frame, const TileCoordinateArray& tiles) OVERRIDE
+        {
+            // Python tile callbacks are notified of whole frame updates:
+            // forward to the single-argument overload implemented in Python.
+            post_render(frame);
+        }
     };
 }
 
@@ -112,5 +119,5 @@ void bind_tile_callback()
     bpy::class_<detail::ITileCallbackWrapper, boost::noncopyable>("ITileCallback")
         .def("pre_render", bpy::pure_virtual(&ITileCallback::pre_render))
         .def("post_render_tile", bpy::pure_virtual(&ITileCallback::post_render_tile))
-        .def("post_render", bpy::pure_virtual(&ITileCallback::post_render));
+        .def("post_render", bpy::pure_virtual(static_cast<void (ITileCallback::*)(const Frame*)>(&ITileCallback::post_render)));
 }
@@ -95,6 +95,15 @@ namespace
             m_render_widget->blit_frame(*frame);
         }
 
+        virtual void post_render(
+            const Frame*                frame,
+            const TileCoordinateArray&  tiles) OVERRIDE
+        {
+            assert(m_render_widget);
+
+            m_render_widget->blit_tiles(*frame, tiles);
+        }
+
       private:
         RenderWidget*       m_render_widget;
         const bool          m_highlight_tiles;
@@ -162,6 +162,10 @@ void RenderingManager::start_rendering(
     const bool                  interactive,
     RenderWidget*               render_widget)
 {
+    // Texture tiles are kept from one rendering to the next, unless the project changed.
+    if (project != m_project)
+        m_texture_store.clear();
+
     m_project = project;
     m_params = params;
     m_render_widget = render_widget;
@@ -196,7 +200,8 @@ void RenderingManager::start_rendering(
             m_params,
             &m_renderer_controller,
             m_tile_callback_factory.get(),
-            &m_abort_switch));
+            &m_abort_switch,
+            &m_texture_store));
 
     m_master_renderer_thread.reset(
         new MasterRendererThread(m_master_renderer.get()));
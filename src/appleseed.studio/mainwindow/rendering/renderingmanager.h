@@ -38,6 +38,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/api/rendering.h"
+#include "renderer/api/texture.h"
 #include "renderer/api/utility.h"
 
 // appleseed.foundation headers.
@@ -145,6 +146,7 @@ class RenderingManager
     std::auto_ptr<renderer::MasterRenderer>     m_master_renderer;
     std::auto_ptr<QThread>                      m_master_renderer_thread;
     foundation::AbortSwitch                     m_abort_switch;
+    renderer::TextureStore                      m_texture_store;
 
     RenderingTimer                              m_rendering_timer;
     QBasicTimer                                 m_render_widget_update_timer;
@@ -35,6 +35,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/api/frame.h"
+#include "renderer/api/rendering.h"
 
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
@@ -239,6 +240,18 @@ void RenderWidget::blit_frame(const Frame& frame)
     }
 }
 
+void RenderWidget::blit_tiles(
+    const Frame&                frame,
+    const TileCoordinateArray&  tiles)
+{
+    QMutexLocker locker(&m_mutex);
+
+    allocate_working_storage(frame.image().properties());
+
+    for (size_t i = 0; i < tiles.size(); ++i)
+        blit_tile_no_lock(frame, tiles[i].x, tiles[i].y);
+}
+
 namespace
 {
     bool is_compatible(const Tile& tile, const CanvasProperties& props)
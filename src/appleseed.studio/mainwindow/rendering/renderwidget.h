@@ -48,6 +48,7 @@
 namespace foundation    { class CanvasProperties; }
 namespace foundation    { class Tile; }
 namespace renderer      { class Frame; }
+namespace renderer      { class TileCoordinateArray; }
 class QPaintEvent;
 
 namespace appleseed {
@@ -98,6 +99,11 @@ class RenderWidget
     void blit_frame(
         const renderer::Frame&      frame);
 
+    // Thread-safe.
+    void blit_tiles(
+        const renderer::Frame&                  frame,
+        const renderer::TileCoordinateArray&    tiles);
+
   private:
     mutable QMutex  m_mutex;
     QImage          m_image;
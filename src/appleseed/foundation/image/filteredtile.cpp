@@ -34,9 +34,16 @@
 #include "foundation/image/pixel.h"
 #include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
+#ifdef APPLESEED_USE_SSE
+#include "foundation/platform/sse.h"
+#endif
+#include "foundation/platform/thread.h"
 
 // Standard headers.
+#include <cassert>
 #include <cmath>
+#include <map>
 
 using namespace std;
 
@@ -56,6 +63,88 @@ namespace foundation
 //   http://alvyray.com/Memos/CG/Microsoft/6_pixel.pdf
 //
 
+namespace
+{
+    //
+    // Tabulated filters shared by all the tiles using the same filter. A filter outlives
+    // the tiles using it, so its address identifies it while it has an entry here.
+    //
+
+    struct SharedTabulatedFilter
+    {
+        TabulatedFilter2<float>*    m_tabulated_filter;
+        size_t                      m_ref_count;
+    };
+
+    typedef map<const Filter2d*, SharedTabulatedFilter> SharedTabulatedFilterMap;
+
+    boost::mutex g_shared_tabulated_filters_mutex;
+    SharedTabulatedFilterMap g_shared_tabulated_filters;
+
+    const TabulatedFilter2<float>& acquire_tabulated_filter(const Filter2d& filter)
+    {
+        boost::mutex::scoped_lock lock(g_shared_tabulated_filters_mutex);
+
+        SharedTabulatedFilterMap::iterator i = g_shared_tabulated_filters.find(&filter);
+
+        if (i == g_shared_tabulated_filters.end())
+        {
+            SharedTabulatedFilter shared;
+            shared.m_tabulated_filter = new TabulatedFilter2<float>(filter);
+            shared.m_ref_count = 0;
+            i = g_shared_tabulated_filters.insert(make_pair(&filter, shared)).first;
+        }
+
+        ++i->second.m_ref_count;
+
+        return *i->second.m_tabulated_filter;
+    }
+
+    void release_tabulated_filter(const Filter2d& filter)
+    {
+        boost::mutex::scoped_lock lock(g_shared_tabulated_filters_mutex);
+
+        const SharedTabulatedFilterMap::iterator i = g_shared_tabulated_filters.find(&filter);
+        assert(i != g_shared_tabulated_filters.end());
+
+        if (--i->second.m_ref_count == 0)
+        {
+            delete i->second.m_tabulated_filter;
+            g_shared_tabulated_filters.erase(i);
+        }
+    }
+
+    size_t get_max_footprint_size(const double radius)
+    {
+        return truncate<size_t>(ceil(2.0 * radius)) + 1;
+    }
+
+    // Accumulate weighted values into a pixel: ptr[i] += values[i] * weight.
+    FORCE_INLINE void splat(
+        float* RESTRICT         ptr,
+        const float* RESTRICT   values,
+        const float             weight,
+        const size_t            count)
+    {
+        size_t i = 0;
+
+#ifdef APPLESEED_USE_SSE
+        // Pixels are not aligned: they begin with the weight channel.
+        const __m128 mweight = _mm_set1_ps(weight);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 mvalues = _mm_loadu_ps(values + i);
+            const __m128 mpixel = _mm_loadu_ps(ptr + i);
+            _mm_storeu_ps(ptr + i, _mm_add_ps(mpixel, _mm_mul_ps(mvalues, mweight)));
+        }
+#endif
+
+        for (; i < count; ++i)
+            ptr[i] += values[i] * weight;
+    }
+}
+
 FilteredTile::FilteredTile(
     const size_t        width,
     const size_t        height,
@@ -64,6 +153,10 @@ FilteredTile::FilteredTile(
   : Tile(width, height, channel_count + 1, PixelFormatFloat)
   , m_crop_window(Vector2u(0, 0), Vector2u(width - 1, height - 1))
   , m_filter(filter)
+  , m_tabulated_filter(acquire_tabulated_filter(filter))
+  , m_xweights(get_max_footprint_size(filter.get_xradius()))
+  , m_yweights(get_max_footprint_size(filter.get_yradius()))
+  , m_values(channel_count)
 {
 }
 
@@ -76,9 +169,29 @@ FilteredTile::FilteredTile(
   : Tile(width, height, channel_count + 1, PixelFormatFloat)
   , m_crop_window(crop_window)
   , m_filter(filter)
+  , m_tabulated_filter(acquire_tabulated_filter(filter))
+  , m_xweights(get_max_footprint_size(filter.get_xradius()))
+  , m_yweights(get_max_footprint_size(filter.get_yradius()))
+  , m_values(channel_count)
 {
 }
 
+FilteredTile::FilteredTile(const FilteredTile& rhs)
+  : Tile(rhs)
+  , m_crop_window(rhs.m_crop_window)
+  , m_filter(rhs.m_filter)
+  , m_tabulated_filter(acquire_tabulated_filter(rhs.m_filter))
+  , m_xweights(rhs.m_xweights)
+  , m_yweights(rhs.m_yweights)
+  , m_values(rhs.m_values)
+{
+}
+
+FilteredTile::~FilteredTile()
+{
+    release_tabulated_filter(m_filter);
+}
+
 void FilteredTile::clear()
 {
     float* ptr = reinterpret_cast<float*>(pixel(0));
@@ -106,20 +219,64 @@ void FilteredTile::add(
     // Don't affect pixels outside the crop window.
     footprint = AABB2i::intersect(footprint, m_crop_window);
 
-    for (int ry = footprint.min.y; ry <= footprint.max.y; ++ry)
+    if (!footprint.is_valid())
+        return;
+
+    // The filter is separable: fetch its horizontal and vertical factors once per column and row.
+    const size_t footprint_width = footprint.max.x - footprint.min.x + 1;
+    const size_t footprint_height = footprint.max.y - footprint.min.y + 1;
+    assert(footprint_width <= m_xweights.size());
+    assert(footprint_height <= m_yweights.size());
+
+    for (size_t i = 0; i < footprint_width; ++i)
     {
-        for (int rx = footprint.min.x; rx <= footprint.max.x; ++rx)
-        {
-            const float weight = static_cast<float>(m_filter.evaluate(rx - dx, ry - dy));
+        const int rx = footprint.min.x + static_cast<int>(i);
+        m_xweights[i] = m_tabulated_filter.evaluate_x(static_cast<float>(rx - dx));
+    }
 
-            float* RESTRICT ptr = reinterpret_cast<float*>(pixel(rx, ry));
+    for (size_t i = 0; i < footprint_height; ++i)
+    {
+        const int ry = footprint.min.y + static_cast<int>(i);
+        m_yweights[i] = m_tabulated_filter.evaluate_y(static_cast<float>(ry - dy));
+    }
+
+    const size_t value_count = m_channel_count - 1;
 
-            *ptr++ += weight;
+    for (size_t j = 0; j < footprint_height; ++j)
+    {
+        const float yweight = m_yweights[j];
+        float* RESTRICT ptr = pixel(footprint.min.x, footprint.min.y + j);
 
-            for (size_t i = 0; i < m_channel_count - 1; ++i)
-                ptr[i] += values[i] * weight;
+        for (size_t i = 0; i < footprint_width; ++i)
+        {
+            const float weight = m_xweights[i] * yweight;
+
+            *ptr += weight;
+            splat(ptr + 1, values, weight, value_count);
+
+            ptr += m_channel_count;
         }
     }
 }
 
+void FilteredTile::add(
+    const size_t        sample_count,
+    const float*        x,
+    const float*        y,
+    const float* const  values[],
+    const float         scale)
+{
+    const double width = static_cast<double>(m_width);
+    const double height = static_cast<double>(m_height);
+    const size_t value_count = m_channel_count - 1;
+
+    for (size_t i = 0; i < sample_count; ++i)
+    {
+        for (size_t c = 0; c < value_count; ++c)
+            m_values[c] = values[c][i] * scale;
+
+        add(x[i] * width, y[i] * height, &m_values[0]);
+    }
+}
+
 }   // namespace foundation
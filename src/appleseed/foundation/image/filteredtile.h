@@ -39,6 +39,7 @@
 // Standard headers.
 #include <cassert>
 #include <cstddef>
+#include <vector>
 
 namespace foundation
 {
@@ -46,6 +47,8 @@ namespace foundation
 //
 // A 2D tile that supports filtered accumulation of values.
 //
+// All tiles using the same filter share a single tabulated version of it.
+//
 
 class FilteredTile
   : public Tile
@@ -64,6 +67,10 @@ class FilteredTile
         const AABB2u&       crop_window,
         const Filter2d&     filter);
 
+    FilteredTile(const FilteredTile& rhs);
+
+    ~FilteredTile();
+
     // Tile properties.
     const AABB2u& get_crop_window() const;
     const Filter2d& get_filter() const;
@@ -124,9 +131,24 @@ class FilteredTile
         const double        y,
         const float*        values);
 
+    // Add samples stored as a structure of arrays. Sample i is located at the point
+    // (x[i] * width, y[i] * height) in continuous image space and its value in channel c
+    // is values[c][i] * scale.
+    void add(
+        const size_t        sample_count,
+        const float*        x,
+        const float*        y,
+        const float* const  values[],
+        const float         scale = 1.0f);
+
   protected:
     const AABB2u            m_crop_window;
     const Filter2d&         m_filter;
+    const TabulatedFilter2<float>&
+                            m_tabulated_filter;
+    std::vector<float>      m_xweights;
+    std::vector<float>      m_yweights;
+    std::vector<float>      m_values;
 };
 
 
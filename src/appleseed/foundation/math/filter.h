@@ -38,8 +38,10 @@
 #include "foundation/platform/compiler.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <vector>
 
 namespace foundation
 {
@@ -211,6 +213,52 @@ class BlackmanHarrisFilter2
 };
 
 
+//
+// Tabulated version of a 2D filter.
+//
+// All the filters above are separable, i.e. f(x, y) = fx(x) * fy(y). A tabulated filter
+// samples fx and fy once at construction and replaces every subsequent evaluation by a
+// pair of non-virtual table lookups, interpolating linearly between table entries.
+// Callers splatting a sample over a footprint of pixels should fetch the horizontal and
+// vertical factors separately, and multiply them.
+//
+// Building the tables costs 2 * TableSize virtual evaluations: a tabulated filter should
+// be built once per filter and shared by all its users.
+//
+
+template <typename T>
+class TabulatedFilter2
+{
+  public:
+    typedef T ValueType;
+
+    // Number of table entries per axis.
+    static const size_t TableSize = 1024;
+
+    template <typename U>
+    explicit TabulatedFilter2(const Filter2<U>& filter);
+
+    T get_xradius() const;
+    T get_yradius() const;
+
+    // Evaluate the horizontal and vertical factors of the filter.
+    T evaluate_x(const T x) const;
+    T evaluate_y(const T y) const;
+
+    T evaluate(const T x, const T y) const;
+
+  private:
+    const T         m_xradius;
+    const T         m_yradius;
+    const T         m_xscale;
+    const T         m_yscale;
+    std::vector<T>  m_xtable;
+    std::vector<T>  m_ytable;
+
+    static T lookup(const std::vector<T>& table, const T x, const T radius, const T scale);
+};
+
+
 //
 // Utilities.
 //
@@ -457,6 +505,78 @@ FORCE_INLINE T BlackmanHarrisFilter2<T>::blackman(const T x)
 }
 
 
+//
+// TabulatedFilter2 class implementation.
+//
+
+template <typename T>
+template <typename U>
+TabulatedFilter2<T>::TabulatedFilter2(const Filter2<U>& filter)
+  : m_xradius(static_cast<T>(filter.get_xradius()))
+  , m_yradius(static_cast<T>(filter.get_yradius()))
+  , m_xscale(static_cast<T>((TableSize - 1) / (U(2.0) * filter.get_xradius())))
+  , m_yscale(static_cast<T>((TableSize - 1) / (U(2.0) * filter.get_yradius())))
+  , m_xtable(TableSize)
+  , m_ytable(TableSize)
+{
+    // f(x, 0) * f(0, y) = fx(x) * fy(y) * f(0, 0), hence the division of the vertical factor.
+    const U center = filter.evaluate(U(0.0), U(0.0));
+    const U rcp_center = center == U(0.0) ? U(0.0) : U(1.0) / center;
+
+    for (size_t i = 0; i < TableSize; ++i)
+    {
+        const U t = static_cast<U>(i) / (TableSize - 1);
+        const U x = filter.get_xradius() * (U(2.0) * t - U(1.0));
+        const U y = filter.get_yradius() * (U(2.0) * t - U(1.0));
+        m_xtable[i] = static_cast<T>(filter.evaluate(x, U(0.0)));
+        m_ytable[i] = static_cast<T>(filter.evaluate(U(0.0), y) * rcp_center);
+    }
+}
+
+template <typename T>
+inline T TabulatedFilter2<T>::get_xradius() const
+{
+    return m_xradius;
+}
+
+template <typename T>
+inline T TabulatedFilter2<T>::get_yradius() const
+{
+    return m_yradius;
+}
+
+template <typename T>
+inline T TabulatedFilter2<T>::evaluate_x(const T x) const
+{
+    return lookup(m_xtable, x, m_xradius, m_xscale);
+}
+
+template <typename T>
+inline T TabulatedFilter2<T>::evaluate_y(const T y) const
+{
+    return lookup(m_ytable, y, m_yradius, m_yscale);
+}
+
+template <typename T>
+inline T TabulatedFilter2<T>::evaluate(const T x, const T y) const
+{
+    return evaluate_x(x) * evaluate_y(y);
+}
+
+template <typename T>
+FORCE_INLINE T TabulatedFilter2<T>::lookup(
+    const std::vector<T>&   table,
+    const T                 x,
+    const T                 radius,
+    const T                 scale)
+{
+    const T u = clamp((x + radius) * scale, T(0.0), T(TableSize - 1));
+    const size_t i = std::min(truncate<size_t>(u), TableSize - 2);
+    const T t = u - static_cast<T>(i);
+    return table[i] + (table[i + 1] - table[i]) * t;
+}
+
+
 //
 // Utilities implementation.
 //
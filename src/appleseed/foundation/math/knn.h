@@ -33,6 +33,9 @@
 // Interface headers.
 #include "foundation/math/knn/knn_answer.h"
 #include "foundation/math/knn/knn_builder.h"
+#include "foundation/math/knn/knn_grid.h"
+#include "foundation/math/knn/knn_grid_builder.h"
+#include "foundation/math/knn/knn_grid_query.h"
 #include "foundation/math/knn/knn_query.h"
 #include "foundation/math/knn/knn_statistics.h"
 #include "foundation/math/knn/knn_tree.h"
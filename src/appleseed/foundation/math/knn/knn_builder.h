@@ -38,6 +38,7 @@
 #include "foundation/math/permutation.h"
 #include "foundation/math/split.h"
 #include "foundation/math/vector.h"
+#include "foundation/utility/job.h"
 #include "foundation/utility/stopwatch.h"
 
 // Standard headers.
@@ -75,6 +76,14 @@ class Builder
     void build_move_points(
         std::vector<VectorType>&    points);
 
+    // Like build_move_points() but the lower levels of the tree are built in parallel
+    // by jobs scheduled on a given job queue. The resulting tree is identical to the
+    // one produced by the serial builder, only the order of the nodes differs.
+    template <typename Timer>
+    void build_move_points(
+        std::vector<VectorType>&    points,
+        JobQueue&                   job_queue);
+
     // Return the construction time.
     double get_build_time() const;
 
@@ -98,12 +107,63 @@ class Builder
             const size_t            index) const;
     };
 
+    typedef std::vector<NodeType> NodeVector;
+
+    // A subtree built independently of the rest of the tree.
+    struct Subtree
+    {
+        size_t                      m_node_index;       // index of the subtree root in the tree
+        size_t                      m_begin;
+        size_t                      m_end;
+        NodeVector                  m_nodes;
+
+        Subtree(
+            const size_t            node_index,
+            const size_t            begin,
+            const size_t            end);
+    };
+
+    class BuildSubtreeJob;
+
     TreeType&   m_tree;
     double      m_build_time;
 
+    // Number of subtrees built in parallel (should be a power of two).
+    static const size_t ParallelSubtreeCount = 64;
+
+    // Minimum number of points required to build the tree in parallel.
+    static const size_t MinParallelPointCount = 4096;
+
+    void build_serial(const size_t count);
+
+    void build_parallel(
+        const size_t                count,
+        JobQueue&                   job_queue);
+
     void partition(
+        NodeVector&                 nodes,
+        const size_t                parent_node_index,
+        const size_t                begin,
+        const size_t                end) const;
+
+    void partition_top_levels(
         const size_t                parent_node_index,
         const size_t                begin,
+        const size_t                end,
+        const size_t                subtree_count,
+        std::vector<Subtree>&       subtrees) const;
+
+    void make_leaf_node(
+        NodeVector&                 nodes,
+        const size_t                node_index,
+        const size_t                begin,
+        const size_t                end) const;
+
+    // Split the points in [begin, end), turn a node into an interior node and return the pivot.
+    size_t make_interior_node(
+        NodeVector&                 nodes,
+        const size_t                node_index,
+        const size_t                begin,
         const size_t                end) const;
 
     BboxType compute_bbox(
@@ -156,19 +216,103 @@ void Builder<T, N>::build_move_points(
     const size_t count = points.size();
 
     if (count > 0)
-    {
         m_tree.m_points.swap(points);
 
-        m_tree.m_indices.resize(count);
+    build_serial(count);
 
-        for (size_t i = 0; i < count; ++i)
-            m_tree.m_indices[i] = i;
+    stopwatch.measure();
+    m_build_time = stopwatch.get_seconds();
+}
+
+template <typename T, size_t N>
+template <typename Timer>
+void Builder<T, N>::build_move_points(
+    std::vector<VectorType>&    points,
+    JobQueue&                   job_queue)
+{
+    Stopwatch<Timer> stopwatch;
+    stopwatch.start();
+
+    const size_t count = points.size();
+
+    if (count > 0)
+        m_tree.m_points.swap(points);
+
+    if (count < MinParallelPointCount)
+        build_serial(count);
+    else build_parallel(count, job_queue);
+
+    stopwatch.measure();
+    m_build_time = stopwatch.get_seconds();
+}
+
+template <typename T, size_t N>
+inline double Builder<T, N>::get_build_time() const
+{
+    return m_build_time;
+}
+
+template <typename T, size_t N>
+inline Builder<T, N>::Subtree::Subtree(
+    const size_t                node_index,
+    const size_t                begin,
+    const size_t                end)
+  : m_node_index(node_index)
+  , m_begin(begin)
+  , m_end(end)
+{
+}
+
+template <typename T, size_t N>
+class Builder<T, N>::BuildSubtreeJob
+  : public IJob
+{
+  public:
+    BuildSubtreeJob(
+        const Builder&          builder,
+        Subtree&                subtree,
+        VectorType              sorted_points[])
+      : m_builder(builder)
+      , m_subtree(subtree)
+      , m_sorted_points(sorted_points)
+    {
     }
 
+    virtual void execute(const size_t thread_index) OVERRIDE
+    {
+        const size_t begin = m_subtree.m_begin;
+        const size_t end = m_subtree.m_end;
+
+        // Build the subtree into its own set of nodes, its root being the first node.
+        m_subtree.m_nodes.reserve((end - begin) * 2 + 1);
+        m_subtree.m_nodes.push_back(NodeType());
+        m_builder.partition(m_subtree.m_nodes, 0, begin, end);
+
+        // Reorder the points of this subtree.
+        const VectorType* points = &m_builder.m_tree.m_points[0];
+        const size_t* indices = &m_builder.m_tree.m_indices[0];
+        for (size_t i = begin; i < end; ++i)
+            m_sorted_points[i] = points[indices[i]];
+    }
+
+  private:
+    const Builder&              m_builder;
+    Subtree&                    m_subtree;
+    VectorType*                 m_sorted_points;
+};
+
+template <typename T, size_t N>
+void Builder<T, N>::build_serial(const size_t count)
+{
+    m_tree.m_indices.resize(count);
+
+    for (size_t i = 0; i < count; ++i)
+        m_tree.m_indices[i] = i;
+
     m_tree.m_nodes.reserve(count * 2 + 1);
     m_tree.m_nodes.push_back(NodeType());
 
-    partition(0, 0, count);
+    partition(m_tree.m_nodes, 0, 0, count);
 
     if (count > 0)
     {
@@ -180,15 +324,59 @@ void Builder<T, N>::build_move_points(
             &m_tree.m_indices[0],
             count);
     }
-
-    stopwatch.measure();
-    m_build_time = stopwatch.get_seconds();
 }
 
 template <typename T, size_t N>
-inline double Builder<T, N>::get_build_time() const
+void Builder<T, N>::build_parallel(
+    const size_t                count,
+    JobQueue&                   job_queue)
 {
-    return m_build_time;
+    assert(count > 0);
+
+    m_tree.m_indices.resize(count);
+
+    for (size_t i = 0; i < count; ++i)
+        m_tree.m_indices[i] = i;
+
+    m_tree.m_nodes.reserve(count * 2 + 1);
+    m_tree.m_nodes.push_back(NodeType());
+
+    // Build the top levels of the tree serially.
+    std::vector<Subtree> subtrees;
+    subtrees.reserve(ParallelSubtreeCount);
+    partition_top_levels(0, 0, count, ParallelSubtreeCount, subtrees);
+
+    // Build the subtrees and reorder their points in parallel. Only wait for our own
+    // jobs: the job queue may be shared with other work.
+    std::vector<VectorType> sorted_points(count);
+    JobCounter job_counter;
+    for (size_t i = 0; i < subtrees.size(); ++i)
+        job_counter.schedule(job_queue, new BuildSubtreeJob(*this, subtrees[i], &sorted_points[0]));
+    job_counter.wait_until_completion();
+
+    m_tree.m_points.swap(sorted_points);
+
+    // Graft the subtrees onto the top levels of the tree.
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+        const NodeVector& subtree_nodes = subtrees[i].m_nodes;
+        const size_t subtree_node_count = subtree_nodes.size();
+
+        // Subtree node j > 0 will be stored at index offset + j in the tree.
+        const size_t offset = m_tree.m_nodes.size() - 1;
+
+        for (size_t j = 0; j < subtree_node_count; ++j)
+        {
+            NodeType node = subtree_nodes[j];
+
+            if (node.is_interior())
+                node.set_child_node_index(node.get_child_node_index() + offset);
+
+            if (j == 0)
+                m_tree.m_nodes[subtrees[i].m_node_index] = node;
+            else m_tree.m_nodes.push_back(node);
+        }
+    }
 }
 
 template <typename T, size_t N>
@@ -209,59 +397,100 @@ inline bool Builder<T, N>::PartitionPredicate::operator()(
 
 template <typename T, size_t N>
 void Builder<T, N>::partition(
+    NodeVector&                 nodes,
     const size_t                parent_node_index,
     const size_t                begin,
     const size_t                end) const
 {
-    const size_t count = end - begin;
-
-    if (count <= 1)
+    if (end - begin <= 1)
+        make_leaf_node(nodes, parent_node_index, begin, end);
+    else
     {
-        NodeType& parent_node = m_tree.m_nodes[parent_node_index];
-        parent_node.make_leaf();
-        parent_node.set_point_index(begin);
-        parent_node.set_point_count(count);
+        const size_t pivot = make_interior_node(nodes, parent_node_index, begin, end);
+        const size_t left_node_index = nodes[parent_node_index].get_child_node_index();
+
+        partition(nodes, left_node_index, begin, pivot);
+        partition(nodes, left_node_index + 1, pivot, end);
     }
+}
+
+template <typename T, size_t N>
+void Builder<T, N>::partition_top_levels(
+    const size_t                parent_node_index,
+    const size_t                begin,
+    const size_t                end,
+    const size_t                subtree_count,
+    std::vector<Subtree>&       subtrees) const
+{
+    if (subtree_count <= 1 || end - begin <= 1)
+        subtrees.push_back(Subtree(parent_node_index, begin, end));
     else
     {
-        const BboxType bbox = compute_bbox(begin, end);
-        SplitType split = SplitType::middle(bbox);
+        const size_t pivot = make_interior_node(m_tree.m_nodes, parent_node_index, begin, end);
+        const size_t left_node_index = m_tree.m_nodes[parent_node_index].get_child_node_index();
 
-        const size_t* bound =
-            std::partition(
-                &m_tree.m_indices[0] + begin,
-                &m_tree.m_indices[0] + end,
-                PartitionPredicate(m_tree.m_points, split));
+        partition_top_levels(left_node_index, begin, pivot, subtree_count / 2, subtrees);
+        partition_top_levels(left_node_index + 1, pivot, end, subtree_count / 2, subtrees);
+    }
+}
 
-        size_t pivot = bound - &m_tree.m_indices[0];
-        assert(pivot >= begin);
-        assert(pivot <= end);
+template <typename T, size_t N>
+inline void Builder<T, N>::make_leaf_node(
+    NodeVector&                 nodes,
+    const size_t                node_index,
+    const size_t                begin,
+    const size_t                end) const
+{
+    NodeType& node = nodes[node_index];
+    node.make_leaf();
+    node.set_point_index(begin);
+    node.set_point_count(end - begin);
+}
 
-        // Switch to median split if one of the two leaf is empty.
-        if (pivot == begin || pivot == end)
-        {
-            pivot = (begin + end) / 2;
-            const VectorType& median_point = m_tree.m_points[m_tree.m_indices[pivot]];
-            split.m_abscissa = median_point[split.m_dimension];
-        }
+template <typename T, size_t N>
+size_t Builder<T, N>::make_interior_node(
+    NodeVector&                 nodes,
+    const size_t                node_index,
+    const size_t                begin,
+    const size_t                end) const
+{
+    assert(end - begin > 1);
 
-        const size_t left_node_index = m_tree.m_nodes.size();
-        const size_t right_node_index = left_node_index + 1;
+    const BboxType bbox = compute_bbox(begin, end);
+    SplitType split = SplitType::middle(bbox);
 
-        m_tree.m_nodes.push_back(NodeType());
-        m_tree.m_nodes.push_back(NodeType());
+    const size_t* bound =
+        std::partition(
+            &m_tree.m_indices[0] + begin,
+            &m_tree.m_indices[0] + end,
+            PartitionPredicate(m_tree.m_points, split));
 
-        NodeType& parent_node = m_tree.m_nodes[parent_node_index];
-        parent_node.make_interior();
-        parent_node.set_split_dim(split.m_dimension);
-        parent_node.set_split_abs(split.m_abscissa);
-        parent_node.set_child_node_index(left_node_index);
-        parent_node.set_point_index(begin);
-        parent_node.set_point_count(count);
+    size_t pivot = bound - &m_tree.m_indices[0];
+    assert(pivot >= begin);
+    assert(pivot <= end);
 
-        partition(left_node_index, begin, pivot);
-        partition(right_node_index, pivot, end);
+    // Switch to median split if one of the two leaf is empty.
+    if (pivot == begin || pivot == end)
+    {
+        pivot = (begin + end) / 2;
+        const VectorType& median_point = m_tree.m_points[m_tree.m_indices[pivot]];
+        split.m_abscissa = median_point[split.m_dimension];
     }
+
+    const size_t left_node_index = nodes.size();
+
+    nodes.push_back(NodeType());
+    nodes.push_back(NodeType());
+
+    NodeType& node = nodes[node_index];
+    node.make_interior();
+    node.set_split_dim(split.m_dimension);
+    node.set_split_abs(split.m_abscissa);
+    node.set_child_node_index(left_node_index);
+    node.set_point_index(begin);
+    node.set_point_count(end - begin);
+
+    return pivot;
 }
 
 template <typename T, size_t N>
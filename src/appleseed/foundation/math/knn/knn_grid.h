@@ -0,0 +1,194 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_KNN_KNN_GRID_H
+#define APPLESEED_FOUNDATION_MATH_KNN_KNN_GRID_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace foundation {
+namespace knn {
+
+//
+// A hashed uniform grid.
+//
+// This is an alternative to k-d trees when all queries use the same, known in
+// advance, maximum search distance: with a cell size of twice that distance, a
+// query only needs to visit 2^N cells. Cells are stored in a hash table so that
+// memory usage only depends on the number of points, not on their extent.
+//
+// Like k-d trees, grids store a reordered copy of the points and use internal
+// indices that must be remapped to user-data indices with remap().
+//
+
+template <typename T, size_t N>
+class Grid
+  : public NonCopyable
+{
+  public:
+    typedef T ValueType;
+    static const size_t Dimension = N;
+
+    typedef Vector<T, N> VectorType;
+    typedef Vector<int32, N> CellType;
+
+    // Constructor.
+    Grid();
+
+    // Return true if the grid does not contain any point.
+    bool empty() const;
+
+    // Transform an internal index to a user-data index.
+    size_t remap(const size_t i) const;
+
+    // Return the i'th point, where i is an internal index.
+    const VectorType& get_point(const size_t i) const;
+
+    // Return the size of a cell along each dimension.
+    ValueType get_cell_size() const;
+
+    // Return the number of buckets of the hash table.
+    size_t get_bucket_count() const;
+
+    // Return the size (in bytes) of this object in memory.
+    size_t get_memory_size() const;
+
+  private:
+    template <typename, size_t> friend class GridBuilder;
+    template <typename, size_t> friend class GridQuery;
+
+    ValueType               m_cell_size;
+    ValueType               m_rcp_cell_size;
+    size_t                  m_bucket_mask;
+    std::vector<VectorType> m_points;           // points sorted by bucket
+    std::vector<size_t>     m_indices;
+    std::vector<uint32>     m_bucket_offsets;   // bucket i holds points [m_bucket_offsets[i], m_bucket_offsets[i + 1])
+
+    CellType compute_cell(const VectorType& point) const;
+
+    size_t compute_bucket(const CellType& cell) const;
+};
+
+typedef Grid<float, 2>  Grid2f;
+typedef Grid<double, 2> Grid2d;
+typedef Grid<float, 3>  Grid3f;
+typedef Grid<double, 3> Grid3d;
+
+
+//
+// Implementation.
+//
+
+template <typename T, size_t N>
+inline Grid<T, N>::Grid()
+  : m_cell_size(T(0.0))
+  , m_rcp_cell_size(T(0.0))
+  , m_bucket_mask(0)
+{
+}
+
+template <typename T, size_t N>
+inline bool Grid<T, N>::empty() const
+{
+    return m_points.empty();
+}
+
+template <typename T, size_t N>
+inline size_t Grid<T, N>::remap(const size_t i) const
+{
+    assert(i < m_indices.size());
+    return m_indices[i];
+}
+
+template <typename T, size_t N>
+inline const Vector<T, N>& Grid<T, N>::get_point(const size_t i) const
+{
+    assert(i < m_points.size());
+    return m_points[i];
+}
+
+template <typename T, size_t N>
+inline T Grid<T, N>::get_cell_size() const
+{
+    return m_cell_size;
+}
+
+template <typename T, size_t N>
+inline size_t Grid<T, N>::get_bucket_count() const
+{
+    return m_bucket_offsets.empty() ? 0 : m_bucket_offsets.size() - 1;
+}
+
+template <typename T, size_t N>
+inline size_t Grid<T, N>::get_memory_size() const
+{
+    size_t mem_size = sizeof(*this);
+    mem_size += m_points.capacity() * sizeof(VectorType);
+    mem_size += m_indices.capacity() * sizeof(size_t);
+    mem_size += m_bucket_offsets.capacity() * sizeof(uint32);
+    return mem_size;
+}
+
+template <typename T, size_t N>
+inline Vector<int32, N> Grid<T, N>::compute_cell(const VectorType& point) const
+{
+    CellType cell;
+
+    for (size_t i = 0; i < N; ++i)
+        cell[i] = static_cast<int32>(std::floor(point[i] * m_rcp_cell_size));
+
+    return cell;
+}
+
+template <typename T, size_t N>
+inline size_t Grid<T, N>::compute_bucket(const CellType& cell) const
+{
+    // Large primes from "Optimized Spatial Hashing for Collision Detection of Deformable Objects".
+    static const uint32 Primes[] = { 73856093, 19349663, 83492791, 49979687 };
+
+    uint32 h = 0;
+
+    for (size_t i = 0; i < N; ++i)
+        h ^= static_cast<uint32>(cell[i]) * Primes[i % 4];
+
+    return static_cast<size_t>(h) & m_bucket_mask;
+}
+
+}       // namespace knn
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_KNN_KNN_GRID_H
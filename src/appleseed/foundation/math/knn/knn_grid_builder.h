@@ -0,0 +1,186 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_KNN_KNN_GRID_BUILDER_H
+#define APPLESEED_FOUNDATION_MATH_KNN_KNN_GRID_BUILDER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/knn/knn_grid.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/stopwatch.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace foundation {
+namespace knn {
+
+template <typename T, size_t N>
+class GridBuilder
+  : public NonCopyable
+{
+  public:
+    typedef T ValueType;
+    static const size_t Dimension = N;
+
+    typedef Vector<T, N> VectorType;
+    typedef Grid<T, N> GridType;
+
+    // Constructor.
+    explicit GridBuilder(GridType& grid);
+
+    // Build a grid with a given cell size for a given set of points.
+    template <typename Timer>
+    void build(
+        const VectorType            points[],
+        const size_t                count,
+        const ValueType             cell_size);
+
+    // Like build() but the points will be moved into the grid rather than copied.
+    template <typename Timer>
+    void build_move_points(
+        std::vector<VectorType>&    points,
+        const ValueType             cell_size);
+
+    // Return the construction time.
+    double get_build_time() const;
+
+  private:
+    GridType&   m_grid;
+    double      m_build_time;
+};
+
+typedef GridBuilder<float, 2>  GridBuilder2f;
+typedef GridBuilder<double, 2> GridBuilder2d;
+typedef GridBuilder<float, 3>  GridBuilder3f;
+typedef GridBuilder<double, 3> GridBuilder3d;
+
+
+//
+// Implementation.
+//
+
+template <typename T, size_t N>
+inline GridBuilder<T, N>::GridBuilder(GridType& grid)
+  : m_grid(grid)
+  , m_build_time(0.0)
+{
+}
+
+template <typename T, size_t N>
+template <typename Timer>
+void GridBuilder<T, N>::build(
+    const VectorType            points[],
+    const size_t                count,
+    const ValueType             cell_size)
+{
+    std::vector<VectorType> vec(count);
+
+    if (count > 0)
+    {
+        assert(points);
+        std::memcpy(&vec[0], points, count * sizeof(VectorType));
+    }
+
+    build_move_points<Timer>(vec, cell_size);
+}
+
+template <typename T, size_t N>
+template <typename Timer>
+void GridBuilder<T, N>::build_move_points(
+    std::vector<VectorType>&    points,
+    const ValueType             cell_size)
+{
+    assert(cell_size > T(0.0));
+
+    Stopwatch<Timer> stopwatch;
+    stopwatch.start();
+
+    const size_t count = points.size();
+    assert(count < 0xFFFFFFFFUL);
+
+    // Use about one bucket per point.
+    const size_t bucket_count = next_pow2<size_t>(std::max<size_t>(count, 1));
+
+    m_grid.m_cell_size = cell_size;
+    m_grid.m_rcp_cell_size = T(1.0) / cell_size;
+    m_grid.m_bucket_mask = bucket_count - 1;
+
+    // Count the points in each bucket.
+    std::vector<uint32> point_buckets(count);
+    std::vector<uint32> bucket_offsets(bucket_count + 1, 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t bucket = m_grid.compute_bucket(m_grid.compute_cell(points[i]));
+        point_buckets[i] = static_cast<uint32>(bucket);
+        ++bucket_offsets[bucket];
+    }
+
+    // Compute the end of each bucket.
+    for (size_t i = 1; i < bucket_count; ++i)
+        bucket_offsets[i] += bucket_offsets[i - 1];
+    bucket_offsets[bucket_count] = static_cast<uint32>(count);
+
+    // Sort the points by bucket; the offsets end up pointing to the beginning of each bucket.
+    std::vector<VectorType> sorted_points(count);
+    std::vector<size_t> indices(count);
+    for (size_t i = count; i > 0; --i)
+    {
+        const uint32 j = --bucket_offsets[point_buckets[i - 1]];
+        sorted_points[j] = points[i - 1];
+        indices[j] = i - 1;
+    }
+
+    m_grid.m_points.swap(sorted_points);
+    m_grid.m_indices.swap(indices);
+    m_grid.m_bucket_offsets.swap(bucket_offsets);
+
+    // Honor the move semantics.
+    std::vector<VectorType>().swap(points);
+
+    stopwatch.measure();
+    m_build_time = stopwatch.get_seconds();
+}
+
+template <typename T, size_t N>
+inline double GridBuilder<T, N>::get_build_time() const
+{
+    return m_build_time;
+}
+
+}       // namespace knn
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_KNN_KNN_GRID_BUILDER_H
@@ -0,0 +1,177 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_KNN_KNN_GRID_QUERY_H
+#define APPLESEED_FOUNDATION_MATH_KNN_KNN_GRID_QUERY_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/knn/knn_answer.h"
+#include "foundation/math/knn/knn_grid.h"
+#include "foundation/math/distance.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
+
+// Standard headers.
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+namespace foundation {
+namespace knn {
+
+template <typename T, size_t N>
+class GridQuery
+  : public NonCopyable
+{
+  public:
+    typedef T ValueType;
+    static const size_t Dimension = N;
+
+    typedef Vector<T, N> VectorType;
+    typedef Grid<T, N> GridType;
+    typedef Answer<T> AnswerType;
+
+    GridQuery(
+        const GridType&     grid,
+        AnswerType&         answer);
+
+    // Unlike k-d tree queries, grid queries require a maximum search distance.
+    // Queries are fastest when this distance is at most half the cell size.
+    void run(
+        const VectorType&   query_point,
+        const ValueType     query_max_square_distance) const;
+
+  private:
+    typedef typename GridType::CellType CellType;
+
+    const GridType&         m_grid;
+    AnswerType&             m_answer;
+
+    void visit_cell(
+        const CellType&     cell,
+        const VectorType&   query_point,
+        const ValueType     query_max_square_distance) const;
+};
+
+typedef GridQuery<float, 2>  GridQuery2f;
+typedef GridQuery<double, 2> GridQuery2d;
+typedef GridQuery<float, 3>  GridQuery3f;
+typedef GridQuery<double, 3> GridQuery3d;
+
+
+//
+// Implementation.
+//
+
+template <typename T, size_t N>
+inline GridQuery<T, N>::GridQuery(
+    const GridType&         grid,
+    AnswerType&             answer)
+  : m_grid(grid)
+  , m_answer(answer)
+{
+}
+
+template <typename T, size_t N>
+inline void GridQuery<T, N>::run(
+    const VectorType&       query_point,
+    const ValueType         query_max_square_distance) const
+{
+    assert(!m_grid.empty());
+    assert(query_max_square_distance >= T(0.0));
+
+    m_answer.clear();
+
+    // Compute the range of cells overlapping the bounding box of the search sphere.
+    const ValueType query_max_distance = std::sqrt(query_max_square_distance);
+    const CellType min_cell = m_grid.compute_cell(query_point - VectorType(query_max_distance));
+    const CellType max_cell = m_grid.compute_cell(query_point + VectorType(query_max_distance));
+
+    // Visit all these cells.
+    CellType cell = min_cell;
+    while (true)
+    {
+        visit_cell(cell, query_point, query_max_square_distance);
+
+        size_t d = 0;
+        while (d < N && cell[d] == max_cell[d])
+        {
+            cell[d] = min_cell[d];
+            ++d;
+        }
+
+        if (d == N)
+            break;
+
+        ++cell[d];
+    }
+}
+
+template <typename T, size_t N>
+inline void GridQuery<T, N>::visit_cell(
+    const CellType&         cell,
+    const VectorType&       query_point,
+    const ValueType         query_max_square_distance) const
+{
+    const size_t bucket = m_grid.compute_bucket(cell);
+    const size_t begin = m_grid.m_bucket_offsets[bucket];
+    const size_t end = m_grid.m_bucket_offsets[bucket + 1];
+
+    const VectorType* RESTRICT points = &m_grid.m_points.front();
+    const size_t max_answer_size = m_answer.m_max_size;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        const ValueType square_dist = square_distance(points[i], query_point);
+
+        if (square_dist > query_max_square_distance)
+            continue;
+
+        // Other cells may share this bucket; only consider the points of this cell
+        // so that points are not found twice when several of these cells are visited.
+        if (m_grid.compute_cell(points[i]) != cell)
+            continue;
+
+        if (m_answer.m_size < max_answer_size)
+        {
+            m_answer.array_insert(i, square_dist);
+
+            // The answer is full, so we transform it into a heap.
+            if (m_answer.m_size == max_answer_size)
+                m_answer.make_heap();
+        }
+        else if (square_dist < m_answer.top().m_square_dist)
+            m_answer.heap_insert(i, square_dist);
+    }
+}
+
+}       // namespace knn
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_KNN_KNN_GRID_QUERY_H
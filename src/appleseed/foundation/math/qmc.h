@@ -31,6 +31,7 @@
 #define APPLESEED_FOUNDATION_MATH_QMC_H
 
 // appleseed.foundation headers.
+#include "foundation/math/hash.h"
 #include "foundation/math/vector.h"
 #include "foundation/platform/types.h"
 
@@ -38,8 +39,10 @@
 #include "boost/static_assert.hpp"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <limits>
 
 namespace foundation
 {
@@ -55,7 +58,6 @@ namespace foundation
 //   implement specializations of Halton and Hammersley sequences generators for bases (2,3).
 //   implement incremental radical inverse (for successive input values).
 //   implement vectorized radical inverse functions with SSE2.
-//   implement Sobol sequence generator.
 //
 
 
@@ -198,6 +200,40 @@ Vector<T, Dim> hammersley_zaremba_sequence(
     const size_t        count);         // total number of samples in sequence
 
 
+//
+// Sobol (0,2)-sequence with hash-based Owen scrambling.
+//
+// The first two dimensions of the Sobol sequence form a (0,2)-sequence in base 2.
+// Points are scrambled with a hash-based approximation of nested uniform (Owen)
+// scrambling, and their order is shuffled by scrambling the point index the same
+// way. Sequences generated with distinct seeds are statistically independent,
+// which allows padding: higher dimensions are obtained by drawing successive
+// pairs of dimensions with different seeds.
+//
+// Reference:
+//
+//   Brent Burley, Practical Hash-based Owen Scrambling
+//   http://jcgt.org/published/0009/04/01/
+//
+
+// Reverse the order of the bits of a 32-bit integer.
+uint32 reverse_bits(uint32 x);
+
+// Return the input'th point of the first or second dimension of the Sobol
+// sequence, as a 32-bit fixed-point number in [0, 2^32).
+uint32 sobol_dimension0(const uint32 input);
+uint32 sobol_dimension1(uint32 input);
+
+// Owen-scramble a 32-bit fixed-point number in [0, 2^32).
+uint32 owen_scramble(uint32 x, const uint32 seed);
+
+// Return the input'th point of an Owen-scrambled and shuffled Sobol (0,2)-sequence.
+// The return value is in the interval [0, 1)^2.
+template <typename T>
+Vector<T, 2> sobol_02_sequence(
+    const uint32        seed,           // scrambling seed
+    const uint32        input);         // point index
+
 
 //
 // Base-2 radical inverse functions implementation.
@@ -2560,6 +2596,75 @@ inline Vector<T, Dim> hammersley_zaremba_sequence(
     return p;
 }
 
+
+
+//
+// Sobol (0,2)-sequence implementation.
+//
+
+inline uint32 reverse_bits(uint32 x)
+{
+    x = (x >> 16) | (x << 16);                                  // 16-bit swap
+    x = ((x & 0xFF00FF00UL) >> 8) | ((x & 0x00FF00FFUL) << 8);  // 8-bit swap
+    x = ((x & 0xF0F0F0F0UL) >> 4) | ((x & 0x0F0F0F0FUL) << 4);  // 4-bit swap
+    x = ((x & 0xCCCCCCCCUL) >> 2) | ((x & 0x33333333UL) << 2);  // 2-bit swap
+    x = ((x & 0xAAAAAAAAUL) >> 1) | ((x & 0x55555555UL) << 1);  // 1-bit swap
+    return x;
+}
+
+inline uint32 sobol_dimension0(const uint32 input)
+{
+    // The generator matrix of the first dimension is the identity: this is the van der Corput sequence.
+    return reverse_bits(input);
+}
+
+inline uint32 sobol_dimension1(uint32 input)
+{
+    // The direction numbers of the second dimension follow v[i+1] = v[i] ^ (v[i] >> 1).
+    uint32 result = 0;
+
+    for (uint32 v = 1UL << 31; input != 0; input >>= 1, v ^= v >> 1)
+    {
+        if (input & 1)
+            result ^= v;
+    }
+
+    return result;
+}
+
+inline uint32 owen_scramble(uint32 x, const uint32 seed)
+{
+    // Laine-Karras style hash, which only propagates bits upward; applied to
+    // the reversed bits, each output bit only depends on higher input bits.
+    x = reverse_bits(x);
+    x += seed;
+    x ^= x * 0x6C50B47CUL;
+    x ^= x * 0xB82F1E52UL;
+    x ^= x * 0xC7AFE638UL;
+    x ^= x * 0x8D22F6E6UL;
+    return reverse_bits(x);
+}
+
+template <typename T>
+inline Vector<T, 2> sobol_02_sequence(
+    const uint32        seed,
+    const uint32        input)
+{
+    const uint32 index = owen_scramble(input, hash_uint32(seed));
+
+    const uint32 x = owen_scramble(sobol_dimension0(index), mix_uint32(seed, 0));
+    const uint32 y = owen_scramble(sobol_dimension1(index), mix_uint32(seed, 1));
+
+    // Convert in double precision, then make sure rounding to T doesn't yield 1.0.
+    const double Scale = 1.0 / 4294967296.0;
+    const T OneMinusEps = T(1.0) - std::numeric_limits<T>::epsilon() / 2;
+
+    return
+        Vector<T, 2>(
+            std::min(static_cast<T>(x * Scale), OneMinusEps),
+            std::min(static_cast<T>(y * Scale), OneMinusEps));
+}
+
 }       // namespace foundation
 
 #endif  // !APPLESEED_FOUNDATION_MATH_QMC_H
@@ -37,6 +37,7 @@
 #include "foundation/math/qmc.h"
 #include "foundation/math/rng.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/test/helpers.h"
 
 // Standard headers.
@@ -73,6 +74,14 @@ class QMCSamplingContext
     // Random number generator type.
     typedef RNG RNGType;
 
+    // Sampling methods, for interface compatibility with SobolSamplingContext.
+    // This context always uses Halton sequences.
+    enum Mode
+    {
+        RNGMode,
+        QMCMode
+    };
+
     // Construct a sampling context of dimension 0. It cannot be used
     // directly; only child contexts obtained by splitting can.
     explicit QMCSamplingContext(RNG& rng);
@@ -86,6 +95,16 @@ class QMCSamplingContext
         const size_t    sample_count,
         const size_t    instance = 0);
 
+    // Same as above; the sampling mode is ignored. Halton sequences are not
+    // scrambled: the scrambling seed offsets the instance number instead.
+    QMCSamplingContext(
+        RNG&            rng,
+        const Mode      mode,
+        const size_t    dimension,
+        const size_t    sample_count,
+        const size_t    instance = 0,
+        const uint32    scrambling_seed = 0);
+
     // Assignment operator.
     QMCSamplingContext& operator=(const QMCSamplingContext& rhs);
 
@@ -189,6 +208,25 @@ inline QMCSamplingContext<RNG>::QMCSamplingContext(
     assert(dimension <= VectorType::Dimension);
 }
 
+template <typename RNG>
+inline QMCSamplingContext<RNG>::QMCSamplingContext(
+    RNG&                rng,
+    const Mode          mode,
+    const size_t        dimension,
+    const size_t        sample_count,
+    const size_t        instance,
+    const uint32        scrambling_seed)
+  : m_rng(rng)
+  , m_base_dimension(0)
+  , m_base_instance(0)
+  , m_dimension(dimension)
+  , m_sample_count(sample_count)
+  , m_instance(instance + scrambling_seed)
+  , m_offset(0.0)
+{
+    assert(dimension <= VectorType::Dimension);
+}
+
 template <typename RNG>
 inline QMCSamplingContext<RNG>::QMCSamplingContext(
     RNG&                rng,
@@ -0,0 +1,405 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#ifndef APPLESEED_FOUNDATION_MATH_SAMPLING_SOBOLSAMPLINGCONTEXT_H
+#define APPLESEED_FOUNDATION_MATH_SAMPLING_SOBOLSAMPLINGCONTEXT_H
+
+// appleseed.foundation headers.
+#include "foundation/math/hash.h"
+#include "foundation/math/qmc.h"
+#include "foundation/math/rng.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cstddef>
+
+namespace foundation
+{
+
+//
+// A sampling context whose sampling method is chosen at run time:
+//
+//   - in RNGMode, samples are drawn from the random number generator,
+//     exactly like RNGSamplingContext does;
+//
+//   - in QMCMode, samples are drawn from a Sobol (0,2)-sequence with
+//     hash-based Owen scrambling. Every pair of dimensions uses its own
+//     scrambling seed (padding), while the point index is preserved across
+//     splits, so that all dimensions of a given trajectory use the same
+//     point of their respective sequences.
+//
+// Reference:
+//
+//   Brent Burley, Practical Hash-based Owen Scrambling
+//   http://jcgt.org/published/0009/04/01/
+//
+
+template <typename RNG>
+class SobolSamplingContext
+{
+  public:
+    // Random number generator type.
+    typedef RNG RNGType;
+
+    // Sampling methods.
+    enum Mode
+    {
+        RNGMode,
+        QMCMode
+    };
+
+    // Construct a sampling context of dimension 0. It cannot be used
+    // directly; only child contexts obtained by splitting can.
+    explicit SobolSamplingContext(
+        RNG&            rng,
+        const Mode      mode = RNGMode);
+
+    // Construct a sampling context for a given number of dimensions
+    // and samples. Set sample_count to 0 if the required number of
+    // samples is unknown or infinite. In QMCMode, initial_instance is
+    // the index of the first point drawn from the sequence, and the
+    // scrambling seed selects the randomization of the sequence: samples
+    // that must be stratified together (e.g. the samples of a pixel)
+    // should share a seed and use successive instance numbers.
+    SobolSamplingContext(
+        RNG&            rng,
+        const size_t    dimension,
+        const size_t    sample_count,
+        const size_t    initial_instance = 0,
+        const uint32    scrambling_seed = 0);
+    SobolSamplingContext(
+        RNG&            rng,
+        const Mode      mode,
+        const size_t    dimension,
+        const size_t    sample_count,
+        const size_t    initial_instance = 0,
+        const uint32    scrambling_seed = 0);
+
+    // Assignment operator.
+    SobolSamplingContext& operator=(const SobolSamplingContext& rhs);
+
+    // Trajectory splitting: return a child sampling context for
+    // a given number of dimensions and samples.
+    SobolSamplingContext split(
+        const size_t    dimension,
+        const size_t    sample_count) const;
+
+    // In-place trajectory splitting.
+    void split_in_place(
+        const size_t    dimension,
+        const size_t    sample_count);
+
+    // Return the sampling method of this context.
+    Mode get_mode() const;
+
+    // Return the next sample in [0,1].
+    double next_double1();
+
+    // Return the next sample in [0,1).
+    double next_double2();
+
+    // Return the next sample in [0,1]^N.
+    void next_vector1(const size_t n, double v[]);
+    template <size_t N> Vector<double, N> next_vector1();
+
+    // Return the next sample in [0,1)^N.
+    void next_vector2(const size_t n, double v[]);
+    template <size_t N> Vector<double, N> next_vector2();
+
+    // Return the total dimension of this sampler.
+    size_t get_total_dimension() const;
+
+    // Return the total instance number of this sampler.
+    size_t get_total_instance() const;
+
+  private:
+    RNG&        m_rng;
+    Mode        m_mode;
+    uint32      m_seed;
+
+    size_t      m_base_dimension;
+    size_t      m_base_instance;
+
+    size_t      m_dimension;
+    size_t      m_sample_count;
+
+    size_t      m_instance;
+
+    SobolSamplingContext(
+        RNG&            rng,
+        const Mode      mode,
+        const uint32    seed,
+        const size_t    base_dimension,
+        const size_t    base_instance,
+        const size_t    dimension,
+        const size_t    sample_count);
+
+    // Return the index of the sample last drawn from this context.
+    size_t get_current_instance() const;
+};
+
+
+//
+// SobolSamplingContext class implementation.
+//
+
+template <typename RNG>
+inline SobolSamplingContext<RNG>::SobolSamplingContext(
+    RNG&                rng,
+    const Mode          mode)
+  : m_rng(rng)
+  , m_mode(mode)
+  , m_seed(0)
+  , m_base_dimension(0)
+  , m_base_instance(0)
+  , m_dimension(0)
+  , m_sample_count(0)
+  , m_instance(0)
+{
+}
+
+template <typename RNG>
+inline SobolSamplingContext<RNG>::SobolSamplingContext(
+    RNG&                rng,
+    const size_t        dimension,
+    const size_t        sample_count,
+    const size_t        initial_instance,
+    const uint32        scrambling_seed)
+  : m_rng(rng)
+  , m_mode(RNGMode)
+  , m_seed(scrambling_seed)
+  , m_base_dimension(0)
+  , m_base_instance(initial_instance)
+  , m_dimension(dimension)
+  , m_sample_count(sample_count)
+  , m_instance(0)
+{
+}
+
+template <typename RNG>
+inline SobolSamplingContext<RNG>::SobolSamplingContext(
+    RNG&                rng,
+    const Mode          mode,
+    const size_t        dimension,
+    const size_t        sample_count,
+    const size_t        initial_instance,
+    const uint32        scrambling_seed)
+  : m_rng(rng)
+  , m_mode(mode)
+  , m_seed(scrambling_seed)
+  , m_base_dimension(0)
+  , m_base_instance(initial_instance)
+  , m_dimension(dimension)
+  , m_sample_count(sample_count)
+  , m_instance(0)
+{
+}
+
+template <typename RNG>
+inline SobolSamplingContext<RNG>::SobolSamplingContext(
+    RNG&                rng,
+    const Mode          mode,
+    const uint32        seed,
+    const size_t        base_dimension,
+    const size_t        base_instance,
+    const size_t        dimension,
+    const size_t        sample_count)
+  : m_rng(rng)
+  , m_mode(mode)
+  , m_seed(seed)
+  , m_base_dimension(base_dimension)
+  , m_base_instance(base_instance)
+  , m_dimension(dimension)
+  , m_sample_count(sample_count)
+  , m_instance(0)
+{
+}
+
+template <typename RNG> inline
+SobolSamplingContext<RNG>&
+SobolSamplingContext<RNG>::operator=(const SobolSamplingContext& rhs)
+{
+    m_mode = rhs.m_mode;
+    m_seed = rhs.m_seed;
+    m_base_dimension = rhs.m_base_dimension;
+    m_base_instance = rhs.m_base_instance;
+    m_dimension = rhs.m_dimension;
+    m_sample_count = rhs.m_sample_count;
+    m_instance = rhs.m_instance;
+    return *this;
+}
+
+template <typename RNG>
+inline SobolSamplingContext<RNG> SobolSamplingContext<RNG>::split(
+    const size_t    dimension,
+    const size_t    sample_count) const
+{
+    SobolSamplingContext child(*this);
+    child.split_in_place(dimension, sample_count);
+    return child;
+}
+
+template <typename RNG>
+inline void SobolSamplingContext<RNG>::split_in_place(
+    const size_t    dimension,
+    const size_t    sample_count)
+{
+    if (m_mode == QMCMode)
+    {
+        const size_t current_instance = get_current_instance();
+
+        if (sample_count > 0)
+        {
+            // The child draws the sample_count points following current_instance * sample_count.
+            m_base_instance = current_instance * sample_count;
+        }
+        else
+        {
+            // The number of samples is unknown: use an independent sequence.
+            m_seed = mix_uint32(m_seed, static_cast<uint32>(current_instance));
+            m_base_instance = 0;
+        }
+
+        m_instance = 0;
+    }
+
+    m_base_dimension += m_dimension;                // dimension allocation
+    m_dimension = dimension;
+    m_sample_count = sample_count;
+}
+
+template <typename RNG>
+inline typename SobolSamplingContext<RNG>::Mode SobolSamplingContext<RNG>::get_mode() const
+{
+    return m_mode;
+}
+
+template <typename RNG>
+inline double SobolSamplingContext<RNG>::next_double1()
+{
+    double v;
+    next_vector1(1, &v);
+    return v;
+}
+
+template <typename RNG>
+inline double SobolSamplingContext<RNG>::next_double2()
+{
+    double v;
+    next_vector2(1, &v);
+    return v;
+}
+
+template <typename RNG>
+inline void SobolSamplingContext<RNG>::next_vector1(const size_t n, double v[])
+{
+    if (m_mode == RNGMode)
+    {
+        for (size_t i = 0; i < n; ++i)
+            v[i] = rand_double1(m_rng);
+    }
+    else
+    {
+        // Samples in [0,1) are also in [0,1].
+        next_vector2(n, v);
+    }
+}
+
+template <typename RNG>
+template <size_t N>
+inline Vector<double, N> SobolSamplingContext<RNG>::next_vector1()
+{
+    Vector<double, N> v;
+
+    next_vector1(N, &v[0]);
+
+    return v;
+}
+
+template <typename RNG>
+inline void SobolSamplingContext<RNG>::next_vector2(const size_t n, double v[])
+{
+    if (m_mode == RNGMode)
+    {
+        for (size_t i = 0; i < n; ++i)
+            v[i] = rand_double2(m_rng);
+    }
+    else
+    {
+        const uint32 instance = static_cast<uint32>(m_base_instance + m_instance);
+
+        for (size_t i = 0; i < n; i += 2)
+        {
+            // Pad dimensions by drawing each pair from an independently scrambled sequence.
+            const uint32 dimension = static_cast<uint32>(m_base_dimension + i);
+            const Vector2d s = sobol_02_sequence<double>(mix_uint32(m_seed, dimension), instance);
+
+            v[i] = s[0];
+
+            if (i + 1 < n)
+                v[i + 1] = s[1];
+        }
+
+        ++m_instance;
+    }
+}
+
+template <typename RNG>
+template <size_t N>
+inline Vector<double, N> SobolSamplingContext<RNG>::next_vector2()
+{
+    Vector<double, N> v;
+
+    next_vector2(N, &v[0]);
+
+    return v;
+}
+
+template <typename RNG>
+inline size_t SobolSamplingContext<RNG>::get_total_dimension() const
+{
+    return m_base_dimension + m_dimension;
+}
+
+template <typename RNG>
+inline size_t SobolSamplingContext<RNG>::get_total_instance() const
+{
+    return m_base_instance + m_instance;
+}
+
+template <typename RNG>
+inline size_t SobolSamplingContext<RNG>::get_current_instance() const
+{
+    return m_base_instance + (m_instance > 0 ? m_instance - 1 : 0);
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_SAMPLING_SOBOLSAMPLINGCONTEXT_H
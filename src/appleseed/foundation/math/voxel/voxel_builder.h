@@ -38,8 +38,8 @@
 
 // Standard headers.
 #include <cassert>
-#include <cmath>
 #include <cstddef>
+#include <vector>
 
 namespace foundation {
 namespace voxel {
@@ -89,6 +89,27 @@ class Builder
     template <typename ItemIntersector>
     void push(const ItemIntersector& item_intersector);
 
+    //
+    // Subdivide the top levels of the tree, down to a given depth or until the refinement
+    // criterion is met, and return the resulting leaves and their bounding boxes. Each leaf
+    // can then be built independently (for instance by a job) with its own builder over the
+    // bounding box of the leaf, and grafted back into this tree with graft(). Since push()
+    // does not test items against the root node, items must be pushed into the builder of
+    // a leaf only if they intersect the bounding box of this leaf.
+    //
+    // Must be called before any item is pushed into the tree.
+    //
+
+    void subdivide_top_levels(
+        const size_t            depth,
+        std::vector<size_t>&    leaf_indices,
+        std::vector<AABBType>&  leaf_bboxes);
+
+    // Replace a leaf node by a tree built independently over the bounding box of this leaf.
+    void graft(
+        const size_t            leaf_index,
+        const TreeType&         subtree);
+
     // Complete the construction of the tree.
     void complete();
 
@@ -103,6 +124,11 @@ class Builder
     Stopwatch<Timer>    m_stopwatch;
     double              m_build_time;
 
+    // Convert a leaf node to an interior node with two empty leaves, return the index of the left one.
+    size_t create_child_nodes(
+        const size_t            node_index,
+        const SplitType&        split);
+
     // Recursively push an item into the tree.
     template <typename ItemIntersector>
     void push_recurse(
@@ -110,14 +136,17 @@ class Builder
         const size_t            node_index,
         const AABBType&         node_bbox);
 
+    // Recursively subdivide the top levels of the tree.
+    void subdivide_recurse(
+        const size_t            node_index,
+        const AABBType&         node_bbox,
+        const size_t            depth,
+        std::vector<size_t>&    leaf_indices,
+        std::vector<AABBType>&  leaf_bboxes);
+
     // Recursively trim the tree.
     bool trim_recurse(
         const size_t            node_index);
-
-    // Compute the maximum leaf node diagonal length.
-    void compute_max_diagonal_recurse(
-        const size_t            node_index,
-        const AABBType&         node_bbox);
 };
 
 
@@ -143,6 +172,7 @@ Builder<Tree, Timer>::Builder(
     // Clear the voxel tree.
     m_tree.clear();
     m_tree.m_bbox = bbox;
+    m_tree.m_max_extent = max_extent;
 
     // Create the root node.
     NodeType root;
@@ -159,11 +189,7 @@ void Builder<Tree, Timer>::complete()
     trim_recurse(0);
 
     // Compute the maximum leaf node diagonal length.
-    assert(m_tree.m_max_diag == ValueType(0.0));
-    compute_max_diagonal_recurse(
-        0,                      // root node
-        m_tree.m_bbox);         // bounding box of the root node
-    m_tree.m_max_diag = std::sqrt(m_tree.m_max_diag);
+    m_tree.compute_max_diag();
 
     // Measure and save construction time.
     m_stopwatch.measure();
@@ -182,6 +208,57 @@ void Builder<Tree, Timer>::push(const ItemIntersector& item_intersector)
         m_tree.m_bbox);         // bounding box of the root node
 }
 
+// Subdivide the top levels of the tree.
+template <typename Tree, typename Timer>
+void Builder<Tree, Timer>::subdivide_top_levels(
+    const size_t                depth,
+    std::vector<size_t>&        leaf_indices,
+    std::vector<AABBType>&      leaf_bboxes)
+{
+    assert(m_tree.m_nodes.size() == 1);
+    assert(m_tree.m_nodes[0].is_leaf());
+    assert(m_tree.m_nodes[0].is_empty());
+
+    leaf_indices.clear();
+    leaf_bboxes.clear();
+
+    subdivide_recurse(
+        0,                      // root node
+        m_tree.m_bbox,          // bounding box of the root node
+        depth,
+        leaf_indices,
+        leaf_bboxes);
+}
+
+// Replace a leaf node by a tree built independently.
+template <typename Tree, typename Timer>
+void Builder<Tree, Timer>::graft(
+    const size_t                leaf_index,
+    const TreeType&             subtree)
+{
+    assert(leaf_index < m_tree.m_nodes.size());
+    assert(m_tree.m_nodes[leaf_index].is_leaf());
+    assert(!subtree.m_nodes.empty());
+
+    const size_t subtree_node_count = subtree.m_nodes.size();
+
+    // Subtree node i > 0 is stored at index offset + i in the tree.
+    const size_t offset = m_tree.m_nodes.size() - 1;
+    m_tree.m_nodes.reserve(offset + subtree_node_count);
+
+    for (size_t i = 0; i < subtree_node_count; ++i)
+    {
+        NodeType node = subtree.m_nodes[i];
+
+        if (node.is_interior())
+            node.set_child_node_index(offset + node.get_child_node_index());
+
+        if (i == 0)
+            m_tree.m_nodes[leaf_index] = node;
+        else m_tree.m_nodes.push_back(node);
+    }
+}
+
 // Return the construction time.
 template <typename Tree, typename Timer>
 double Builder<Tree, Timer>::get_build_time() const
@@ -189,6 +266,38 @@ double Builder<Tree, Timer>::get_build_time() const
     return m_build_time;
 }
 
+// Convert a leaf node to an interior node with two empty leaves.
+template <typename Tree, typename Timer>
+size_t Builder<Tree, Timer>::create_child_nodes(
+    const size_t                node_index,
+    const SplitType&            split)
+{
+    assert(m_tree.m_nodes[node_index].is_leaf());
+
+    // Compute the index of the left child node.
+    const size_t left_node_index = m_tree.m_nodes.size();
+
+    // Create the left node.
+    NodeType left_node;
+    left_node.make_leaf();
+    left_node.set_solid_bit(false);
+    m_tree.m_nodes.push_back(left_node);
+
+    // Create the right node.
+    NodeType right_node;
+    right_node.make_leaf();
+    right_node.set_solid_bit(false);
+    m_tree.m_nodes.push_back(right_node);
+
+    // Convert the parent node to an interior node.
+    m_tree.m_nodes[node_index].make_interior();
+    m_tree.m_nodes[node_index].set_child_node_index(left_node_index);
+    m_tree.m_nodes[node_index].set_split_dim(split.m_dimension);
+    m_tree.m_nodes[node_index].set_split_abs(split.m_abscissa);
+
+    return left_node_index;
+}
+
 // Recursively push an item into the tree.
 template <typename Tree, typename Timer>
 template <typename ItemIntersector>
@@ -210,40 +319,12 @@ void Builder<Tree, Timer>::push_recurse(
     // Descend into the tree if the node is too large.
     if (node_extent > m_max_extent)
     {
-        size_t left_node_index;
-        size_t right_node_index;
-
         // Locate the left and right child nodes, or create them if they don't exist yet.
-        if (m_tree.m_nodes[node_index].is_leaf())
-        {
-            // Compute the indices of the child nodes.
-            left_node_index = m_tree.m_nodes.size();
-            right_node_index = left_node_index + 1;
-
-            // Create the left node.
-            NodeType left_node;
-            left_node.make_leaf();
-            left_node.set_solid_bit(false);
-            m_tree.m_nodes.push_back(left_node);
-
-            // Create the right node.
-            NodeType right_node;
-            right_node.make_leaf();
-            right_node.set_solid_bit(false);
-            m_tree.m_nodes.push_back(right_node);
-
-            // Convert the parent node to an interior node.
-            m_tree.m_nodes[node_index].make_interior();
-            m_tree.m_nodes[node_index].set_child_node_index(left_node_index);
-            m_tree.m_nodes[node_index].set_split_dim(split.m_dimension);
-            m_tree.m_nodes[node_index].set_split_abs(split.m_abscissa);
-        }
-        else
-        {
-            // Compute the indices of the child nodes.
-            left_node_index = m_tree.m_nodes[node_index].get_child_node_index();
-            right_node_index = left_node_index + 1;
-        }
+        const size_t left_node_index =
+            m_tree.m_nodes[node_index].is_leaf()
+                ? create_child_nodes(node_index, split)
+                : m_tree.m_nodes[node_index].get_child_node_index();
+        const size_t right_node_index = left_node_index + 1;
 
         // Compute the bounding boxes of the child nodes.
         AABBType left_node_bbox, right_node_bbox;
@@ -275,6 +356,41 @@ void Builder<Tree, Timer>::push_recurse(
     }
 }
 
+// Recursively subdivide the top levels of the tree.
+template <typename Tree, typename Timer>
+void Builder<Tree, Timer>::subdivide_recurse(
+    const size_t                node_index,
+    const AABBType&             node_bbox,
+    const size_t                depth,
+    std::vector<size_t>&        leaf_indices,
+    std::vector<AABBType>&      leaf_bboxes)
+{
+    // Compute the splitting dimension and abscissa, like push_recurse() does.
+    const SplitType split = SplitType::middle(node_bbox);
+
+    // Compute the extent of the node along the splitting dimension.
+    const ValueType node_extent =
+          node_bbox.max[split.m_dimension]
+        - node_bbox.min[split.m_dimension];
+
+    if (depth == 0 || node_extent <= m_max_extent)
+    {
+        leaf_indices.push_back(node_index);
+        leaf_bboxes.push_back(node_bbox);
+        return;
+    }
+
+    const size_t left_node_index = create_child_nodes(node_index, split);
+
+    // Compute the bounding boxes of the child nodes.
+    AABBType left_node_bbox, right_node_bbox;
+    split_bbox(node_bbox, split, left_node_bbox, right_node_bbox);
+
+    // Recurse into the child nodes.
+    subdivide_recurse(left_node_index, left_node_bbox, depth - 1, leaf_indices, leaf_bboxes);
+    subdivide_recurse(left_node_index + 1, right_node_bbox, depth - 1, leaf_indices, leaf_bboxes);
+}
+
 // Recursively trim the tree.
 template <typename Tree, typename Timer>
 bool Builder<Tree, Timer>::trim_recurse(
@@ -303,44 +419,6 @@ bool Builder<Tree, Timer>::trim_recurse(
     return node.is_solid();
 }
 
-// Compute the maximum leaf node diagonal length.
-template <typename Tree, typename Timer>
-void Builder<Tree, Timer>::compute_max_diagonal_recurse(
-    const size_t                node_index,
-    const AABBType&             node_bbox)
-{
-    assert(node_index < m_tree.m_nodes.size());
-
-    // Fetch the node.
-    const NodeType& node = m_tree.m_nodes[node_index];
-
-    if (node.is_leaf())
-    {
-        if (node.is_solid())
-        {
-            // Compute the (square of the) length of the diagonal of this leaf node.
-            const VectorType e = node_bbox.extent();
-            const ValueType diag = e[0] * e[0] + e[1] * e[1] + e[2] * e[2];
-
-            // Keep track of the maximum (squared) diagonal length.
-            if (m_tree.m_max_diag < diag)
-                m_tree.m_max_diag = diag;
-        }
-    }
-    else
-    {
-        // Compute the bounding boxes of the child nodes.
-        const Split<ValueType> split(node.get_split_dim(), node.get_split_abs());
-        AABBType left_node_bbox, right_node_bbox;
-        split_bbox(node_bbox, split, left_node_bbox, right_node_bbox);
-
-        // Recurse into the child nodes.
-        const size_t child_index = node.get_child_node_index();
-        compute_max_diagonal_recurse(child_index, left_node_bbox);
-        compute_max_diagonal_recurse(child_index + 1, right_node_bbox);
-    }
-}
-
 }       // namespace voxel
 }       // namespace foundation
 
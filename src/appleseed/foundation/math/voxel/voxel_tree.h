@@ -35,9 +35,13 @@
 #include "foundation/math/voxel/voxel_node.h"
 #include "foundation/math/split.h"
 #include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/bufferedfile.h"
 
 // Standard headers.
+#include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstdio>
 #include <string>
@@ -77,6 +81,13 @@ class Tree
     // Return the maximum leaf node diagonal length.
     ValueType get_max_diag_length() const;
 
+    // Return the maximum leaf node extent the tree was built with.
+    ValueType get_max_extent() const;
+
+    // Set or return a value identifying the data the tree was built from.
+    void set_signature(const uint64 signature);
+    uint64 get_signature() const;
+
     // Return the size (in bytes) of this object in memory.
     size_t get_memory_size() const;
 
@@ -84,9 +95,16 @@ class Tree
     // Return true on success, false on error.
     bool dump_solid_leaves_to_disk(const std::string& filename) const;
 
-    // Dump the entire tree to disk, in proprietary binary format.
+    // Dump the entire tree to disk, in proprietary binary format,
+    // including the maximum leaf node extent the tree was built with
+    // and its signature.
+    // Return true on success, false on error.
     bool dump_tree_to_disk(const std::string& filename) const;
 
+    // Load a tree written by dump_tree_to_disk().
+    // Return true on success, false on error (the tree is then left empty).
+    bool load_tree_from_disk(const std::string& filename);
+
   protected:
     template <
         typename Tree,
@@ -106,9 +124,24 @@ class Tree
 
     typedef std::vector<NodeType> NodeVector;
 
+    // Signature and version of files written by dump_tree_to_disk().
+    enum
+    {
+        FileSignature = 0x54584F56,         // 'VOXT'
+        FileVersion = 3
+    };
+
     AABBType    m_bbox;                     // bounding box of the tree
     NodeVector  m_nodes;                    // nodes of the tree
     ValueType   m_max_diag;                 // maximum leaf node diagonal length
+    ValueType   m_max_extent;               // maximum leaf node extent used to build the tree
+    uint64      m_signature;                // identifies the data the tree was built from
+
+    // Compute the maximum leaf node diagonal length.
+    void compute_max_diag();
+    void compute_max_diag_recurse(
+        const size_t    node_index,
+        const AABBType& node_bbox);
 
     // Write a vertex definition to a file.
     static size_t dump_vertex(
@@ -151,6 +184,8 @@ void Tree<T, N>::clear()
     m_bbox.invalidate();
     m_nodes.clear();
     m_max_diag = ValueType(0.0);
+    m_max_extent = ValueType(0.0);
+    m_signature = 0;
 }
 
 template <typename T, size_t N>
@@ -165,6 +200,24 @@ inline T Tree<T, N>::get_max_diag_length() const
     return m_max_diag;
 }
 
+template <typename T, size_t N>
+inline T Tree<T, N>::get_max_extent() const
+{
+    return m_max_extent;
+}
+
+template <typename T, size_t N>
+inline void Tree<T, N>::set_signature(const uint64 signature)
+{
+    m_signature = signature;
+}
+
+template <typename T, size_t N>
+inline uint64 Tree<T, N>::get_signature() const
+{
+    return m_signature;
+}
+
 template <typename T, size_t N>
 size_t Tree<T, N>::get_memory_size() const
 {
@@ -208,23 +261,155 @@ bool Tree<T, N>::dump_tree_to_disk(const std::string& filename) const
     if (!file.is_open())
         return false;
 
-    // Write the bounding box of the tree.
-    file.write(m_bbox.min);
-    file.write(m_bbox.max);
+    // Write the file header.
+    size_t bytes = 0;
+    bytes += file.write(static_cast<uint32>(FileSignature));
+    bytes += file.write(static_cast<uint32>(FileVersion));
+
+    // Write the bounding box of the tree and the parameters it was built with.
+    bytes += file.write(m_bbox.min);
+    bytes += file.write(m_bbox.max);
+    bytes += file.write(m_max_extent);
+    bytes += file.write(m_signature);
 
     // Write the nodes.
     const size_t node_count = m_nodes.size();
-    file.write(node_count);
+    bytes += file.write(node_count);
     for (size_t i = 0; i < node_count; ++i)
     {
         const NodeType& node = m_nodes[i];
-        file.write(node.m_info);
-        file.write(node.m_abscissa);
+        bytes += file.write(node.m_info);
+        bytes += file.write(node.m_abscissa);
     }
 
+    const size_t expected_bytes =
+          2 * sizeof(uint32)
+        + 2 * sizeof(VectorType)
+        + sizeof(ValueType)
+        + sizeof(uint64)
+        + sizeof(size_t)
+        + node_count * (sizeof(uint32) + sizeof(ValueType));
+
+    return bytes == expected_bytes;
+}
+
+template <typename T, size_t N>
+bool Tree<T, N>::load_tree_from_disk(const std::string& filename)
+{
+    clear();
+
+    // Open the file for reading.
+    BufferedFile file(
+        filename.c_str(),
+        BufferedFile::BinaryType,
+        BufferedFile::ReadMode);
+    if (!file.is_open())
+        return false;
+
+    // Read and check the file header.
+    uint32 signature, version;
+    if (file.read(signature) != sizeof(uint32) ||
+        file.read(version) != sizeof(uint32) ||
+        signature != FileSignature ||
+        version != FileVersion)
+        return false;
+
+    // Read the bounding box of the tree and the parameters it was built with.
+    AABBType bbox;
+    ValueType max_extent;
+    uint64 tree_signature;
+    size_t node_count;
+    if (file.read(bbox.min) != sizeof(VectorType) ||
+        file.read(bbox.max) != sizeof(VectorType) ||
+        file.read(max_extent) != sizeof(ValueType) ||
+        file.read(tree_signature) != sizeof(uint64) ||
+        file.read(node_count) != sizeof(size_t) ||
+        !bbox.is_valid() ||
+        !(max_extent > ValueType(0.0)) ||
+        node_count == 0 ||
+        node_count >= (1UL << 29))
+        return false;
+
+    // Read the nodes.
+    NodeVector nodes(node_count);
+    for (size_t i = 0; i < node_count; ++i)
+    {
+        NodeType& node = nodes[i];
+
+        if (file.read(node.m_info) != sizeof(uint32) ||
+            file.read(node.m_abscissa) != sizeof(ValueType))
+            return false;
+
+        // Child nodes are always stored after their parent.
+        if (node.is_interior())
+        {
+            const size_t child_index = node.get_child_node_index();
+            if (child_index <= i || child_index + 1 >= node_count || node.get_split_dim() >= N)
+                return false;
+        }
+    }
+
+    m_bbox = bbox;
+    m_nodes.swap(nodes);
+    m_max_extent = max_extent;
+    m_signature = tree_signature;
+    compute_max_diag();
+
     return true;
 }
 
+template <typename T, size_t N>
+void Tree<T, N>::compute_max_diag()
+{
+    m_max_diag = ValueType(0.0);
+
+    if (!m_nodes.empty())
+    {
+        compute_max_diag_recurse(
+            0,                      // root node
+            m_bbox);                // bounding box of the root node
+    }
+
+    m_max_diag = std::sqrt(m_max_diag);
+}
+
+template <typename T, size_t N>
+void Tree<T, N>::compute_max_diag_recurse(
+    const size_t        node_index,
+    const AABBType&     node_bbox)
+{
+    assert(node_index < m_nodes.size());
+
+    // Fetch the node.
+    const NodeType& node = m_nodes[node_index];
+
+    if (node.is_leaf())
+    {
+        if (node.is_solid())
+        {
+            // Compute the (square of the) length of the diagonal of this leaf node.
+            const VectorType e = node_bbox.extent();
+            const ValueType diag = dot(e, e);
+
+            // Keep track of the maximum (squared) diagonal length.
+            if (m_max_diag < diag)
+                m_max_diag = diag;
+        }
+    }
+    else
+    {
+        // Compute the bounding boxes of the child nodes.
+        const Split<ValueType> split(node.get_split_dim(), node.get_split_abs());
+        AABBType left_node_bbox, right_node_bbox;
+        split_bbox(node_bbox, split, left_node_bbox, right_node_bbox);
+
+        // Recurse into the child nodes.
+        const size_t child_index = node.get_child_node_index();
+        compute_max_diag_recurse(child_index, left_node_bbox);
+        compute_max_diag_recurse(child_index + 1, right_node_bbox);
+    }
+}
+
 template <typename T, size_t N>
 size_t Tree<T, N>::dump_vertex(
     const double    x,
@@ -37,6 +37,9 @@
 // appleseed.main headers.
 #include "main/dllsymbol.h"
 
+// Standard headers.
+#include <cstddef>
+
 // Forward declarations.
 namespace foundation    { class IMeshBuilder; }
 
@@ -61,6 +64,10 @@ class DLLSYMBOL GenericMeshFileReader
     int get_obj_options() const;
     void set_obj_options(const int obj_options);
 
+    // Get/set the number of threads used to parse Wavefront OBJ files in parallel, 0 to use all logical cores.
+    size_t get_obj_thread_count() const;
+    void set_obj_thread_count(const size_t obj_thread_count);
+
     // Read a mesh.
     virtual void read(IMeshBuilder& builder);
 
@@ -38,10 +38,12 @@
 #include "foundation/utility/string.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cctype>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -64,6 +66,8 @@ class OBJMeshFileLexer
     // Constructor.
     explicit OBJMeshFileLexer(const ParsingMode parsing_mode = Precise)
       : m_parsing_mode(parsing_mode)
+      , m_buffer_ptr(0)
+      , m_buffer_end(0)
       , m_eof(false)
       , m_line_number(0)
       , m_line(4096)
@@ -79,6 +83,9 @@ class OBJMeshFileLexer
     // Return true on success, false on error.
     bool open(const std::string& filename)
     {
+        m_buffer_ptr = 0;
+        m_buffer_end = 0;
+
         m_eof = false;
         m_line_number = 0;
         m_line_size = 0;
@@ -97,16 +104,48 @@ class OBJMeshFileLexer
         return true;
     }
 
-    // Close the input file.
+    // Open an in-memory range of lines, typically a portion of a memory-mapped file.
+    // The range must start at the beginning of a line. first_line_number is the
+    // position in the file of the first line of the range and is used for error reporting.
+    void open(
+        const char*     begin,
+        const char*     end,
+        const size_t    first_line_number = 1)
+    {
+        assert(begin);
+        assert(begin <= end);
+        assert(first_line_number > 0);
+
+        m_buffer_ptr = begin;
+        m_buffer_end = end;
+
+        m_eof = false;
+        m_line_number = first_line_number - 1;
+        m_line_size = 0;
+        m_line_index = 0;
+
+        read_next_line();
+    }
+
+    // Close the input file or the in-memory range of lines.
     void close()
     {
         m_file.close();
+
+        m_buffer_ptr = 0;
+        m_buffer_end = 0;
+    }
+
+    // Return true if an input file or an in-memory range of lines is open.
+    bool is_open() const
+    {
+        return m_buffer_ptr != 0 || m_file.is_open();
     }
 
     // Return the position of the current line in the file.
     size_t get_line_number() const
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         return m_line_number;
     }
@@ -114,7 +153,7 @@ class OBJMeshFileLexer
     // Return the current character in the line.
     FORCE_INLINE unsigned char get_char() const
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         return m_line_index == m_line_size ? '\n' : m_line[m_line_index];
     }
@@ -122,7 +161,7 @@ class OBJMeshFileLexer
     // Advance to the next character in the line.
     FORCE_INLINE void next_char()
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         if (m_line_index < m_line_size)
             ++m_line_index;
@@ -142,7 +181,7 @@ class OBJMeshFileLexer
     // Return true if the end of the line has been reached.
     FORCE_INLINE bool is_eol() const
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         return m_line_index == m_line_size;
     }
@@ -150,7 +189,7 @@ class OBJMeshFileLexer
     // Return true if the end of the file has been reached.
     FORCE_INLINE bool is_eof() const
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         return m_eof && is_eol();
     }
@@ -158,7 +197,7 @@ class OBJMeshFileLexer
     // Eat blank characters and comments.
     void eat_blanks()
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         while (true)
         {
@@ -193,7 +232,7 @@ class OBJMeshFileLexer
     // Accept a end-of-line character, or generate a parse error.
     void accept_newline()
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         if (!is_eol())
             parse_error();
@@ -204,7 +243,7 @@ class OBJMeshFileLexer
     // Accept a string of non-blank characters, or generate a parse error.
     void accept_string(const char** begin, size_t* length)
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         if (is_eof())
             parse_error();
@@ -237,7 +276,7 @@ class OBJMeshFileLexer
     // Accept a long integer, or generate a parse error.
     FORCE_INLINE long accept_long()
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         // Read an integer value at the current position in the line.
         const char* base_ptr = &m_line[0];
@@ -256,7 +295,7 @@ class OBJMeshFileLexer
     // Accept a double-precision floating point number, or generate a parse error.
     FORCE_INLINE double accept_double()
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         // Read a floating-point value at the current position in the line.
         char* base_ptr = &m_line[0];
@@ -280,6 +319,8 @@ class OBJMeshFileLexer
     const ParsingMode   m_parsing_mode;     // parsing mode for floating-point values
     bool                m_is_space[256];    // precomputed values of std::isspace(c) for all c
     BufferedFile        m_file;
+    const char*         m_buffer_ptr;       // current position in the in-memory range of lines, or 0
+    const char*         m_buffer_end;       // end of the in-memory range of lines
     bool                m_eof;              // has the end of the file been reached?
     size_t              m_line_number;      // position of the current line in the file
     std::vector<char>   m_line;             // current line
@@ -289,14 +330,14 @@ class OBJMeshFileLexer
     // Close the input file and throw an ExceptionParseError exception.
     void parse_error()
     {
-        m_file.close();
+        close();
         throw OBJMeshFileReader::ExceptionParseError(m_line_number);
     }
 
-    // Read the next line from the input file.
+    // Read the next line from the input file or from the in-memory range of lines.
     void read_next_line()
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         m_line_size = 0;
 
@@ -304,29 +345,58 @@ class OBJMeshFileLexer
         {
             ++m_line_number;
 
-            while (m_line_size < m_line.size() - 1)
-            {
-                // Read one character from the file.
-                char c;
-                if (m_file.read(&c) < 1)
-                {
-                    // Reached the end of the file.
-                    m_eof = true;
-                    break;
-                }
-
-                // Stop as soon as the end of the line is reached.
-                if (c == '\n')
-                    break;
-
-                // Append the character to the line.
-                m_line[m_line_size++] = c;
-            }
+            if (m_buffer_ptr)
+                read_next_line_from_buffer();
+            else read_next_line_from_file();
         }
 
         // Append a null terminator.
         m_line[m_line_size] = 0;
     }
+
+    void read_next_line_from_file()
+    {
+        while (m_line_size < m_line.size() - 1)
+        {
+            // Read one character from the file.
+            char c;
+            if (m_file.read(&c) < 1)
+            {
+                // Reached the end of the file.
+                m_eof = true;
+                break;
+            }
+
+            // Stop as soon as the end of the line is reached.
+            if (c == '\n')
+                break;
+
+            // Append the character to the line.
+            m_line[m_line_size++] = c;
+        }
+    }
+
+    void read_next_line_from_buffer()
+    {
+        // Same semantics as read_next_line_from_file(), but a whole line at a time.
+        const size_t available = static_cast<size_t>(m_buffer_end - m_buffer_ptr);
+        const size_t max_size = std::min(available, m_line.size() - 1);
+        const char* newline = static_cast<const char*>(std::memchr(m_buffer_ptr, '\n', max_size));
+
+        m_line_size = newline ? static_cast<size_t>(newline - m_buffer_ptr) : max_size;
+        std::memcpy(&m_line[0], m_buffer_ptr, m_line_size);
+
+        if (newline)
+            m_buffer_ptr = newline + 1;
+        else
+        {
+            m_buffer_ptr += max_size;
+
+            // Reached the end of the range.
+            if (max_size == available)
+                m_eof = true;
+        }
+    }
 };
 
 }       // namespace foundation
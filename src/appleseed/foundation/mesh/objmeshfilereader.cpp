@@ -31,20 +31,33 @@
 #include "objmeshfilereader.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/core/exceptions/exceptionioerror.h"
-#include "foundation/core/exceptions/exceptionnotimplemented.h"
 #include "foundation/math/vector.h"
 #include "foundation/mesh/imeshbuilder.h"
 #include "foundation/mesh/objmeshfilelexer.h"
+#include "foundation/platform/system.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/job.h"
+#include "foundation/utility/log.h"
 #include "foundation/utility/memory.h"
 
+// boost headers.
+#include "boost/filesystem/operations.hpp"
+#include "boost/interprocess/exceptions.hpp"
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+#include "boost/system/error_code.hpp"
+
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <map>
 #include <utility>
 #include <vector>
 
+using namespace boost;
 using namespace std;
 
 namespace foundation
@@ -57,530 +70,1166 @@ namespace foundation
 namespace
 {
     const size_t Undefined = ~0;
-}
 
-struct OBJMeshFileReader::Impl
-{
-    const int               m_options;
-    IMeshBuilder&           m_builder;
-    OBJMeshFileLexer        m_lexer;
-
-    // Current state.
-    bool                    m_inside_mesh_def;              // currently inside a mesh definition?
-    string                  m_current_mesh_name;            // name of the current mesh
-    map<string, size_t>     m_material_slots;               // material slots for the current mesh
-    size_t                  m_current_material_slot_index;  // index of the current material slot
-
-    // Features defined in the file.
-    vector<Vector3d>        m_vertices;
-    vector<Vector2d>        m_tex_coords;
-    vector<Vector3d>        m_normals;
-
-    // Mappings between internal indices and mesh indices.
-    vector<size_t>          m_vertex_index_mapping;
-    vector<size_t>          m_tex_coord_index_mapping;
-    vector<size_t>          m_normal_index_mapping;
-
-    // Temporary vectors for collecting indices while parsing face statements.
-    vector<size_t>          m_face_vertex_indices;
-    vector<size_t>          m_face_tex_coord_indices;
-    vector<size_t>          m_face_normal_indices;
-
-    // Constructor.
-    Impl(
-        const int           options,
-        IMeshBuilder&       builder)
-      : m_options(options)
-      , m_builder(builder)
-      , m_lexer(
-            (options & FavorSpeedOverPrecision)
-                ? OBJMeshFileLexer::Fast
-                : OBJMeshFileLexer::Precise)
-      , m_inside_mesh_def(false)
-      , m_current_material_slot_index(0)
-    {
-    }
+    //
+    // Owns the features (vertices, texture coordinates, normals) defined in the file
+    // and forwards meshes, material slots and faces to the mesh builder.
+    //
 
-    // Close the input file and throw an ExceptionParseError exception.
-    void parse_error()
+    class MeshFeeder
+      : public NonCopyable
     {
-        const size_t line_number = m_lexer.get_line_number();
-
-        m_lexer.close();
+      public:
+        // Features defined in the file.
+        vector<Vector3d>        m_vertices;
+        vector<Vector2d>        m_tex_coords;
+        vector<Vector3d>        m_normals;
+
+        // Constructor.
+        explicit MeshFeeder(IMeshBuilder& builder)
+          : m_builder(builder)
+          , m_inside_mesh_def(false)
+          , m_current_material_slot_index(0)
+        {
+        }
 
-        throw ExceptionParseError(line_number);
-    }
+        size_t get_vertex_count() const
+        {
+            return m_vertices.size();
+        }
 
-    void parse_file()
-    {
-        while (true)
+        size_t get_tex_coord_count() const
         {
-            m_lexer.eat_blanks();
+            return m_tex_coords.size();
+        }
 
-            // Handle end of file.
-            if (m_lexer.is_eof())
-                break;
+        size_t get_normal_count() const
+        {
+            return m_normals.size();
+        }
 
-            // Handle empty lines.
-            if (m_lexer.is_eol())
-            {
-                m_lexer.accept_newline();
-                continue;
-            }
+        void push_vertex(const Vector3d& v)
+        {
+            m_vertices.push_back(v);
+        }
 
-            const char* keyword;
-            size_t keyword_length;
+        void push_tex_coords(const Vector2d& v)
+        {
+            m_tex_coords.push_back(v);
+        }
 
-            m_lexer.accept_string(&keyword, &keyword_length);
+        void push_normal(const Vector3d& n)
+        {
+            m_normals.push_back(n);
+        }
 
-            if (keyword_length == 1)
+        void begin_object_or_group(const string& upcoming_mesh_name)
+        {
+            // Start a new mesh only if the name of the object or group actually changes.
+            if (upcoming_mesh_name != m_current_mesh_name)
             {
-                switch (keyword[0])
+                // End the current mesh.
+                if (m_inside_mesh_def)
                 {
-                  case 'f':
-                    parse_f_statement();
-                    break;
-
-                  case 'g':
-                  case 'o':
-                    parse_o_g_statement();
-                    break;
+                    m_builder.end_mesh();
+                    m_inside_mesh_def = false;
+                }
 
-                  case 'v':
-                    parse_v_statement();
-                    break;
+                clear_keep_memory(m_vertex_index_mapping);
+                clear_keep_memory(m_tex_coord_index_mapping);
+                clear_keep_memory(m_normal_index_mapping);
 
-                  default:
-                    // Ignore unknown or unhandled statements.
-                    m_lexer.eat_line();
-                    continue;
-                }
+                m_current_mesh_name = upcoming_mesh_name;
             }
-            else if (keyword_length == 2)
-            {
-                switch (keyword[0] * 256 + keyword[1])
-                {
-                  case 'v' * 256 + 'n':
-                    parse_vn_statement();
-                    break;
+        }
 
-                  case 'v' * 256 + 't':
-                    parse_vt_statement();
-                    break;
+        void use_material(const string& material_slot_name)
+        {
+            // Begin a mesh definition if we're not already inside one.
+            ensure_mesh_def();
 
-                  default:
-                    // Ignore unknown or unhandled statements.
-                    m_lexer.eat_line();
-                    continue;
-                }
-            }
-            else if (strncmp(keyword, "usemtl", keyword_length) == 0)
+            // Check whether this material slot has already been defined for this mesh.
+            const map<string, size_t>::const_iterator& it =
+                m_material_slots.find(material_slot_name);
+
+            if (it != m_material_slots.end())
             {
-                parse_usemtl_statement();
+                // It has: just make it the active material slot.
+                m_current_material_slot_index = it->second;
             }
             else
             {
-                // Ignore unknown or unhandled statements.
-                m_lexer.eat_line();
-                continue;
+                // It hasn't: insert it into the mesh and make it the active material slot.
+                m_current_material_slot_index = m_builder.push_material_slot(material_slot_name.c_str());
+                m_material_slots.insert(make_pair(material_slot_name, m_current_material_slot_index));
             }
-
-            m_lexer.eat_blanks();
-            m_lexer.accept_newline();
         }
 
-        // End the definition of the last object.
-        if (m_inside_mesh_def)
-            m_builder.end_mesh();
-    }
+        // Insert a well-formed face into the mesh. The index vectors are modified.
+        void insert_face(
+            vector<size_t>&     face_vertex_indices,
+            vector<size_t>&     face_tex_coord_indices,
+            vector<size_t>&     face_normal_indices)
+        {
+            // Begin a mesh definition if we're not already inside one.
+            ensure_mesh_def();
 
-    void parse_f_statement()
-    {
-        clear_keep_memory(m_face_vertex_indices);
-        clear_keep_memory(m_face_tex_coord_indices);
-        clear_keep_memory(m_face_normal_indices);
+            // Insert the features into the mesh, updating index mappings as necessary.
+            insert_vertices_into_mesh(face_vertex_indices);
+            insert_vertex_normals_into_mesh(face_normal_indices);
+            insert_tex_coords_into_mesh(face_tex_coord_indices);
+
+            // Translate feature indices from internal space to mesh space.
+            translate_indices(face_vertex_indices, m_vertex_index_mapping);
+            translate_indices(face_normal_indices, m_normal_index_mapping);
+            translate_indices(face_tex_coord_indices, m_tex_coord_index_mapping);
+
+            const size_t n = face_vertex_indices.size();
+
+            // Begin defining a new face.
+            m_builder.begin_face(n);
+
+            // Set face vertices.
+            m_builder.set_face_vertices(&face_vertex_indices.front());
+
+            // Set face vertex normals (if any).
+            if (face_normal_indices.size() == n)
+                m_builder.set_face_vertex_normals(&face_normal_indices.front());
+
+            // Set face vertex texture coordinates (if any).
+            if (face_tex_coord_indices.size() == n)
+                m_builder.set_face_vertex_tex_coords(&face_tex_coord_indices.front());
+
+            // Set face material.
+            m_builder.set_face_material(m_current_material_slot_index);
+
+            // End defining the face.
+            m_builder.end_face();
+        }
 
-        while (true)
+        void end()
         {
-            m_lexer.eat_blanks();
+            // End the definition of the last object.
+            if (m_inside_mesh_def)
+                m_builder.end_mesh();
+        }
+
+      private:
+        IMeshBuilder&           m_builder;
 
-            if (m_lexer.is_eol())
-                break;
+        // Current state.
+        bool                    m_inside_mesh_def;              // currently inside a mesh definition?
+        string                  m_current_mesh_name;            // name of the current mesh
+        map<string, size_t>     m_material_slots;               // material slots for the current mesh
+        size_t                  m_current_material_slot_index;  // index of the current material slot
 
-            //
-            // Recognized (epsilon)
-            // Accept n
-            //
+        // Mappings between internal indices and mesh indices.
+        vector<size_t>          m_vertex_index_mapping;
+        vector<size_t>          m_tex_coord_index_mapping;
+        vector<size_t>          m_normal_index_mapping;
 
+        void insert_vertices_into_mesh(const vector<size_t>& face_vertex_indices)
+        {
+            const size_t face_vertex_index_count = face_vertex_indices.size();
+
+            for (size_t i = 0; i < face_vertex_index_count; ++i)
             {
-                const long n = m_lexer.accept_long();
-                const size_t v = fix_index(n, m_vertices.size());
-                m_face_vertex_indices.push_back(v);
+                const size_t vertex_index = face_vertex_indices[i];
+                ensure_minimum_size(m_vertex_index_mapping, vertex_index + 1, Undefined);
+                if (m_vertex_index_mapping[vertex_index] == Undefined)
+                    m_vertex_index_mapping[vertex_index] = m_builder.push_vertex(m_vertices[vertex_index]);
             }
+        }
 
-            //
-            // Recognized n
-            // Accept (epsilon), /
-            //
+        void insert_vertex_normals_into_mesh(const vector<size_t>& face_normal_indices)
+        {
+            const size_t face_normal_index_count = face_normal_indices.size();
 
+            for (size_t i = 0; i < face_normal_index_count; ++i)
             {
-                const unsigned char c = m_lexer.get_char();
-                if (m_lexer.is_space(c))
-                    continue;
-                else if (c == '/')
-                    m_lexer.next_char();
-                else parse_error();
+                const size_t normal_index = face_normal_indices[i];
+                ensure_minimum_size(m_normal_index_mapping, normal_index + 1, Undefined);
+                if (m_normal_index_mapping[normal_index] == Undefined)
+                    m_normal_index_mapping[normal_index] = m_builder.push_vertex_normal(m_normals[normal_index]);
             }
+        }
 
-            //
-            // Recognized n/
-            // Accept /, n
-            //
+        void insert_tex_coords_into_mesh(const vector<size_t>& face_tex_coord_indices)
+        {
+            const size_t face_tex_coord_index_count = face_tex_coord_indices.size();
 
+            for (size_t i = 0; i < face_tex_coord_index_count; ++i)
             {
-                const unsigned char c = m_lexer.get_char();
-                if (c == '/')
-                {
-                    m_lexer.next_char();
-                    goto skip;
-                }
-                else
-                {
-                    const long n = m_lexer.accept_long();
-                    const size_t vt = fix_index(n, m_tex_coords.size());
-                    m_face_tex_coord_indices.push_back(vt);
-                }
+                const size_t tex_coord_index = face_tex_coord_indices[i];
+                ensure_minimum_size(m_tex_coord_index_mapping, tex_coord_index + 1, Undefined);
+                if (m_tex_coord_index_mapping[tex_coord_index] == Undefined)
+                    m_tex_coord_index_mapping[tex_coord_index] = m_builder.push_tex_coords(m_tex_coords[tex_coord_index]);
             }
+        }
+
+        static void translate_indices(
+            vector<size_t>&         indices,
+            const vector<size_t>&   mapping)
+        {
+            const size_t count = indices.size();
 
-            //
-            // Recognized n/n
-            // Accept (epsilon), /
-            //
+            for (size_t i = 0; i < count; ++i)
+                indices[i] = mapping[indices[i]];
+        }
 
+        void ensure_mesh_def()
+        {
+            if (!m_inside_mesh_def)
             {
-                const unsigned char c = m_lexer.get_char();
-                if (m_lexer.is_space(c))
-                    continue;
-                else if (c == '/')
-                    m_lexer.next_char();
-                else parse_error();
+                // Begin the definition of the new mesh.
+                m_builder.begin_mesh(m_current_mesh_name.c_str());
+                m_inside_mesh_def = true;
+
+                // Clear material slot definitions.
+                m_material_slots.clear();
+                m_current_material_slot_index = 0;
             }
+        }
+    };
+
+
+    //
+    // Parses OBJ statements from a lexer and forwards them to a handler.
+    //
+    // The Handler type must provide the following methods:
+    //
+    //   size_t get_vertex_count() const;
+    //   size_t get_tex_coord_count() const;
+    //   size_t get_normal_count() const;
+    //   void push_vertex(const Vector3d& v);
+    //   void push_tex_coords(const Vector2d& v);
+    //   void push_normal(const Vector3d& n);
+    //   void begin_object_or_group(const string& name);
+    //   void use_material(const string& name);
+    //   void insert_face(vector<size_t>& vertex_indices, vector<size_t>& tex_coord_indices, vector<size_t>& normal_indices);
+    //
+
+    template <typename Handler>
+    class OBJParser
+      : public NonCopyable
+    {
+      public:
+        // Constructor.
+        OBJParser(
+            const int           options,
+            OBJMeshFileLexer&   lexer,
+            Handler&            handler)
+          : m_options(options)
+          , m_lexer(lexer)
+          , m_handler(handler)
+        {
+        }
 
-          skip:
+        void parse()
+        {
+            while (true)
+            {
+                m_lexer.eat_blanks();
 
-            //
-            // Recognized n//, n/n/
-            // Accept (epsilon), n
-            //
+                // Handle end of file.
+                if (m_lexer.is_eof())
+                    break;
 
-            {
-                const unsigned char c = m_lexer.get_char();
-                if (m_lexer.is_space(c))
+                // Handle empty lines.
+                if (m_lexer.is_eol())
+                {
+                    m_lexer.accept_newline();
                     continue;
+                }
+
+                const char* keyword;
+                size_t keyword_length;
+
+                m_lexer.accept_string(&keyword, &keyword_length);
+
+                if (keyword_length == 1)
+                {
+                    switch (keyword[0])
+                    {
+                      case 'f':
+                        parse_f_statement();
+                        break;
+
+                      case 'g':
+                      case 'o':
+                        parse_o_g_statement();
+                        break;
+
+                      case 'v':
+                        parse_v_statement();
+                        break;
+
+                      default:
+                        // Ignore unknown or unhandled statements.
+                        m_lexer.eat_line();
+                        continue;
+                    }
+                }
+                else if (keyword_length == 2)
+                {
+                    switch (keyword[0] * 256 + keyword[1])
+                    {
+                      case 'v' * 256 + 'n':
+                        parse_vn_statement();
+                        break;
+
+                      case 'v' * 256 + 't':
+                        parse_vt_statement();
+                        break;
+
+                      default:
+                        // Ignore unknown or unhandled statements.
+                        m_lexer.eat_line();
+                        continue;
+                    }
+                }
+                else if (strncmp(keyword, "usemtl", keyword_length) == 0)
+                {
+                    parse_usemtl_statement();
+                }
                 else
                 {
-                    const long n = m_lexer.accept_long();
-                    const size_t vn = fix_index(n, m_normals.size());
-                    m_face_normal_indices.push_back(vn);
+                    // Ignore unknown or unhandled statements.
+                    m_lexer.eat_line();
+                    continue;
                 }
+
+                m_lexer.eat_blanks();
+                m_lexer.accept_newline();
             }
         }
 
-        // Check whether the face is well-formed.
-        const size_t vc = m_face_vertex_indices.size();
-        const size_t tc = m_face_tex_coord_indices.size();
-        const size_t nc = m_face_normal_indices.size();
-        const bool well_formed =
-                vc >= 3
-            && (tc == 0 || tc == vc)
-            && (nc == 0 || nc == vc);
+      private:
+        const int               m_options;
+        OBJMeshFileLexer&       m_lexer;
+        Handler&                m_handler;
+
+        // Temporary vectors for collecting indices while parsing face statements.
+        vector<size_t>          m_face_vertex_indices;
+        vector<size_t>          m_face_tex_coord_indices;
+        vector<size_t>          m_face_normal_indices;
 
-        if (well_formed)
+        // Close the input file and throw an ExceptionParseError exception.
+        void parse_error()
         {
-            // The face is well-formed, insert it into the mesh.
-            insert_face_into_mesh();
+            const size_t line_number = m_lexer.get_line_number();
+
+            m_lexer.close();
+
+            throw OBJMeshFileReader::ExceptionParseError(line_number);
         }
-        else
+
+        void parse_f_statement()
         {
-            // The face is ill-formed, ignore it or abort parsing.
-            if (m_options & StopOnInvalidFaceDef)
-                throw ExceptionInvalidFaceDef(m_lexer.get_line_number());
+            clear_keep_memory(m_face_vertex_indices);
+            clear_keep_memory(m_face_tex_coord_indices);
+            clear_keep_memory(m_face_normal_indices);
+
+            while (true)
+            {
+                m_lexer.eat_blanks();
+
+                if (m_lexer.is_eol())
+                    break;
+
+                //
+                // Recognized (epsilon)
+                // Accept n
+                //
+
+                {
+                    const long n = m_lexer.accept_long();
+                    const size_t v = fix_index(n, m_handler.get_vertex_count());
+                    m_face_vertex_indices.push_back(v);
+                }
+
+                //
+                // Recognized n
+                // Accept (epsilon), /
+                //
+
+                {
+                    const unsigned char c = m_lexer.get_char();
+                    if (m_lexer.is_space(c))
+                        continue;
+                    else if (c == '/')
+                        m_lexer.next_char();
+                    else parse_error();
+                }
+
+                //
+                // Recognized n/
+                // Accept /, n
+                //
+
+                {
+                    const unsigned char c = m_lexer.get_char();
+                    if (c == '/')
+                    {
+                        m_lexer.next_char();
+                        goto skip;
+                    }
+                    else
+                    {
+                        const long n = m_lexer.accept_long();
+                        const size_t vt = fix_index(n, m_handler.get_tex_coord_count());
+                        m_face_tex_coord_indices.push_back(vt);
+                    }
+                }
+
+                //
+                // Recognized n/n
+                // Accept (epsilon), /
+                //
+
+                {
+                    const unsigned char c = m_lexer.get_char();
+                    if (m_lexer.is_space(c))
+                        continue;
+                    else if (c == '/')
+                        m_lexer.next_char();
+                    else parse_error();
+                }
+
+              skip:
+
+                //
+                // Recognized n//, n/n/
+                // Accept (epsilon), n
+                //
+
+                {
+                    const unsigned char c = m_lexer.get_char();
+                    if (m_lexer.is_space(c))
+                        continue;
+                    else
+                    {
+                        const long n = m_lexer.accept_long();
+                        const size_t vn = fix_index(n, m_handler.get_normal_count());
+                        m_face_normal_indices.push_back(vn);
+                    }
+                }
+            }
+
+            // Check whether the face is well-formed.
+            const size_t vc = m_face_vertex_indices.size();
+            const size_t tc = m_face_tex_coord_indices.size();
+            const size_t nc = m_face_normal_indices.size();
+            const bool well_formed =
+                    vc >= 3
+                && (tc == 0 || tc == vc)
+                && (nc == 0 || nc == vc);
+
+            if (well_formed)
+            {
+                // The face is well-formed, insert it into the mesh.
+                m_handler.insert_face(
+                    m_face_vertex_indices,
+                    m_face_tex_coord_indices,
+                    m_face_normal_indices);
+            }
+            else
+            {
+                // The face is ill-formed, ignore it or abort parsing.
+                if (m_options & OBJMeshFileReader::StopOnInvalidFaceDef)
+                    throw OBJMeshFileReader::ExceptionInvalidFaceDef(m_lexer.get_line_number());
+            }
         }
-    }
 
-    // Convert 1-based indices (including negative indices) to 0-based indices.
-    size_t fix_index(const long index, const size_t count)
-    {
-        if (index > 0)
+        // Convert 1-based indices (including negative indices) to 0-based indices.
+        size_t fix_index(const long index, const size_t count)
         {
-            const size_t i = static_cast<size_t>(index);
-            if (i > count)
+            if (index > 0)
+            {
+                const size_t i = static_cast<size_t>(index);
+                if (i > count)
+                    parse_error();
+                return i - 1;
+            }
+            else if (index < 0)
+            {
+                const size_t i = static_cast<size_t>(-index);
+                if (i > count)
+                    parse_error();
+                return count - i;
+            }
+            else
+            {
                 parse_error();
-            return i - 1;
+                return 0;       // keep the compiler happy
+            }
         }
-        else if (index < 0)
+
+        void parse_o_g_statement()
         {
-            const size_t i = static_cast<size_t>(-index);
-            if (i > count)
-                parse_error();
-            return count - i;
+            // Retrieve the name of the upcoming mesh.
+            m_handler.begin_object_or_group(parse_compound_identifier());
         }
-        else
+
+        string parse_compound_identifier()
         {
-            parse_error();
-            return 0;       // keep the compiler happy
-        }
-    }
+            string identifier;
 
-    void insert_face_into_mesh()
-    {
-        // Begin a mesh definition if we're not already inside one.
-        ensure_mesh_def();
+            m_lexer.eat_blanks();
 
-        // Insert the features into the mesh, updating index mappings as necessary.
-        insert_vertices_into_mesh();
-        insert_vertex_normals_into_mesh();
-        insert_tex_coords_into_mesh();
+            while (!m_lexer.is_eol())
+            {
+                const char* token;
+                size_t token_length;
 
-        // Translate feature indices from internal space to mesh space.
-        translate_indices(m_face_vertex_indices, m_vertex_index_mapping);
-        translate_indices(m_face_normal_indices, m_normal_index_mapping);
-        translate_indices(m_face_tex_coord_indices, m_tex_coord_index_mapping);
+                m_lexer.accept_string(&token, &token_length);
+                m_lexer.eat_blanks();
 
-        const size_t n = m_face_vertex_indices.size();
+                if (!identifier.empty())
+                    identifier += ' ';
 
-        // Begin defining a new face.
-        m_builder.begin_face(n); 
+                identifier.append(token, token_length);
+            }
 
-        // Set face vertices.
-        m_builder.set_face_vertices(&m_face_vertex_indices.front());
+            return identifier;
+        }
 
-        // Set face vertex normals (if any).
-        if (m_face_normal_indices.size() == n)
-            m_builder.set_face_vertex_normals(&m_face_normal_indices.front());
+        void parse_v_statement()
+        {
+            Vector3d v;
 
-        // Set face vertex texture coordinates (if any).
-        if (m_face_tex_coord_indices.size() == n)
-            m_builder.set_face_vertex_tex_coords(&m_face_tex_coord_indices.front());
+            m_lexer.eat_blanks();
+            v.x = m_lexer.accept_double();
 
-        // Set face material.
-        m_builder.set_face_material(m_current_material_slot_index);
+            m_lexer.eat_blanks();
+            v.y = m_lexer.accept_double();
 
-        // End defining the face.
-        m_builder.end_face();
-    }
+            m_lexer.eat_blanks();
+            v.z = m_lexer.accept_double();
 
-    void insert_vertices_into_mesh()
-    {
-        const size_t face_vertex_index_count = m_face_vertex_indices.size();
+            m_lexer.eat_blanks();
 
-        for (size_t i = 0; i < face_vertex_index_count; ++i)
-        {
-            const size_t vertex_index = m_face_vertex_indices[i];
-            ensure_minimum_size(m_vertex_index_mapping, vertex_index + 1, Undefined);
-            if (m_vertex_index_mapping[vertex_index] == Undefined)
-                m_vertex_index_mapping[vertex_index] = m_builder.push_vertex(m_vertices[vertex_index]);
+            if (!m_lexer.is_eol())
+                m_lexer.accept_double();
+
+            m_handler.push_vertex(v);
         }
-    }
 
-    void insert_vertex_normals_into_mesh()
-    {
-        const size_t face_normal_index_count = m_face_normal_indices.size();
+        void parse_vt_statement()
+        {
+            Vector2d v;
+
+            m_lexer.eat_blanks();
+            v.x = m_lexer.accept_double();
+
+            m_lexer.eat_blanks();
+            v.y = m_lexer.accept_double();
 
-        for (size_t i = 0; i < face_normal_index_count; ++i)
+            m_lexer.eat_blanks();
+
+            if (!m_lexer.is_eol())
+                m_lexer.accept_double();
+
+            m_handler.push_tex_coords(v);
+        }
+
+        void parse_vn_statement()
         {
-            const size_t normal_index = m_face_normal_indices[i];
-            ensure_minimum_size(m_normal_index_mapping, normal_index + 1, Undefined);
-            if (m_normal_index_mapping[normal_index] == Undefined)
-                m_normal_index_mapping[normal_index] = m_builder.push_vertex_normal(m_normals[normal_index]);
+            Vector3d n;
+
+            m_lexer.eat_blanks();
+            n.x = m_lexer.accept_double();
+
+            m_lexer.eat_blanks();
+            n.y = m_lexer.accept_double();
+
+            m_lexer.eat_blanks();
+            n.z = m_lexer.accept_double();
+
+            m_handler.push_normal(n);
         }
-    }
 
-    void insert_tex_coords_into_mesh()
+        void parse_usemtl_statement()
+        {
+            // Retrieve the name of the material slot.
+            m_handler.use_material(parse_compound_identifier());
+        }
+    };
+
+
+    //
+    // Parallel parsing.
+    //
+    // The memory-mapped file is split at line boundaries into chunks. A first parallel
+    // pass counts the features defined in each chunk, which gives the position in the
+    // file of the first vertex, texture coordinate, normal and line of every chunk.
+    // A second parallel pass then parses the chunks: features are written in place in
+    // the feature arrays of the mesh feeder, and faces, objects, groups and material
+    // slots are recorded with indices that are already file-global. Recorded statements
+    // are finally replayed in order into the mesh builder by the calling thread, which
+    // overlaps with the parsing of the next batch of chunks.
+    //
+
+    const size_t MinChunkSize = 64 * 1024;          // in bytes
+    const size_t MaxChunkSize = 4 * 1024 * 1024;    // in bytes
+    const size_t ChunksPerThread = 4;
+
+    struct Chunk
     {
-        const size_t face_tex_coord_index_count = m_face_tex_coord_indices.size();
+        enum StatementType
+        {
+            FaceStatement           = 0,
+            FaceHasTexCoords        = 1 << 0,       // flag for face statements
+            FaceHasNormals          = 1 << 1,       // flag for face statements
+            ObjectOrGroupStatement  = 1 << 2,
+            UseMaterialStatement    = 1 << 3
+        };
+
+        enum Error
+        {
+            NoError,
+            ParseError,
+            InvalidFaceDefError
+        };
+
+        // Range of lines of this chunk.
+        const char*             m_begin;
+        const char*             m_end;
+
+        // Number of features and lines in this chunk.
+        size_t                  m_vertex_count;
+        size_t                  m_tex_coord_count;
+        size_t                  m_normal_count;
+        size_t                  m_line_count;
+
+        // Position in the file of the first feature and of the first line of this chunk.
+        size_t                  m_vertex_offset;
+        size_t                  m_tex_coord_offset;
+        size_t                  m_normal_offset;
+        size_t                  m_first_line;
+
+        // Statements of this chunk, in order.
+        vector<uint8>           m_statements;
+        vector<size_t>          m_face_sizes;
+        vector<size_t>          m_face_vertex_indices;
+        vector<size_t>          m_face_tex_coord_indices;
+        vector<size_t>          m_face_normal_indices;
+        vector<string>          m_names;
+
+        // Error that occurred while parsing this chunk.
+        Error                   m_error;
+        size_t                  m_error_line;
+
+        Chunk(const char* begin, const char* end)
+          : m_begin(begin)
+          , m_end(end)
+          , m_vertex_count(0)
+          , m_tex_coord_count(0)
+          , m_normal_count(0)
+          , m_line_count(0)
+          , m_vertex_offset(0)
+          , m_tex_coord_offset(0)
+          , m_normal_offset(0)
+          , m_first_line(1)
+          , m_error(NoError)
+          , m_error_line(0)
+        {
+        }
 
-        for (size_t i = 0; i < face_tex_coord_index_count; ++i)
+        void clear_statements()
         {
-            const size_t tex_coord_index = m_face_tex_coord_indices[i];
-            ensure_minimum_size(m_tex_coord_index_mapping, tex_coord_index + 1, Undefined);
-            if (m_tex_coord_index_mapping[tex_coord_index] == Undefined)
-                m_tex_coord_index_mapping[tex_coord_index] = m_builder.push_tex_coords(m_tex_coords[tex_coord_index]);
+            clear_release_memory(m_statements);
+            clear_release_memory(m_face_sizes);
+            clear_release_memory(m_face_vertex_indices);
+            clear_release_memory(m_face_tex_coord_indices);
+            clear_release_memory(m_face_normal_indices);
+            clear_release_memory(m_names);
         }
-    }
+    };
 
-    static void translate_indices(
-        vector<size_t>&         indices,
-        const vector<size_t>&   mapping)
+    OBJMeshFileLexer::ParsingMode get_parsing_mode(const int options)
     {
-        const size_t count = indices.size();
-
-        for (size_t i = 0; i < count; ++i)
-            indices[i] = mapping[indices[i]];
+        return
+            (options & OBJMeshFileReader::FavorSpeedOverPrecision)
+                ? OBJMeshFileLexer::Fast
+                : OBJMeshFileLexer::Precise;
     }
 
-    void parse_o_g_statement()
+    // Count the features and the lines of a chunk.
+    class CountChunkJob
+      : public IJob
     {
-        // Retrieve the name of the upcoming mesh.
-        const string upcoming_mesh_name = parse_compound_identifier();
+      public:
+        CountChunkJob(
+            const int           options,
+            Chunk&              chunk)
+          : m_options(options)
+          , m_chunk(chunk)
+        {
+        }
 
-        // Start a new mesh only if the name of the object or group actually changes.
-        if (upcoming_mesh_name != m_current_mesh_name)
+        virtual void execute(const size_t thread_index)
         {
-            // End the current mesh.
-            if (m_inside_mesh_def)
+            OBJMeshFileLexer lexer(get_parsing_mode(m_options));
+            lexer.open(m_chunk.m_begin, m_chunk.m_end);
+
+            // This must recognize statements exactly like OBJParser::parse() does.
+            while (true)
             {
-                m_builder.end_mesh();
-                m_inside_mesh_def = false;
+                lexer.eat_blanks();
+
+                if (lexer.is_eof())
+                    break;
+
+                if (lexer.is_eol())
+                {
+                    lexer.accept_newline();
+                    continue;
+                }
+
+                const char* keyword;
+                size_t keyword_length;
+
+                lexer.accept_string(&keyword, &keyword_length);
+
+                if (keyword[0] == 'v')
+                {
+                    if (keyword_length == 1)
+                        ++m_chunk.m_vertex_count;
+                    else if (keyword_length == 2 && keyword[1] == 't')
+                        ++m_chunk.m_tex_coord_count;
+                    else if (keyword_length == 2 && keyword[1] == 'n')
+                        ++m_chunk.m_normal_count;
+                }
+
+                lexer.eat_line();
             }
 
-            clear_keep_memory(m_vertex_index_mapping);
-            clear_keep_memory(m_tex_coord_index_mapping);
-            clear_keep_memory(m_normal_index_mapping);
+            // The line count includes the empty line that follows the last newline character.
+            m_chunk.m_line_count = lexer.get_line_number() - 1;
 
-            m_current_mesh_name = upcoming_mesh_name;
+            lexer.close();
         }
-    }
 
-    string parse_compound_identifier()
+      private:
+        const int               m_options;
+        Chunk&                  m_chunk;
+    };
+
+    // Handler that writes features in place and records the other statements of a chunk.
+    class ChunkRecorder
+      : public NonCopyable
     {
-        string identifier;
+      public:
+        ChunkRecorder(
+            MeshFeeder&         feeder,
+            Chunk&              chunk)
+          : m_feeder(feeder)
+          , m_chunk(chunk)
+          , m_vertex_count(0)
+          , m_tex_coord_count(0)
+          , m_normal_count(0)
+        {
+        }
 
-        m_lexer.eat_blanks();
+        size_t get_vertex_count() const
+        {
+            return m_chunk.m_vertex_offset + m_vertex_count;
+        }
 
-        while (!m_lexer.is_eol())
+        size_t get_tex_coord_count() const
         {
-            const char* token;
-            size_t token_length;
+            return m_chunk.m_tex_coord_offset + m_tex_coord_count;
+        }
 
-            m_lexer.accept_string(&token, &token_length);
-            m_lexer.eat_blanks();
+        size_t get_normal_count() const
+        {
+            return m_chunk.m_normal_offset + m_normal_count;
+        }
 
-            if (!identifier.empty())
-                identifier += ' ';
+        void push_vertex(const Vector3d& v)
+        {
+            assert(m_vertex_count < m_chunk.m_vertex_count);
+            m_feeder.m_vertices[get_vertex_count()] = v;
+            ++m_vertex_count;
+        }
 
-            identifier.append(token, token_length);
+        void push_tex_coords(const Vector2d& v)
+        {
+            assert(m_tex_coord_count < m_chunk.m_tex_coord_count);
+            m_feeder.m_tex_coords[get_tex_coord_count()] = v;
+            ++m_tex_coord_count;
         }
 
-        return identifier;
-    }
+        void push_normal(const Vector3d& n)
+        {
+            assert(m_normal_count < m_chunk.m_normal_count);
+            m_feeder.m_normals[get_normal_count()] = n;
+            ++m_normal_count;
+        }
 
-    void parse_v_statement()
-    {
-        Vector3d v;
+        void begin_object_or_group(const string& name)
+        {
+            m_chunk.m_statements.push_back(Chunk::ObjectOrGroupStatement);
+            m_chunk.m_names.push_back(name);
+        }
 
-        m_lexer.eat_blanks();
-        v.x = m_lexer.accept_double();
+        void use_material(const string& name)
+        {
+            m_chunk.m_statements.push_back(Chunk::UseMaterialStatement);
+            m_chunk.m_names.push_back(name);
+        }
 
-        m_lexer.eat_blanks();
-        v.y = m_lexer.accept_double();
+        void insert_face(
+            vector<size_t>&     face_vertex_indices,
+            vector<size_t>&     face_tex_coord_indices,
+            vector<size_t>&     face_normal_indices)
+        {
+            uint8 statement = Chunk::FaceStatement;
 
-        m_lexer.eat_blanks();
-        v.z = m_lexer.accept_double();
+            if (!face_tex_coord_indices.empty())
+                statement |= Chunk::FaceHasTexCoords;
 
-        m_lexer.eat_blanks();
+            if (!face_normal_indices.empty())
+                statement |= Chunk::FaceHasNormals;
 
-        if (!m_lexer.is_eol())
-            m_lexer.accept_double();
+            m_chunk.m_statements.push_back(statement);
+            m_chunk.m_face_sizes.push_back(face_vertex_indices.size());
 
-        m_vertices.push_back(v);
-    }
+            append(m_chunk.m_face_vertex_indices, face_vertex_indices);
+            append(m_chunk.m_face_tex_coord_indices, face_tex_coord_indices);
+            append(m_chunk.m_face_normal_indices, face_normal_indices);
+        }
 
-    void parse_vt_statement()
-    {
-        Vector2d v;
+      private:
+        MeshFeeder&             m_feeder;
+        Chunk&                  m_chunk;
+        size_t                  m_vertex_count;
+        size_t                  m_tex_coord_count;
+        size_t                  m_normal_count;
 
-        m_lexer.eat_blanks();
-        v.x = m_lexer.accept_double();
+        static void append(vector<size_t>& dest, const vector<size_t>& src)
+        {
+            dest.insert(dest.end(), src.begin(), src.end());
+        }
+    };
 
-        m_lexer.eat_blanks();
-        v.y = m_lexer.accept_double();
+    // Parse a chunk whose feature offsets are known.
+    class ParseChunkJob
+      : public IJob
+    {
+      public:
+        ParseChunkJob(
+            const int           options,
+            MeshFeeder&         feeder,
+            Chunk&              chunk)
+          : m_options(options)
+          , m_feeder(feeder)
+          , m_chunk(chunk)
+        {
+        }
 
-        m_lexer.eat_blanks();
+        virtual void execute(const size_t thread_index)
+        {
+            OBJMeshFileLexer lexer(get_parsing_mode(m_options));
+            lexer.open(m_chunk.m_begin, m_chunk.m_end, m_chunk.m_first_line);
 
-        if (!m_lexer.is_eol())
-            m_lexer.accept_double();
+            ChunkRecorder recorder(m_feeder, m_chunk);
+            OBJParser<ChunkRecorder> parser(m_options, lexer, recorder);
 
-        m_tex_coords.push_back(v);
-    }
+            try
+            {
+                parser.parse();
+            }
+            catch (const OBJMeshFileReader::ExceptionInvalidFaceDef& e)
+            {
+                m_chunk.m_error = Chunk::InvalidFaceDefError;
+                m_chunk.m_error_line = e.m_line;
+            }
+            catch (const OBJMeshFileReader::ExceptionParseError& e)
+            {
+                m_chunk.m_error = Chunk::ParseError;
+                m_chunk.m_error_line = e.m_line;
+            }
 
-    void parse_vn_statement()
-    {
-        Vector3d n;
+            lexer.close();
+        }
 
-        m_lexer.eat_blanks();
-        n.x = m_lexer.accept_double();
+      private:
+        const int               m_options;
+        MeshFeeder&             m_feeder;
+        Chunk&                  m_chunk;
+    };
+
+    // Replay the statements of a chunk into the mesh builder. If parsing the chunk failed,
+    // these are the statements that precede the error.
+    void feed_chunk(
+        const Chunk&            chunk,
+        MeshFeeder&             feeder,
+        vector<size_t>&         face_vertex_indices,
+        vector<size_t>&         face_tex_coord_indices,
+        vector<size_t>&         face_normal_indices)
+    {
+        const size_t statement_count = chunk.m_statements.size();
 
-        m_lexer.eat_blanks();
-        n.y = m_lexer.accept_double();
+        size_t face_index = 0;
+        size_t name_index = 0;
+        size_t vertex_index = 0;
+        size_t tex_coord_index = 0;
+        size_t normal_index = 0;
 
-        m_lexer.eat_blanks();
-        n.z = m_lexer.accept_double();
+        for (size_t i = 0; i < statement_count; ++i)
+        {
+            const uint8 statement = chunk.m_statements[i];
 
-        m_normals.push_back(n);
-    }
+            if (statement == Chunk::ObjectOrGroupStatement)
+                feeder.begin_object_or_group(chunk.m_names[name_index++]);
+            else if (statement == Chunk::UseMaterialStatement)
+                feeder.use_material(chunk.m_names[name_index++]);
+            else
+            {
+                const size_t n = chunk.m_face_sizes[face_index++];
 
-    void parse_usemtl_statement()
-    {
-        // Begin a mesh definition if we're not already inside one.
-        ensure_mesh_def();
+                face_vertex_indices.assign(
+                    chunk.m_face_vertex_indices.begin() + vertex_index,
+                    chunk.m_face_vertex_indices.begin() + vertex_index + n);
+                vertex_index += n;
 
-        // Retrieve the name of the material slot.
-        const string material_slot_name = parse_compound_identifier();
+                clear_keep_memory(face_tex_coord_indices);
+                if (statement & Chunk::FaceHasTexCoords)
+                {
+                    face_tex_coord_indices.assign(
+                        chunk.m_face_tex_coord_indices.begin() + tex_coord_index,
+                        chunk.m_face_tex_coord_indices.begin() + tex_coord_index + n);
+                    tex_coord_index += n;
+                }
 
-        // Check whether this material slot has already been defined for this mesh.
-        const map<string, size_t>::const_iterator& it =
-            m_material_slots.find(material_slot_name);
+                clear_keep_memory(face_normal_indices);
+                if (statement & Chunk::FaceHasNormals)
+                {
+                    face_normal_indices.assign(
+                        chunk.m_face_normal_indices.begin() + normal_index,
+                        chunk.m_face_normal_indices.begin() + normal_index + n);
+                    normal_index += n;
+                }
 
-        if (it != m_material_slots.end())
-        {
-            // It has: just make it the active material slot.
-            m_current_material_slot_index = it->second;
+                feeder.insert_face(
+                    face_vertex_indices,
+                    face_tex_coord_indices,
+                    face_normal_indices);
+            }
         }
-        else
+    }
+
+    // Throw the exception corresponding to the error that occurred while parsing a chunk, if any.
+    void check_chunk(const Chunk& chunk)
+    {
+        switch (chunk.m_error)
         {
-            // It hasn't: insert it into the mesh and make it the active material slot.
-            m_current_material_slot_index = m_builder.push_material_slot(material_slot_name.c_str());
-            m_material_slots.insert(make_pair(material_slot_name, m_current_material_slot_index));
+          case Chunk::ParseError:
+            throw OBJMeshFileReader::ExceptionParseError(chunk.m_error_line);
+
+          case Chunk::InvalidFaceDefError:
+            throw OBJMeshFileReader::ExceptionInvalidFaceDef(chunk.m_error_line);
         }
     }
 
-    void ensure_mesh_def()
+    // Split a range of characters at line boundaries into chunks of approximately a given size.
+    void split_into_chunks(
+        const char*             begin,
+        const char*             end,
+        const size_t            chunk_size,
+        vector<Chunk>&          chunks)
     {
-        if (!m_inside_mesh_def)
+        const char* ptr = begin;
+
+        while (ptr < end)
         {
-            // Begin the definition of the new mesh.
-            m_builder.begin_mesh(m_current_mesh_name.c_str());
-            m_inside_mesh_def = true;
+            const char* chunk_end = end;
+
+            if (static_cast<size_t>(end - ptr) > chunk_size)
+            {
+                const char* split = ptr + chunk_size - 1;
+                const char* newline =
+                    static_cast<const char*>(memchr(split, '\n', static_cast<size_t>(end - split)));
+
+                if (newline)
+                    chunk_end = newline + 1;
+            }
 
-            // Clear material slot definitions.
-            m_material_slots.clear();
-            m_current_material_slot_index = 0;
+            chunks.push_back(Chunk(ptr, chunk_end));
+            ptr = chunk_end;
         }
     }
-};
+}
 
 OBJMeshFileReader::OBJMeshFileReader(
     const string&   filename,
-    const int       options)
+    const int       options,
+    const size_t    thread_count)
   : m_filename(filename)
   , m_options(options)
+  , m_thread_count(thread_count)
 {
 }
 
 void OBJMeshFileReader::read(IMeshBuilder& builder)
 {
-    Impl impl(m_options, builder);
+    if (m_options & ParseInParallel)
+    {
+        const size_t thread_count =
+            m_thread_count > 0
+                ? m_thread_count
+                : System::get_logical_cpu_core_count();
+
+        read_parallel(builder, thread_count);
+    }
+    else read_serial(builder);
+}
+
+void OBJMeshFileReader::read_serial(IMeshBuilder& builder)
+{
+    OBJMeshFileLexer lexer(get_parsing_mode(m_options));
 
     // Open the input file.
-    if (!impl.m_lexer.open(m_filename))
+    if (!lexer.open(m_filename))
         throw ExceptionIOError();
 
+    MeshFeeder feeder(builder);
+    OBJParser<MeshFeeder> parser(m_options, lexer, feeder);
+
     // Parse the file.
-    impl.parse_file();
+    parser.parse();
+    feeder.end();
 
     // Close the input file.
-    impl.m_lexer.close();
+    lexer.close();
+}
+
+void OBJMeshFileReader::read_parallel(IMeshBuilder& builder, const size_t thread_count)
+{
+    assert(thread_count > 0);
+
+    boost::system::error_code ec;
+    const uintmax_t file_size = boost::filesystem::file_size(m_filename, ec);
+
+    if (ec)
+        throw ExceptionIOError();
+
+    // Small files are not worth the trouble.
+    if (file_size < 2 * MinChunkSize)
+    {
+        read_serial(builder);
+        return;
+    }
+
+    // Memory-map the input file.
+    interprocess::file_mapping mapping;
+    interprocess::mapped_region region;
+    try
+    {
+        interprocess::file_mapping(m_filename.c_str(), interprocess::read_only).swap(mapping);
+        interprocess::mapped_region(mapping, interprocess::read_only).swap(region);
+    }
+    catch (const interprocess::interprocess_exception&)
+    {
+        throw ExceptionIOError();
+    }
+
+    const char* data = static_cast<const char*>(region.get_address());
+    const size_t data_size = region.get_size();
+
+    // Split the file into chunks.
+    const size_t chunk_size =
+        max(MinChunkSize, min(MaxChunkSize, data_size / (thread_count * ChunksPerThread)));
+    vector<Chunk> chunks;
+    chunks.reserve(data_size / chunk_size + 1);
+    split_into_chunks(data, data + data_size, chunk_size, chunks);
+
+    const size_t chunk_count = chunks.size();
+
+    // The mesh feeder must outlive the job manager.
+    MeshFeeder feeder(builder);
+
+    Logger logger;
+    JobQueue job_queue;
+    JobManager job_manager(
+        logger,
+        job_queue,
+        thread_count,
+        JobManager::KeepRunningOnEmptyQueue);
+    job_manager.start();
+
+    // Count features and lines in all chunks.
+    for (size_t i = 0; i < chunk_count; ++i)
+        job_queue.schedule(new CountChunkJob(m_options, chunks[i]));
+    job_queue.wait_until_completion();
+
+    // Compute the position in the file of the first feature and line of every chunk.
+    size_t vertex_count = 0;
+    size_t tex_coord_count = 0;
+    size_t normal_count = 0;
+    size_t line_count = 0;
+    for (size_t i = 0; i < chunk_count; ++i)
+    {
+        Chunk& chunk = chunks[i];
+        chunk.m_vertex_offset = vertex_count;
+        chunk.m_tex_coord_offset = tex_coord_count;
+        chunk.m_normal_offset = normal_count;
+        chunk.m_first_line = line_count + 1;
+        vertex_count += chunk.m_vertex_count;
+        tex_coord_count += chunk.m_tex_coord_count;
+        normal_count += chunk.m_normal_count;
+        line_count += chunk.m_line_count;
+    }
+
+    feeder.m_vertices.resize(vertex_count);
+    feeder.m_tex_coords.resize(tex_coord_count);
+    feeder.m_normals.resize(normal_count);
+
+    // Temporary vectors for replaying face statements.
+    vector<size_t> face_vertex_indices;
+    vector<size_t> face_tex_coord_indices;
+    vector<size_t> face_normal_indices;
+
+    // Parse chunks in batches, feeding the mesh builder with a batch while the next one is being parsed.
+    const size_t batch_size = thread_count;
+    size_t batch_begin = 0;
+    size_t batch_end = min(batch_size, chunk_count);
+
+    for (size_t i = batch_begin; i < batch_end; ++i)
+        job_queue.schedule(new ParseChunkJob(m_options, feeder, chunks[i]));
+    job_queue.wait_until_completion();
+
+    while (batch_begin < chunk_count)
+    {
+        const size_t next_batch_end = min(batch_end + batch_size, chunk_count);
+
+        for (size_t i = batch_end; i < next_batch_end; ++i)
+            job_queue.schedule(new ParseChunkJob(m_options, feeder, chunks[i]));
+
+        for (size_t i = batch_begin; i < batch_end; ++i)
+        {
+            // Like the serial reader, feed the statements that precede an error before reporting it.
+            feed_chunk(
+                chunks[i],
+                feeder,
+                face_vertex_indices,
+                face_tex_coord_indices,
+                face_normal_indices);
+
+            check_chunk(chunks[i]);
+
+            chunks[i].clear_statements();
+        }
+
+        job_queue.wait_until_completion();
+
+        batch_begin = batch_end;
+        batch_end = next_batch_end;
+    }
+
+    feeder.end();
 }
 
 }   // namespace foundation
@@ -83,22 +83,26 @@ class OBJMeshFileReader
     {
         Default                 = 0,            // none of the flags below
         FavorSpeedOverPrecision = 1 << 0,       // use approximate algorithm for parsing floating-point values
-        StopOnInvalidFaceDef    = 1 << 1        // stop parsing on invalid face definitions
+        StopOnInvalidFaceDef    = 1 << 1,       // stop parsing on invalid face definitions
+        ParseInParallel         = 1 << 2        // memory-map the file and parse chunks of lines in parallel
     };
 
     // Constructor.
     OBJMeshFileReader(
         const std::string&  filename,
-        const int           options = Default);
+        const int           options = Default,
+        const size_t        thread_count = 0);  // number of parsing threads, 0 to use all logical cores
 
     // Read a mesh.
     virtual void read(IMeshBuilder& builder) OVERRIDE;
 
   private:
-    struct Impl;
-
     const std::string       m_filename;
     const int               m_options;
+    const size_t            m_thread_count;
+
+    void read_serial(IMeshBuilder& builder);
+    void read_parallel(IMeshBuilder& builder, const size_t thread_count);
 };
 
 }       // namespace foundation
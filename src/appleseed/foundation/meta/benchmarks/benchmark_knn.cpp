@@ -30,12 +30,15 @@
 // appleseed.foundation headers.
 #include "foundation/math/knn.h"
 #include "foundation/math/rng.h"
+#include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/system.h"
 #include "foundation/platform/timer.h"
 #include "foundation/platform/types.h"
 #include "foundation/utility/autoreleaseptr.h"
 #include "foundation/utility/benchmark.h"
 #include "foundation/utility/bufferedfile.h"
+#include "foundation/utility/job.h"
 #include "foundation/utility/log.h"
 #include "foundation/utility/statistics.h"
 #include "foundation/utility/string.h"
@@ -279,3 +282,124 @@ BENCHMARK_SUITE(Foundation_Math_Knn_Query)
     BENCHMARK_CASE_F(PhotonMap_K100, PhotonMapFixture<100>)  { run_queries(); }
     BENCHMARK_CASE_F(PhotonMap_K500, PhotonMapFixture<500>)  { run_queries(); }
 }
+
+BENCHMARK_SUITE(Foundation_Math_Knn_Builder)
+{
+    const size_t PointCount = 100000;
+
+    struct Fixture
+    {
+        vector<Vector3f>    m_points;
+        Logger              m_logger;
+        JobQueue            m_job_queue;
+        JobManager          m_job_manager;
+
+        Fixture()
+          : m_job_manager(
+                m_logger,
+                m_job_queue,
+                System::get_logical_cpu_core_count(),
+                JobManager::KeepRunningOnEmptyQueue)
+        {
+            MersenneTwister rng;
+
+            m_points.resize(PointCount);
+
+            for (size_t i = 0; i < PointCount; ++i)
+                m_points[i] = Vector3f(rand_float1(rng), rand_float1(rng), rand_float1(rng));
+
+            m_job_manager.start();
+        }
+
+        void build_tree_serially()
+        {
+            vector<Vector3f> points(m_points);
+            knn::Tree3f tree;
+            knn::Builder3f builder(tree);
+            builder.build_move_points<DefaultWallclockTimer>(points);
+        }
+
+        void build_tree_in_parallel()
+        {
+            vector<Vector3f> points(m_points);
+            knn::Tree3f tree;
+            knn::Builder3f builder(tree);
+            builder.build_move_points<DefaultWallclockTimer>(points, m_job_queue);
+        }
+
+        void build_grid()
+        {
+            vector<Vector3f> points(m_points);
+            knn::Grid3f grid;
+            knn::GridBuilder3f builder(grid);
+            builder.build_move_points<DefaultWallclockTimer>(points, 0.1f);
+        }
+    };
+
+    BENCHMARK_CASE_F(BuildTree_Serial, Fixture)             { build_tree_serially(); }
+    BENCHMARK_CASE_F(BuildTree_Parallel, Fixture)           { build_tree_in_parallel(); }
+    BENCHMARK_CASE_F(BuildGrid, Fixture)                    { build_grid(); }
+}
+
+BENCHMARK_SUITE(Foundation_Math_Knn_FixedRadiusQuery)
+{
+    const size_t PointCount = 100000;
+    const size_t QueryCount = 100;
+    const size_t AnswerSize = 100;
+    const float QueryRadius = 0.05f;       // about 50 points per query
+
+    struct Fixture
+    {
+        vector<Vector3f>    m_query_points;
+        knn::Tree3f         m_tree;
+        knn::Grid3f         m_grid;
+        knn::Answer<float>  m_answer;
+        size_t              m_accumulator;
+
+        Fixture()
+          : m_answer(AnswerSize)
+          , m_accumulator(0)
+        {
+            MersenneTwister rng;
+
+            vector<Vector3f> points(PointCount);
+            for (size_t i = 0; i < PointCount; ++i)
+                points[i] = Vector3f(rand_float1(rng), rand_float1(rng), rand_float1(rng));
+
+            knn::Builder3f tree_builder(m_tree);
+            tree_builder.build<DefaultWallclockTimer>(&points[0], PointCount);
+
+            knn::GridBuilder3f grid_builder(m_grid);
+            grid_builder.build_move_points<DefaultWallclockTimer>(points, 2.0f * QueryRadius);
+
+            m_query_points.resize(QueryCount);
+            for (size_t i = 0; i < QueryCount; ++i)
+                m_query_points[i] = Vector3f(rand_float1(rng), rand_float1(rng), rand_float1(rng));
+        }
+
+        void run_tree_queries()
+        {
+            knn::Query3f query(m_tree, m_answer);
+
+            for (size_t i = 0; i < QueryCount; ++i)
+            {
+                query.run(m_query_points[i], square(QueryRadius));
+                m_accumulator += m_answer.size();
+            }
+        }
+
+        void run_grid_queries()
+        {
+            knn::GridQuery3f query(m_grid, m_answer);
+
+            for (size_t i = 0; i < QueryCount; ++i)
+            {
+                query.run(m_query_points[i], square(QueryRadius));
+                m_accumulator += m_answer.size();
+            }
+        }
+    };
+
+    BENCHMARK_CASE_F(Tree, Fixture)                         { run_tree_queries(); }
+    BENCHMARK_CASE_F(Grid, Fixture)                         { run_grid_queries(); }
+}
@@ -28,10 +28,21 @@
 //
 
 // appleseed.foundation headers.
+#include "foundation/image/filteredtile.h"
+#include "foundation/math/aabb.h"
 #include "foundation/math/filter.h"
+#include "foundation/math/qmc.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
 #include "foundation/utility/benchmark.h"
 
+// Standard headers.
+#include <cmath>
+#include <cstddef>
+
 using namespace foundation;
+using namespace std;
 
 BENCHMARK_SUITE(Foundation_Math_Filter_BoxFilter2)
 {
@@ -113,3 +124,114 @@ BENCHMARK_SUITE(Foundation_Math_Filter_MitchellFilter2)
         }
     }
 }
+
+BENCHMARK_SUITE(Foundation_Math_Filter_TabulatedFilter2)
+{
+    struct Fixture
+    {
+        MitchellFilter2<float>      m_filter;
+        TabulatedFilter2<float>     m_tabulated_filter;
+        float                       m_dummy;
+
+        Fixture()
+          : m_filter(2.0f, 2.0f, 1.0f / 3, 1.0f / 3)
+          , m_tabulated_filter(m_filter)
+        {
+        }
+    };
+
+    BENCHMARK_CASE_F(Evaluate, Fixture)
+    {
+        m_dummy = 0.0f;
+
+        for (int y = -2; y <= +2; ++y)
+        {
+            for (int x = -2; x <= +2; ++x)
+            {
+                m_dummy += m_tabulated_filter.evaluate(static_cast<float>(x), static_cast<float>(y));
+            }
+        }
+    }
+}
+
+BENCHMARK_SUITE(Foundation_Math_Filter_Splatting)
+{
+    //
+    // Compares the filtered accumulation of FilteredTile against a straightforward
+    // implementation evaluating the filter through its virtual interface at every pixel.
+    //
+
+    const size_t TileSize = 32;
+    const size_t ChannelCount = 16;     // main image plus three AOVs, all RGBA
+    const size_t SampleCount = 256;
+
+    void add_reference(
+        FilteredTile&       tile,
+        const Filter2d&     filter,
+        const double        x,
+        const double        y,
+        const float*        values)
+    {
+        const double dx = x - 0.5;
+        const double dy = y - 0.5;
+
+        AABB2i footprint;
+        footprint.min.x = truncate<int>(ceil(dx - filter.get_xradius()));
+        footprint.min.y = truncate<int>(ceil(dy - filter.get_yradius()));
+        footprint.max.x = truncate<int>(floor(dx + filter.get_xradius()));
+        footprint.max.y = truncate<int>(floor(dy + filter.get_yradius()));
+        footprint = AABB2i::intersect(footprint, tile.get_crop_window());
+
+        for (int ry = footprint.min.y; ry <= footprint.max.y; ++ry)
+        {
+            for (int rx = footprint.min.x; rx <= footprint.max.x; ++rx)
+            {
+                const float weight = static_cast<float>(filter.evaluate(rx - dx, ry - dy));
+
+                float* RESTRICT ptr = tile.pixel(rx, ry);
+
+                *ptr++ += weight;
+
+                for (size_t i = 0; i < ChannelCount; ++i)
+                    ptr[i] += values[i] * weight;
+            }
+        }
+    }
+
+    struct Fixture
+    {
+        MitchellFilter2<double>     m_filter;
+        FilteredTile                m_tile;
+        Vector2d                    m_positions[SampleCount];
+        float                       m_values[ChannelCount];
+
+        Fixture()
+          : m_filter(2.0, 2.0, 1.0 / 3, 1.0 / 3)
+          , m_tile(TileSize, TileSize, ChannelCount, m_filter)
+        {
+            m_tile.clear();
+
+            for (size_t i = 0; i < SampleCount; ++i)
+            {
+                // Deterministic, well-distributed positions over the tile.
+                m_positions[i].x = TileSize * radical_inverse_base2<double>(i);
+                m_positions[i].y = TileSize * (i + 0.5) / SampleCount;
+            }
+
+            for (size_t i = 0; i < ChannelCount; ++i)
+                m_values[i] = static_cast<float>(i + 1);
+        }
+    };
+
+    BENCHMARK_CASE_F(VirtualEvaluation, Fixture)
+    {
+        for (size_t i = 0; i < SampleCount; ++i)
+            add_reference(m_tile, m_filter, m_positions[i].x, m_positions[i].y, m_values);
+    }
+
+    BENCHMARK_CASE_F(TabulatedSeparableSplatting, Fixture)
+    {
+        for (size_t i = 0; i < SampleCount; ++i)
+            m_tile.add(m_positions[i].x, m_positions[i].y, m_values);
+    }
+}
@@ -0,0 +1,136 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+// appleseed.foundation headers.
+#include "foundation/mesh/meshbuilderbase.h"
+#include "foundation/mesh/objmeshfilereader.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/benchmark.h"
+
+// Standard headers.
+#include <cstddef>
+#include <cstdio>
+
+using namespace foundation;
+using namespace std;
+
+BENCHMARK_SUITE(Foundation_Mesh_OBJMeshFileReader)
+{
+    const char* Filepath = "unit benchmarks/outputs/benchmark_objmeshfilereader_grid.obj";
+
+    void write_grid_mesh_file(const char* filepath, const size_t resolution)
+    {
+        FILE* file = fopen(filepath, "wt");
+
+        if (file == 0)
+            return;
+
+        const double rcp_resolution = 1.0 / resolution;
+
+        for (size_t y = 0; y < resolution; ++y)
+        {
+            for (size_t x = 0; x < resolution; ++x)
+            {
+                fprintf(file, "v %f %f %f\n", x * rcp_resolution, y * rcp_resolution, 0.0);
+                fprintf(file, "vt %f %f\n", x * rcp_resolution, y * rcp_resolution);
+                fprintf(file, "vn %f %f %f\n", 0.0, 0.0, 1.0);
+            }
+        }
+
+        const size_t r = resolution;
+
+        for (size_t y = 0; y < resolution - 1; ++y)
+        {
+            for (size_t x = 0; x < resolution - 1; ++x)
+            {
+                const size_t i = y * r + x + 1;
+                const size_t j = i + 1;
+                const size_t k = i + r + 1;
+                const size_t l = i + r;
+
+                fprintf(
+                    file,
+                    "f " FMT_SIZE_T "/" FMT_SIZE_T "/" FMT_SIZE_T
+                    " " FMT_SIZE_T "/" FMT_SIZE_T "/" FMT_SIZE_T
+                    " " FMT_SIZE_T "/" FMT_SIZE_T "/" FMT_SIZE_T
+                    " " FMT_SIZE_T "/" FMT_SIZE_T "/" FMT_SIZE_T "\n",
+                    i, i, i, j, j, j, k, k, k, l, l, l);
+            }
+        }
+
+        fclose(file);
+    }
+
+    struct Fixture
+    {
+        MeshBuilderBase m_builder;
+
+        Fixture()
+        {
+            // About 28 MB of OBJ data.
+            write_grid_mesh_file(Filepath, 500);
+        }
+
+        void read(const int options, const size_t thread_count)
+        {
+            OBJMeshFileReader reader(
+                Filepath,
+                OBJMeshFileReader::FavorSpeedOverPrecision | options,
+                thread_count);
+
+            reader.read(m_builder);
+        }
+    };
+
+    BENCHMARK_CASE_F(SerialParsing, Fixture)
+    {
+        read(OBJMeshFileReader::Default, 1);
+    }
+
+    BENCHMARK_CASE_F(ParallelParsing_1Thread, Fixture)
+    {
+        read(OBJMeshFileReader::ParseInParallel, 1);
+    }
+
+    BENCHMARK_CASE_F(ParallelParsing_2Threads, Fixture)
+    {
+        read(OBJMeshFileReader::ParseInParallel, 2);
+    }
+
+    BENCHMARK_CASE_F(ParallelParsing_4Threads, Fixture)
+    {
+        read(OBJMeshFileReader::ParseInParallel, 4);
+    }
+
+    BENCHMARK_CASE_F(ParallelParsing_8Threads, Fixture)
+    {
+        read(OBJMeshFileReader::ParseInParallel, 8);
+    }
+}
@@ -28,10 +28,12 @@
 //
 
 // appleseed.foundation headers.
+#include "foundation/math/hash.h"
 #include "foundation/math/permutation.h"
 #include "foundation/math/primes.h"
 #include "foundation/math/qmc.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/benchmark.h"
 
 // Standard headers.
@@ -145,6 +147,35 @@ BENCHMARK_SUITE(Foundation_Math_QMC)
             for (size_t i = 0; i < 64; ++i)
                 m_x += hammersley_sequence<T, 2>(Bases, i, 64);
         }
+
+        void sobol_payload()
+        {
+            m_x = Vector<T, 2>(0.0f);
+
+            for (uint32 i = 0; i < 64; ++i)
+                m_x += sobol_02_sequence<T>(0x9E3779B9UL, i);
+        }
+
+        void high_dimension_halton_payload()
+        {
+            // Dimensions 64 and 65 of a Faure-scrambled Halton sequence.
+            m_x = Vector<T, 2>(0.0f);
+
+            for (size_t i = 0; i < 64; ++i)
+            {
+                m_x[0] += fast_permuted_radical_inverse<T>(64, FaurePermutations[64], i);
+                m_x[1] += fast_permuted_radical_inverse<T>(65, FaurePermutations[65], i);
+            }
+        }
+
+        void high_dimension_sobol_payload()
+        {
+            // Dimensions 64 and 65 of a padded Owen-scrambled Sobol sequence.
+            m_x = Vector<T, 2>(0.0f);
+
+            for (uint32 i = 0; i < 64; ++i)
+                m_x += sobol_02_sequence<T>(mix_uint32(0x9E3779B9UL, 64), i);
+        }
     };
 
     // Radical inverse, single precision.
@@ -224,4 +255,28 @@ BENCHMARK_SUITE(Foundation_Math_QMC)
     {
         hammersley_payload();
     }
+
+    // Owen-scrambled Sobol (0,2)-sequence.
+
+    BENCHMARK_CASE_F(Sobol02Sequence_SinglePrecision, Vector2Fixture<float>)
+    {
+        sobol_payload();
+    }
+
+    BENCHMARK_CASE_F(Sobol02Sequence_DoublePrecision, Vector2Fixture<double>)
+    {
+        sobol_payload();
+    }
+
+    // High dimensions.
+
+    BENCHMARK_CASE_F(FaureScrambledHaltonSequence_Dimensions64And65_DoublePrecision, Vector2Fixture<double>)
+    {
+        high_dimension_halton_payload();
+    }
+
+    BENCHMARK_CASE_F(Sobol02Sequence_Dimensions64And65_DoublePrecision, Vector2Fixture<double>)
+    {
+        high_dimension_sobol_payload();
+    }
 }
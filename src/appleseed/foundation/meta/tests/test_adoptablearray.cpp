@@ -0,0 +1,116 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/iunknown.h"
+#include "foundation/platform/compiler.h"
+#include "foundation/utility/containers/adoptablearray.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+
+TEST_SUITE(Foundation_Utility_Containers_AdoptableArray)
+{
+    struct Owner
+      : public IUnknown
+    {
+        bool& m_released;
+
+        explicit Owner(bool& released)
+          : m_released(released)
+        {
+        }
+
+        virtual void release() OVERRIDE
+        {
+            m_released = true;
+            delete this;
+        }
+    };
+
+    TEST_CASE(Append_AppendsElements)
+    {
+        const int values[] = { 1, 2, 3 };
+
+        AdoptableArray<int> array;
+        array.push_back(0);
+        array.append(values, 3);
+
+        ASSERT_EQ(4, array.size());
+        EXPECT_EQ(0, array[0]);
+        EXPECT_EQ(1, array[1]);
+        EXPECT_EQ(2, array[2]);
+        EXPECT_EQ(3, array[3]);
+    }
+
+    TEST_CASE(Adopt_ReferencesBufferWithoutCopying)
+    {
+        int values[] = { 1, 2, 3 };
+
+        AdoptableArray<int> array;
+        array.adopt(values, 3);
+
+        EXPECT_TRUE(array.is_adopted());
+        EXPECT_EQ(3, array.size());
+        EXPECT_EQ(values, array.data());
+    }
+
+    TEST_CASE(PushBack_GivenAdoptedBuffer_CopiesElementsAndReleasesOwner)
+    {
+        int values[] = { 1, 2, 3 };
+        bool released = false;
+
+        AdoptableArray<int> array;
+        array.adopt(values, 3, new Owner(released));
+        array.push_back(4);
+
+        EXPECT_TRUE(released);
+        EXPECT_FALSE(array.is_adopted());
+        ASSERT_EQ(4, array.size());
+        EXPECT_EQ(1, array[0]);
+        EXPECT_EQ(4, array[3]);
+    }
+
+    TEST_CASE(Destructor_GivenAdoptedBuffer_ReleasesOwner)
+    {
+        int values[] = { 1, 2, 3 };
+        bool released = false;
+
+        {
+            AdoptableArray<int> array;
+            array.adopt(values, 3, new Owner(released));
+            EXPECT_FALSE(released);
+        }
+
+        EXPECT_TRUE(released);
+    }
+}
@@ -186,6 +186,23 @@ TEST_SUITE(Foundation_Utility_Cache_LRUCache)
         cache.get(9);   // flushes 6, cache contains 9
         ASSERT_EQ(9000, element_swapper.m_memory_size);
     }
+
+    TEST_CASE(Invalidate_UnloadsElementsInKeyRangeOnly)
+    {
+        ElementSwapperTrackingSize element_swapper;
+        LRUCache<Key, Element, ElementSwapperTrackingSize> cache(element_swapper);
+
+        cache.get(1);
+        cache.get(2);
+        cache.get(4);
+        ASSERT_EQ(7000, element_swapper.m_memory_size);
+
+        cache.invalidate(2, 4);     // unloads 2, cache contains 1 and 4
+        ASSERT_EQ(5000, element_swapper.m_memory_size);
+
+        cache.get(2);               // reloads 2, cache contains 1, 2 and 4
+        ASSERT_EQ(7000, element_swapper.m_memory_size);
+    }
 }
 
 TEST_SUITE(Foundation_Utility_Cache_DualStageCache)
@@ -0,0 +1,109 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/utility/eventtracer.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace foundation;
+using namespace std;
+
+TEST_SUITE(Foundation_Utility_EventTracer)
+{
+    struct Fixture
+    {
+        Fixture()
+        {
+            EventTracer::clear();
+        }
+
+        ~Fixture()
+        {
+            EventTracer::disable();
+            EventTracer::clear();
+        }
+    };
+
+    TEST_CASE_F(ScopedEvent_GivenTracingIsDisabled_RecordsNothing, Fixture)
+    {
+        {
+            ScopedEvent event("event", "category");
+        }
+
+        EXPECT_EQ(0, EventTracer::get_event_count());
+    }
+
+    TEST_CASE_F(ScopedEvent_GivenTracingIsEnabled_RecordsOneEvent, Fixture)
+    {
+        EventTracer::enable();
+
+        {
+            ScopedEvent event("event", "category");
+        }
+
+        EXPECT_EQ(1, EventTracer::get_event_count());
+    }
+
+    TEST_CASE_F(ScopedEvent_GivenTracingIsDisabledDuringEvent_RecordsEvent, Fixture)
+    {
+        EventTracer::enable();
+
+        {
+            ScopedEvent event("event", "category");
+            EventTracer::disable();
+        }
+
+        EXPECT_EQ(1, EventTracer::get_event_count());
+    }
+
+    TEST_CASE_F(Write_WritesCompleteEventsInChromeTraceFormat, Fixture)
+    {
+        const char* Filename = "unit tests/outputs/test_eventtracer.json";
+
+        EventTracer::enable();
+        EventTracer::set_thread_name("main \"thread\"");
+        EventTracer::record("event", "category", 10, 25);
+
+        const bool success = EventTracer::write(Filename);
+        ASSERT_TRUE(success);
+
+        ifstream file(Filename);
+        const string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+        EXPECT_NEQ(string::npos, contents.find("\"traceEvents\""));
+        EXPECT_NEQ(string::npos, contents.find("\"args\":{\"name\":\"main \\\"thread\\\"\"}"));
+        EXPECT_NEQ(string::npos, contents.find("\"name\":\"event\",\"cat\":\"category\",\"ph\":\"X\""));
+        EXPECT_NEQ(string::npos, contents.find("\"ts\":10,\"dur\":15"));
+    }
+}
@@ -101,4 +101,24 @@ TEST_SUITE(Foundation_Image_FilteredTile)
         const BoxFilter2<double> filter(2.0, 2.0);
         test("unit tests/outputs/test_filteredtile_boxfilter_radius2dot0.txt", filter);
     }
+
+    TEST_CASE(Add_GivenOtherTileUsingSameFilterWasDestroyed_WeighsSamplesWithFilter)
+    {
+        const TriangleFilter2<double> filter(1.5, 1.5);
+        FilteredTile tile(5, 6, 1, filter);
+
+        {
+            FilteredTile other_tile(5, 6, 1, filter);
+        }
+
+        tile.clear();
+
+        const float values[1] = { 1.0f };
+        tile.add(2.5, 3.0, values);
+
+        // The sample is at the center of pixel (2, 2) along x and on the edge between
+        // pixels (2, 2) and (2, 3) along y.
+        EXPECT_FEQ_EPS(filter.evaluate(0.0, 0.5), static_cast<double>(tile.pixel(2, 2)[0]), 1.0e-3);
+        EXPECT_FEQ_EPS(filter.evaluate(1.0, 0.5), static_cast<double>(tile.pixel(1, 2)[0]), 1.0e-3);
+    }
 }
@@ -28,10 +28,12 @@
 //
 
 // appleseed.foundation headers.
+#include "foundation/platform/thread.h"
 #include "foundation/platform/timer.h"
 #include "foundation/platform/types.h"
 #include "foundation/utility/job/abortswitch.h"
 #include "foundation/utility/job/ijob.h"
+#include "foundation/utility/job/jobcounter.h"
 #include "foundation/utility/job/jobmanager.h"
 #include "foundation/utility/job/jobqueue.h"
 #include "foundation/utility/job/workerthread.h"
@@ -371,6 +373,80 @@ TEST_SUITE(Foundation_Utility_Job_JobManager)
 
         EXPECT_EQ(1, execution_count);
     }
+
+    class JobSettingFlag
+      : public IJob
+    {
+      public:
+        explicit JobSettingFlag(volatile bool& flag)
+          : m_flag(flag)
+        {
+        }
+
+        virtual void execute(const size_t thread_index)
+        {
+            m_flag = true;
+        }
+
+      private:
+        volatile bool& m_flag;
+    };
+
+    TEST_CASE(JobManagerWithPinnedWorkerThreadsExecutesJobs)
+    {
+        Logger logger;
+        JobQueue job_queue;
+        JobManager job_manager(logger, job_queue, 4, JobManager::PinWorkerThreads);
+
+        const size_t JobCount = 8;
+        volatile bool executed[JobCount];
+
+        for (size_t i = 0; i < JobCount; ++i)
+        {
+            executed[i] = false;
+            job_queue.schedule(new JobSettingFlag(executed[i]));
+        }
+
+        job_manager.start();
+        job_queue.wait_until_completion();
+
+        for (size_t i = 0; i < JobCount; ++i)
+            EXPECT_TRUE(executed[i]);
+    }
+
+    class JobCountingThreadExecutions
+      : public IJob
+    {
+      public:
+        explicit JobCountingThreadExecutions(volatile size_t execution_counts[])
+          : m_execution_counts(execution_counts)
+        {
+        }
+
+        virtual void execute(const size_t thread_index)
+        {
+            ++m_execution_counts[thread_index];
+        }
+
+      private:
+        volatile size_t* m_execution_counts;
+    };
+
+    TEST_CASE(ExecuteOnEachThread_ExecutesJobOnceOnEachWorkerThread)
+    {
+        Logger logger;
+        JobQueue job_queue;
+        JobManager job_manager(logger, job_queue, 4, JobManager::KeepRunningOnEmptyQueue);
+
+        volatile size_t execution_counts[4] = { 0, 0, 0, 0 };
+        JobCountingThreadExecutions job(execution_counts);
+
+        job_manager.execute_on_each_thread(job);
+
+        for (size_t i = 0; i < 4; ++i)
+            EXPECT_EQ(1, execution_counts[i]);
+        EXPECT_FALSE(job_queue.has_scheduled_or_running_jobs());
+    }
 }
 
 TEST_SUITE(Foundation_Utility_Job_WorkerThread)
@@ -481,3 +557,65 @@ TEST_SUITE(Foundation_Utility_Job_WorkerThread)
         EXPECT_EQ(1, execution_count);
     }
 }
+
+TEST_SUITE(Foundation_Utility_Job_JobCounter)
+{
+    class JobWaitingForFlag
+      : public IJob
+    {
+      public:
+        explicit JobWaitingForFlag(volatile bool& flag)
+          : m_flag(flag)
+        {
+        }
+
+        virtual void execute(const size_t thread_index)
+        {
+            while (!m_flag)
+                yield();
+        }
+
+      private:
+        volatile bool& m_flag;
+    };
+
+    TEST_CASE(WaitUntilCompletion_GivenQueueRunningOtherJob_WaitsForCountedJobsOnly)
+    {
+        Logger logger;
+        JobQueue job_queue;
+        JobManager job_manager(logger, job_queue, 2, JobManager::KeepRunningOnEmptyQueue);
+
+        volatile bool flag = false;
+        job_queue.schedule(new JobWaitingForFlag(flag));
+
+        volatile size_t execution_count = 0;
+        JobCounter job_counter;
+        job_counter.schedule(job_queue, new JobNotifyingAboutExecution(execution_count));
+        job_counter.schedule(job_queue, new JobNotifyingAboutExecution(execution_count));
+
+        job_manager.start();
+        job_counter.wait_until_completion();
+
+        EXPECT_EQ(2, execution_count);
+        EXPECT_EQ(0, job_counter.get_pending_job_count());
+        EXPECT_TRUE(job_queue.has_running_jobs());
+
+        flag = true;
+        job_queue.wait_until_completion();
+    }
+
+    TEST_CASE(WaitUntilCompletion_GivenClearedJob_ReturnsImmediately)
+    {
+        volatile size_t execution_count = 0;
+
+        JobQueue job_queue;
+        JobCounter job_counter;
+        job_counter.schedule(job_queue, new JobNotifyingAboutExecution(execution_count));
+
+        job_queue.clear_scheduled_jobs();
+        job_counter.wait_until_completion();
+
+        EXPECT_EQ(0, execution_count);
+        EXPECT_EQ(0, job_counter.get_pending_job_count());
+    }
+}
@@ -47,18 +47,43 @@
 #include "foundation/math/vector.h"
 #include "foundation/platform/timer.h"
 #include "foundation/utility/iostreamop.h"
+#include "foundation/utility/job.h"
+#include "foundation/utility/log.h"
 #include "foundation/utility/test.h"
 
 // STANN headers.
 #include "sfcnn.hpp"
 
 // Standard headers.
+#include <cassert>
 #include <cstddef>
 #include <vector>
 
 using namespace foundation;
 using namespace std;
 
+namespace
+{
+    void generate_random_points(
+        MersenneTwister&    rng,
+        vector<Vector3d>&   points,
+        const size_t        count)
+    {
+        assert(points.empty());
+
+        points.reserve(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3d p;
+            p.x = rand_double1(rng);
+            p.y = rand_double1(rng);
+            p.z = rand_double1(rng);
+            points.push_back(p);
+        }
+    }
+}
+
 TEST_SUITE(Foundation_Math_Knn_Tree)
 {
     TEST_CASE(Empty_GivenDefaultConstructedTree_ReturnsTrue)
@@ -282,25 +307,6 @@ TEST_SUITE(Foundation_Math_Knn_Query)
         EXPECT_EQ(1, answer.size());
     }
 
-    void generate_random_points(
-        MersenneTwister&    rng,
-        vector<Vector3d>&   points,
-        const size_t        count)
-    {
-        assert(points.empty());
-
-        points.reserve(count);
-
-        for (size_t i = 0; i < count; ++i)
-        {
-            Vector3d p;
-            p.x = rand_double1(rng);
-            p.y = rand_double1(rng);
-            p.z = rand_double1(rng);
-            points.push_back(p);
-        }
-    }
-
     TEST_CASE(Run_ReturnsSameResultsAsSTANN)
     {
         const size_t PointCount = 1000;
@@ -396,6 +402,162 @@ TEST_SUITE(Foundation_Math_Knn_Query)
             }
         }
     }
+
+    TEST_CASE(Run_GivenTreeBuiltInParallel_ReturnsSameResultsAsWithTreeBuiltSerially)
+    {
+        const size_t PointCount = 10000;
+        const size_t QueryCount = 1000;
+        const size_t AnswerSize = 20;
+
+        MersenneTwister rng;
+
+        vector<Vector3d> points;
+        generate_random_points(rng, points, PointCount);
+
+        knn::Tree3d serial_tree;
+        knn::Builder3d serial_builder(serial_tree);
+        serial_builder.build<DefaultWallclockTimer>(&points[0], PointCount);
+
+        knn::Tree3d parallel_tree;
+        {
+            Logger logger;
+            JobQueue job_queue;
+            JobManager job_manager(logger, job_queue, 4, JobManager::KeepRunningOnEmptyQueue);
+            job_manager.start();
+
+            vector<Vector3d> points_copy(points);
+            knn::Builder3d parallel_builder(parallel_tree);
+            parallel_builder.build_move_points<DefaultWallclockTimer>(points_copy, job_queue);
+        }
+
+        EXPECT_EQ(serial_tree.get_memory_size(), parallel_tree.get_memory_size());
+
+        knn::Answer<double> serial_answer(AnswerSize);
+        knn::Query3d serial_query(serial_tree, serial_answer);
+
+        knn::Answer<double> parallel_answer(AnswerSize);
+        knn::Query3d parallel_query(parallel_tree, parallel_answer);
+
+        for (size_t i = 0; i < QueryCount; ++i)
+        {
+            Vector3d q;
+            q.x = rand_double1(rng);
+            q.y = rand_double1(rng);
+            q.z = rand_double1(rng);
+
+            serial_query.run(q);
+            serial_answer.sort();
+
+            parallel_query.run(q);
+            parallel_answer.sort();
+
+            ASSERT_EQ(AnswerSize, parallel_answer.size());
+
+            for (size_t j = 0; j < AnswerSize; ++j)
+            {
+                EXPECT_EQ(
+                    serial_tree.remap(serial_answer.get(j).m_index),
+                    parallel_tree.remap(parallel_answer.get(j).m_index));
+            }
+        }
+    }
+}
+
+TEST_SUITE(Foundation_Math_Knn_Grid)
+{
+    TEST_CASE(Empty_GivenDefaultConstructedGrid_ReturnsTrue)
+    {
+        knn::Grid3d grid;
+
+        EXPECT_TRUE(grid.empty());
+    }
+
+    TEST_CASE(Build_GivenPoints_PreservesPoints)
+    {
+        const size_t PointCount = 100;
+
+        MersenneTwister rng;
+
+        vector<Vector3d> points;
+        generate_random_points(rng, points, PointCount);
+
+        knn::Grid3d grid;
+        knn::GridBuilder3d builder(grid);
+        builder.build<DefaultWallclockTimer>(&points[0], PointCount, 0.1);
+
+        EXPECT_FALSE(grid.empty());
+        EXPECT_EQ(128, grid.get_bucket_count());
+
+        for (size_t i = 0; i < PointCount; ++i)
+            EXPECT_EQ(points[grid.remap(i)], grid.get_point(i));
+    }
+}
+
+TEST_SUITE(Foundation_Math_Knn_GridQuery)
+{
+    // Return true if grid queries find the same points as k-d tree queries.
+    bool grid_query_matches_tree_query(
+        const double        cell_size,
+        const double        query_max_square_distance)
+    {
+        const size_t PointCount = 1000;
+        const size_t QueryCount = 1000;
+        const size_t AnswerSize = 20;
+
+        MersenneTwister rng;
+
+        vector<Vector3d> points;
+        generate_random_points(rng, points, PointCount);
+
+        knn::Tree3d tree;
+        knn::Builder3d tree_builder(tree);
+        tree_builder.build<DefaultWallclockTimer>(&points[0], PointCount);
+
+        knn::Grid3d grid;
+        knn::GridBuilder3d grid_builder(grid);
+        grid_builder.build<DefaultWallclockTimer>(&points[0], PointCount, cell_size);
+
+        knn::Answer<double> tree_answer(AnswerSize);
+        knn::Query3d tree_query(tree, tree_answer);
+
+        knn::Answer<double> grid_answer(AnswerSize);
+        knn::GridQuery3d grid_query(grid, grid_answer);
+
+        for (size_t i = 0; i < QueryCount; ++i)
+        {
+            Vector3d q;
+            q.x = rand_double1(rng);
+            q.y = rand_double1(rng);
+            q.z = rand_double1(rng);
+
+            tree_query.run(q, query_max_square_distance);
+            tree_answer.sort();
+
+            grid_query.run(q, query_max_square_distance);
+            grid_answer.sort();
+
+            if (grid_answer.size() != tree_answer.size())
+                return false;
+
+            for (size_t j = 0; j < tree_answer.size(); ++j)
+            {
+                if (grid.remap(grid_answer.get(j).m_index) != tree.remap(tree_answer.get(j).m_index))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    TEST_CASE(Run_GivenCellSizeTwiceSearchDistance_ReturnsSameResultsAsTreeQuery)
+    {
+        EXPECT_TRUE(grid_query_matches_tree_query(0.2, square(0.1)));
+    }
+
+    TEST_CASE(Run_GivenCellSizeSmallerThanSearchDistance_ReturnsSameResultsAsTreeQuery)
+    {
+        EXPECT_TRUE(grid_query_matches_tree_query(0.02, square(0.1)));
+    }
 }
 
 #pragma warning (pop)
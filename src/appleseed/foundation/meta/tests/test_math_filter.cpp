@@ -36,6 +36,7 @@
 #include "foundation/utility/test.h"
 
 // Standard headers.
+#include <cmath>
 #include <cstddef>
 #include <string>
 #include <vector>
@@ -215,3 +216,79 @@ TEST_SUITE(Foundation_Math_Filter_BlackmanHarrisFilter2)
             filter);
     }
 }
+
+TEST_SUITE(Foundation_Math_Filter_TabulatedFilter2)
+{
+    bool matches_filter(const Filter2d& filter)
+    {
+        const TabulatedFilter2<float> tabulated(filter);
+        const size_t PointCount = 64;
+
+        for (size_t y = 0; y < PointCount; ++y)
+        {
+            for (size_t x = 0; x < PointCount; ++x)
+            {
+                const double fx = fit<size_t, double>(x, 0, PointCount - 1, -filter.get_xradius(), filter.get_xradius());
+                const double fy = fit<size_t, double>(y, 0, PointCount - 1, -filter.get_yradius(), filter.get_yradius());
+
+                const double expected = filter.evaluate(fx, fy);
+                const double actual = tabulated.evaluate(static_cast<float>(fx), static_cast<float>(fy));
+
+                if (abs(expected - actual) > 1.0e-2)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    TEST_CASE(TestPropertyGetters)
+    {
+        const BoxFilter2<double> filter(2.0, 3.0);
+        const TabulatedFilter2<float> tabulated(filter);
+
+        EXPECT_EQ(2.0f, tabulated.get_xradius());
+        EXPECT_EQ(3.0f, tabulated.get_yradius());
+    }
+
+    TEST_CASE(Evaluate_MatchesTriangleFilter)
+    {
+        EXPECT_TRUE(matches_filter(TriangleFilter2<double>(2.0, 3.0)));
+    }
+
+    TEST_CASE(Evaluate_MatchesGaussianFilter)
+    {
+        EXPECT_TRUE(matches_filter(GaussianFilter2<double>(2.0, 3.0, 4.0)));
+    }
+
+    TEST_CASE(Evaluate_MatchesMitchellFilter)
+    {
+        EXPECT_TRUE(matches_filter(MitchellFilter2<double>(2.0, 3.0, 1.0 / 3, 1.0 / 3)));
+    }
+
+    TEST_CASE(Evaluate_MatchesLanczosFilter)
+    {
+        EXPECT_TRUE(matches_filter(LanczosFilter2<double>(2.0, 3.0, 3.0)));
+    }
+
+    TEST_CASE(Evaluate_MatchesBlackmanHarrisFilter)
+    {
+        EXPECT_TRUE(matches_filter(BlackmanHarrisFilter2<double>(2.0, 3.0)));
+    }
+
+    TEST_CASE(EvaluateX_GivenPointsHalfwayBetweenTableEntries_InterpolatesFilter)
+    {
+        const GaussianFilter2<double> filter(2.0, 2.0, 4.0);
+        const TabulatedFilter2<float> tabulated(filter);
+        const double step = 4.0 / (TabulatedFilter2<float>::TableSize - 1);
+
+        for (size_t i = 0; i < TabulatedFilter2<float>::TableSize - 1; ++i)
+        {
+            const double x = -2.0 + (i + 0.5) * step;
+            const double expected = filter.evaluate(x, 0.0);
+            const double actual = tabulated.evaluate_x(static_cast<float>(x));
+
+            EXPECT_LT(1.0e-4, abs(expected - actual));
+        }
+    }
+}
@@ -36,6 +36,7 @@
 
 // Standard headers.
 #include <cstddef>
+#include <cstdio>
 #include <string>
 #include <vector>
 
@@ -44,7 +45,22 @@ using namespace std;
 
 TEST_SUITE(Foundation_Mesh_OBJMeshFileReader)
 {
-    struct Face {};
+    struct Face
+    {
+        vector<size_t>      m_vertices;
+        vector<size_t>      m_vertex_normals;
+        vector<size_t>      m_tex_coords;
+        size_t              m_material;
+
+        bool operator==(const Face& rhs) const
+        {
+            return
+                m_vertices == rhs.m_vertices &&
+                m_vertex_normals == rhs.m_vertex_normals &&
+                m_tex_coords == rhs.m_tex_coords &&
+                m_material == rhs.m_material;
+        }
+    };
 
     struct Mesh
     {
@@ -52,6 +68,7 @@ TEST_SUITE(Foundation_Mesh_OBJMeshFileReader)
         vector<Vector3d>    m_vertices;
         vector<Vector3d>    m_vertex_normals;
         vector<Vector2d>    m_tex_coords;
+        vector<string>      m_material_slots;
         vector<Face>        m_faces;
     };
 
@@ -84,10 +101,41 @@ TEST_SUITE(Foundation_Mesh_OBJMeshFileReader)
             return m_meshes.back().m_tex_coords.size() - 1;
         }
 
+        virtual size_t push_material_slot(const char* name) OVERRIDE
+        {
+            m_meshes.back().m_material_slots.push_back(name);
+            return m_meshes.back().m_material_slots.size() - 1;
+        }
+
         virtual void begin_face(const size_t vertex_count) OVERRIDE
         {
             m_meshes.back().m_faces.push_back(Face());
+            m_meshes.back().m_faces.back().m_material = ~size_t(0);
+            m_face_vertex_count = vertex_count;
         }
+
+        virtual void set_face_vertices(const size_t vertices[]) OVERRIDE
+        {
+            m_meshes.back().m_faces.back().m_vertices.assign(vertices, vertices + m_face_vertex_count);
+        }
+
+        virtual void set_face_vertex_normals(const size_t vertex_normals[]) OVERRIDE
+        {
+            m_meshes.back().m_faces.back().m_vertex_normals.assign(vertex_normals, vertex_normals + m_face_vertex_count);
+        }
+
+        virtual void set_face_vertex_tex_coords(const size_t tex_coords[]) OVERRIDE
+        {
+            m_meshes.back().m_faces.back().m_tex_coords.assign(tex_coords, tex_coords + m_face_vertex_count);
+        }
+
+        virtual void set_face_material(const size_t material) OVERRIDE
+        {
+            m_meshes.back().m_faces.back().m_material = material;
+        }
+
+      private:
+        size_t              m_face_vertex_count;
     };
 
     TEST_CASE(ReadCubeMeshFile)
@@ -121,4 +169,129 @@ TEST_SUITE(Foundation_Mesh_OBJMeshFileReader)
         EXPECT_EQ(4, mesh.m_tex_coords.size());
         EXPECT_EQ(1, mesh.m_faces.size());
     }
+
+    void write_grid_mesh_file(const char* filepath, const size_t object_count, const size_t resolution)
+    {
+        FILE* file = fopen(filepath, "wt");
+
+        if (file == 0)
+            return;
+
+        for (size_t o = 0; o < object_count; ++o)
+        {
+            fprintf(file, "o object%d\n", static_cast<int>(o));
+
+            for (size_t y = 0; y < resolution; ++y)
+            {
+                for (size_t x = 0; x < resolution; ++x)
+                {
+                    fprintf(file, "v %d %d %d\n", static_cast<int>(x), static_cast<int>(y), static_cast<int>(o));
+                    fprintf(file, "vt %d %d\n", static_cast<int>(x), static_cast<int>(y));
+                }
+            }
+
+            fprintf(file, "vn 0 0 1\n");
+            fprintf(file, "usemtl material%d\n", static_cast<int>(o % 2));
+
+            const int base = static_cast<int>(o * resolution * resolution + 1);
+            const int r = static_cast<int>(resolution);
+
+            for (int y = 0; y < r - 1; ++y)
+            {
+                for (int x = 0; x < r - 1; ++x)
+                {
+                    const int i = base + y * r + x;
+                    fprintf(file, "f %d/%d/-1 %d/%d/-1 %d/%d/-1\n", i, i, i + 1, i + 1, i + r, i + r);
+                    fprintf(file, "f -1 -2 %d\n", i + r);
+                }
+            }
+        }
+
+        fclose(file);
+    }
+
+    TEST_CASE(ReadMeshFileInParallel_GivenLargeMeshFile_ProducesSameMeshesAsSerialRead)
+    {
+        const char* Filepath = "unit tests/outputs/test_objmeshfilereader_grid.obj";
+        write_grid_mesh_file(Filepath, 3, 100);
+
+        OBJMeshFileReader serial_reader(Filepath);
+        MeshBuilder serial_builder;
+        serial_reader.read(serial_builder);
+
+        OBJMeshFileReader parallel_reader(Filepath, OBJMeshFileReader::ParseInParallel, 4);
+        MeshBuilder parallel_builder;
+        parallel_reader.read(parallel_builder);
+
+        ASSERT_EQ(3, serial_builder.m_meshes.size());
+        ASSERT_EQ(serial_builder.m_meshes.size(), parallel_builder.m_meshes.size());
+
+        for (size_t i = 0; i < serial_builder.m_meshes.size(); ++i)
+        {
+            const Mesh& expected = serial_builder.m_meshes[i];
+            const Mesh& mesh = parallel_builder.m_meshes[i];
+
+            EXPECT_EQ(expected.m_name, mesh.m_name);
+            EXPECT_TRUE(expected.m_vertices == mesh.m_vertices);
+            EXPECT_TRUE(expected.m_vertex_normals == mesh.m_vertex_normals);
+            EXPECT_TRUE(expected.m_tex_coords == mesh.m_tex_coords);
+            EXPECT_TRUE(expected.m_material_slots == mesh.m_material_slots);
+            EXPECT_EQ(expected.m_faces.size(), mesh.m_faces.size());
+            EXPECT_TRUE(expected.m_faces == mesh.m_faces);
+        }
+    }
+
+    // Read a mesh file, returning the line of the parse error or 0 if there was none.
+    size_t read_until_parse_error(OBJMeshFileReader& reader, MeshBuilder& builder)
+    {
+        try
+        {
+            reader.read(builder);
+            return 0;
+        }
+        catch (const OBJMeshFileReader::ExceptionParseError& e)
+        {
+            return e.m_line;
+        }
+    }
+
+    TEST_CASE(ReadMeshFileInParallel_GivenParseError_ProducesSameMeshesAndErrorLineAsSerialRead)
+    {
+        const char* Filepath = "unit tests/outputs/test_objmeshfilereader_grid_with_error.obj";
+        write_grid_mesh_file(Filepath, 3, 100);
+
+        FILE* file = fopen(Filepath, "at");
+        ASSERT_TRUE(file != 0);
+        fprintf(file, "v 1 2 three\n");
+        fprintf(file, "f 1 2 3\n");
+        fclose(file);
+
+        OBJMeshFileReader serial_reader(Filepath);
+        MeshBuilder serial_builder;
+        const size_t serial_error_line = read_until_parse_error(serial_reader, serial_builder);
+
+        OBJMeshFileReader parallel_reader(Filepath, OBJMeshFileReader::ParseInParallel, 4);
+        MeshBuilder parallel_builder;
+        const size_t parallel_error_line = read_until_parse_error(parallel_reader, parallel_builder);
+
+        EXPECT_NEQ(0, serial_error_line);
+        EXPECT_EQ(serial_error_line, parallel_error_line);
+
+        ASSERT_EQ(3, serial_builder.m_meshes.size());
+        ASSERT_EQ(serial_builder.m_meshes.size(), parallel_builder.m_meshes.size());
+
+        for (size_t i = 0; i < serial_builder.m_meshes.size(); ++i)
+        {
+            const Mesh& expected = serial_builder.m_meshes[i];
+            const Mesh& mesh = parallel_builder.m_meshes[i];
+
+            EXPECT_EQ(expected.m_name, mesh.m_name);
+            EXPECT_TRUE(expected.m_vertices == mesh.m_vertices);
+            EXPECT_TRUE(expected.m_vertex_normals == mesh.m_vertex_normals);
+            EXPECT_TRUE(expected.m_tex_coords == mesh.m_tex_coords);
+            EXPECT_TRUE(expected.m_material_slots == mesh.m_material_slots);
+            EXPECT_EQ(expected.m_faces.size(), mesh.m_faces.size());
+            EXPECT_TRUE(expected.m_faces == mesh.m_faces);
+        }
+    }
 }
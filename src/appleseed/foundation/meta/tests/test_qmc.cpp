@@ -38,6 +38,7 @@
 #include "foundation/math/rng.h"
 #include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/makevector.h"
 #include "foundation/utility/maplefile.h"
 #include "foundation/utility/string.h"
@@ -421,6 +422,142 @@ TEST_SUITE(Foundation_Math_QMC)
                 MaplePlotDef("qmc_rmsd").set_legend("RMS Deviation (QMC)").set_color("red")));
     }
 
+    TEST_CASE(SobolDimension0_ReturnsVanDerCorputSequence)
+    {
+        EXPECT_EQ(0x00000000UL, sobol_dimension0(0));
+        EXPECT_EQ(0x80000000UL, sobol_dimension0(1));
+        EXPECT_EQ(0x40000000UL, sobol_dimension0(2));
+        EXPECT_EQ(0xC0000000UL, sobol_dimension0(3));
+    }
+
+    TEST_CASE(SobolDimension1_ReturnsSecondDimensionOfSobolSequence)
+    {
+        // 0, 1/2, 3/4, 1/4, 5/8, 1/8, 3/8, 7/8 (natural order, not Gray code order).
+        EXPECT_EQ(0x00000000UL, sobol_dimension1(0));
+        EXPECT_EQ(0x80000000UL, sobol_dimension1(1));
+        EXPECT_EQ(0xC0000000UL, sobol_dimension1(2));
+        EXPECT_EQ(0x40000000UL, sobol_dimension1(3));
+        EXPECT_EQ(0xA0000000UL, sobol_dimension1(4));
+        EXPECT_EQ(0x20000000UL, sobol_dimension1(5));
+        EXPECT_EQ(0x60000000UL, sobol_dimension1(6));
+        EXPECT_EQ(0xE0000000UL, sobol_dimension1(7));
+    }
+
+    // Return true if the first 2^log2_count points of a sequence form a (0,m,2)-net in base 2,
+    // i.e. if every elementary interval of volume 1/2^m contains exactly one point.
+    bool is_02_net(const vector<Vector2d>& points, const size_t log2_count)
+    {
+        const size_t count = size_t(1) << log2_count;
+
+        for (size_t log2_nx = 0; log2_nx <= log2_count; ++log2_nx)
+        {
+            const size_t nx = size_t(1) << log2_nx;
+            const size_t ny = count / nx;
+
+            vector<size_t> cells(count, 0);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const size_t cx = truncate<size_t>(points[i].x * nx);
+                const size_t cy = truncate<size_t>(points[i].y * ny);
+
+                if (++cells[cy * nx + cx] > 1)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    TEST_CASE(Sobol02Sequence_FirstPowerOfTwoPoints_FormA02Net)
+    {
+        const size_t Log2Count = 8;
+
+        for (uint32 seed = 0; seed < 16; ++seed)
+        {
+            vector<Vector2d> points;
+
+            for (uint32 i = 0; i < (1UL << Log2Count); ++i)
+                points.push_back(sobol_02_sequence<double>(seed, i));
+
+            EXPECT_TRUE(is_02_net(points, Log2Count));
+        }
+    }
+
+    TEST_CASE(Sobol02Sequence_DistinctSeeds_YieldDistinctPoints)
+    {
+        const Vector2d p0 = sobol_02_sequence<double>(0, 7);
+        const Vector2d p1 = sobol_02_sequence<double>(1, 7);
+
+        EXPECT_TRUE(p0 != p1);
+    }
+
+    TEST_CASE(Generate2DSobolSequenceImage)
+    {
+        vector<Vector2d> points;
+
+        for (uint32 i = 0; i < PointCount; ++i)
+            points.push_back(sobol_02_sequence<double>(0, i));
+
+        write_point_cloud_image("unit tests/outputs/test_qmc_sobol_owen_scrambled.png", points);
+    }
+
+    TEST_CASE(Integrate2DFunction)
+    {
+        // Integrate a smooth function over [0,1]^2 with independent random and
+        // scrambled Sobol estimates, and plot the RMS error vs. the sample count.
+        const double ExactValue = 4.0 / (Pi * Pi);
+        const size_t TrialCount = 64;
+        const size_t Log2MaxSampleCount = 10;
+
+        MersenneTwister rng;
+
+        vector<double> abscissa;
+        vector<double> rng_rmse;
+        vector<double> sobol_rmse;
+
+        for (size_t m = 0; m <= Log2MaxSampleCount; ++m)
+        {
+            const size_t sample_count = size_t(1) << m;
+
+            double rng_sse = 0.0;
+            double sobol_sse = 0.0;
+
+            for (size_t t = 0; t < TrialCount; ++t)
+            {
+                double rng_sum = 0.0;
+                double sobol_sum = 0.0;
+
+                for (size_t i = 0; i < sample_count; ++i)
+                {
+                    const double rx = rand_double2(rng);
+                    const double ry = rand_double2(rng);
+                    rng_sum += sin(rx * Pi) * sin(ry * Pi);
+
+                    const Vector2d s = sobol_02_sequence<double>(static_cast<uint32>(t), static_cast<uint32>(i));
+                    sobol_sum += sin(s.x * Pi) * sin(s.y * Pi);
+                }
+
+                rng_sse += square(rng_sum / sample_count - ExactValue);
+                sobol_sse += square(sobol_sum / sample_count - ExactValue);
+            }
+
+            abscissa.push_back(static_cast<double>(sample_count));
+            rng_rmse.push_back(sqrt(rng_sse / TrialCount));
+            sobol_rmse.push_back(sqrt(sobol_sse / TrialCount));
+        }
+
+        EXPECT_TRUE(sobol_rmse.back() < rng_rmse.back());
+
+        MapleFile file("unit tests/outputs/test_qmc_integrate2dfunction.mpl");
+        file.define("rng_rmse", abscissa, rng_rmse);
+        file.define("sobol_rmse", abscissa, sobol_rmse);
+        file.plot(
+            make_vector(
+                MaplePlotDef("rng_rmse").set_legend("RMS Error (RNG)").set_color("blue"),
+                MaplePlotDef("sobol_rmse").set_legend("RMS Error (Owen-Scrambled Sobol)").set_color("red")));
+    }
+
 #if 0
 
     TEST_CASE(PrecomputeHaltonSequence)
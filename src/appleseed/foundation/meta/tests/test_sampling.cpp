@@ -32,6 +32,7 @@
 #include "foundation/math/qmc.h"
 #include "foundation/math/rng.h"
 #include "foundation/math/sampling.h"
+#include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
 #include "foundation/utility/iostreamop.h"
 #include "foundation/utility/string.h"
@@ -106,6 +107,98 @@ TEST_SUITE(Foundation_Math_Sampling_QMCSamplingContext)
     }
 }
 
+TEST_SUITE(Foundation_Math_Sampling_SobolSamplingContext)
+{
+    typedef MersenneTwister RNG;
+    typedef SobolSamplingContext<RNG> SamplingContext;
+
+    TEST_CASE(NextVector2_RNGMode_ReturnsRandomNumbers)
+    {
+        RNG rng1, rng2;
+        SamplingContext context(rng1, SamplingContext::RNGMode, 2, 0, 7);
+
+        const Vector2d s = context.next_vector2<2>();
+
+        EXPECT_EQ(rand_double2(rng2), s[0]);
+        EXPECT_EQ(rand_double2(rng2), s[1]);
+    }
+
+    TEST_CASE(Split_AccumulatesDimensions)
+    {
+        RNG rng;
+        SamplingContext context(rng, SamplingContext::QMCMode, 2, 64, 7);
+        SamplingContext child_context = context.split(3, 16);
+        SamplingContext child_child_context = child_context.split(4, 8);
+
+        EXPECT_EQ(2, context.get_total_dimension());
+        EXPECT_EQ(5, child_context.get_total_dimension());
+        EXPECT_EQ(9, child_child_context.get_total_dimension());
+    }
+
+    TEST_CASE(NextVector2_QMCMode_ReturnsSamplesInUnitSquare)
+    {
+        RNG rng;
+        SamplingContext context(rng, SamplingContext::QMCMode, 4, 0, 0, 7);
+
+        for (size_t i = 0; i < 1024; ++i)
+        {
+            const Vector4d s = context.next_vector2<4>();
+
+            for (size_t d = 0; d < 4; ++d)
+            {
+                EXPECT_TRUE(s[d] >= 0.0);
+                EXPECT_TRUE(s[d] < 1.0);
+            }
+        }
+    }
+
+    TEST_CASE(NextVector2_QMCMode_InitialInstanceIsIndexOfFirstPoint)
+    {
+        RNG rng;
+        SamplingContext context1(rng, SamplingContext::QMCMode, 2, 0, 0, 7);
+        SamplingContext context2(rng, SamplingContext::QMCMode, 2, 0, 5, 7);
+
+        for (size_t i = 0; i < 5; ++i)
+            context1.next_vector2<2>();
+
+        EXPECT_EQ(context1.next_vector2<2>(), context2.next_vector2<2>());
+    }
+
+    TEST_CASE(NextVector2_QMCMode_DifferentScramblingSeeds_ReturnDifferentSamples)
+    {
+        RNG rng;
+        SamplingContext context1(rng, SamplingContext::QMCMode, 2, 0, 0, 7);
+        SamplingContext context2(rng, SamplingContext::QMCMode, 2, 0, 0, 8);
+
+        EXPECT_NEQ(context1.next_vector2<2>(), context2.next_vector2<2>());
+    }
+
+    TEST_CASE(Split_QMCMode_ChildSamplesOfSuccessiveParentSamplesAreStratified)
+    {
+        const size_t SampleCount = 64;     // 8 x 8 strata
+
+        RNG rng;
+        SamplingContext context(rng, SamplingContext::QMCMode, 2, SampleCount, 0, 7);
+
+        vector<size_t> strata(SampleCount, 0);
+
+        for (size_t i = 0; i < SampleCount; ++i)
+        {
+            context.next_vector2<2>();
+
+            SamplingContext child_context = context.split(2, 1);
+            const Vector2d s = child_context.next_vector2<2>();
+
+            const size_t x = truncate<size_t>(s[0] * 8.0);
+            const size_t y = truncate<size_t>(s[1] * 8.0);
+            ++strata[y * 8 + x];
+        }
+
+        for (size_t i = 0; i < SampleCount; ++i)
+            EXPECT_EQ(1, strata[i]);
+    }
+}
+
 TEST_SUITE(Foundation_Math_Sampling_QMCSamplingContext_DirectIlluminationSimulation)
 {
     typedef MersenneTwister RNG;
@@ -0,0 +1,116 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.foundation headers.
+#include "foundation/platform/system.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace std;
+
+TEST_SUITE(Foundation_Platform_System)
+{
+    TEST_CASE(ParseCpuList_GivenSingleIndex_ReturnsIndex)
+    {
+        vector<size_t> indices;
+        System::parse_cpu_list("3\n", indices);
+
+        ASSERT_EQ(1, indices.size());
+        EXPECT_EQ(3, indices[0]);
+    }
+
+    TEST_CASE(ParseCpuList_GivenRangesAndIndices_ReturnsAllIndicesInOrder)
+    {
+        vector<size_t> indices;
+        System::parse_cpu_list("0-2,5,8-9\n", indices);
+
+        const size_t Expected[] = { 0, 1, 2, 5, 8, 9 };
+        ASSERT_EQ(6, indices.size());
+        EXPECT_SEQUENCE_EQ(6, Expected, &indices[0]);
+    }
+
+    TEST_CASE(ParseCpuList_GivenEmptyString_ReturnsNoIndex)
+    {
+        vector<size_t> indices;
+        System::parse_cpu_list("\n", indices);
+
+        EXPECT_TRUE(indices.empty());
+    }
+
+    TEST_CASE(ParseCpuList_AppendsToExistingIndices)
+    {
+        vector<size_t> indices(1, 7);
+        System::parse_cpu_list("0", indices);
+
+        ASSERT_EQ(2, indices.size());
+        EXPECT_EQ(7, indices[0]);
+        EXPECT_EQ(0, indices[1]);
+    }
+
+    TEST_CASE(InterleaveNumaNodeCpuCores_GivenNodesOfDifferentSizes_AlternatesNodes)
+    {
+        vector<vector<size_t> > node_cores(2);
+        System::parse_cpu_list("0-3", node_cores[0]);
+        System::parse_cpu_list("8-9", node_cores[1]);
+
+        vector<size_t> cores;
+        System::interleave_numa_node_cpu_cores(node_cores, cores);
+
+        const size_t Expected[] = { 0, 8, 1, 9, 2, 3 };
+        ASSERT_EQ(6, cores.size());
+        EXPECT_SEQUENCE_EQ(6, Expected, &cores[0]);
+    }
+
+    TEST_CASE(InterleaveNumaNodeCpuCores_GivenEmptyNode_SkipsIt)
+    {
+        vector<vector<size_t> > node_cores(3);
+        System::parse_cpu_list("0-1", node_cores[0]);
+        System::parse_cpu_list("4-5", node_cores[2]);
+
+        vector<size_t> cores;
+        System::interleave_numa_node_cpu_cores(node_cores, cores);
+
+        const size_t Expected[] = { 0, 4, 1, 5 };
+        ASSERT_EQ(4, cores.size());
+        EXPECT_SEQUENCE_EQ(4, Expected, &cores[0]);
+    }
+
+    TEST_CASE(GetNumaNodeCpuCores_GivenFirstNode_ReturnsCores)
+    {
+        const size_t node_count = System::get_numa_node_count();
+        ASSERT_GT(0, node_count);
+
+        vector<size_t> cores;
+        System::get_numa_node_cpu_cores(0, cores);
+
+        EXPECT_FALSE(cores.empty());
+    }
+}
@@ -0,0 +1,205 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+#include "foundation/math/voxel.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace foundation;
+using namespace std;
+
+TEST_SUITE(Foundation_Math_Voxel_Tree)
+{
+    typedef voxel::Tree<float, 3> TreeType;
+    typedef voxel::Builder<TreeType> BuilderType;
+
+    class SphereIntersector
+    {
+      public:
+        SphereIntersector(const Vector3f& center, const float radius)
+          : m_center(center)
+          , m_square_radius(radius * radius)
+        {
+        }
+
+        bool intersect(const AABB3f& bbox) const
+        {
+            float square_distance = 0.0f;
+
+            for (size_t i = 0; i < 3; ++i)
+            {
+                if (m_center[i] < bbox.min[i])
+                    square_distance += (bbox.min[i] - m_center[i]) * (bbox.min[i] - m_center[i]);
+                else if (m_center[i] > bbox.max[i])
+                    square_distance += (m_center[i] - bbox.max[i]) * (m_center[i] - bbox.max[i]);
+            }
+
+            return square_distance <= m_square_radius;
+        }
+
+      private:
+        const Vector3f  m_center;
+        const float     m_square_radius;
+    };
+
+    const AABB3f TreeBbox(Vector3f(-1.0f, -1.0f, -1.0f), Vector3f(3.0f, 1.0f, 2.0f));
+    const float MaxExtent = 0.1f;
+
+    vector<SphereIntersector> make_spheres()
+    {
+        vector<SphereIntersector> spheres;
+        spheres.push_back(SphereIntersector(Vector3f(0.0f, 0.0f, 0.0f), 0.5f));
+        spheres.push_back(SphereIntersector(Vector3f(1.0f, 0.2f, 0.5f), 0.6f));
+        spheres.push_back(SphereIntersector(Vector3f(2.5f, -0.5f, 1.5f), 0.3f));
+        return spheres;
+    }
+
+    void build_serial(TreeType& tree)
+    {
+        const vector<SphereIntersector> spheres = make_spheres();
+
+        BuilderType builder(tree, TreeBbox, MaxExtent);
+
+        for (size_t i = 0; i < spheres.size(); ++i)
+            builder.push(spheres[i]);
+
+        builder.complete();
+    }
+
+    void build_grafted(TreeType& tree)
+    {
+        const vector<SphereIntersector> spheres = make_spheres();
+
+        BuilderType builder(tree, TreeBbox, MaxExtent);
+
+        vector<size_t> leaf_indices;
+        vector<AABB3f> leaf_bboxes;
+        builder.subdivide_top_levels(3, leaf_indices, leaf_bboxes);
+
+        for (size_t i = 0; i < leaf_indices.size(); ++i)
+        {
+            TreeType subtree;
+            BuilderType subtree_builder(subtree, leaf_bboxes[i], MaxExtent);
+
+            for (size_t j = 0; j < spheres.size(); ++j)
+            {
+                if (spheres[j].intersect(leaf_bboxes[i]))
+                    subtree_builder.push(spheres[j]);
+            }
+
+            builder.graft(leaf_indices[i], subtree);
+        }
+
+        builder.complete();
+    }
+
+    string dump_solid_leaves(const TreeType& tree, const string& filename)
+    {
+        if (!tree.dump_solid_leaves_to_disk(filename))
+            return string();
+
+        ifstream file(filename.c_str());
+        return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+
+    TEST_CASE(SubdivideTopLevelsAndGraft_ProducesSameSolidLeavesAsSerialBuild)
+    {
+        TreeType serial_tree;
+        build_serial(serial_tree);
+
+        TreeType grafted_tree;
+        build_grafted(grafted_tree);
+
+        const string serial_leaves =
+            dump_solid_leaves(serial_tree, "unit tests/outputs/test_voxeltree_serial.obj");
+        const string grafted_leaves =
+            dump_solid_leaves(grafted_tree, "unit tests/outputs/test_voxeltree_grafted.obj");
+
+        EXPECT_FALSE(serial_leaves.empty());
+        EXPECT_EQ(serial_leaves, grafted_leaves);
+        EXPECT_EQ(serial_tree.get_max_diag_length(), grafted_tree.get_max_diag_length());
+    }
+
+    TEST_CASE(LoadTreeFromDisk_GivenDumpedTree_RestoresTree)
+    {
+        TreeType tree;
+        build_grafted(tree);
+        tree.set_signature(0x0123456789ABCDEFULL);
+        ASSERT_TRUE(tree.dump_tree_to_disk("unit tests/outputs/test_voxeltree.bin"));
+
+        TreeType loaded_tree;
+        ASSERT_TRUE(loaded_tree.load_tree_from_disk("unit tests/outputs/test_voxeltree.bin"));
+
+        EXPECT_TRUE(tree.get_bbox() == loaded_tree.get_bbox());
+        EXPECT_EQ(MaxExtent, loaded_tree.get_max_extent());
+        EXPECT_EQ(0x0123456789ABCDEFULL, loaded_tree.get_signature());
+        EXPECT_EQ(tree.get_max_diag_length(), loaded_tree.get_max_diag_length());
+        EXPECT_EQ(
+            dump_solid_leaves(tree, "unit tests/outputs/test_voxeltree_original.obj"),
+            dump_solid_leaves(loaded_tree, "unit tests/outputs/test_voxeltree_loaded.obj"));
+    }
+
+    TEST_CASE(LoadTreeFromDisk_GivenTruncatedFile_ReturnsFalseAndLeavesTreeEmpty)
+    {
+        TreeType tree;
+        build_serial(tree);
+        ASSERT_TRUE(tree.dump_tree_to_disk("unit tests/outputs/test_voxeltree_truncated.bin"));
+
+        // Drop the last node.
+        string content;
+        {
+            ifstream file("unit tests/outputs/test_voxeltree_truncated.bin", ios::binary);
+            content.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        }
+        {
+            ofstream file("unit tests/outputs/test_voxeltree_truncated.bin", ios::binary);
+            file.write(content.data(), content.size() - 1);
+        }
+
+        TreeType loaded_tree;
+        EXPECT_FALSE(loaded_tree.load_tree_from_disk("unit tests/outputs/test_voxeltree_truncated.bin"));
+        EXPECT_EQ(0.0f, loaded_tree.get_max_diag_length());
+        EXPECT_FALSE(loaded_tree.get_bbox().is_valid());
+    }
+
+    TEST_CASE(LoadTreeFromDisk_GivenMissingFile_ReturnsFalse)
+    {
+        TreeType tree;
+
+        EXPECT_FALSE(tree.load_tree_from_disk("unit tests/outputs/test_voxeltree_missing.bin"));
+    }
+}
@@ -37,6 +37,8 @@
 #include "foundation/utility/string.h"
 
 // Standard headers.
+#include <algorithm>
+#include <cstdlib>
 #include <string>
 
 // Windows.
@@ -61,6 +63,7 @@
     #include <mach/task_info.h>
     #include <sys/mount.h>
     #include <sys/param.h>
+    #include <sys/resource.h>
     #include <sys/sysctl.h>
     #include <sys/types.h>
 
@@ -69,8 +72,10 @@
 
     // Standard headers.
     #include <cstdio>
+    #include <cstdlib>
 
     // Platform headers.
+    #include <sys/resource.h>
     #include <sys/sysinfo.h>
     #include <sys/types.h>
     #include <unistd.h>
@@ -95,12 +100,14 @@ void System::print_information(Logger& logger)
         logger,
         "system information:\n"
         "  logical cores    %s\n"
+        "  NUMA nodes       %s\n"
         "  L1 data cache    size %s, line size %s\n"
         "  L2 cache         size %s, line size %s\n"
         "  L3 cache         size %s, line size %s\n"
         "  physical memory  size %s\n"
         "  virtual memory   size %s",
         pretty_uint(get_logical_cpu_core_count()).c_str(),
+        pretty_uint(get_numa_node_count()).c_str(),
         pretty_size(get_l1_data_cache_size()).c_str(),
         pretty_size(get_l1_data_cache_line_size()).c_str(),
         pretty_size(get_l2_cache_size()).c_str(),
@@ -124,6 +131,73 @@ uint64 System::get_cpu_core_frequency(const uint32 calibration_time_ms)
     return X86Timer(calibration_time_ms).frequency();
 }
 
+namespace
+{
+    // Used on platforms, or in situations, where the NUMA topology is unknown.
+    void get_all_cpu_cores(vector<size_t>& cores)
+    {
+        const size_t core_count = System::get_logical_cpu_core_count();
+
+        cores.clear();
+        cores.reserve(core_count);
+
+        for (size_t i = 0; i < core_count; ++i)
+            cores.push_back(i);
+    }
+}
+
+void System::interleave_numa_node_cpu_cores(
+    const vector<vector<size_t> >&  node_cores,
+    vector<size_t>&                 cores)
+{
+    const size_t node_count = node_cores.size();
+
+    size_t max_node_core_count = 0;
+    for (size_t i = 0; i < node_count; ++i)
+        max_node_core_count = max(max_node_core_count, node_cores[i].size());
+
+    cores.clear();
+
+    for (size_t j = 0; j < max_node_core_count; ++j)
+    {
+        for (size_t i = 0; i < node_count; ++i)
+        {
+            if (j < node_cores[i].size())
+                cores.push_back(node_cores[i][j]);
+        }
+    }
+}
+
+void System::parse_cpu_list(
+    const char*                     s,
+    vector<size_t>&                 indices)
+{
+    while (*s)
+    {
+        char* end;
+        const unsigned long first = strtoul(s, &end, 10);
+        if (end == s)
+            break;
+
+        unsigned long last = first;
+        s = end;
+
+        if (*s == '-')
+        {
+            last = strtoul(s + 1, &end, 10);
+            s = end;
+        }
+
+        for (unsigned long i = first; i <= last; ++i)
+            indices.push_back(static_cast<size_t>(i));
+
+        if (*s != ',')
+            break;
+
+        ++s;
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 // Windows.
 // ------------------------------------------------------------------------------------------------
@@ -177,6 +251,37 @@ namespace
     }
 }
 
+size_t System::get_numa_node_count()
+{
+    ULONG highest_node;
+    if (!GetNumaHighestNodeNumber(&highest_node))
+        return 1;
+
+    return static_cast<size_t>(highest_node) + 1;
+}
+
+void System::get_numa_node_cpu_cores(
+    const size_t            node,
+    vector<size_t>&         cores)
+{
+    ULONGLONG mask;
+    if (!GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask))
+    {
+        if (node == 0)
+            get_all_cpu_cores(cores);
+        else cores.clear();
+        return;
+    }
+
+    cores.clear();
+
+    for (size_t i = 0; i < 64; ++i)
+    {
+        if (mask & (ULONGLONG(1) << i))
+            cores.push_back(i);
+    }
+}
+
 size_t System::get_l1_data_cache_size()
 {
     CACHE_DESCRIPTOR cache;
@@ -248,6 +353,14 @@ uint64 System::get_process_virtual_memory_size()
     return pmc.PrivateUsage;
 }
 
+uint64 System::get_peak_process_virtual_memory_size()
+{
+    PROCESS_MEMORY_COUNTERS pmc;
+    GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+
+    return pmc.PeakPagefileUsage;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Mac OS X.
 // ------------------------------------------------------------------------------------------------
@@ -264,6 +377,20 @@ namespace
     }
 }
 
+size_t System::get_numa_node_count()
+{
+    return 1;
+}
+
+void System::get_numa_node_cpu_cores(
+    const size_t            node,
+    vector<size_t>&         cores)
+{
+    if (node == 0)
+        get_all_cpu_cores(cores);
+    else cores.clear();
+}
+
 size_t System::get_l1_data_cache_size()
 {
     return get_system_value("hw.l1dcachesize");
@@ -345,12 +472,78 @@ uint64 System::get_process_virtual_memory_size()
     return info.resident_size;
 }
 
+uint64 System::get_peak_process_virtual_memory_size()
+{
+    // On Mac OS X, ru_maxrss is expressed in bytes.
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+    return static_cast<uint64>(usage.ru_maxrss);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Linux.
 // ------------------------------------------------------------------------------------------------
 
 #elif defined __linux__
 
+namespace
+{
+    // Read a list of index ranges from a file of /sys/devices/system/node.
+    bool read_sysfs_list(const char* path, vector<size_t>& indices)
+    {
+        indices.clear();
+
+        FILE* fp = fopen(path, "r");
+        if (fp == 0)
+            return false;
+
+        char buffer[4096];
+        if (fgets(buffer, sizeof(buffer), fp))
+            System::parse_cpu_list(buffer, indices);
+
+        fclose(fp);
+
+        return !indices.empty();
+    }
+
+    // Retrieve the system numbers of the online NUMA nodes. Node numbers may have gaps.
+    bool get_online_numa_nodes(vector<size_t>& nodes)
+    {
+        return read_sysfs_list("/sys/devices/system/node/online", nodes);
+    }
+}
+
+size_t System::get_numa_node_count()
+{
+    vector<size_t> nodes;
+    return get_online_numa_nodes(nodes) ? nodes.size() : 1;
+}
+
+void System::get_numa_node_cpu_cores(
+    const size_t            node,
+    vector<size_t>&         cores)
+{
+    cores.clear();
+
+    vector<size_t> nodes;
+    if (!get_online_numa_nodes(nodes))
+    {
+        // No NUMA information (e.g. kernel built without NUMA support): assume a single node.
+        if (node == 0)
+            get_all_cpu_cores(cores);
+        return;
+    }
+
+    if (node >= nodes.size())
+        return;
+
+    char path[64];
+    sprintf(path, "/sys/devices/system/node/node%lu/cpulist", static_cast<unsigned long>(nodes[node]));
+    read_sysfs_list(path, cores);
+}
+
 size_t System::get_l1_data_cache_size()
 {
     return sysconf(_SC_LEVEL1_DCACHE_SIZE);
@@ -425,6 +618,16 @@ uint64 System::get_process_virtual_memory_size()
     return static_cast<uint64>(rss) * sysconf(_SC_PAGESIZE);
 }
 
+uint64 System::get_peak_process_virtual_memory_size()
+{
+    // On Linux, ru_maxrss is expressed in kilobytes.
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+    return static_cast<uint64>(usage.ru_maxrss) * 1024;
+}
+
 #endif
 
 }   // namespace foundation
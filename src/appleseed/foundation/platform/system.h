@@ -39,6 +39,7 @@
 
 // Standard headers.
 #include <cstddef>
+#include <vector>
 
 // Forward declarations.
 namespace foundation    { class Logger; }
@@ -67,6 +68,32 @@ class DLLSYMBOL System
     // Return the frequency, in Hz, of a given CPU core at this instant.
     static uint64 get_cpu_core_frequency(const uint32 calibration_time_ms = 10);
 
+    //
+    // NUMA topology.
+    //
+
+    // Return the number of NUMA nodes in the system, 1 on non-NUMA systems.
+    static size_t get_numa_node_count();
+
+    // Retrieve the indices of the logical CPU cores that belong to a given NUMA node.
+    // Nodes are numbered from 0 to get_numa_node_count() - 1, even if the system
+    // numbers them differently (e.g. when some nodes are offline).
+    static void get_numa_node_cpu_cores(
+        const size_t            node,
+        std::vector<size_t>&    cores);
+
+    // Merge the logical CPU cores of multiple NUMA nodes by interleaving nodes:
+    // the first core of each node, then the second core of each node, and so on.
+    static void interleave_numa_node_cpu_cores(
+        const std::vector<std::vector<size_t> >&    node_cores,
+        std::vector<size_t>&                        cores);
+
+    // Parse a list of index ranges such as "0-7,16-23", the format in which Linux
+    // describes sets of CPU cores or NUMA nodes. Indices are appended to a vector.
+    static void parse_cpu_list(
+        const char*             s,
+        std::vector<size_t>&    indices);
+
     //
     // CPU caches.
     //
@@ -105,6 +132,9 @@ class DLLSYMBOL System
 
     // Return the amount in bytes of virtual memory used by the current process.
     static uint64 get_process_virtual_memory_size();
+
+    // Return the peak amount in bytes of virtual memory used by the current process.
+    static uint64 get_peak_process_virtual_memory_size();
 };
 
 }       // namespace foundation
@@ -39,6 +39,12 @@
 // boost headers.
 #include "boost/date_time/posix_time/posix_time_types.hpp"
 
+// Platform headers.
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 // Standard headers.
 #include <cassert>
 
@@ -272,4 +278,38 @@ void yield()
     this_thread::yield();
 }
 
+#if defined _WIN32
+
+bool set_current_thread_cpu_affinity(const size_t core)
+{
+    if (core >= sizeof(DWORD_PTR) * 8)
+        return false;
+
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core) != 0;
+}
+
+#elif defined __linux__
+
+bool set_current_thread_cpu_affinity(const size_t core)
+{
+    if (core >= CPU_SETSIZE)
+        return false;
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core, &cpu_set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+}
+
+#else
+
+bool set_current_thread_cpu_affinity(const size_t core)
+{
+    // Thread affinity is not supported on this platform (Mac OS X only offers affinity hints).
+    return false;
+}
+
+#endif
+
 }   // namespace foundation
@@ -37,6 +37,9 @@
 // appleseed.main headers.
 #include "main/dllsymbol.h"
 
+// Standard headers.
+#include <cstddef>
+
 // boost headers.
 #include "boost/interprocess/detail/atomic.hpp"
 #include "boost/smart_ptr/detail/spinlock.hpp"
@@ -206,6 +209,10 @@ DLLSYMBOL void sleep(const uint32 ms);
 // Give up the remainder of the current thread's time slice, to allow other threads to run.
 DLLSYMBOL void yield();
 
+// Restrict the current thread to run on a given logical CPU core.
+// Return false if the affinity could not be set or is not supported on this platform.
+DLLSYMBOL bool set_current_thread_cpu_affinity(const size_t core);
+
 
 //
 // Spinlock class implementation.
@@ -99,6 +99,9 @@ class AttributeSet
         const size_t        index,
         T*                  value) const;
 
+    // Return the size (in bytes) of this object in memory.
+    size_t get_memory_size() const;
+
   private:
     struct Channel
     {
@@ -126,6 +129,16 @@ inline size_t AttributeSet::get_attribute_count(const ChannelID channel_id) cons
     return channel->m_storage.size() / channel->m_value_size;
 }
 
+inline size_t AttributeSet::get_memory_size() const
+{
+    size_t size = sizeof(*this) + m_channels.capacity() * sizeof(Channel*);
+
+    for (size_t i = 0; i < m_channels.size(); ++i)
+        size += sizeof(Channel) + m_channels[i]->m_storage.capacity();
+
+    return size;
+}
+
 template <typename T>
 inline size_t AttributeSet::push_attribute(
     const ChannelID         channel_id,
@@ -469,6 +469,9 @@ class LRUCache
     // Get an element from the cache.
     ElementType& get(const KeyType& key);
 
+    // Invalidate the cache entries whose keys lie in [begin_key, end_key).
+    void invalidate(const KeyType& begin_key, const KeyType& end_key);
+
     // Return the size (in bytes) of this object in memory.
     size_t get_memory_size() const;
 
@@ -957,6 +960,28 @@ get(const KeyType& key)
     }
 }
 
+FOUNDATION_LRUCACHE_TEMPLATE_DEF(void)
+invalidate(const KeyType& begin_key, const KeyType& end_key)
+{
+    typename Index::iterator i = m_index.lower_bound(begin_key);
+    const typename Index::iterator e = m_index.lower_bound(end_key);
+
+    while (i != e)
+    {
+        // Unload the element.
+#ifndef NDEBUG
+        const bool success =
+#endif
+        m_element_swapper.unload(i->second->m_key, i->second->m_element);
+        assert(success);
+
+        // Remove the element from the queue and from the index.
+        m_queue.erase(i->second);
+        --m_queue_size;
+        m_index.erase(i++);
+    }
+}
+
 FOUNDATION_LRUCACHE_TEMPLATE_DEF(inline size_t)
 get_memory_size() const
 {
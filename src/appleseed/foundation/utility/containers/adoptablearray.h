@@ -0,0 +1,318 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#ifndef APPLESEED_FOUNDATION_UTILITY_CONTAINERS_ADOPTABLEARRAY_H
+#define APPLESEED_FOUNDATION_UTILITY_CONTAINERS_ADOPTABLEARRAY_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/iunknown.h"
+#include "foundation/core/concepts/noncopyable.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace foundation
+{
+
+//
+// A contiguous array of elements that either owns its storage, like std::vector,
+// or references an externally owned buffer that it adopted without copying it.
+//
+// An adopted buffer is read and written in place. The first operation that may
+// change the size of the array (push_back(), reserve(), resize()) copies the
+// adopted elements into owned storage and releases the adopted buffer.
+//
+
+template <typename T>
+class AdoptableArray
+  : public NonCopyable
+{
+  public:
+    // Types.
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef size_t size_type;
+
+    // Constructor.
+    AdoptableArray();
+
+    // Destructor.
+    ~AdoptableArray();
+
+    // Return the number of elements in the array.
+    size_type size() const;
+
+    // Return true if the array is empty.
+    bool empty() const;
+
+    // Remove all elements, releasing the adopted buffer if any.
+    void clear();
+
+    // Reserve memory for a given number of elements.
+    void reserve(const size_type count);
+
+    // Change the number of elements in the array.
+    void resize(const size_type new_size);
+
+    // Append an element to the array.
+    void push_back(const value_type& val);
+
+    // Append a contiguous range of elements to the array.
+    void append(const value_type* values, const size_type count);
+
+    // Reference an externally owned buffer of elements instead of the current content of the array.
+    // The buffer must remain valid until owner->release() is called, which happens as soon as the
+    // array stops referencing it. If owner is 0, the buffer must outlive the array or the adoption.
+    void adopt(
+        value_type*         values,
+        const size_type     count,
+        IUnknown*           owner = 0);
+
+    // Return true if the array references an adopted buffer.
+    bool is_adopted() const;
+
+    // Element access.
+    reference operator[](const size_type pos);
+    const_reference operator[](const size_type pos) const;
+    value_type* data();
+    const value_type* data() const;
+
+    // Iterators.
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+  private:
+    std::vector<T>  m_owned;
+    value_type*     m_data;
+    size_type       m_size;
+    bool            m_adopted;
+    IUnknown*       m_owner;
+
+    void make_owned();
+    void release_adopted();
+    void update_from_owned();
+};
+
+
+//
+// AdoptableArray class implementation.
+//
+
+template <typename T>
+inline AdoptableArray<T>::AdoptableArray()
+  : m_data(0)
+  , m_size(0)
+  , m_adopted(false)
+  , m_owner(0)
+{
+}
+
+template <typename T>
+inline AdoptableArray<T>::~AdoptableArray()
+{
+    release_adopted();
+}
+
+template <typename T>
+inline size_t AdoptableArray<T>::size() const
+{
+    return m_size;
+}
+
+template <typename T>
+inline bool AdoptableArray<T>::empty() const
+{
+    return m_size == 0;
+}
+
+template <typename T>
+void AdoptableArray<T>::clear()
+{
+    release_adopted();
+
+    std::vector<T>().swap(m_owned);
+    update_from_owned();
+}
+
+template <typename T>
+void AdoptableArray<T>::reserve(const size_type count)
+{
+    make_owned();
+
+    m_owned.reserve(count);
+    update_from_owned();
+}
+
+template <typename T>
+void AdoptableArray<T>::resize(const size_type new_size)
+{
+    make_owned();
+
+    m_owned.resize(new_size);
+    update_from_owned();
+}
+
+template <typename T>
+inline void AdoptableArray<T>::push_back(const value_type& val)
+{
+    if (m_adopted)
+        make_owned();
+
+    m_owned.push_back(val);
+    update_from_owned();
+}
+
+template <typename T>
+void AdoptableArray<T>::append(const value_type* values, const size_type count)
+{
+    assert(values || count == 0);
+
+    make_owned();
+
+    m_owned.insert(m_owned.end(), values, values + count);
+    update_from_owned();
+}
+
+template <typename T>
+void AdoptableArray<T>::adopt(
+    value_type*         values,
+    const size_type     count,
+    IUnknown*           owner)
+{
+    assert(values || count == 0);
+
+    release_adopted();
+    std::vector<T>().swap(m_owned);
+
+    m_data = values;
+    m_size = count;
+    m_adopted = true;
+    m_owner = owner;
+}
+
+template <typename T>
+inline bool AdoptableArray<T>::is_adopted() const
+{
+    return m_adopted;
+}
+
+template <typename T>
+inline T& AdoptableArray<T>::operator[](const size_type pos)
+{
+    assert(pos < m_size);
+    return m_data[pos];
+}
+
+template <typename T>
+inline const T& AdoptableArray<T>::operator[](const size_type pos) const
+{
+    assert(pos < m_size);
+    return m_data[pos];
+}
+
+template <typename T>
+inline T* AdoptableArray<T>::data()
+{
+    return m_data;
+}
+
+template <typename T>
+inline const T* AdoptableArray<T>::data() const
+{
+    return m_data;
+}
+
+template <typename T>
+inline T* AdoptableArray<T>::begin()
+{
+    return m_data;
+}
+
+template <typename T>
+inline T* AdoptableArray<T>::end()
+{
+    return m_data + m_size;
+}
+
+template <typename T>
+inline const T* AdoptableArray<T>::begin() const
+{
+    return m_data;
+}
+
+template <typename T>
+inline const T* AdoptableArray<T>::end() const
+{
+    return m_data + m_size;
+}
+
+template <typename T>
+void AdoptableArray<T>::make_owned()
+{
+    if (m_adopted)
+    {
+        std::vector<T> owned(m_data, m_data + m_size);
+        release_adopted();
+        m_owned.swap(owned);
+        update_from_owned();
+    }
+}
+
+template <typename T>
+void AdoptableArray<T>::release_adopted()
+{
+    if (m_adopted)
+    {
+        if (m_owner)
+            m_owner->release();
+
+        m_data = 0;
+        m_size = 0;
+        m_adopted = false;
+        m_owner = 0;
+    }
+}
+
+template <typename T>
+inline void AdoptableArray<T>::update_from_owned()
+{
+    m_data = m_owned.empty() ? 0 : &m_owned[0];
+    m_size = m_owned.size();
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_UTILITY_CONTAINERS_ADOPTABLEARRAY_H
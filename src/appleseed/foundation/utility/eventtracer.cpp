@@ -0,0 +1,254 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "eventtracer.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/defaulttimers.h"
+
+// boost headers.
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/tss.hpp"
+
+// Standard headers.
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace boost;
+using namespace std;
+
+namespace foundation
+{
+
+namespace
+{
+    struct Event
+    {
+        const char*     m_name;
+        const char*     m_category;
+        uint64          m_begin_time;
+        uint64          m_end_time;
+    };
+
+    // Events recorded by a single thread. Only the owning thread writes to it.
+    struct ThreadBuffer
+    {
+        size_t          m_thread_id;
+        string          m_thread_name;
+        vector<Event>   m_events;
+    };
+
+    // Thread buffers outlive their threads so that their events can be written at any time.
+    class ThreadBufferRegistry
+      : public NonCopyable
+    {
+      public:
+        ~ThreadBufferRegistry()
+        {
+            for (size_t i = 0; i < m_buffers.size(); ++i)
+                delete m_buffers[i];
+        }
+
+        ThreadBuffer* create_buffer()
+        {
+            ThreadBuffer* buffer = new ThreadBuffer();
+            buffer->m_events.reserve(4096);
+
+            mutex::scoped_lock lock(m_mutex);
+            buffer->m_thread_id = m_buffers.size();
+            m_buffers.push_back(buffer);
+
+            return buffer;
+        }
+
+        mutex                   m_mutex;
+        vector<ThreadBuffer*>   m_buffers;
+    };
+
+    ThreadBufferRegistry g_registry;
+
+    // Thread buffers are owned by the registry, not by the threads.
+    void release_thread_buffer(ThreadBuffer* buffer)
+    {
+    }
+
+    thread_specific_ptr<ThreadBuffer> g_thread_buffer(release_thread_buffer);
+
+    ThreadBuffer& get_thread_buffer()
+    {
+        ThreadBuffer* buffer = g_thread_buffer.get();
+
+        if (buffer == 0)
+        {
+            buffer = g_registry.create_buffer();
+            g_thread_buffer.reset(buffer);
+        }
+
+        return *buffer;
+    }
+
+    // Write a string as a JSON string literal.
+    void write_json_string(FILE* file, const char* s)
+    {
+        fputc('"', file);
+
+        for (; *s; ++s)
+        {
+            if (*s == '"' || *s == '\\')
+                fputc('\\', file);
+            fputc(*s, file);
+        }
+
+        fputc('"', file);
+    }
+}
+
+
+//
+// EventTracer class implementation.
+//
+
+bool EventTracer::s_enabled = false;
+
+void EventTracer::enable()
+{
+    s_enabled = true;
+}
+
+void EventTracer::disable()
+{
+    s_enabled = false;
+}
+
+uint64 EventTracer::get_time()
+{
+    DefaultWallclockTimer timer;
+    const uint64 frequency = timer.frequency();
+    const uint64 value = timer.read();
+
+    return frequency == 1000000 ? value : value * 1000000 / frequency;
+}
+
+void EventTracer::record(
+    const char*     name,
+    const char*     category,
+    const uint64    begin_time,
+    const uint64    end_time)
+{
+    Event event;
+    event.m_name = name;
+    event.m_category = category;
+    event.m_begin_time = begin_time;
+    event.m_end_time = end_time;
+
+    get_thread_buffer().m_events.push_back(event);
+}
+
+void EventTracer::set_thread_name(const char* name)
+{
+    if (s_enabled)
+        get_thread_buffer().m_thread_name = name;
+}
+
+size_t EventTracer::get_event_count()
+{
+    mutex::scoped_lock lock(g_registry.m_mutex);
+
+    size_t event_count = 0;
+
+    for (size_t i = 0; i < g_registry.m_buffers.size(); ++i)
+        event_count += g_registry.m_buffers[i]->m_events.size();
+
+    return event_count;
+}
+
+void EventTracer::clear()
+{
+    mutex::scoped_lock lock(g_registry.m_mutex);
+
+    for (size_t i = 0; i < g_registry.m_buffers.size(); ++i)
+        g_registry.m_buffers[i]->m_events.clear();
+}
+
+bool EventTracer::write(const char* filepath)
+{
+    FILE* file = fopen(filepath, "wt");
+
+    if (file == 0)
+        return false;
+
+    mutex::scoped_lock lock(g_registry.m_mutex);
+
+    fprintf(file, "{\"traceEvents\":[\n");
+
+    bool first = true;
+
+    for (size_t i = 0; i < g_registry.m_buffers.size(); ++i)
+    {
+        const ThreadBuffer& buffer = *g_registry.m_buffers[i];
+
+        if (!buffer.m_thread_name.empty())
+        {
+            fprintf(
+                file,
+                "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" FMT_SIZE_T ",\"args\":{\"name\":",
+                first ? "" : ",\n",
+                buffer.m_thread_id);
+            write_json_string(file, buffer.m_thread_name.c_str());
+            fprintf(file, "}}");
+            first = false;
+        }
+
+        for (size_t j = 0; j < buffer.m_events.size(); ++j)
+        {
+            const Event& event = buffer.m_events[j];
+
+            fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+            write_json_string(file, event.m_name);
+            fprintf(file, ",\"cat\":");
+            write_json_string(file, event.m_category);
+            fprintf(
+                file,
+                ",\"ph\":\"X\",\"pid\":1,\"tid\":" FMT_SIZE_T ",\"ts\":" FMT_UINT64 ",\"dur\":" FMT_UINT64 "}",
+                buffer.m_thread_id,
+                event.m_begin_time,
+                event.m_end_time - event.m_begin_time);
+            first = false;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+
+    fclose(file);
+
+    return true;
+}
+
+}   // namespace foundation
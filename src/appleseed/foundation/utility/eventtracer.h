@@ -0,0 +1,151 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_UTILITY_EVENTTRACER_H
+#define APPLESEED_FOUNDATION_UTILITY_EVENTTRACER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/types.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+
+namespace foundation
+{
+
+//
+// A timeline of the events recorded by all threads, written in the Chrome trace event
+// format (the resulting file can be loaded in chrome://tracing).
+//
+// Every thread records events into its own buffer, so recording an event never requires
+// any synchronization. When event tracing is disabled, a scoped event costs a single test.
+//
+// Event names and categories are not copied: they must be string literals.
+//
+
+class DLLSYMBOL EventTracer
+  : public NonCopyable
+{
+  public:
+    // Enable or disable the recording of events. Recorded events are kept when disabling.
+    static void enable();
+    static void disable();
+    static bool is_enabled();
+
+    // Return the current time, in microseconds.
+    static uint64 get_time();
+
+    // Record a complete event on the calling thread. Times are in microseconds.
+    static void record(
+        const char*     name,
+        const char*     category,
+        const uint64    begin_time,
+        const uint64    end_time);
+
+    // Set the name of the calling thread, as displayed in the timeline.
+    static void set_thread_name(const char* name);
+
+    // Return the number of recorded events.
+    // Must not be called while events are being recorded.
+    static size_t get_event_count();
+
+    // Discard all recorded events.
+    // Must not be called while events are being recorded.
+    static void clear();
+
+    // Write all recorded events to a file. Return true on success, false otherwise.
+    // Must not be called while events are being recorded.
+    static bool write(const char* filepath);
+
+  private:
+    static bool s_enabled;
+};
+
+
+//
+// Record an event spanning the lifetime of this object.
+//
+
+class ScopedEvent
+  : public NonCopyable
+{
+  public:
+    // Constructor, starts the event.
+    ScopedEvent(
+        const char*     name,
+        const char*     category);
+
+    // Destructor, ends the event.
+    ~ScopedEvent();
+
+  private:
+    const char*         m_name;
+    const char*         m_category;
+    const bool          m_enabled;
+    uint64              m_begin_time;
+};
+
+
+//
+// EventTracer class implementation.
+//
+
+inline bool EventTracer::is_enabled()
+{
+    return s_enabled;
+}
+
+
+//
+// ScopedEvent class implementation.
+//
+
+inline ScopedEvent::ScopedEvent(
+    const char*         name,
+    const char*         category)
+  : m_name(name)
+  , m_category(category)
+  , m_enabled(EventTracer::is_enabled())
+{
+    if (m_enabled)
+        m_begin_time = EventTracer::get_time();
+}
+
+inline ScopedEvent::~ScopedEvent()
+{
+    if (m_enabled)
+        EventTracer::record(m_name, m_category, m_begin_time, EventTracer::get_time());
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_UTILITY_EVENTTRACER_H
@@ -33,6 +33,29 @@
 namespace foundation
 {
 
+namespace foreach_impl
+{
+    // Value type of an iterator. Raw pointers are supported as well
+    // without requiring iterators to provide full iterator traits.
+    template <typename Iterator>
+    struct IteratorValueType
+    {
+        typedef typename Iterator::value_type Type;
+    };
+
+    template <typename T>
+    struct IteratorValueType<T*>
+    {
+        typedef T Type;
+    };
+
+    template <typename T>
+    struct IteratorValueType<const T*>
+    {
+        typedef T Type;
+    };
+}   // namespace foreach_impl
+
 //
 // Helper classes to iterate over the elements of a collection.
 //
@@ -50,7 +73,7 @@ class const_each
   public:
     // Types.
     typedef typename C::const_iterator const_iterator;
-    typedef typename const_iterator::value_type value_type;
+    typedef typename foreach_impl::IteratorValueType<const_iterator>::Type value_type;
 
     // Constructor.
     const_each(const C& c);
@@ -83,7 +106,7 @@ class each
   public:
     // Types.
     typedef typename C::iterator iterator;
-    typedef typename iterator::value_type value_type;
+    typedef typename foreach_impl::IteratorValueType<iterator>::Type value_type;
 
     // Constructor.
     each(C& c);
@@ -0,0 +1,150 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "jobcounter.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/compiler.h"
+#include "foundation/platform/thread.h"
+#include "foundation/utility/job/ijob.h"
+#include "foundation/utility/job/jobqueue.h"
+
+// boost headers.
+#include "boost/thread/condition_variable.hpp"
+
+// Standard headers.
+#include <cassert>
+
+namespace foundation
+{
+
+//
+// JobCounter class implementation.
+//
+
+struct JobCounter::Impl
+{
+    mutable boost::mutex            m_mutex;
+    boost::condition_variable_any   m_event;
+    size_t                          m_pending_job_count;
+
+    Impl()
+      : m_pending_job_count(0)
+    {
+    }
+};
+
+// Wraps a counted job. The wrapper is always owned by the job queue, and the job
+// is retired when the wrapper is deleted, whether the job was executed or not.
+class JobCounter::CountedJob
+  : public IJob
+{
+  public:
+    CountedJob(
+        JobCounter&     counter,
+        IJob*           job,
+        const bool      owned)
+      : m_counter(counter)
+      , m_job(job)
+      , m_owned(owned)
+    {
+    }
+
+    ~CountedJob()
+    {
+        if (m_owned)
+            delete m_job;
+
+        m_counter.retire_job();
+    }
+
+    virtual void execute(const size_t thread_index) OVERRIDE
+    {
+        m_job->execute(thread_index);
+    }
+
+  private:
+    JobCounter&         m_counter;
+    IJob*               m_job;
+    const bool          m_owned;
+};
+
+JobCounter::JobCounter()
+  : impl(new Impl())
+{
+}
+
+JobCounter::~JobCounter()
+{
+    assert(impl->m_pending_job_count == 0);
+
+    delete impl;
+}
+
+void JobCounter::schedule(
+    JobQueue&           job_queue,
+    IJob*               job,
+    const bool          transfer_ownership)
+{
+    assert(job);
+
+    {
+        boost::mutex::scoped_lock lock(impl->m_mutex);
+        ++impl->m_pending_job_count;
+    }
+
+    job_queue.schedule(new CountedJob(*this, job, transfer_ownership));
+}
+
+size_t JobCounter::get_pending_job_count() const
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    return impl->m_pending_job_count;
+}
+
+void JobCounter::wait_until_completion()
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    while (impl->m_pending_job_count > 0)
+        impl->m_event.wait(lock);
+}
+
+void JobCounter::retire_job()
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    assert(impl->m_pending_job_count > 0);
+    --impl->m_pending_job_count;
+
+    if (impl->m_pending_job_count == 0)
+        impl->m_event.notify_all();
+}
+
+}   // namespace foundation
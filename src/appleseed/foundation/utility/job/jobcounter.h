@@ -0,0 +1,88 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef APPLESEED_FOUNDATION_UTILITY_JOB_JOBCOUNTER_H
+#define APPLESEED_FOUNDATION_UTILITY_JOB_JOBCOUNTER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+
+// Forward declarations.
+namespace foundation    { class IJob; }
+namespace foundation    { class JobQueue; }
+
+namespace foundation
+{
+
+//
+// Keeps track of a group of jobs scheduled on a job queue that may be shared with
+// other jobs, so that one can wait for the completion of this group only.
+//
+// All methods of this class, excepted the destructor, are thread-safe.
+//
+
+class DLLSYMBOL JobCounter
+  : public NonCopyable
+{
+  public:
+    // Constructor.
+    JobCounter();
+
+    // Destructor. All jobs scheduled through this counter must be completed.
+    ~JobCounter();
+
+    // Schedule a job for execution on a given job queue. Ownership of the job
+    // is transfered to the job queue if and only if transfer_ownership is true.
+    void schedule(
+        JobQueue&       job_queue,
+        IJob*           job,
+        const bool      transfer_ownership = true);
+
+    // Return the number of jobs scheduled through this counter that are not yet completed.
+    size_t get_pending_job_count() const;
+
+    // Wait until all jobs scheduled through this counter are completed.
+    void wait_until_completion();
+
+  private:
+    class CountedJob;
+
+    struct Impl;
+    Impl* impl;
+
+    void retire_job();
+};
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_UTILITY_JOB_JOBCOUNTER_H
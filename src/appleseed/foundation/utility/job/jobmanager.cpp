@@ -31,11 +31,18 @@
 #include "jobmanager.h"
 
 // appleseed.foundation headers.
+#include "foundation/platform/compiler.h"
+#include "foundation/platform/system.h"
+#include "foundation/utility/job/ijob.h"
+#include "foundation/utility/job/jobcounter.h"
 #include "foundation/utility/job/jobqueue.h"
 #include "foundation/utility/job/workerthread.h"
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/log.h"
 
+// boost headers.
+#include "boost/thread/barrier.hpp"
+
 // Standard headers.
 #include <cassert>
 #include <vector>
@@ -50,6 +57,49 @@ namespace foundation
 // JobManager class implementation.
 //
 
+namespace
+{
+    // Collect the logical CPU cores of the system, interleaving NUMA nodes. Assigning cores
+    // to worker threads in this order spreads the threads, and the memory they use, evenly
+    // across nodes.
+    void collect_cpu_cores_by_numa_node(vector<size_t>& cpu_cores)
+    {
+        const size_t node_count = System::get_numa_node_count();
+
+        vector<vector<size_t> > node_cores(node_count);
+        for (size_t i = 0; i < node_count; ++i)
+            System::get_numa_node_cpu_cores(i, node_cores[i]);
+
+        System::interleave_numa_node_cpu_cores(node_cores, cpu_cores);
+    }
+
+    // A job that waits until every worker thread holds one, then executes another job.
+    class BarrierJob
+      : public IJob
+    {
+      public:
+        BarrierJob(
+            IJob&               job,
+            boost::barrier&     barrier)
+          : m_job(job)
+          , m_barrier(barrier)
+        {
+        }
+
+        virtual void execute(const size_t thread_index) OVERRIDE
+        {
+            // No worker thread can acquire a second job before all threads acquired one.
+            m_barrier.wait();
+
+            m_job.execute(thread_index);
+        }
+
+      private:
+        IJob&                   m_job;
+        boost::barrier&         m_barrier;
+    };
+}
+
 struct JobManager::Impl
 {
     typedef vector<WorkerThread*> WorkerThreads;
@@ -103,14 +153,23 @@ void JobManager::start()
     // Create the worker threads if they don't already exist.
     if (impl->m_worker_threads.empty())
     {
+        vector<size_t> cpu_cores;
+        if (impl->m_flags & PinWorkerThreads)
+            collect_cpu_cores_by_numa_node(cpu_cores);
+
         for (size_t i = 0; i < impl->m_thread_count; ++i)
         {
+            size_t cpu_core = WorkerThread::AnyCpuCore;
+            if (!cpu_cores.empty())
+                cpu_core = cpu_cores[i % cpu_cores.size()];
+
             impl->m_worker_threads.push_back(
                 new WorkerThread(
                     i,
                     impl->m_logger,
                     impl->m_job_queue,
-                    impl->m_flags));
+                    impl->m_flags,
+                    cpu_core));
         }
     }
 
@@ -119,6 +178,22 @@ void JobManager::start()
         (*i)->start();
 }
 
+void JobManager::execute_on_each_thread(IJob& job)
+{
+    assert(impl->m_flags & KeepRunningOnEmptyQueue);
+    assert(!impl->m_job_queue.has_scheduled_or_running_jobs());
+
+    boost::barrier barrier(static_cast<unsigned int>(impl->m_thread_count));
+
+    JobCounter job_counter;
+    for (size_t i = 0; i < impl->m_thread_count; ++i)
+        job_counter.schedule(impl->m_job_queue, new BarrierJob(job, barrier));
+
+    start();
+
+    job_counter.wait_until_completion();
+}
+
 void JobManager::stop()
 {
     // Stop and delete the worker threads.
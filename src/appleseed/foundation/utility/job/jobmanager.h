@@ -40,6 +40,7 @@
 #include <cstddef>
 
 // Forward declarations.
+namespace foundation    { class IJob; }
 namespace foundation    { class JobQueue; }
 namespace foundation    { class Logger; }
 
@@ -59,7 +60,8 @@ class DLLSYMBOL JobManager
     enum Flags
     {
         KeepRunningOnEmptyQueue = 1 << 0,   // the worker thread keeps running even if the job queue is empty
-        KeepRunningOnJobFailure = 1 << 1    // the worker thread keeps executing jobs from the work queue even if one or more jobs failed
+        KeepRunningOnJobFailure = 1 << 1,   // the worker thread keeps executing jobs from the work queue even if one or more jobs failed
+        PinWorkerThreads        = 1 << 2    // each worker thread is bound to a CPU core, threads are spread evenly across NUMA nodes
     };
 
     // Constructor.
@@ -78,6 +80,13 @@ class DLLSYMBOL JobManager
     // Start job execution. Returns immediately.
     void start();
 
+    // Execute a given job exactly once on each worker thread, starting job execution
+    // if necessary, and return once all executions are completed. The job queue must
+    // be empty and the KeepRunningOnEmptyQueue flag must be set. Per-thread data that
+    // the job allocates is allocated by the thread that will use it, on the NUMA node
+    // of its CPU core when the PinWorkerThreads flag is set.
+    void execute_on_each_thread(IJob& job);
+
     // Stop job execution. Returns once currently running jobs are completed.
     void stop();
 
@@ -33,10 +33,12 @@
 // appleseed.foundation headers.
 #include "foundation/platform/thread.h"
 #include "foundation/platform/types.h"
+#include "foundation/utility/eventtracer.h"
 #include "foundation/utility/job/ijob.h"
 #include "foundation/utility/job/jobmanager.h"
 #include "foundation/utility/job/jobqueue.h"
 #include "foundation/utility/log.h"
+#include "foundation/utility/string.h"
 
 // Standard headers.
 #include <exception>
@@ -55,11 +57,13 @@ WorkerThread::WorkerThread(
     const size_t    index,
     Logger&         logger,
     JobQueue&       job_queue,
-    const int       flags)
+    const int       flags,
+    const size_t    cpu_core)
   : m_index(index)
   , m_logger(logger)
   , m_job_queue(job_queue)
   , m_flags(flags)
+  , m_cpu_core(cpu_core)
   , m_thread_func(*this)
   , m_thread(0)
 {
@@ -100,6 +104,20 @@ void WorkerThread::stop()
 
 void WorkerThread::run()
 {
+    // Pin the thread before it executes any job, so that the memory it touches first
+    // is allocated on the NUMA node of its CPU core.
+    if (m_cpu_core != AnyCpuCore && !set_current_thread_cpu_affinity(m_cpu_core))
+    {
+        LOG_WARNING(
+            m_logger,
+            "worker thread " FMT_SIZE_T ": failed to bind thread to cpu core " FMT_SIZE_T ".",
+            m_index,
+            m_cpu_core);
+    }
+
+    if (EventTracer::is_enabled())
+        EventTracer::set_thread_name(("worker thread " + to_string(m_index)).c_str());
+
     while (!m_abort_switch.is_aborted())
     {
         // Acquire a job.
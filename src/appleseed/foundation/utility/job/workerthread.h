@@ -54,12 +54,16 @@ class WorkerThread
   : public NonCopyable
 {
   public:
+    // Value of the cpu_core parameter for worker threads free to run on any CPU core.
+    static const size_t AnyCpuCore = ~size_t(0);
+
     // Constructor.
     WorkerThread(
         const size_t    index,
         Logger&         logger,
         JobQueue&       job_queue,
-        const int       flags);     // see foundation::JobManager::Flags
+        const int       flags,      // see foundation::JobManager::Flags
+        const size_t    cpu_core = AnyCpuCore);
 
     // Destructor.
     ~WorkerThread();
@@ -92,6 +96,7 @@ class WorkerThread
     Logger&             m_logger;
     JobQueue&           m_job_queue;
     const int           m_flags;
+    const size_t        m_cpu_core;
 
     AbortSwitch         m_abort_switch;
     ThreadFunc          m_thread_func;
@@ -31,6 +31,7 @@
 #define APPLESEED_RENDERER_API_TEXTURE_H
 
 // API headers.
+#include "renderer/kernel/texturing/texturestore.h"
 #include "renderer/modeling/texture/disktexture2d.h"
 #include "renderer/modeling/texture/itexturefactory.h"
 #include "renderer/modeling/texture/texture.h"
@@ -31,6 +31,7 @@
 #define APPLESEED_RENDERER_API_TRACECONTEXT_H
 
 // API headers.
+#include "renderer/kernel/intersection/raystatistics.h"
 #include "renderer/kernel/intersection/tracecontext.h"
 
 #endif  // !APPLESEED_RENDERER_API_TRACECONTEXT_H
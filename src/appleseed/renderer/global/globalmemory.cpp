@@ -0,0 +1,146 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+// Interface header.
+#include "globalmemory.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/system.h"
+#include "foundation/platform/thread.h"
+#include "foundation/utility/string.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+namespace
+{
+    const char* MemoryCategoryNames[MemoryCategoryCount] =
+    {
+        "geometry",
+        "acceleration",
+        "textures",
+        "photon maps",
+        "frame buffers"
+    };
+
+    struct MemoryCounter
+    {
+        Spinlock    m_spinlock;
+        uint64      m_size;
+        uint64      m_peak_size;
+
+        MemoryCounter()
+          : m_size(0)
+          , m_peak_size(0)
+        {
+        }
+    };
+
+    MemoryCounter g_memory_counters[MemoryCategoryCount];
+}
+
+const char* get_memory_category_name(const MemoryCategory category)
+{
+    assert(category < MemoryCategoryCount);
+    return MemoryCategoryNames[category];
+}
+
+void add_memory_size(const MemoryCategory category, const size_t size)
+{
+    assert(category < MemoryCategoryCount);
+
+    MemoryCounter& counter = g_memory_counters[category];
+    Spinlock::ScopedLock lock(counter.m_spinlock);
+
+    counter.m_size += size;
+    counter.m_peak_size = max(counter.m_peak_size, counter.m_size);
+}
+
+void remove_memory_size(const MemoryCategory category, const size_t size)
+{
+    assert(category < MemoryCategoryCount);
+
+    MemoryCounter& counter = g_memory_counters[category];
+    Spinlock::ScopedLock lock(counter.m_spinlock);
+
+    assert(counter.m_size >= size);
+    counter.m_size -= size;
+}
+
+uint64 get_memory_size(const MemoryCategory category)
+{
+    assert(category < MemoryCategoryCount);
+
+    MemoryCounter& counter = g_memory_counters[category];
+    Spinlock::ScopedLock lock(counter.m_spinlock);
+
+    return counter.m_size;
+}
+
+uint64 get_peak_memory_size(const MemoryCategory category)
+{
+    assert(category < MemoryCategoryCount);
+
+    MemoryCounter& counter = g_memory_counters[category];
+    Spinlock::ScopedLock lock(counter.m_spinlock);
+
+    return counter.m_peak_size;
+}
+
+Statistics get_memory_statistics()
+{
+    Statistics stats;
+
+    for (size_t i = 0; i < MemoryCategoryCount; ++i)
+    {
+        const MemoryCategory category = static_cast<MemoryCategory>(i);
+
+        stats.insert<string>(
+            get_memory_category_name(category),
+            pretty_size(get_memory_size(category)) +
+            " (peak " + pretty_size(get_peak_memory_size(category)) + ")");
+    }
+
+    stats.insert<string>(
+        "process",
+        pretty_size(System::get_process_virtual_memory_size()) +
+        " (peak " + pretty_size(System::get_peak_process_virtual_memory_size()) + ")");
+
+    return stats;
+}
+
+}   // namespace renderer
@@ -0,0 +1,141 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#ifndef APPLESEED_RENDERER_GLOBAL_GLOBALMEMORY_H
+#define APPLESEED_RENDERER_GLOBAL_GLOBALMEMORY_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/statistics.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+
+namespace renderer
+{
+
+//
+// Globally accessible memory accounting.
+//
+// Memory used by the main subsystems of the renderer is attributed to a
+// category. The current and peak amounts of memory of each category are
+// tracked for the lifetime of the process, and are reported along with
+// the rendering statistics.
+//
+// All functions are thread-safe.
+//
+
+enum MemoryCategory
+{
+    MemoryCategoryGeometry,                 // tessellations
+    MemoryCategoryAccelerationStructures,   // assembly, region and triangle trees
+    MemoryCategoryTextures,                 // texture tiles held by the texture store
+    MemoryCategoryPhotonMaps,               // photons and photon maps
+    MemoryCategoryFrameBuffers,             // frame images and accumulation buffers
+    MemoryCategoryCount                     // number of categories, must be last
+};
+
+// Return the name of a memory category.
+DLLSYMBOL const char* get_memory_category_name(const MemoryCategory category);
+
+// Attribute memory to, or withdraw memory from, a category.
+DLLSYMBOL void add_memory_size(const MemoryCategory category, const size_t size);
+DLLSYMBOL void remove_memory_size(const MemoryCategory category, const size_t size);
+
+// Return the current/peak amount of memory in bytes attributed to a category.
+DLLSYMBOL foundation::uint64 get_memory_size(const MemoryCategory category);
+DLLSYMBOL foundation::uint64 get_peak_memory_size(const MemoryCategory category);
+
+// Return the memory usage of all categories and of the process.
+foundation::Statistics get_memory_statistics();
+
+
+//
+// Attributes an amount of memory to a category for the lifetime of this object.
+//
+
+class MemoryAccount
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    explicit MemoryAccount(const MemoryCategory category);
+
+    // Destructor, withdraws the memory from the category.
+    ~MemoryAccount();
+
+    // Set the amount of memory in bytes attributed to the category.
+    void set_size(const size_t size);
+
+    // Return the amount of memory in bytes attributed to the category.
+    size_t get_size() const;
+
+  private:
+    const MemoryCategory    m_category;
+    size_t                  m_size;
+};
+
+
+//
+// MemoryAccount class implementation.
+//
+
+inline MemoryAccount::MemoryAccount(const MemoryCategory category)
+  : m_category(category)
+  , m_size(0)
+{
+}
+
+inline MemoryAccount::~MemoryAccount()
+{
+    set_size(0);
+}
+
+inline void MemoryAccount::set_size(const size_t size)
+{
+    if (size > m_size)
+        add_memory_size(m_category, size - m_size);
+    else if (size < m_size)
+        remove_memory_size(m_category, m_size - size);
+
+    m_size = size;
+}
+
+inline size_t MemoryAccount::get_size() const
+{
+    return m_size;
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_GLOBAL_GLOBALMEMORY_H
@@ -57,13 +57,14 @@ typedef foundation::RegularSpectrum<float, 31> Spectrum;
 // Alpha channel representation.
 typedef foundation::Color<float, 1> Alpha;
 
-// Sampling context.
+// Sampling context. Unless USE_QMC_SAMPLER is defined, the sampling mode
+// (random or quasi Monte Carlo) is selected per render, see samplingmode.h.
 #ifdef USE_QMC_SAMPLER
     typedef foundation::QMCSamplingContext<
         foundation::MersenneTwister
     > SamplingContext;
 #else
-    typedef foundation::RNGSamplingContext<
+    typedef foundation::SobolSamplingContext<
         foundation::MersenneTwister
     > SamplingContext;
 #endif
@@ -31,9 +31,11 @@
 #include "imagestack.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globalmemory.h"
 #include "renderer/kernel/aov/tilestack.h"
 
 // appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
 
 // Standard headers.
@@ -63,6 +65,13 @@ struct ImageStack::Impl
     };
 
     vector<NamedImage>      m_images;
+
+    MemoryAccount           m_memory_account;
+
+    Impl()
+      : m_memory_account(MemoryCategoryFrameBuffers)
+    {
+    }
 };
 
 ImageStack::ImageStack(
@@ -93,6 +102,8 @@ void ImageStack::clear()
         delete impl->m_images[i].m_image;
 
     impl->m_images.clear();
+
+    impl->m_memory_account.set_size(0);
 }
 
 bool ImageStack::empty() const
@@ -158,6 +169,11 @@ size_t ImageStack::append(
 
     impl->m_images.push_back(named_image);
 
+    // Account for the memory used by the image once all its tiles are allocated.
+    const CanvasProperties& props = named_image.m_image->properties();
+    impl->m_memory_account.set_size(
+        impl->m_memory_account.get_size() + props.m_pixel_count * props.m_pixel_size);
+
     return aov_index;
 }
 
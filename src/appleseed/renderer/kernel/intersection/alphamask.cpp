@@ -0,0 +1,121 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "alphamask.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/bitmask.h"
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// AlphaMask class implementation.
+//
+
+const uint32 AlphaMask::TransparentBlock;
+const uint32 AlphaMask::OpaqueBlock;
+
+AlphaMask::AlphaMask(
+    const BitMask2&     opaque_texels,
+    const bool          exact,
+    const double        transparency)
+  : m_width(opaque_texels.get_width())
+  , m_height(opaque_texels.get_height())
+  , m_max_x(static_cast<float>(m_width) - 1.0f)
+  , m_max_y(static_cast<float>(m_height) - 1.0f)
+  , m_block_count_x((m_width + BlockMask) >> BlockSizeLog2)
+  , m_exact(exact)
+  , m_transparency(transparency)
+{
+    const size_t block_count_y = (m_height + BlockMask) >> BlockSizeLog2;
+
+    m_blocks.reserve(m_block_count_x * block_count_y);
+
+    for (size_t by = 0; by < block_count_y; ++by)
+    {
+        for (size_t bx = 0; bx < m_block_count_x; ++bx)
+        {
+            // Gather the texels of this block. Texels outside the mask are never looked up.
+            uint64 words[WordsPerBlock] = { 0 };
+            size_t opaque_count = 0;
+            size_t texel_count = 0;
+
+            for (size_t y = 0; y < BlockSize; ++y)
+            {
+                const size_t iy = (by << BlockSizeLog2) + y;
+                if (iy >= m_height)
+                    break;
+
+                for (size_t x = 0; x < BlockSize; ++x)
+                {
+                    const size_t ix = (bx << BlockSizeLog2) + x;
+                    if (ix >= m_width)
+                        break;
+
+                    ++texel_count;
+
+                    if (opaque_texels.is_set(ix, iy))
+                    {
+                        const size_t bit = (y << BlockSizeLog2) | x;
+                        words[bit / 64] |= uint64(1) << (bit & 63);
+                        ++opaque_count;
+                    }
+                }
+            }
+
+            // Store a summary entry for uniform blocks, and the texels of mixed blocks.
+            if (opaque_count == 0)
+                m_blocks.push_back(TransparentBlock);
+            else if (opaque_count == texel_count)
+                m_blocks.push_back(OpaqueBlock);
+            else
+            {
+                m_blocks.push_back(static_cast<uint32>(m_words.size()));
+                m_words.insert(m_words.end(), words, words + WordsPerBlock);
+            }
+        }
+    }
+
+    // Release excess storage.
+    vector<uint64>(m_words).swap(m_words);
+}
+
+size_t AlphaMask::get_memory_size() const
+{
+    return
+          sizeof(*this)
+        + m_blocks.capacity() * sizeof(uint32)
+        + m_words.capacity() * sizeof(uint64);
+}
+
+}   // namespace renderer
@@ -0,0 +1,173 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_INTERSECTION_ALPHAMASK_H
+#define APPLESEED_RENDERER_KERNEL_INTERSECTION_ALPHAMASK_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+// Forward declarations.
+namespace foundation    { struct BitMask2; }
+
+namespace renderer
+{
+
+//
+// A compressed binary alpha mask.
+//
+// The mask is split into square blocks of texels. Blocks that are fully opaque
+// or fully transparent are stored as a single summary entry and answer lookups
+// without touching any texel data; only mixed blocks store one bit per texel.
+//
+
+class AlphaMask
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor, compresses a bit mask where set bits denote opaque texels.
+    AlphaMask(
+        const foundation::BitMask2&     opaque_texels,
+        const bool                      exact,
+        const double                    transparency);
+
+    // Return the dimensions of the mask, in texels.
+    size_t get_width() const;
+    size_t get_height() const;
+
+    // Return true if the alpha map the mask was built from only contains
+    // fully opaque and fully transparent texels.
+    bool is_exact() const;
+
+    // Return the ratio of transparent texels to the total number of texels.
+    double get_transparency() const;
+
+    // Return the total number of blocks and the number of mixed blocks.
+    size_t get_block_count() const;
+    size_t get_mixed_block_count() const;
+
+    // Return true if the mask is opaque at given UV coordinates.
+    bool is_opaque(const foundation::Vector2f& uv) const;
+
+    // Return the size (in bytes) of this object in memory.
+    size_t get_memory_size() const;
+
+  private:
+    enum
+    {
+        BlockSizeLog2 = 4,
+        BlockSize = 1 << BlockSizeLog2,
+        BlockMask = BlockSize - 1,
+        WordsPerBlock = BlockSize * BlockSize / 64
+    };
+
+    static const foundation::uint32 TransparentBlock = ~foundation::uint32(0);
+    static const foundation::uint32 OpaqueBlock = ~foundation::uint32(0) - 1;
+
+    const size_t                        m_width;
+    const size_t                        m_height;
+    const float                         m_max_x;
+    const float                         m_max_y;
+    const size_t                        m_block_count_x;
+    const bool                          m_exact;
+    const double                        m_transparency;
+    std::vector<foundation::uint32>     m_blocks;       // per block: TransparentBlock, OpaqueBlock, or index of the first word in m_words
+    std::vector<foundation::uint64>     m_words;        // texels of mixed blocks, one bit per texel
+};
+
+
+//
+// AlphaMask class implementation.
+//
+
+inline size_t AlphaMask::get_width() const
+{
+    return m_width;
+}
+
+inline size_t AlphaMask::get_height() const
+{
+    return m_height;
+}
+
+inline bool AlphaMask::is_exact() const
+{
+    return m_exact;
+}
+
+inline double AlphaMask::get_transparency() const
+{
+    return m_transparency;
+}
+
+inline size_t AlphaMask::get_block_count() const
+{
+    return m_blocks.size();
+}
+
+inline size_t AlphaMask::get_mixed_block_count() const
+{
+    return m_words.size() / WordsPerBlock;
+}
+
+inline bool AlphaMask::is_opaque(const foundation::Vector2f& uv) const
+{
+    const float fx = foundation::clamp(uv[0] * m_width, 0.0f, m_max_x);
+    const float fy = foundation::clamp(uv[1] * m_height, 0.0f, m_max_y);
+
+    const size_t ix = foundation::truncate<size_t>(fx);
+    const size_t iy = foundation::truncate<size_t>(fy);
+
+    // Look the block summary up first.
+    const foundation::uint32 block =
+        m_blocks[(iy >> BlockSizeLog2) * m_block_count_x + (ix >> BlockSizeLog2)];
+
+    if (block == OpaqueBlock)
+        return true;
+
+    if (block == TransparentBlock)
+        return false;
+
+    // Mixed block: fetch the texel.
+    const size_t bit = ((iy & BlockMask) << BlockSizeLog2) | (ix & BlockMask);
+    assert(block + bit / 64 < m_words.size());
+
+    return ((m_words[block + bit / 64] >> (bit & 63)) & 1) != 0;
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_INTERSECTION_ALPHAMASK_H
@@ -0,0 +1,271 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "alphamaskrepository.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/alphamask.h"
+#include "renderer/modeling/input/source.h"
+#include "renderer/modeling/input/texturesource.h"
+#include "renderer/modeling/scene/textureinstance.h"
+#include "renderer/modeling/texture/texture.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/bitmask.h"
+#include "foundation/utility/foreach.h"
+
+// Standard headers.
+#include <cassert>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+namespace
+{
+    // Return the alpha map identifier under which the alpha mask of a given alpha map is stored.
+    const void* get_alpha_map_id(const Source& alpha_map)
+    {
+        const TextureSource* texture_source = dynamic_cast<const TextureSource*>(&alpha_map);
+
+        return
+            texture_source
+                ? static_cast<const void*>(&texture_source->get_texture_instance())
+                : static_cast<const void*>(&alpha_map);
+    }
+
+    AlphaMask* build_alpha_mask(
+        const Source&       alpha_map,
+        TextureCache&       texture_cache)
+    {
+        // Compute the dimensions of the alpha mask.
+        size_t width, height;
+        if (const TextureSource* texture_source = dynamic_cast<const TextureSource*>(&alpha_map))
+        {
+            const CanvasProperties& texture_props =
+                texture_source->get_texture_instance().get_texture().properties();
+            width = texture_props.m_canvas_width;
+            height = texture_props.m_canvas_height;
+        }
+        else
+        {
+            width = 1;
+            height = 1;
+        }
+
+        BitMask2 opaque_texels(width, height);
+
+        const double rcp_width = 1.0 / width;
+        const double rcp_height = 1.0 / height;
+        size_t transparent_texel_count = 0;
+        size_t partial_texel_count = 0;
+
+        // Compute the alpha mask.
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                // Evaluate the alpha map at the center of the texel.
+                const Vector2d uv(
+                    (x + 0.5) * rcp_width,
+                    1.0 - (y + 0.5) * rcp_height);
+                Alpha alpha;
+                alpha_map.evaluate(texture_cache, uv, alpha);
+
+                // Mark this texel as opaque or transparent in the alpha mask.
+                const bool opaque = alpha[0] > 0.0f;
+                opaque_texels.set(x, y, opaque);
+
+                // Keep track of the number of transparent and partially transparent texels.
+                transparent_texel_count += opaque ? 0 : 1;
+                partial_texel_count += opaque && alpha[0] < 1.0f ? 1 : 0;
+            }
+        }
+
+        // The alpha mask is exact if the alpha map is binary.
+        return
+            new AlphaMask(
+                opaque_texels,
+                partial_texel_count == 0,
+                static_cast<double>(transparent_texel_count) / (width * height));
+    }
+}
+
+
+//
+// AlphaMaskRepository class implementation.
+//
+
+AlphaMaskRepository::AlphaMaskRepository()
+  : m_generation(0)
+  , m_acquire_count(0)
+  , m_build_count(0)
+{
+}
+
+AlphaMaskRepository::~AlphaMaskRepository()
+{
+    assert(m_entries.empty());
+
+    for (const_each<EntryMap> i = m_entries; i; ++i)
+        delete i->second.m_mask;
+}
+
+const AlphaMask* AlphaMaskRepository::acquire(
+    const Source&           alpha_map,
+    TextureCache&           texture_cache)
+{
+    Key key(get_alpha_map_id(alpha_map), 0);
+
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        ++m_acquire_count;
+        key.second = m_generation;
+
+        const EntryMap::iterator i = m_entries.find(key);
+        if (i != m_entries.end())
+        {
+            ++i->second.m_ref_count;
+            return i->second.m_mask;
+        }
+    }
+
+    // Build the alpha mask without holding the lock.
+    AlphaMask* alpha_mask = build_alpha_mask(alpha_map, texture_cache);
+
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    ++m_build_count;
+
+    // Another thread may have built the same alpha mask in the meantime.
+    const EntryMap::iterator i = m_entries.find(key);
+    if (i != m_entries.end())
+    {
+        delete alpha_mask;
+        ++i->second.m_ref_count;
+        return i->second.m_mask;
+    }
+
+    Entry entry;
+    entry.m_mask = alpha_mask;
+    entry.m_ref_count = 1;
+    m_entries.insert(make_pair(key, entry));
+
+    return alpha_mask;
+}
+
+void AlphaMaskRepository::release(const AlphaMask* alpha_mask)
+{
+    assert(alpha_mask);
+
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    for (EntryMap::iterator i = m_entries.begin(), e = m_entries.end(); i != e; ++i)
+    {
+        if (i->second.m_mask == alpha_mask)
+        {
+            assert(i->second.m_ref_count > 0);
+
+            if (--i->second.m_ref_count == 0)
+            {
+                delete alpha_mask;
+                m_entries.erase(i);
+            }
+
+            return;
+        }
+    }
+
+    assert(!"Alpha mask not found in repository.");
+}
+
+void AlphaMaskRepository::invalidate()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    // Masks of previous generations remain valid for their current users.
+    ++m_generation;
+}
+
+size_t AlphaMaskRepository::get_mask_count() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    return m_entries.size();
+}
+
+size_t AlphaMaskRepository::get_memory_size() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    size_t size = 0;
+
+    for (const_each<EntryMap> i = m_entries; i; ++i)
+        size += i->second.m_mask->get_memory_size();
+
+    return size;
+}
+
+Statistics AlphaMaskRepository::get_statistics() const
+{
+    size_t mask_count, mixed_block_count = 0, total_block_count = 0, memory_size = 0;
+    size_t acquire_count, build_count;
+
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        mask_count = m_entries.size();
+        acquire_count = m_acquire_count;
+        build_count = m_build_count;
+
+        for (const_each<EntryMap> i = m_entries; i; ++i)
+        {
+            const AlphaMask& mask = *i->second.m_mask;
+            mixed_block_count += mask.get_mixed_block_count();
+            total_block_count += mask.get_block_count();
+            memory_size += mask.get_memory_size();
+        }
+    }
+
+    Statistics stats;
+    stats.insert("alpha masks", mask_count);
+    stats.insert_percent("reused masks", acquire_count - build_count, acquire_count);
+    stats.insert_percent("mixed blocks", mixed_block_count, total_block_count);
+    stats.insert_size("alpha mask memory", memory_size);
+
+    return stats;
+}
+
+}   // namespace renderer
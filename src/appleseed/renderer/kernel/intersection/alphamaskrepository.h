@@ -0,0 +1,113 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_INTERSECTION_ALPHAMASKREPOSITORY_H
+#define APPLESEED_RENDERER_KERNEL_INTERSECTION_ALPHAMASKREPOSITORY_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/thread.h"
+#include "foundation/utility/statistics.h"
+
+// Standard headers.
+#include <cstddef>
+#include <map>
+#include <utility>
+
+// Forward declarations.
+namespace renderer  { class AlphaMask; }
+namespace renderer  { class Source; }
+namespace renderer  { class TextureCache; }
+
+namespace renderer
+{
+
+//
+// A thread-safe repository of alpha masks shared between intersection filters.
+//
+// Alpha masks built from textures are keyed by texture instance, so that all
+// materials and objects using the same alpha texture share a single mask.
+// Masks are reference-counted and deleted when their last user releases them.
+//
+// Since the scene may be edited between renders, masks are only shared within
+// a generation: after invalidate(), masks still in use are never returned again
+// and new masks are built from the current alpha maps.
+//
+
+class AlphaMaskRepository
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    AlphaMaskRepository();
+
+    // Destructor.
+    ~AlphaMaskRepository();
+
+    // Retrieve the alpha mask of a given alpha map, building it if necessary.
+    // Each call must be balanced by a call to release().
+    const AlphaMask* acquire(
+        const Source&               alpha_map,
+        TextureCache&               texture_cache);
+
+    // Release an alpha mask previously returned by acquire().
+    void release(const AlphaMask*   alpha_mask);
+
+    // Start a new generation: alpha masks acquired from now on are rebuilt.
+    // Call this before intersection filters are updated after scene edits.
+    void invalidate();
+
+    // Return the number of alpha masks in the repository.
+    size_t get_mask_count() const;
+
+    // Return the size (in bytes) of all alpha masks in the repository.
+    size_t get_memory_size() const;
+
+    // Retrieve statistics about the repository.
+    foundation::Statistics get_statistics() const;
+
+  private:
+    struct Entry
+    {
+        const AlphaMask*            m_mask;
+        size_t                      m_ref_count;
+    };
+
+    typedef std::pair<const void*, size_t> Key;     // alpha map and generation
+    typedef std::map<Key, Entry> EntryMap;
+
+    mutable boost::mutex            m_mutex;
+    EntryMap                        m_entries;
+    size_t                          m_generation;
+    size_t                          m_acquire_count;
+    size_t                          m_build_count;
+};
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_INTERSECTION_ALPHAMASKREPOSITORY_H
@@ -31,6 +31,7 @@
 #include "assemblytree.h"
 
 // appleseed.renderer headers.
+#include "renderer/kernel/intersection/alphamaskrepository.h"
 #include "renderer/kernel/shading/shadingpoint.h"
 #include "renderer/modeling/object/iregion.h"
 #include "renderer/modeling/object/object.h"
@@ -44,6 +45,7 @@
 #include "foundation/math/permutation.h"
 #include "foundation/platform/system.h"
 #include "foundation/platform/timer.h"
+#include "foundation/utility/eventtracer.h"
 #include "foundation/utility/statistics.h"
 #include "foundation/utility/string.h"
 
@@ -61,9 +63,13 @@ namespace renderer
 // AssemblyTree class implementation.
 //
 
-AssemblyTree::AssemblyTree(const Scene& scene)
+AssemblyTree::AssemblyTree(
+    const Scene&            scene,
+    AlphaMaskRepository&    alpha_mask_repository)
   : TreeType(AlignedAllocator<void>(System::get_l1_data_cache_line_size()))
   , m_scene(scene)
+  , m_alpha_mask_repository(alpha_mask_repository)
+  , m_memory_account(MemoryCategoryAccelerationStructures)
 {
     update();
 }
@@ -86,8 +92,18 @@ AssemblyTree::~AssemblyTree()
 
 void AssemblyTree::update()
 {
+    const ScopedEvent event("update assembly tree", "intersection");
+
     rebuild_assembly_tree();
+
+    // Alpha maps may have been edited since the last update: don't let
+    // intersection filters reuse alpha masks built from their old contents.
+    m_alpha_mask_repository.invalidate();
+
     update_child_trees();
+    build_flat_triangle_trees();
+
+    m_memory_account.set_size(get_memory_size());
 }
 
 size_t AssemblyTree::get_memory_size() const
@@ -100,6 +116,25 @@ size_t AssemblyTree::get_memory_size() const
         + m_assembly_versions.size() * sizeof(pair<UniqueID, VersionID>);
 }
 
+namespace
+{
+    // Return true if all the triangles of an assembly must be gathered into a single,
+    // eagerly built triangle tree.
+    bool has_flat_triangle_tree(const Assembly& assembly)
+    {
+        return
+            assembly.get_parameters()
+                .child("acceleration_structure")
+                .get_optional<bool>("flat", false);
+    }
+
+    // Return true if an assembly uses a region tree as its child tree.
+    bool has_region_tree(const Assembly& assembly)
+    {
+        return assembly.is_flushable() && !has_flat_triangle_tree(assembly);
+    }
+}
+
 void AssemblyTree::collect_assembly_instances(
     const AssemblyInstanceContainer&    assembly_instances,
     const TransformSequence&            parent_transform_seq,
@@ -133,7 +168,8 @@ void AssemblyTree::collect_assembly_instances(
             Item(
                 &assembly,
                 &assembly_instance,
-                cumulated_transform_seq));
+                cumulated_transform_seq,
+                has_region_tree(assembly)));
 
         // Compute and store the assembly instance bounding box.
         AABB3d assembly_instance_bbox(
@@ -294,7 +330,10 @@ namespace
         }
     }
 
-    Lazy<TriangleTree>* create_triangle_tree(const Scene& scene, const Assembly& assembly)
+    Lazy<TriangleTree>* create_triangle_tree(
+        const Scene&            scene,
+        const Assembly&         assembly,
+        AlphaMaskRepository&    alpha_mask_repository)
     {
         // Compute the assembly space bounding box of the assembly.
         const GAABB3 assembly_bbox =
@@ -312,19 +351,24 @@ namespace
                     assembly.get_uid(),
                     assembly_bbox,
                     assembly,
-                    regions)));
+                    regions,
+                    alpha_mask_repository)));
 
         return new Lazy<TriangleTree>(triangle_tree_factory);
     }
 
-    Lazy<RegionTree>* create_region_tree(const Scene& scene, const Assembly& assembly)
+    Lazy<RegionTree>* create_region_tree(
+        const Scene&            scene,
+        const Assembly&         assembly,
+        AlphaMaskRepository&    alpha_mask_repository)
     {
         auto_ptr<ILazyFactory<RegionTree> > region_tree_factory(
             new RegionTreeFactory(
                 RegionTree::Arguments(
                     scene,
                     assembly.get_uid(),
-                    assembly)));
+                    assembly,
+                    alpha_mask_repository)));
 
         return new Lazy<RegionTree>(region_tree_factory);
     }
@@ -350,64 +394,90 @@ void AssemblyTree::update_child_trees()
         const AssemblyVersionMap::const_iterator stored_version_it =
             m_assembly_versions.find(assembly_uid);
 
-        if (stored_version_it != m_assembly_versions.end())
+        // Retrieve the existing child tree of the assembly, if any. The kind of child tree
+        // may have changed since the last update, e.g. if the assembly was made flat.
+        const RegionTreeContainer::iterator region_tree_it = m_region_trees.find(assembly_uid);
+        const TriangleTreeContainer::iterator triangle_tree_it = m_triangle_trees.find(assembly_uid);
+        const bool use_region_tree = has_region_tree(assembly);
+
+        if (stored_version_it != m_assembly_versions.end() &&
+            stored_version_it->second == current_version_id)
         {
-            if (stored_version_it->second == current_version_id)
+            // The child tree of this assembly is up-to-date wrt. the assembly's geometry.
+            // If it is of the right kind, simply update it.
+            if (use_region_tree)
             {
-                // The child tree of this assembly is up-to-date wrt. the assembly's geometry.
-                // Simply update the child tree.
-                if (assembly.is_flushable())
-                {
-                    Update<RegionTree> access(m_region_trees.find(assembly_uid)->second);
-                    if (access.get())
-                        access->update_non_geometry();
-                }
-                else
+                if (region_tree_it != m_region_trees.end())
                 {
-                    Update<TriangleTree> access(m_triangle_trees.find(assembly_uid)->second);
+                    Update<RegionTree> access(region_tree_it->second);
                     if (access.get())
                         access->update_non_geometry();
+                    continue;
                 }
-
-                continue;
             }
             else
             {
-                // The child tree is out-of-date wrt. the assembly's geometry: delete it.
-                // It will get rebuilt from scratch lazily.
-                if (assembly.is_flushable())
-                {
-                    const RegionTreeContainer::iterator it = m_region_trees.find(assembly_uid);
-                    delete it->second;
-                    m_region_trees.erase(it);
-                }
-                else
+                if (triangle_tree_it != m_triangle_trees.end())
                 {
-                    const TriangleTreeContainer::iterator it = m_triangle_trees.find(assembly_uid);
-                    delete it->second;
-                    m_triangle_trees.erase(it);
+                    Update<TriangleTree> access(triangle_tree_it->second);
+                    if (access.get())
+                        access->update_non_geometry();
+                    continue;
                 }
             }
         }
 
+        // The child tree is out-of-date wrt. the assembly's geometry, or of the wrong kind:
+        // delete it. It will get rebuilt from scratch lazily.
+        if (region_tree_it != m_region_trees.end())
+        {
+            delete region_tree_it->second;
+            m_region_trees.erase(region_tree_it);
+        }
+
+        if (triangle_tree_it != m_triangle_trees.end())
+        {
+            delete triangle_tree_it->second;
+            m_triangle_trees.erase(triangle_tree_it);
+        }
+
+        // Store the current version ID of the assembly.
+        m_assembly_versions[assembly_uid] = current_version_id;
+
         // The assembly does not contain any geometry, nothing to do.
         if (assembly.object_instances().empty())
             continue;
 
         // The assembly does contains geometry, lazily build a new child tree.
-        if (assembly.is_flushable())
+        if (use_region_tree)
         {
             m_region_trees.insert(
-                make_pair(assembly_uid, create_region_tree(m_scene, assembly)));
+                make_pair(assembly_uid, create_region_tree(m_scene, assembly, m_alpha_mask_repository)));
         }
         else
         {
             m_triangle_trees.insert(
-                make_pair(assembly_uid, create_triangle_tree(m_scene, assembly)));
+                make_pair(assembly_uid, create_triangle_tree(m_scene, assembly, m_alpha_mask_repository)));
         }
+    }
+}
 
-        // Store the current version ID of the assembly.
-        m_assembly_versions[assembly_uid] = current_version_id;
+void AssemblyTree::build_flat_triangle_trees()
+{
+    // Build the flat triangle trees now rather than when the first ray enters their assembly.
+    // Rays retrieve them by assembly UID, like any other child tree.
+    for (const_each<ItemVector> i = m_items; i; ++i)
+    {
+        if (i->m_has_region_tree || !has_flat_triangle_tree(*i->m_assembly))
+            continue;
+
+        const TriangleTreeContainer::iterator it = m_triangle_trees.find(i->m_assembly_uid);
+
+        if (it != m_triangle_trees.end())
+        {
+            // Accessing the tree builds it; it stays alive until update_child_trees() deletes it.
+            const Access<TriangleTree> access(it->second);
+        }
     }
 }
 
@@ -502,7 +572,7 @@ bool AssemblyLeafVisitor::visit(
 
         FOUNDATION_BVH_TRAVERSAL_STATS(stats.m_intersected_items.insert(1));
 
-        if (item.m_assembly->is_flushable())
+        if (item.m_has_region_tree)
         {
             // Retrieve the region tree of this assembly.
             const RegionTree& region_tree =
@@ -513,7 +583,8 @@ bool AssemblyLeafVisitor::visit(
             // Check the intersection between the ray and the region tree.
             RegionLeafVisitor visitor(
                 local_shading_point,
-                m_triangle_tree_cache
+                m_triangle_tree_cache,
+                m_ray_stats
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
                 , m_triangle_tree_stats
 #endif
@@ -537,7 +608,7 @@ bool AssemblyLeafVisitor::visit(
             {
                 // Check the intersection between the ray and the triangle tree.
                 TriangleTreeIntersector intersector;
-                TriangleLeafVisitor visitor(*triangle_tree, local_shading_point);
+                TriangleLeafVisitor visitor(*triangle_tree, local_shading_point, m_ray_stats);
                 if (triangle_tree->get_moving_triangle_count() > 0)
                 {
                     intersector.intersect_motion(
@@ -631,7 +702,7 @@ bool AssemblyLeafProbeVisitor::visit(
 
         FOUNDATION_BVH_TRAVERSAL_STATS(stats.m_intersected_items.insert(1));
 
-        if (item.m_assembly->is_flushable())
+        if (item.m_has_region_tree)
         {
             // Retrieve the region tree of this assembly.
             const RegionTree& region_tree =
@@ -641,7 +712,9 @@ bool AssemblyLeafProbeVisitor::visit(
 
             // Check the intersection between the ray and the region tree.
             RegionLeafProbeVisitor visitor(
-                m_triangle_tree_cache
+                m_triangle_tree_cache,
+                m_resolve_transparency,
+                m_ray_stats
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
                 , m_triangle_tree_stats
 #endif
@@ -653,10 +726,11 @@ bool AssemblyLeafProbeVisitor::visit(
                 local_ray_info,
                 visitor);
         
-            // Terminate traversal if there was a hit.
-            if (visitor.hit())
+            // Terminate traversal if there was a hit or if the probe gave up.
+            if (visitor.hit() || visitor.transparent_hit())
             {
-                m_hit = true;
+                m_hit = visitor.hit();
+                m_transparent_hit = visitor.transparent_hit();
                 return false;
             }
         }
@@ -672,7 +746,7 @@ bool AssemblyLeafProbeVisitor::visit(
             {
                 // Check the intersection between the ray and the triangle tree.
                 TriangleTreeProbeIntersector intersector;
-                TriangleLeafProbeVisitor visitor(*triangle_tree);
+                TriangleLeafProbeVisitor visitor(*triangle_tree, m_resolve_transparency, m_ray_stats);
                 if (triangle_tree->get_moving_triangle_count() > 0)
                 {
                     intersector.intersect_motion(
@@ -699,10 +773,11 @@ bool AssemblyLeafProbeVisitor::visit(
                         );
                 }
 
-                // Terminate traversal if there was a hit.
-                if (visitor.hit())
+                // Terminate traversal if there was a hit or if the probe gave up.
+                if (visitor.hit() || visitor.transparent_hit())
                 {
-                    m_hit = true;
+                    m_hit = visitor.hit();
+                    m_transparent_hit = visitor.transparent_hit();
                     return false;
                 }
             }
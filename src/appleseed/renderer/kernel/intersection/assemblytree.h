@@ -32,8 +32,10 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/global.h"
+#include "renderer/global/globalmemory.h"
 #include "renderer/kernel/intersection/intersectionsettings.h"
 #include "renderer/kernel/intersection/probevisitorbase.h"
+#include "renderer/kernel/intersection/raystatistics.h"
 #include "renderer/kernel/intersection/regioninfo.h"
 #include "renderer/kernel/intersection/regiontree.h"
 #include "renderer/kernel/intersection/triangletree.h"
@@ -55,6 +57,7 @@
 
 // Forward declarations.
 namespace foundation    { class Statistics; }
+namespace renderer      { class AlphaMaskRepository; }
 namespace renderer      { class Assembly; }
 namespace renderer      { class AssemblyInstance; }
 namespace renderer      { class ShadingPoint; }
@@ -75,7 +78,9 @@ class AssemblyTree
 {
   public:
     // Constructor, builds the tree for a given scene.
-    explicit AssemblyTree(const Scene& scene);
+    AssemblyTree(
+        const Scene&                            scene,
+        AlphaMaskRepository&                    alpha_mask_repository);
 
     // Destructor.
     ~AssemblyTree();
@@ -97,17 +102,20 @@ class AssemblyTree
         foundation::UniqueID                    m_assembly_uid;
         const renderer::AssemblyInstance*       m_assembly_instance;
         renderer::TransformSequence             m_transform_sequence;
+        bool                                    m_has_region_tree;      // the child tree of the assembly is a region tree
 
         Item() {}
 
         Item(
             const renderer::Assembly*           assembly,
             const renderer::AssemblyInstance*   assembly_instance,
-            renderer::TransformSequence         transform_sequence)
+            renderer::TransformSequence         transform_sequence,
+            const bool                          has_region_tree)
           : m_assembly(assembly)
           , m_assembly_uid(assembly->get_uid())
           , m_assembly_instance(assembly_instance)
           , m_transform_sequence(transform_sequence)
+          , m_has_region_tree(has_region_tree)
         {
         }
     };
@@ -118,10 +126,12 @@ class AssemblyTree
     typedef std::map<foundation::UniqueID, foundation::VersionID> AssemblyVersionMap;
 
     const Scene&            m_scene;
+    AlphaMaskRepository&    m_alpha_mask_repository;
     RegionTreeContainer     m_region_trees;
     TriangleTreeContainer   m_triangle_trees;
     ItemVector              m_items;
     AssemblyVersionMap      m_assembly_versions;
+    MemoryAccount           m_memory_account;
 
     void collect_assembly_instances(
         const AssemblyInstanceContainer&        assembly_instances,
@@ -132,6 +142,7 @@ class AssemblyTree
 
     void collect_unique_assemblies(AssemblyVector& assemblies) const;
     void update_child_trees();
+    void build_flat_triangle_trees();
 };
 
 
@@ -149,7 +160,8 @@ class AssemblyLeafVisitor
         const AssemblyTree&                         tree,
         RegionTreeAccessCache&                      region_tree_cache,
         TriangleTreeAccessCache&                    triangle_tree_cache,
-        const ShadingPoint*                         parent_shading_point
+        const ShadingPoint*                         parent_shading_point,
+        RayStatistics&                              ray_stats
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , foundation::bvh::TraversalStatistics&     triangle_tree_stats
 #endif
@@ -172,6 +184,7 @@ class AssemblyLeafVisitor
     RegionTreeAccessCache&                          m_region_tree_cache;
     TriangleTreeAccessCache&                        m_triangle_tree_cache;
     const ShadingPoint*                             m_parent_shading_point;
+    RayStatistics&                                  m_ray_stats;
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     foundation::bvh::TraversalStatistics&           m_triangle_tree_stats;
 #endif
@@ -192,7 +205,9 @@ class AssemblyLeafProbeVisitor
         const AssemblyTree&                         tree,
         RegionTreeAccessCache&                      region_tree_cache,
         TriangleTreeAccessCache&                    triangle_tree_cache,
-        const ShadingPoint*                         parent_shading_point
+        const ShadingPoint*                         parent_shading_point,
+        const bool                                  resolve_transparency,
+        RayStatistics&                              ray_stats
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , foundation::bvh::TraversalStatistics&     triangle_tree_stats
 #endif
@@ -214,6 +229,8 @@ class AssemblyLeafProbeVisitor
     RegionTreeAccessCache&                          m_region_tree_cache;
     TriangleTreeAccessCache&                        m_triangle_tree_cache;
     const ShadingPoint*                             m_parent_shading_point;
+    const bool                                      m_resolve_transparency;
+    RayStatistics&                                  m_ray_stats;
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     foundation::bvh::TraversalStatistics&           m_triangle_tree_stats;
 #endif
@@ -246,7 +263,8 @@ inline AssemblyLeafVisitor::AssemblyLeafVisitor(
     const AssemblyTree&                             tree,
     RegionTreeAccessCache&                          region_tree_cache,
     TriangleTreeAccessCache&                        triangle_tree_cache,
-    const ShadingPoint*                             parent_shading_point
+    const ShadingPoint*                             parent_shading_point,
+    RayStatistics&                                  ray_stats
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     , foundation::bvh::TraversalStatistics&         triangle_tree_stats
 #endif
@@ -256,6 +274,7 @@ inline AssemblyLeafVisitor::AssemblyLeafVisitor(
   , m_region_tree_cache(region_tree_cache)
   , m_triangle_tree_cache(triangle_tree_cache)
   , m_parent_shading_point(parent_shading_point)
+  , m_ray_stats(ray_stats)
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
   , m_triangle_tree_stats(triangle_tree_stats)
 #endif
@@ -271,7 +290,9 @@ inline AssemblyLeafProbeVisitor::AssemblyLeafProbeVisitor(
     const AssemblyTree&                             tree,
     RegionTreeAccessCache&                          region_tree_cache,
     TriangleTreeAccessCache&                        triangle_tree_cache,
-    const ShadingPoint*                             parent_shading_point
+    const ShadingPoint*                             parent_shading_point,
+    const bool                                      resolve_transparency,
+    RayStatistics&                                  ray_stats
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     , foundation::bvh::TraversalStatistics&         triangle_tree_stats
 #endif
@@ -280,6 +301,8 @@ inline AssemblyLeafProbeVisitor::AssemblyLeafProbeVisitor(
   , m_region_tree_cache(region_tree_cache)
   , m_triangle_tree_cache(triangle_tree_cache)
   , m_parent_shading_point(parent_shading_point)
+  , m_resolve_transparency(resolve_transparency)
+  , m_ray_stats(ray_stats)
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
   , m_triangle_tree_stats(triangle_tree_stats)
 #endif
@@ -32,22 +32,17 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/kernel/intersection/alphamaskrepository.h"
 #include "renderer/kernel/tessellation/statictessellation.h"
 #include "renderer/modeling/input/source.h"
-#include "renderer/modeling/input/texturesource.h"
 #include "renderer/modeling/material/material.h"
 #include "renderer/modeling/object/iregion.h"
 #include "renderer/modeling/object/object.h"
 #include "renderer/modeling/object/regionkit.h"
 #include "renderer/modeling/object/triangle.h"
 #include "renderer/modeling/scene/objectinstance.h"
-#include "renderer/modeling/scene/textureinstance.h"
-#include "renderer/modeling/texture/texture.h"
 
 // appleseed.foundation headers.
-#include "foundation/image/canvasproperties.h"
-#include "foundation/image/color.h"
-#include "foundation/image/tile.h"
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/lazy.h"
 
@@ -116,8 +111,10 @@ namespace
 IntersectionFilter::IntersectionFilter(
     Object&                 object,
     const MaterialArray&    materials,
+    AlphaMaskRepository&    alpha_mask_repository,
     TextureCache&           texture_cache)
-  : m_alpha_masks(materials.size(), 0)
+  : m_alpha_mask_repository(alpha_mask_repository)
+  , m_alpha_masks(materials.size(), 0)
 {
     // Create one alpha mask per material.
     for (size_t i = 0; i < materials.size(); ++i)
@@ -140,20 +137,19 @@ IntersectionFilter::IntersectionFilter(
         if (alpha_map == 0)
             continue;
 
-        // Build the alpha mask.
-        double transparency;
-        auto_ptr<AlphaMask> alpha_mask(
-            create_alpha_mask(
-                alpha_map,
-                texture_cache,
-                transparency));
+        // Retrieve the alpha mask, possibly shared with other intersection filters.
+        const AlphaMask* alpha_mask =
+            m_alpha_mask_repository.acquire(*alpha_map, texture_cache);
 
         // Discard the alpha mask if it's mostly opaque.
-        if (transparency < 5.0 / 100)
+        if (alpha_mask->get_transparency() < 5.0 / 100)
+        {
+            m_alpha_mask_repository.release(alpha_mask);
             continue;
+        }
 
         // Store the alpha mask.
-        m_alpha_masks[i] = alpha_mask.release();
+        m_alpha_masks[i] = alpha_mask;
     }
 
     if (has_alpha_masks())
@@ -175,7 +171,10 @@ IntersectionFilter::IntersectionFilter(
 IntersectionFilter::~IntersectionFilter()
 {
     for (size_t i = 0; i < m_alpha_masks.size(); ++i)
-        delete m_alpha_masks[i];
+    {
+        if (m_alpha_masks[i])
+            m_alpha_mask_repository.release(m_alpha_masks[i]);
+    }
 }
 
 bool IntersectionFilter::has_alpha_masks() const
@@ -189,60 +188,12 @@ bool IntersectionFilter::has_alpha_masks() const
     return false;
 }
 
-IntersectionFilter::AlphaMask* IntersectionFilter::create_alpha_mask(
-    const Source*           alpha_map,
-    TextureCache&           texture_cache,
-    double&                 transparency)
+size_t IntersectionFilter::get_memory_size() const
 {
-    assert(alpha_map);
-
-    // Compute the dimensions of the alpha mask.
-    size_t width, height;
-    if (dynamic_cast<const TextureSource*>(alpha_map))
-    {
-        const CanvasProperties& texture_props =
-            static_cast<const TextureSource*>(alpha_map)->get_texture_instance().get_texture().properties();
-        width = texture_props.m_canvas_width;
-        height = texture_props.m_canvas_height;
-    }
-    else
-    {
-        width = 1;
-        height = 1;
-    }
-
-    // Create and initialize the alpha mask.
-    AlphaMask* alpha_mask = new AlphaMask(width, height);
-
-    const double rcp_width = 1.0 / width;
-    const double rcp_height = 1.0 / height;
-    size_t transparent_texel_count = 0;
-
-    // Compute the alpha mask.
-    for (size_t y = 0; y < height; ++y)
-    {
-        for (size_t x = 0; x < width; ++x)
-        {
-            // Evaluate the alpha map at the center of the texel.
-            const Vector2d uv(
-                (x + 0.5) * rcp_width,
-                1.0 - (y + 0.5) * rcp_height);
-            Alpha alpha;
-            alpha_map->evaluate(texture_cache, uv, alpha);
-
-            // Mark this texel as opaque or transparent in the alpha mask.
-            const bool opaque = alpha[0] > 0.0f;
-            alpha_mask->set_opaque(x, y, opaque);
-
-            // Keep track of the number of transparent texels.
-            transparent_texel_count += opaque ? 0 : 1;
-        }
-    }
-
-    // Compute the ratio of transparent texels to the total number of texels.
-    transparency = static_cast<double>(transparent_texel_count) / (width * height);
-
-    return alpha_mask;
+    return
+          sizeof(*this)
+        + m_alpha_masks.capacity() * sizeof(const AlphaMask*)
+        + m_uv.capacity() * sizeof(Vector2f);
 }
 
 size_t IntersectionFilter::get_masks_memory_size() const
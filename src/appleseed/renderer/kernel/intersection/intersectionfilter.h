@@ -31,13 +31,12 @@
 #define APPLESEED_RENDERER_KERNEL_INTERSECTION_INTERSECTIONFILTER_H
 
 // appleseed.renderer headers.
+#include "renderer/kernel/intersection/alphamask.h"
 #include "renderer/kernel/intersection/trianglekey.h"
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
-#include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
-#include "foundation/utility/bitmask.h"
 
 // Standard headers.
 #include <cassert>
@@ -45,9 +44,9 @@
 #include <vector>
 
 // Forward declarations.
+namespace renderer  { class AlphaMaskRepository; }
 namespace renderer  { class MaterialArray; }
 namespace renderer  { class Object; }
-namespace renderer  { class Source; }
 namespace renderer  { class TextureCache; }
 
 namespace renderer
@@ -60,69 +59,30 @@ class IntersectionFilter
     IntersectionFilter(
         Object&                 object,
         const MaterialArray&    materials,
+        AlphaMaskRepository&    alpha_mask_repository,
         TextureCache&           texture_cache);
 
     ~IntersectionFilter();
 
     bool has_alpha_masks() const;
 
+    // Return true if the alpha mask of a given material exactly captures its alpha map,
+    // i.e. if the alpha map only contains fully opaque and fully transparent texels.
+    bool is_exact(const size_t material_index) const;
+
     bool accept(
         const TriangleKey&      triangle_key,
         const double            u,
         const double            v) const;
 
+    // Return the size (in bytes) of this object in memory, excluding the shared alpha masks.
+    size_t get_memory_size() const;
+
   private:
-    class AlphaMask
-      : public foundation::NonCopyable
-    {
-      public:
-        AlphaMask(
-            const size_t        width,
-            const size_t        height)
-          : m_max_x(static_cast<float>(width) - 1.0f)
-          , m_max_y(static_cast<float>(height) - 1.0f)
-          , m_bitmask(width, height)
-        {
-        }
-
-        void set_opaque(
-            const size_t        x,
-            const size_t        y,
-            const bool          opaque)
-        {
-            m_bitmask.set(x, y, opaque);
-        }
-
-        bool is_opaque(const foundation::Vector2f& uv) const
-        {
-            const float fx = foundation::clamp(uv[0] * m_bitmask.get_width(), 0.0f, m_max_x);
-            const float fy = foundation::clamp(uv[1] * m_bitmask.get_height(), 0.0f, m_max_y);
-
-            const size_t ix = foundation::truncate<size_t>(fx);
-            const size_t iy = foundation::truncate<size_t>(fy);
-
-            return m_bitmask.is_set(ix, iy);
-        }
-
-        size_t get_memory_size() const
-        {
-            return m_bitmask.get_memory_size();
-        }
-
-      private:
-        const float             m_max_x;
-        const float             m_max_y;
-        foundation::BitMask2    m_bitmask;
-    };
-
-    std::vector<AlphaMask*>             m_alpha_masks;
+    AlphaMaskRepository&                m_alpha_mask_repository;
+    std::vector<const AlphaMask*>       m_alpha_masks;
     std::vector<foundation::Vector2f>   m_uv;
 
-    static AlphaMask* create_alpha_mask(
-        const Source*           alpha_map,
-        TextureCache&           texture_cache,
-        double&                 transparency);
-
     size_t get_masks_memory_size() const;
 };
 
@@ -131,6 +91,15 @@ class IntersectionFilter
 // IntersectionFilter class implementation.
 //
 
+inline bool IntersectionFilter::is_exact(const size_t material_index) const
+{
+    assert(material_index < m_alpha_masks.size());
+
+    const AlphaMask* alpha_mask = m_alpha_masks[material_index];
+
+    return alpha_mask && alpha_mask->is_exact();
+}
+
 inline bool IntersectionFilter::accept(
     const TriangleKey&          triangle_key,
     const double                u,
@@ -67,6 +67,11 @@ Intersector::Intersector(
 {
 }
 
+Intersector::~Intersector()
+{
+    m_trace_context.add_ray_statistics(m_ray_stats);
+}
+
 Vector3d Intersector::refine(
     const TriangleSupportPlaneType& support_plane,
     const Vector3d&                 point,
@@ -244,6 +249,7 @@ bool Intersector::trace(
 
     // Update ray casting statistics.
     ++m_shading_ray_count;
+    m_ray_stats.count_ray(ray.m_type);
 
     // Initialize the shading point.
     shading_point.m_region_kit_cache = &m_region_kit_cache;
@@ -271,7 +277,8 @@ bool Intersector::trace(
         assembly_tree,
         m_region_tree_cache,
         m_triangle_tree_cache,
-        parent_shading_point
+        parent_shading_point,
+        m_ray_stats
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , m_triangle_tree_traversal_stats
 #endif
@@ -296,11 +303,30 @@ bool Intersector::trace(
 bool Intersector::trace_probe(
     const ShadingRay&               ray,
     const ShadingPoint*             parent_shading_point) const
+{
+    bool transparent_hit;
+    return do_trace_probe(ray, parent_shading_point, false, transparent_hit);
+}
+
+bool Intersector::trace_probe(
+    const ShadingRay&               ray,
+    const ShadingPoint*             parent_shading_point,
+    bool&                           transparent_hit) const
+{
+    return do_trace_probe(ray, parent_shading_point, true, transparent_hit);
+}
+
+bool Intersector::do_trace_probe(
+    const ShadingRay&               ray,
+    const ShadingPoint*             parent_shading_point,
+    const bool                      resolve_transparency,
+    bool&                           transparent_hit) const
 {
     assert(parent_shading_point == 0 || parent_shading_point->hit());
 
     // Update ray casting statistics.
     ++m_probe_ray_count;
+    ++m_ray_stats.m_ray_counts[RayStatistics::ShadowRays];
 
     // Compute ray info once for the entire traversal.
     const ShadingRay::RayInfoType ray_info(ray);
@@ -320,7 +346,9 @@ bool Intersector::trace_probe(
         assembly_tree,
         m_region_tree_cache,
         m_triangle_tree_cache,
-        parent_shading_point
+        parent_shading_point,
+        resolve_transparency,
+        m_ray_stats
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , m_triangle_tree_traversal_stats
 #endif
@@ -335,6 +363,8 @@ bool Intersector::trace_probe(
 #endif
         );
 
+    transparent_hit = visitor.transparent_hit();
+
     return visitor.hit();
 }
 
@@ -405,8 +435,7 @@ StatisticsVector Intersector::get_statistics() const
 {
     const uint64 total_ray_count = m_shading_ray_count + m_probe_ray_count;
 
-    Statistics intersection_stats;
-    intersection_stats.insert("total rays", total_ray_count);
+    Statistics intersection_stats = m_ray_stats.get_statistics();
     intersection_stats.insert(
         auto_ptr<RayCountStatisticsEntry>(
             new RayCountStatisticsEntry(
@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/kernel/intersection/intersectionsettings.h"
+#include "renderer/kernel/intersection/raystatistics.h"
 #include "renderer/kernel/intersection/regiontree.h"
 #include "renderer/kernel/intersection/triangletree.h"
 #include "renderer/kernel/tessellation/statictessellation.h"
@@ -72,6 +73,9 @@ class Intersector
         TextureCache&                   texture_cache,
         const bool                      report_self_intersections = false);
 
+    // Destructor, reports the number of traced rays to the trace context.
+    ~Intersector();
+
     // Refine the location of a point on a surface.
     static foundation::Vector3d refine(
         const TriangleSupportPlaneType& support_plane,
@@ -102,6 +106,15 @@ class Intersector
         const ShadingRay&               ray,
         const ShadingPoint*             parent_shading_point = 0) const;
 
+    // Trace a world space probe ray through the scene. Surfaces whose opacity is exactly
+    // captured by their intersection filter are resolved during traversal; the ray gives
+    // up at any other surface that may be partially transparent and reports it via
+    // 'transparent_hit'. Returns true if a fully opaque surface was hit.
+    bool trace_probe(
+        const ShadingRay&               ray,
+        const ShadingPoint*             parent_shading_point,
+        bool&                           transparent_hit) const;
+
     // Manufacture a hit "by hand".
     void manufacture_hit(
         ShadingPoint&                   shading_point,
@@ -130,10 +143,17 @@ class Intersector
     // Intersection statistics.
     mutable foundation::uint64                      m_shading_ray_count;
     mutable foundation::uint64                      m_probe_ray_count;
+    mutable RayStatistics                           m_ray_stats;
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     mutable foundation::bvh::TraversalStatistics    m_assembly_tree_traversal_stats;
     mutable foundation::bvh::TraversalStatistics    m_triangle_tree_traversal_stats;
 #endif
+
+    bool do_trace_probe(
+        const ShadingRay&               ray,
+        const ShadingPoint*             parent_shading_point,
+        const bool                      resolve_transparency,
+        bool&                           transparent_hit) const;
 };
 
 }       // namespace renderer
@@ -50,8 +50,13 @@ class ProbeVisitorBase
     // Return whether a hit was found.
     bool hit() const;
 
+    // Return whether traversal stopped at a surface that may be partially transparent
+    // without counting it as a hit. Only happens when transparency is resolved.
+    bool transparent_hit() const;
+
   protected:
     bool m_hit;
+    bool m_transparent_hit;
 };
 
 
@@ -61,6 +66,7 @@ class ProbeVisitorBase
 
 inline ProbeVisitorBase::ProbeVisitorBase()
   : m_hit(false)
+  , m_transparent_hit(false)
 {
 }
 
@@ -69,6 +75,11 @@ inline bool ProbeVisitorBase::hit() const
     return m_hit;
 }
 
+inline bool ProbeVisitorBase::transparent_hit() const
+{
+    return m_transparent_hit;
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_INTERSECTION_PROBEVISITORBASE_H
@@ -0,0 +1,114 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "raystatistics.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/otherwise.h"
+
+// Standard headers.
+#include <string>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// RayStatistics class implementation.
+//
+
+const char* RayStatistics::get_category_name(const Category category)
+{
+    switch (category)
+    {
+      case CameraRays:      return "camera rays";
+      case IndirectRays:    return "indirect rays";
+      case ShadowRays:      return "shadow/probe rays";
+      case LightRays:       return "light/photon rays";
+      case OtherRays:       return "other rays";
+      assert_otherwise;
+    }
+
+    return "";
+}
+
+RayStatistics& RayStatistics::operator+=(const RayStatistics& rhs)
+{
+    for (size_t i = 0; i < CategoryCount; ++i)
+        m_ray_counts[i] += rhs.m_ray_counts[i];
+
+    m_leaf_visit_count += rhs.m_leaf_visit_count;
+    m_triangle_test_count += rhs.m_triangle_test_count;
+
+    return *this;
+}
+
+RayStatistics& RayStatistics::operator-=(const RayStatistics& rhs)
+{
+    for (size_t i = 0; i < CategoryCount; ++i)
+        m_ray_counts[i] -= rhs.m_ray_counts[i];
+
+    m_leaf_visit_count -= rhs.m_leaf_visit_count;
+    m_triangle_test_count -= rhs.m_triangle_test_count;
+
+    return *this;
+}
+
+Statistics RayStatistics::get_statistics(const double seconds) const
+{
+    const uint64 total_ray_count = get_total_ray_count();
+
+    Statistics stats;
+    stats.insert("total rays", total_ray_count);
+
+    for (size_t i = 0; i < CategoryCount; ++i)
+        stats.insert(get_category_name(static_cast<Category>(i)), m_ray_counts[i]);
+
+    stats.insert("leaf visits", m_leaf_visit_count);
+    stats.insert("triangle tests", m_triangle_test_count);
+
+    if (seconds > 0.0)
+    {
+        stats.insert("rays per second", total_ray_count / seconds, "rays/s");
+
+        for (size_t i = 0; i < CategoryCount; ++i)
+        {
+            stats.insert(
+                string(get_category_name(static_cast<Category>(i))) + " per second",
+                m_ray_counts[i] / seconds,
+                "rays/s");
+        }
+    }
+
+    return stats;
+}
+
+}   // namespace renderer
@@ -0,0 +1,153 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_INTERSECTION_RAYSTATISTICS_H
+#define APPLESEED_RENDERER_KERNEL_INTERSECTION_RAYSTATISTICS_H
+
+// appleseed.renderer headers.
+#include "renderer/kernel/shading/shadingray.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/types.h"
+#include "foundation/utility/statistics.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+
+namespace renderer
+{
+
+//
+// Ray casting counters, broken down by ray category.
+//
+// Instances are meant to be owned by a single thread (typically by an Intersector)
+// and merged into a shared instance once rendering is over, so that counting rays
+// never requires any synchronization.
+//
+
+class DLLSYMBOL RayStatistics
+{
+  public:
+    // Ray categories.
+    enum Category
+    {
+        CameraRays,                             // primary rays
+        IndirectRays,                           // diffuse, glossy and specular bounces
+        ShadowRays,                             // shadow and probe rays
+        LightRays,                              // photons and light paths
+        OtherRays,                              // rays without a recognized type
+        CategoryCount
+    };
+
+    foundation::uint64  m_ray_counts[CategoryCount];
+    foundation::uint64  m_leaf_visit_count;     // number of triangle tree leaves visited
+    foundation::uint64  m_triangle_test_count;  // number of ray-triangle intersection tests
+
+    // Constructor, clears all counters.
+    RayStatistics();
+
+    // Reset all counters to zero.
+    void clear();
+
+    // Return the category of a given ray type.
+    static Category get_category(const ShadingRay::TypeType ray_type);
+
+    // Return the name of a given ray category.
+    static const char* get_category_name(const Category category);
+
+    // Count one ray of a given type.
+    void count_ray(const ShadingRay::TypeType ray_type);
+
+    // Return the total number of rays, all categories included.
+    foundation::uint64 get_total_ray_count() const;
+
+    // Merge or subtract the counters of another instance.
+    RayStatistics& operator+=(const RayStatistics& rhs);
+    RayStatistics& operator-=(const RayStatistics& rhs);
+
+    // Retrieve the counters as statistics. If 'seconds' is positive, ray rates are included.
+    foundation::Statistics get_statistics(const double seconds = 0.0) const;
+};
+
+
+//
+// RayStatistics class implementation.
+//
+
+inline RayStatistics::RayStatistics()
+{
+    clear();
+}
+
+inline void RayStatistics::clear()
+{
+    for (size_t i = 0; i < CategoryCount; ++i)
+        m_ray_counts[i] = 0;
+
+    m_leaf_visit_count = 0;
+    m_triangle_test_count = 0;
+}
+
+inline RayStatistics::Category RayStatistics::get_category(const ShadingRay::TypeType ray_type)
+{
+    if (ray_type & ShadingRay::CameraRay)
+        return CameraRays;
+
+    if (ray_type & ShadingRay::LightRay)
+        return LightRays;
+
+    if (ray_type & (ShadingRay::ShadowRay | ShadingRay::ProbeRay))
+        return ShadowRays;
+
+    if (ray_type & (ShadingRay::DiffuseRay | ShadingRay::GlossyRay | ShadingRay::SpecularRay))
+        return IndirectRays;
+
+    return OtherRays;
+}
+
+inline void RayStatistics::count_ray(const ShadingRay::TypeType ray_type)
+{
+    ++m_ray_counts[get_category(ray_type)];
+}
+
+inline foundation::uint64 RayStatistics::get_total_ray_count() const
+{
+    foundation::uint64 total = 0;
+
+    for (size_t i = 0; i < CategoryCount; ++i)
+        total += m_ray_counts[i];
+
+    return total;
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_INTERSECTION_RAYSTATISTICS_H
@@ -406,11 +406,13 @@ namespace
 
 RegionTree::Arguments::Arguments(
     const Scene&    scene,
-    const UniqueID  assembly_uid,
-    const Assembly& assembly)
+    const UniqueID          assembly_uid,
+    const Assembly&         assembly,
+    AlphaMaskRepository&    alpha_mask_repository)
   : m_scene(scene)
   , m_assembly_uid(assembly_uid)
   , m_assembly(assembly)
+  , m_alpha_mask_repository(alpha_mask_repository)
 {
 }
 
@@ -444,7 +446,8 @@ RegionTree::RegionTree(const Arguments& arguments)
                     triangle_tree_uid,
                     interm_leaf->m_extent,
                     interm_leaf->m_assembly,
-                    interm_leaf->m_regions)));
+                    interm_leaf->m_regions,
+                    arguments.m_alpha_mask_repository)));
 
         // Create and store the triangle tree.
         m_triangle_trees.insert(
@@ -514,7 +517,7 @@ double RegionLeafVisitor::visit(
     {
         // Check the intersection between the ray and the triangle tree.
         TriangleTreeIntersector intersector;
-        TriangleLeafVisitor visitor(*triangle_tree, m_shading_point);
+        TriangleLeafVisitor visitor(*triangle_tree, m_shading_point, m_ray_stats);
         if (triangle_tree->get_moving_triangle_count() > 0)
         {
             intersector.intersect_motion(
@@ -569,7 +572,7 @@ double RegionLeafProbeVisitor::visit(
     {
         // Check the intersection between the ray and the triangle tree.
         TriangleTreeProbeIntersector intersector;
-        TriangleLeafProbeVisitor visitor(*triangle_tree);
+        TriangleLeafProbeVisitor visitor(*triangle_tree, m_resolve_transparency, m_ray_stats);
         if (triangle_tree->get_moving_triangle_count() > 0)
         {
             intersector.intersect_motion(
@@ -596,10 +599,11 @@ double RegionLeafProbeVisitor::visit(
                 );
         }
 
-        // Terminate traversal if there was a hit.
-        if (visitor.hit())
+        // Terminate traversal if there was a hit or if the probe gave up.
+        if (visitor.hit() || visitor.transparent_hit())
         {
-            m_hit = true;
+            m_hit = visitor.hit();
+            m_transparent_hit = visitor.transparent_hit();
             return ray.m_tmin;
         }
     }
@@ -34,6 +34,7 @@
 #include "renderer/global/global.h"
 #include "renderer/kernel/intersection/intersectionsettings.h"
 #include "renderer/kernel/intersection/probevisitorbase.h"
+#include "renderer/kernel/intersection/raystatistics.h"
 #include "renderer/kernel/intersection/triangletree.h"
 #include "renderer/kernel/shading/shadingray.h"
 
@@ -47,6 +48,7 @@
 #include <map>
 
 // Forward declarations.
+namespace renderer  { class AlphaMaskRepository; }
 namespace renderer  { class Assembly; }
 namespace renderer  { class RegionTree; }
 namespace renderer  { class Scene; }
@@ -94,12 +96,14 @@ class RegionTree
         const Scene&                    m_scene;
         const foundation::UniqueID      m_assembly_uid;
         const Assembly&                 m_assembly;
+        AlphaMaskRepository&            m_alpha_mask_repository;
 
         // Constructor.
         Arguments(
             const Scene&                scene,
             const foundation::UniqueID  assembly_uid,
-            const Assembly&             assembly);
+            const Assembly&             assembly,
+            AlphaMaskRepository&        alpha_mask_repository);
     };
 
     // Constructor, builds the tree for a given assembly.
@@ -172,7 +176,8 @@ class RegionLeafVisitor
     // Constructor.
     RegionLeafVisitor(
         ShadingPoint&                           shading_point,
-        TriangleTreeAccessCache&                triangle_tree_cache
+        TriangleTreeAccessCache&                triangle_tree_cache,
+        RayStatistics&                          ray_stats
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , foundation::bvh::TraversalStatistics& triangle_tree_stats
 #endif
@@ -187,6 +192,7 @@ class RegionLeafVisitor
   private:
     ShadingPoint&                               m_shading_point;
     TriangleTreeAccessCache&                    m_triangle_tree_cache;
+    RayStatistics&                              m_ray_stats;
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     foundation::bvh::TraversalStatistics&       m_triangle_tree_stats;
 #endif
@@ -204,7 +210,9 @@ class RegionLeafProbeVisitor
   public:
     // Constructor.
     RegionLeafProbeVisitor(
-        TriangleTreeAccessCache&                triangle_tree_cache
+        TriangleTreeAccessCache&                triangle_tree_cache,
+        const bool                              resolve_transparency,
+        RayStatistics&                          ray_stats
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , foundation::bvh::TraversalStatistics& triangle_tree_stats
 #endif
@@ -218,6 +226,8 @@ class RegionLeafProbeVisitor
 
   private:
     TriangleTreeAccessCache&                    m_triangle_tree_cache;
+    const bool                                  m_resolve_transparency;
+    RayStatistics&                              m_ray_stats;
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     foundation::bvh::TraversalStatistics&       m_triangle_tree_stats;
 #endif
@@ -272,13 +282,15 @@ inline foundation::UniqueID RegionLeaf::get_triangle_tree_uid() const
 
 inline RegionLeafVisitor::RegionLeafVisitor(
     ShadingPoint&                               shading_point,
-    TriangleTreeAccessCache&                    triangle_tree_cache
+    TriangleTreeAccessCache&                    triangle_tree_cache,
+    RayStatistics&                              ray_stats
   #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     , foundation::bvh::TraversalStatistics&     triangle_tree_stats
 #endif
     )
   : m_shading_point(shading_point)
   , m_triangle_tree_cache(triangle_tree_cache)
+  , m_ray_stats(ray_stats)
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
   , m_triangle_tree_stats(triangle_tree_stats)
 #endif
@@ -291,12 +303,16 @@ inline RegionLeafVisitor::RegionLeafVisitor(
 //
 
 inline RegionLeafProbeVisitor::RegionLeafProbeVisitor(
-    TriangleTreeAccessCache&                    triangle_tree_cache
+    TriangleTreeAccessCache&                    triangle_tree_cache,
+    const bool                                  resolve_transparency,
+    RayStatistics&                              ray_stats
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     , foundation::bvh::TraversalStatistics&     triangle_tree_stats
 #endif
     )
   : m_triangle_tree_cache(triangle_tree_cache)
+  , m_resolve_transparency(resolve_transparency)
+  , m_ray_stats(ray_stats)
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
   , m_triangle_tree_stats(triangle_tree_stats)
 #endif
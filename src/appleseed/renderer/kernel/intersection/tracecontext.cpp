@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/kernel/intersection/alphamaskrepository.h"
 #include "renderer/kernel/intersection/assemblytree.h"
 #include "renderer/kernel/intersection/intersectionsettings.h"
 #include "renderer/kernel/intersection/regioninfo.h"
@@ -42,6 +43,7 @@
 #include "renderer/kernel/shading/shadingresult.h"
 
 // appleseed.foundation headers.
+#include "foundation/utility/statistics.h"
 #include "foundation/utility/string.h"
 
 using namespace foundation;
@@ -55,7 +57,8 @@ namespace renderer
 
 TraceContext::TraceContext(const Scene& scene)
   : m_scene(scene)
-  , m_assembly_tree(new AssemblyTree(scene))
+  , m_alpha_mask_repository(new AlphaMaskRepository())
+  , m_assembly_tree(new AssemblyTree(scene, *m_alpha_mask_repository))
 {
     RENDERER_LOG_DEBUG(
         "data structures size:\n"
@@ -73,16 +76,47 @@ TraceContext::TraceContext(const Scene& scene)
         pretty_size(sizeof(ShadingRay)).c_str(),
         pretty_size(sizeof(ShadingResult)).c_str(),
         pretty_size(sizeof(TriangleKey)).c_str());
+
+    print_alpha_mask_statistics();
 }
 
 TraceContext::~TraceContext()
 {
+    // Intersection filters release their alpha masks when the trees are deleted.
     delete m_assembly_tree;
+    delete m_alpha_mask_repository;
 }
 
 void TraceContext::update()
 {
     m_assembly_tree->update();
+
+    print_alpha_mask_statistics();
+}
+
+void TraceContext::add_ray_statistics(const RayStatistics& ray_stats) const
+{
+    boost::mutex::scoped_lock lock(m_ray_stats_mutex);
+    m_ray_stats += ray_stats;
+}
+
+RayStatistics TraceContext::get_ray_statistics() const
+{
+    boost::mutex::scoped_lock lock(m_ray_stats_mutex);
+    return m_ray_stats;
+}
+
+uint64 TraceContext::get_ray_count() const
+{
+    return get_ray_statistics().get_total_ray_count();
+}
+
+void TraceContext::print_alpha_mask_statistics() const
+{
+    RENDERER_LOG_DEBUG("%s",
+        StatisticsVector::make(
+            "alpha mask statistics",
+            m_alpha_mask_repository->get_statistics()).to_string().c_str());
 }
 
 }   // namespace renderer
@@ -30,13 +30,21 @@
 #ifndef APPLESEED_RENDERER_KERNEL_INTERSECTION_TRACECONTEXT_H
 #define APPLESEED_RENDERER_KERNEL_INTERSECTION_TRACECONTEXT_H
 
+// appleseed.renderer headers.
+#include "renderer/kernel/intersection/raystatistics.h"
+
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/types.h"
 
 // appleseed.main headers.
 #include "main/dllsymbol.h"
 
+// boost headers.
+#include "boost/thread/mutex.hpp"
+
 // Forward declarations.
+namespace renderer  { class AlphaMaskRepository; }
 namespace renderer  { class AssemblyTree; }
 namespace renderer  { class Scene; }
 
@@ -69,9 +77,23 @@ class DLLSYMBOL TraceContext
     // Synchronize the trace context with the scene.
     void update();
 
+    // Merge the ray statistics of a thread into the ones of this trace context.
+    void add_ray_statistics(const RayStatistics& ray_stats) const;
+
+    // Return the statistics of all rays traced against this trace context since its creation.
+    RayStatistics get_ray_statistics() const;
+
+    // Return the number of rays traced against this trace context since its creation.
+    foundation::uint64 get_ray_count() const;
+
   private:
-    const Scene&    m_scene;
-    AssemblyTree*   m_assembly_tree;
+    const Scene&                m_scene;
+    AlphaMaskRepository*        m_alpha_mask_repository;
+    AssemblyTree*               m_assembly_tree;
+    mutable boost::mutex        m_ray_stats_mutex;
+    mutable RayStatistics       m_ray_stats;
+
+    void print_alpha_mask_statistics() const;
 };
 
 
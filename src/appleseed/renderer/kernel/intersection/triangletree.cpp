@@ -46,6 +46,9 @@
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/containers.h"
 #include "renderer/modeling/scene/objectinstance.h"
+#ifdef WITH_OSL
+#include "renderer/modeling/shadergroup/shadergroup.h"
+#endif
 #include "renderer/utility/bbox.h"
 #include "renderer/utility/messagecontext.h"
 #include "renderer/utility/paramarray.h"
@@ -56,6 +59,7 @@
 #include "foundation/math/treeoptimizer.h"
 #include "foundation/platform/system.h"
 #include "foundation/platform/timer.h"
+#include "foundation/utility/eventtracer.h"
 #include "foundation/utility/makevector.h"
 #include "foundation/utility/memory.h"
 #include "foundation/utility/statistics.h"
@@ -380,18 +384,21 @@ TriangleTree::Arguments::Arguments(
     const UniqueID          triangle_tree_uid,
     const GAABB3&           bbox,
     const Assembly&         assembly,
-    const RegionInfoVector& regions)
+    const RegionInfoVector& regions,
+    AlphaMaskRepository&    alpha_mask_repository)
   : m_scene(scene)
   , m_triangle_tree_uid(triangle_tree_uid)
   , m_bbox(bbox)
   , m_assembly(assembly)
   , m_regions(regions)
+  , m_alpha_mask_repository(alpha_mask_repository)
 {
 }
 
 TriangleTree::TriangleTree(const Arguments& arguments)
   : TreeType(AlignedAllocator<void>(System::get_l1_data_cache_line_size()))
   , m_arguments(arguments)
+  , m_memory_account(MemoryCategoryAccelerationStructures)
 {
     // Retrieve construction parameters.
     const MessageContext message_context(
@@ -405,6 +412,8 @@ TriangleTree::TriangleTree(const Arguments& arguments)
     Stopwatch<DefaultWallclockTimer> stopwatch;
     stopwatch.start();
 
+    const ScopedEvent event("build triangle tree", "intersection");
+
     // Build the tree.
     Statistics statistics;
     if (algorithm == "bvh")
@@ -429,6 +438,12 @@ TriangleTree::TriangleTree(const Arguments& arguments)
     // Create intersection filters.
     if (m_arguments.m_assembly.get_parameters().get_optional<bool>("enable_intersection_filters", true))
         create_intersection_filters();
+
+    // Identify object instances whose transparency can't be resolved during traversal.
+    collect_transparent_object_instances();
+
+    // Account for the memory used by the tree.
+    m_memory_account.set_size(get_memory_size());
 }
 
 TriangleTree::~TriangleTree()
@@ -446,16 +461,30 @@ void TriangleTree::update_non_geometry()
     delete_intersection_filters();
     if (m_arguments.m_assembly.get_parameters().get_optional<bool>("enable_intersection_filters", true))
         create_intersection_filters();
+
+    // Update transparent object instances.
+    collect_transparent_object_instances();
+
+    // Account for the memory used by the new intersection filters.
+    m_memory_account.set_size(get_memory_size());
 }
 
 size_t TriangleTree::get_memory_size() const
 {
-    return
+    size_t size =
           TreeType::get_memory_size()
         - sizeof(*static_cast<const TreeType*>(this))
         + sizeof(*this)
         + m_triangle_keys.capacity() * sizeof(TriangleKey)
-        + m_leaf_data.capacity() * sizeof(uint8);
+        + m_leaf_data.capacity() * sizeof(uint8)
+        + m_intersection_filters_repository.capacity() * sizeof(const IntersectionFilter*)
+        + m_intersection_filters.capacity() * sizeof(const IntersectionFilter*)
+        + m_transparent_object_instances.capacity() * sizeof(uint8);
+
+    for (size_t i = 0; i < m_intersection_filters_repository.size(); ++i)
+        size += m_intersection_filters_repository[i]->get_memory_size();
+
+    return size;
 }
 
 namespace
@@ -1098,6 +1127,7 @@ namespace
 
     // Create intersection filters for a set of filter keys.
     void do_create_intersection_filters(
+        AlphaMaskRepository&                alpha_mask_repository,
         TextureCache&                       texture_cache,
         const FilterKeySet&                 filter_keys,
         IntersectionFilterMap&              intersection_filters)
@@ -1115,6 +1145,7 @@ namespace
                 new IntersectionFilter(
                     *filter_key.m_object,
                     filter_key.m_materials,
+                    alpha_mask_repository,
                     texture_cache));
 
             // Store this intersection filter if it's useful.
@@ -1122,6 +1153,52 @@ namespace
                 intersection_filters[&filter_key] = intersection_filter.release();
         }
     }
+
+    // Return true if the opacity of a material at a point accepted by an intersection filter is unknown.
+    bool is_transparent(
+        const Material*                     material,
+        const IntersectionFilter*           filter,
+        const size_t                        material_index)
+    {
+        if (material == 0)
+            return false;
+
+#ifdef WITH_OSL
+        if (material->has_osl_surface() && material->get_uncached_osl_surface()->has_transparency())
+            return true;
+#endif
+
+        // Use the uncached version of get_alpha_map(), see FilterKey::has_alpha_maps().
+        if (material->get_uncached_alpha_map() == 0)
+            return false;
+
+        // Points accepted by an exact alpha mask are fully opaque.
+        return filter == 0 || !filter->is_exact(material_index);
+    }
+
+    // Return true if an object instance may be partially transparent at points accepted by its intersection filter.
+    bool is_transparent(
+        const ObjectInstance&               object_instance,
+        const IntersectionFilter*           filter)
+    {
+        const MaterialArray& front_materials = object_instance.get_front_materials();
+        const MaterialArray& back_materials = object_instance.get_back_materials();
+        const size_t material_count = max(front_materials.size(), back_materials.size());
+
+        for (size_t i = 0; i < material_count; ++i)
+        {
+            const Material* front_material = i < front_materials.size() ? front_materials[i] : 0;
+            const Material* back_material = i < back_materials.size() ? back_materials[i] : 0;
+
+            // Intersection filters are built from front materials.
+            if (is_transparent(front_material, filter, i))
+                return true;
+            if (is_transparent(back_material, back_material == front_material ? filter : 0, i))
+                return true;
+        }
+
+        return false;
+    }
 }
 
 void TriangleTree::create_intersection_filters()
@@ -1148,6 +1225,7 @@ void TriangleTree::create_intersection_filters()
     TextureStore texture_store(m_arguments.m_scene);
     TextureCache texture_cache(texture_store);
     do_create_intersection_filters(
+        m_arguments.m_alpha_mask_repository,
         texture_cache,
         filter_keys,
         intersection_filters);
@@ -1166,6 +1244,44 @@ void TriangleTree::create_intersection_filters()
         m_intersection_filters[i->first] = intersection_filters[i->second];
 }
 
+void TriangleTree::collect_transparent_object_instances()
+{
+    m_transparent_object_instances.clear();
+
+    // Collect object instance indices.
+    IndexSet object_instance_indices;
+    collect_object_instance_indices(
+        m_arguments.m_regions,
+        object_instance_indices);
+    if (object_instance_indices.empty())
+        return;
+
+    const ObjectInstanceContainer& object_instances = m_arguments.m_assembly.object_instances();
+    const size_t max_object_instance_index =
+        *max_element(object_instance_indices.begin(), object_instance_indices.end());
+    vector<uint8> transparent_object_instances(max_object_instance_index + 1, 0);
+    bool found_transparent_object_instance = false;
+
+    for (const_each<IndexSet> i = object_instance_indices; i; ++i)
+    {
+        const size_t object_instance_index = *i;
+        const IntersectionFilter* filter =
+            object_instance_index < m_intersection_filters.size()
+                ? m_intersection_filters[object_instance_index]
+                : 0;
+
+        if (is_transparent(*object_instances.get_by_index(object_instance_index), filter))
+        {
+            transparent_object_instances[object_instance_index] = 1;
+            found_transparent_object_instance = true;
+        }
+    }
+
+    // Leave the vector empty if all object instances are opaque.
+    if (found_transparent_object_instance)
+        m_transparent_object_instances.swap(transparent_object_instances);
+}
+
 void TriangleTree::delete_intersection_filters()
 {
     for (size_t i = 0; i < m_intersection_filters_repository.size(); ++i)
@@ -31,10 +31,12 @@
 #define APPLESEED_RENDERER_KERNEL_INTERSECTION_TRIANGLETREE_H
 
 // appleseed.renderer headers.
+#include "renderer/global/globalmemory.h"
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/intersection/intersectionfilter.h"
 #include "renderer/kernel/intersection/intersectionsettings.h"
 #include "renderer/kernel/intersection/probevisitorbase.h"
+#include "renderer/kernel/intersection/raystatistics.h"
 #include "renderer/kernel/intersection/regioninfo.h"
 #include "renderer/kernel/intersection/trianglekey.h"
 #include "renderer/kernel/shading/shadingpoint.h"
@@ -60,6 +62,7 @@
 
 // Forward declarations.
 namespace foundation    { class Statistics; }
+namespace renderer      { class AlphaMaskRepository; }
 namespace renderer      { class Assembly; }
 namespace renderer      { class ParamArray; }
 namespace renderer      { class Scene; }
@@ -88,6 +91,7 @@ class TriangleTree
         const GAABB3                            m_bbox;
         const Assembly&                         m_assembly;
         const RegionInfoVector                  m_regions;
+        AlphaMaskRepository&                    m_alpha_mask_repository;
 
         // Constructor.
         Arguments(
@@ -95,7 +99,8 @@ class TriangleTree
             const foundation::UniqueID          triangle_tree_uid,
             const GAABB3&                       bbox,
             const Assembly&                     assembly,
-            const RegionInfoVector&             regions);
+            const RegionInfoVector&             regions,
+            AlphaMaskRepository&                alpha_mask_repository);
     };
 
     // Constructor, builds the tree for a given set of regions.
@@ -127,6 +132,9 @@ class TriangleTree
     std::vector<foundation::uint8>              m_leaf_data;
     std::vector<const IntersectionFilter*>      m_intersection_filters_repository;
     std::vector<const IntersectionFilter*>      m_intersection_filters;
+    std::vector<foundation::uint8>              m_transparent_object_instances;
+
+    MemoryAccount                               m_memory_account;
 
     void build_bvh(
         const ParamArray&                       params,
@@ -155,6 +163,8 @@ class TriangleTree
 
     void create_intersection_filters();
     void delete_intersection_filters();
+
+    void collect_transparent_object_instances();
 };
 
 
@@ -210,7 +220,8 @@ class TriangleLeafVisitor
     // Constructor.
     TriangleLeafVisitor(
         const TriangleTree&                     tree,
-        ShadingPoint&                           shading_point);
+        ShadingPoint&                           shading_point,
+        RayStatistics&                          ray_stats);
 
     // Visit a leaf.
     bool visit(
@@ -230,6 +241,7 @@ class TriangleLeafVisitor
     const TriangleTree&     m_tree;
     const bool              m_has_intersection_filters;
     ShadingPoint&           m_shading_point;
+    RayStatistics&          m_ray_stats;
     GTriangleType           m_interpolated_triangle;
     const GTriangleType*    m_hit_triangle;
     size_t                  m_hit_triangle_index;
@@ -240,14 +252,21 @@ class TriangleLeafVisitor
 // Triangle leaf visitor for probe rays, only return boolean answers
 // (whether an intersection was found or not).
 //
+// When transparency is resolved, surfaces whose opacity is exactly captured by
+// their intersection filter are skipped or reported as hits accordingly. Any other
+// surface that may be partially transparent terminates traversal without a hit
+// and is reported via transparent_hit(), since the probe cannot settle it.
+//
 
 class TriangleLeafProbeVisitor
   : public ProbeVisitorBase
 {
   public:
     // Constructor.
-    explicit TriangleLeafProbeVisitor(
-        const TriangleTree&                     tree);
+    TriangleLeafProbeVisitor(
+        const TriangleTree&                     tree,
+        const bool                              resolve_transparency,
+        RayStatistics&                          ray_stats);
 
     // Visit a leaf.
     bool visit(
@@ -263,6 +282,15 @@ class TriangleLeafProbeVisitor
   private:
     const TriangleTree&     m_tree;
     const bool              m_has_intersection_filters;
+    const bool              m_has_transparent_object_instances;
+    const bool              m_need_hit_coordinates;
+    RayStatistics&          m_ray_stats;
+
+    // Return true if a hit on a given triangle terminates traversal.
+    bool accept_hit(
+        const size_t                            triangle_index,
+        const double                            u,
+        const double                            v);
 };
 
 
@@ -344,10 +372,12 @@ inline size_t TriangleTree::get_moving_triangle_count() const
 
 inline TriangleLeafVisitor::TriangleLeafVisitor(
     const TriangleTree&                     tree,
-    ShadingPoint&                           shading_point)
+    ShadingPoint&                           shading_point,
+    RayStatistics&                          ray_stats)
   : m_tree(tree)
   , m_has_intersection_filters(!tree.m_intersection_filters.empty())
   , m_shading_point(shading_point)
+  , m_ray_stats(ray_stats)
   , m_hit_triangle(0)
 {
 }
@@ -374,6 +404,8 @@ inline bool TriangleLeafVisitor::visit(
     const size_t triangle_index = node.get_item_index();
     const size_t triangle_count = node.get_item_count();
 
+    ++m_ray_stats.m_leaf_visit_count;
+
     // Sequentially intersect all triangles of the leaf.
     for (size_t i = 0; i < triangle_count; ++i)
     {
@@ -453,6 +485,7 @@ inline bool TriangleLeafVisitor::visit(
     }
 
     FOUNDATION_BVH_TRAVERSAL_STATS(stats.m_intersected_items.insert(triangle_count));
+    m_ray_stats.m_triangle_test_count += triangle_count;
 
     // Continue traversal.
     distance = m_shading_point.m_ray.m_tmax;
@@ -484,12 +517,41 @@ inline void TriangleLeafVisitor::read_hit_triangle_data() const
 //
 
 inline TriangleLeafProbeVisitor::TriangleLeafProbeVisitor(
-    const TriangleTree&                     tree)
+    const TriangleTree&                     tree,
+    const bool                              resolve_transparency,
+    RayStatistics&                          ray_stats)
   : m_tree(tree)
   , m_has_intersection_filters(!tree.m_intersection_filters.empty())
+  , m_has_transparent_object_instances(resolve_transparency && !tree.m_transparent_object_instances.empty())
+  , m_need_hit_coordinates(m_has_intersection_filters || m_has_transparent_object_instances)
+  , m_ray_stats(ray_stats)
 {
 }
 
+inline bool TriangleLeafProbeVisitor::accept_hit(
+    const size_t                            triangle_index,
+    const double                            u,
+    const double                            v)
+{
+    const TriangleKey& triangle_key = m_tree.m_triangle_keys[triangle_index];
+    const size_t object_instance_index = triangle_key.get_object_instance_index();
+
+    // Optionally filter intersections.
+    if (m_has_intersection_filters)
+    {
+        const IntersectionFilter* filter = m_tree.m_intersection_filters[object_instance_index];
+        if (filter && !filter->accept(triangle_key, u, v))
+            return false;
+    }
+
+    // Give up at the first surface that may be partially transparent: only the trace loop can settle it.
+    if (m_has_transparent_object_instances &&
+        m_tree.m_transparent_object_instances[object_instance_index])
+        m_transparent_hit = true;
+
+    return true;
+}
+
 inline bool TriangleLeafProbeVisitor::visit(
     const TriangleTree::NodeType&           node,
     const ShadingRay&                       ray,
@@ -509,8 +571,11 @@ inline bool TriangleLeafProbeVisitor::visit(
             ? user_data + sizeof(foundation::uint32)    // triangles are stored in the leaf node
             : &m_tree.m_leaf_data[leaf_data_index];     // triangles are stored in the tree
 
+    const size_t triangle_index = node.get_item_index();
     const size_t triangle_count = node.get_item_count();
 
+    ++m_ray_stats.m_leaf_visit_count;
+
     // Sequentially intersect triangles until a hit is found.
     for (size_t i = 0; i < triangle_count; ++i)
     {
@@ -527,10 +592,14 @@ inline bool TriangleLeafProbeVisitor::visit(
             leaf_data += sizeof(GTriangleType);
 
             // Intersect the triangle.
-            if (reader.m_triangle.intersect(ray))
+            double t, u, v;
+            if (m_need_hit_coordinates
+                    ? reader.m_triangle.intersect(ray, t, u, v) && accept_hit(triangle_index + i, u, v)
+                    : reader.m_triangle.intersect(ray))
             {
                 FOUNDATION_BVH_TRAVERSAL_STATS(stats.m_intersected_items.insert(i + 1));
-                m_hit = true;
+                m_ray_stats.m_triangle_test_count += i + 1;
+                m_hit = !m_transparent_hit;
                 return false;
             }
         }
@@ -553,16 +622,21 @@ inline bool TriangleLeafProbeVisitor::visit(
             const impl::TriangleReader reader(triangle);
 
             // Intersect the triangle.
-            if (reader.m_triangle.intersect(ray))
+            double t, u, v;
+            if (m_need_hit_coordinates
+                    ? reader.m_triangle.intersect(ray, t, u, v) && accept_hit(triangle_index + i, u, v)
+                    : reader.m_triangle.intersect(ray))
             {
                 FOUNDATION_BVH_TRAVERSAL_STATS(stats.m_intersected_items.insert(i + 1));
-                m_hit = true;
+                m_ray_stats.m_triangle_test_count += i + 1;
+                m_hit = !m_transparent_hit;
                 return false;
             }
         }
     }
 
     FOUNDATION_BVH_TRAVERSAL_STATS(stats.m_intersected_items.insert(triangle_count));
+    m_ray_stats.m_triangle_test_count += triangle_count;
 
     // Continue traversal.
     distance = ray.m_tmax;
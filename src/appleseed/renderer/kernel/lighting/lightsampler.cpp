@@ -53,6 +53,7 @@
 #include "foundation/math/area.h"
 #include "foundation/math/sampling.h"
 #include "foundation/math/scalar.h"
+#include "foundation/utility/eventtracer.h"
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/lazy.h"
 #include "foundation/utility/string.h"
@@ -114,6 +115,8 @@ LightSampler::LightSampler(const Scene& scene, const ParamArray& params)
   : m_params(params)
   , m_emitting_triangle_hash_table(m_triangle_key_hasher)
 {
+    const ScopedEvent event("build light sampler", "lighting");
+
     RENDERER_LOG_INFO("collecting light emitters...");
 
     // Collect all non-physical lights.
@@ -59,6 +59,7 @@
 #include "renderer/modeling/input/inputevaluator.h"
 #include "renderer/modeling/light/light.h"
 #include "renderer/modeling/scene/scene.h"
+#include "renderer/utility/samplingmode.h"
 #include "renderer/utility/transformsequence.h"
 
 // appleseed.foundation headers.
@@ -116,6 +117,8 @@ namespace
             const size_t    m_max_path_length;              // maximum path length, ~0 for unlimited
             const size_t    m_rr_min_path_length;           // minimum path length before Russian Roulette kicks in, ~0 for unlimited
 
+            const SamplingContext::Mode m_sampling_mode;
+
             explicit Parameters(const ParamArray& params)
               : m_enable_ibl(params.get_optional<bool>("enable_ibl", true))
               , m_enable_caustics(params.get_optional<bool>("enable_caustics", true))
@@ -124,6 +127,7 @@ namespace
               , m_report_self_intersections(params.get_optional<bool>("report_self_intersections", false))
               , m_max_path_length(nz(params.get_optional<size_t>("max_path_length", 0)))
               , m_rr_min_path_length(nz(params.get_optional<size_t>("rr_min_path_length", 3)))
+              , m_sampling_mode(get_sampling_context_mode(params))
             {
             }
 
@@ -239,7 +243,7 @@ namespace
 
             const Spectrum                  m_initial_flux;         // initial particle flux (in W)
             Vector3d                        m_camera_position;      // camera position in world space
-            SampleVector&                   m_samples;
+            SampleBatch&                    m_samples;
             size_t                          m_sample_count;         // the number of samples added to m_samples
 
             PathVisitor(
@@ -247,7 +251,7 @@ namespace
                 const Scene&                scene,
                 const Frame&                frame,
                 const ShadingContext&       shading_context,
-                SampleVector&               samples,
+                SampleBatch&                samples,
                 const Spectrum&             initial_flux)
               : m_params(params)
               , m_camera(*scene.get_camera())
@@ -448,13 +452,10 @@ namespace
             {
                 assert(min_value(radiance) >= 0.0f);
 
-                Sample sample;
-                sample.m_position = position_ndc;
-                sample.m_color.rgb() =
+                const Color3f rgb =
                     ciexyz_to_linear_rgb(
                         spectrum_to_ciexyz<float>(m_lighting_conditions, radiance));
-                sample.m_color[3] = 1.0f;
-                m_samples.push_back(sample);
+                m_samples.push_back(position_ndc, Color4f(rgb, 1.0f));
                 ++m_sample_count;
             }
 
@@ -498,13 +499,17 @@ namespace
 
         virtual size_t generate_samples(
             const size_t                sequence_index,
-            SampleVector&               samples) OVERRIDE
+            SampleBatch&                samples) OVERRIDE
         {
+            // In QMC mode, all light paths are successive points of a single sequence
+            // shared by all sample generators, which use disjoint sequence indices.
             SamplingContext sampling_context(
                 m_rng,
-                0,
-                sequence_index,
-                sequence_index);
+                m_params.m_sampling_mode,
+                0,                          // number of dimensions
+                sequence_index,             // number of samples
+                sequence_index,             // initial instance number
+                0);                         // scrambling seed
 
             size_t stored_sample_count = 0;
 
@@ -529,7 +534,7 @@ namespace
 
         size_t generate_light_sample(
             SamplingContext&            sampling_context,
-            SampleVector&               samples)
+            SampleBatch&                samples)
         {
             // Sample the light sources.
             LightSample light_sample;
@@ -545,7 +550,7 @@ namespace
         size_t generate_emitting_triangle_sample(
             SamplingContext&            sampling_context,
             LightSample&                light_sample,
-            SampleVector&               samples)
+            SampleBatch&                samples)
         {
             // Make sure the geometric normal of the light sample is in the same hemisphere as the shading normal.
             light_sample.m_geometric_normal =
@@ -637,7 +642,7 @@ namespace
         size_t generate_non_physical_light_sample(
             SamplingContext&            sampling_context,
             const LightSample&          light_sample,
-            SampleVector&               samples)
+            SampleBatch&                samples)
         {
             // Sample the light.
             InputEvaluator input_evaluator(m_texture_cache);
@@ -709,7 +714,7 @@ namespace
         size_t generate_environment_sample(
             SamplingContext&            sampling_context,
             const EnvironmentEDF*       env_edf,
-            SampleVector&               samples)
+            SampleBatch&                samples)
         {
             // Sample the environment.
             sampling_context.split_in_place(2, 1);
@@ -844,6 +849,8 @@ SampleAccumulationBuffer* LightTracingSampleGeneratorFactory::create_sample_accu
         new GlobalSampleAccumulationBuffer(
             props.m_canvas_width,
             props.m_canvas_height,
+            props.m_tile_width,
+            props.m_tile_height,
             m_frame.get_filter());
 }
 
@@ -37,6 +37,7 @@
 #include "renderer/kernel/lighting/imagebasedlighting.h"
 #include "renderer/kernel/lighting/lightsampler.h"
 #include "renderer/kernel/lighting/pathtracer.h"
+#include "renderer/kernel/rendering/pixelcontext.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingpoint.h"
 #include "renderer/modeling/bsdf/bsdf.h"
@@ -62,7 +63,6 @@
 
 // Forward declarations.
 namespace renderer  { class EnvironmentEDF; }
-namespace renderer  { class PixelContext; }
 
 using namespace foundation;
 using namespace std;
@@ -157,6 +157,7 @@ namespace
                 m_pass_callback,
                 m_light_sampler,
                 sampling_context,
+                pixel_context,
                 shading_context,
                 shading_point.get_scene(),
                 m_answer,
@@ -203,18 +204,21 @@ namespace
             const SPPMPassCallback&     m_pass_callback;
             const LightSampler&         m_light_sampler;
             SamplingContext&            m_sampling_context;
+            const PixelContext&         m_pixel_context;
             const ShadingContext&       m_shading_context;
             TextureCache&               m_texture_cache;
             const EnvironmentEDF*       m_env_edf;
             knn::Answer<float>&         m_answer;
             Spectrum&                   m_path_radiance;
             SpectrumStack&              m_path_aovs;
+            bool                        m_lookup_recorded;
 
             PathVisitor(
                 const SPPMParameters&   params,
                 const SPPMPassCallback& pass_callback,
                 const LightSampler&     light_sampler,
                 SamplingContext&        sampling_context,
+                const PixelContext&     pixel_context,
                 const ShadingContext&   shading_context,
                 const Scene&            scene,
                 knn::Answer<float>&     answer,
@@ -224,12 +228,14 @@ namespace
               , m_pass_callback(pass_callback)
               , m_light_sampler(light_sampler)
               , m_sampling_context(sampling_context)
+              , m_pixel_context(pixel_context)
               , m_shading_context(shading_context)
               , m_texture_cache(shading_context.get_texture_cache())
               , m_env_edf(scene.get_environment()->get_environment_edf())
               , m_answer(answer)
               , m_path_radiance(path_radiance)
               , m_path_aovs(path_aovs)
+              , m_lookup_recorded(false)
             {
             }
 
@@ -344,15 +350,24 @@ namespace
                 if (photon_map.empty())
                     return;
 
-                const float radius = m_pass_callback.get_lookup_radius();
+                const float radius =
+                    m_params.m_per_pixel_radius
+                        ? m_pass_callback.get_lookup_radius(m_pixel_context.m_ix, m_pixel_context.m_iy)
+                        : m_pass_callback.get_lookup_radius();
                 const Vector3f point(vertex.get_point());
                 const Vector3f normal(vertex.get_geometric_normal());
 
                 // Find the nearby photons around the path vertex.
-                const knn::Query3f query(photon_map, m_answer);
-                query.run(point, radius * radius);
+                photon_map.find_nearest_photons(point, radius * radius, m_answer);
                 const size_t photon_count = m_answer.size();
 
+                // The first lookup along the path drives the radius reduction of the pixel.
+                if (m_params.m_per_pixel_radius && !m_lookup_recorded)
+                {
+                    m_pass_callback.record_lookup(m_pixel_context.m_ix, m_pixel_context.m_iy, photon_count);
+                    m_lookup_recorded = true;
+                }
+
                 // Compute the square radius of the lookup disk.
                 float max_square_dist;
                 if (photon_count == m_params.m_max_photons_per_estimate)
@@ -370,6 +385,8 @@ namespace
                     return;
 #endif
 
+                const SPPMPhotonVector& photons = m_pass_callback.get_photons();
+
                 size_t included_photon_count = 0;
                 Spectrum indirect_radiance(0.0f);
 
@@ -378,22 +395,25 @@ namespace
                 {
                     // Retrieve the i'th photon.
                     const knn::Answer<float>::Entry& photon = m_answer.get(i);
-                    const SPPMPhotonData& data = m_pass_callback.get_photon_data(photon_map.remap(photon.m_index));
+                    const size_t photon_index = photon_map.remap(photon.m_index);
 
                     // Reject photons from the opposite hemisphere as they won't contribute.
-                    if (dot(normal, data.m_incoming) <= 0.0f)
+                    const Vector3f photon_incoming = photons.get_incoming(photon_index);
+                    if (dot(normal, photon_incoming) <= 0.0f)
                         continue;
 
+                    const Vector3f photon_geometric_normal = photons.get_geometric_normal(photon_index);
+
 #if 1
                     // Reject photons on a surface with too different an orientation.
                     const float NormalThreshold = 1.0e-3f;
-                    if (dot(normal, data.m_geometric_normal) < NormalThreshold)
+                    if (dot(normal, photon_geometric_normal) < NormalThreshold)
                         continue;
 #endif
 
 #if 0
                     // Reject photons on the wrong side of the surface.
-                    if (dot(vertex.m_outgoing, Vector3d(data.m_geometric_normal)) <= 0.0)
+                    if (dot(vertex.m_outgoing, Vector3d(photon_geometric_normal)) <= 0.0)
                         continue;
 #endif
 
@@ -416,7 +436,7 @@ namespace
                             vertex.get_geometric_normal(),
                             vertex.get_shading_basis(),
                             vertex.m_outgoing,                      // toward the camera
-                            normalize(Vector3d(data.m_incoming)),   // toward the light
+                            normalize(Vector3d(photon_incoming)),   // toward the light
                             BSDF::Diffuse,
                             bsdf_value);
                     if (bsdf_prob == 0.0)
@@ -425,8 +445,10 @@ namespace
                     // The photons store flux but we are computing reflected radiance.
                     // The first step of the flux -> radiance conversion is done here.
                     // The conversion will be completed when doing density estimation.
-                    bsdf_value /= abs(dot(data.m_incoming, data.m_geometric_normal));
-                    bsdf_value *= data.m_flux;
+                    Spectrum photon_flux;
+                    photons.get_flux(photon_index, photon_flux);
+                    bsdf_value /= abs(dot(photon_incoming, photon_geometric_normal));
+                    bsdf_value *= photon_flux;
 
                     // Apply kernel weight.
 #if 0
@@ -510,20 +532,23 @@ namespace
             Spectrum&               radiance)
         {
             const SPPMPhotonMap& photon_map = m_pass_callback.get_photon_map();
-            const knn::Query3f query(photon_map, m_answer);
-
-            query.run(
+            photon_map.find_nearest_photons(
                 Vector3f(shading_point.get_point()),
-                square(m_params.m_view_photons_radius));
+                square(m_params.m_view_photons_radius),
+                m_answer);
 
             radiance.set(0.0f);
 
+            const SPPMPhotonVector& photons = m_pass_callback.get_photons();
             const size_t photon_count = m_answer.size();
 
             for (size_t i = 0; i < photon_count; ++i)
             {
                 const knn::Answer<float>::Entry& photon = m_answer.get(i);
-                radiance += m_pass_callback.get_photon_data(photon_map.remap(photon.m_index)).m_flux;
+
+                Spectrum photon_flux;
+                photons.get_flux(photon_map.remap(photon.m_index), photon_flux);
+                radiance += photon_flux;
             }
 
             if (photon_count > 1)
@@ -33,6 +33,7 @@
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
 #include "renderer/utility/paramarray.h"
+#include "renderer/utility/samplingmode.h"
 
 // appleseed.foundation headers.
 #include "foundation/utility/string.h"
@@ -80,12 +81,32 @@ namespace
             return default_mode;
         }
     }
+
+    SPPMParameters::PhotonMapType get_photon_map_type(const ParamArray& params)
+    {
+        const string value = params.get_optional<string>("photon_map", "kdtree");
+
+        if (value == "kdtree")
+            return SPPMParameters::KdTree;
+        else if (value == "grid")
+            return SPPMParameters::HashedGrid;
+        else
+        {
+            RENDERER_LOG_ERROR(
+                "invalid value \"%s\" for parameter \"%s\", using default value \"%s\"",
+                value.c_str(),
+                "photon_map",
+                "kdtree");
+            return SPPMParameters::KdTree;
+        }
+    }
 }
 
 SPPMParameters::SPPMParameters(const ParamArray& params)
   : m_dl_mode(get_mode(params, "dl_mode", SPPM))
   , m_enable_ibl(params.get_optional<bool>("enable_ibl", true))
   , m_enable_caustics(params.get_optional<bool>("enable_caustics", true))
+  , m_sampling_mode(get_sampling_context_mode(params))
   , m_light_photon_count(params.get_optional<size_t>("light_photons_per_pass", 100000))
   , m_env_photon_count(params.get_optional<size_t>("env_photons_per_pass", 100000))
   , m_photon_packet_size(params.get_optional<size_t>("photon_packet_size", 100000))
@@ -94,9 +115,12 @@ SPPMParameters::SPPMParameters(const ParamArray& params)
   , m_path_tracing_max_path_length(nz(params.get_optional<size_t>("path_tracing_max_path_length", 0)))
   , m_path_tracing_rr_min_path_length(nz(params.get_optional<size_t>("path_tracing_rr_min_path_length", 3)))
   , m_max_iterations(params.get_optional<size_t>("max_iterations", 1000))
+  , m_pass_count(params.get_optional<size_t>("passes", 1))
   , m_initial_radius_percents(params.get_required<float>("initial_radius", 0.1f))
   , m_alpha(params.get_optional<float>("alpha", 0.7f))
+  , m_per_pixel_radius(params.get_optional<bool>("per_pixel_radius", true))
   , m_max_photons_per_estimate(params.get_optional<size_t>("max_photons_per_estimate", 100))
+  , m_photon_map_type(get_photon_map_type(params))
   , m_dl_light_sample_count(params.get_optional<double>("dl_light_samples", 1.0))
   , m_view_photons(params.get_optional<bool>("view_photons", false))
   , m_view_photons_radius(params.get_optional<float>("view_photons_radius", 1.0e-3f))
@@ -134,13 +158,17 @@ void SPPMParameters::print() const
         "  rr min path len. %s\n"
         "  initial radius   %s%%\n"
         "  alpha            %s\n"
+        "  per-pixel radius %s\n"
         "  max photons/est. %s\n"
+        "  photon map       %s\n"
         "  dl light samples %s",
         m_path_tracing_max_path_length == ~0 ? "infinite" : pretty_uint(m_path_tracing_max_path_length).c_str(),
         m_path_tracing_rr_min_path_length == ~0 ? "infinite" : pretty_uint(m_path_tracing_rr_min_path_length).c_str(),
         pretty_scalar(m_initial_radius_percents, 3).c_str(),
         pretty_scalar(m_alpha, 1).c_str(),
+        m_per_pixel_radius ? "on" : "off",
         pretty_uint(m_max_photons_per_estimate).c_str(),
+        m_photon_map_type == KdTree ? "k-d tree" : "hashed grid",
         pretty_scalar(m_dl_light_sample_count).c_str());
 }
 
@@ -30,6 +30,9 @@
 #ifndef APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPARAMETERS_H
 #define APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPARAMETERS_H
 
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+
 // Standard headers.
 #include <cstddef>
 
@@ -42,11 +45,14 @@ namespace renderer
 struct SPPMParameters
 {
     enum Mode { SPPM, RayTraced, Off };
+    enum PhotonMapType { KdTree, HashedGrid };
 
     const Mode      m_dl_mode;                              // direct lighting mode
     const bool      m_enable_ibl;                           // is image-based lighting enabled?
     const bool      m_enable_caustics;                      // are caustics enabled?
 
+    const SamplingContext::Mode m_sampling_mode;            // random or quasi Monte Carlo sampling
+
     const size_t    m_light_photon_count;                   // number of photons emitted from the lights
     const size_t    m_env_photon_count;                     // number of photons emitted from the environment
     const size_t    m_photon_packet_size;                   // number of photons per tracing job
@@ -58,10 +64,13 @@ struct SPPMParameters
     const size_t    m_path_tracing_rr_min_path_length;      // minimum path tracing path length before Russian Roulette kicks in, ~0 for unlimited
 
     const size_t    m_max_iterations;                       // maximum number of iteration during path tracing
+    const size_t    m_pass_count;                           // number of rendering passes
 
     const float     m_initial_radius_percents;              // initial lookup radius as a percentage of the scene diameter
     const float     m_alpha;                                // radius shrinking control
+    const bool      m_per_pixel_radius;                     // shrink the lookup radius of each pixel independently?
     const size_t    m_max_photons_per_estimate;             // maximum number of photons per density estimation
+    const PhotonMapType m_photon_map_type;                  // acceleration structure used for photon lookups
     const double    m_dl_light_sample_count;                // number of light samples used to estimate direct illumination in ray traced mode
     float           m_rcp_dl_light_sample_count;
 
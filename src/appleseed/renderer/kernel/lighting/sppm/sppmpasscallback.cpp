@@ -32,10 +32,16 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/kernel/rendering/checkpoint.h"
+#include "renderer/modeling/frame/frame.h"
 #include "renderer/modeling/scene/scene.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/exceptions/exceptionioerror.h"
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
 #include "foundation/math/hash.h"
+#include "foundation/utility/eventtracer.h"
 #include "foundation/utility/job.h"
 #include "foundation/utility/string.h"
 
@@ -63,7 +69,8 @@ SPPMPassCallback::SPPMPassCallback(
     OSL::ShadingSystem&     shading_system,
 #endif
     const SPPMParameters&   params)
-  : m_params(params)
+  : m_scene(scene)
+  , m_params(params)
   , m_photon_tracer(
         scene,
         light_sampler,
@@ -74,12 +81,11 @@ SPPMPassCallback::SPPMPassCallback(
 #endif
         params)
   , m_pass_number(0)
+  , m_photons_scheduled(false)
   , m_emitted_photon_count(0)
+  , m_memory_account(MemoryCategoryPhotonMaps)
 {
-    // Compute the initial lookup radius.
-    const float scene_diameter = static_cast<float>(2.0 * scene.compute_radius());
-    const float diameter_factor = m_params.m_initial_radius_percents / 100.0f;
-    m_initial_lookup_radius = m_lookup_radius = scene_diameter * diameter_factor;
+    compute_initial_lookup_radius();
 }
 
 void SPPMPassCallback::release()
@@ -92,28 +98,104 @@ void SPPMPassCallback::pre_render(
     JobQueue&               job_queue,
     AbortSwitch&            abort_switch)
 {
-    RENDERER_LOG_INFO(
-        "sppm lookup radius is %f (%s of initial radius).",
-        m_lookup_radius,
-        pretty_percent(m_lookup_radius, m_initial_lookup_radius, 3).c_str());
+    const ScopedEvent event("sppm pass setup", "sppm");
+
+    if (m_params.m_per_pixel_radius)
+    {
+        // Allocate per-pixel statistics on the first pass or if the resolution changed.
+        const CanvasProperties& props = frame.image().properties();
+        if (m_pixel_stats.get_width() != props.m_canvas_width ||
+            m_pixel_stats.get_height() != props.m_canvas_height)
+        {
+            m_pixel_stats.reset(
+                props.m_canvas_width,
+                props.m_canvas_height,
+                m_initial_lookup_radius);
+        }
+
+        RENDERER_LOG_INFO(
+            "sppm maximum lookup radius is %f (%s of initial radius).",
+            m_pixel_stats.get_max_radius(),
+            pretty_percent(m_pixel_stats.get_max_radius(), m_initial_lookup_radius, 3).c_str());
+    }
+    else
+    {
+        RENDERER_LOG_INFO(
+            "sppm lookup radius is %f (%s of initial radius).",
+            m_lookup_radius,
+            pretty_percent(m_lookup_radius, m_initial_lookup_radius, 3).c_str());
+    }
 
     m_stopwatch.start();
 
-    // Create a new set of photons.
-    m_photons.clear_keep_memory();
-    m_emitted_photon_count =
-        m_photon_tracer.trace_photons(
-            m_photons,
+    // Trace the photons of this pass, unless they were traced while the previous pass was rendered.
+    if (!m_photons_scheduled)
+    {
+        const ScopedEvent event("trace photons", "sppm");
+
+        m_photon_tracer.schedule_photon_tracing(
             hash_uint32(m_pass_number),
             job_queue,
             abort_switch);
+        job_queue.wait_until_completion();
+    }
 
     // Stop there if rendering was aborted.
     if (abort_switch.is_aborted())
         return;
 
-    // Build a new photon map.
-    m_photon_map.reset(new SPPMPhotonMap(m_photons));
+    // Gather the photons of this pass.
+    {
+        const ScopedEvent event("collect photons", "sppm");
+        m_emitted_photon_count = m_photon_tracer.collect_photons(m_photons, job_queue);
+    }
+
+    // Build a new photon map suited to the lookup radii of this pass. With per-pixel radii,
+    // size it for most pixels rather than for the largest radius: pixels that rarely find
+    // photons keep large radii that would otherwise make every lookup visit oversized cells.
+    {
+        const ScopedEvent event("build photon map", "sppm");
+        m_photon_map.reset(
+            new SPPMPhotonMap(
+                m_photons,
+                m_params.m_photon_map_type,
+                m_pixel_stats.empty() ? m_lookup_radius : m_pixel_stats.compute_radius_percentile(0.9f),
+                job_queue));
+    }
+
+    // Account for the memory used by the photons, the photon map and the pixel statistics.
+    const size_t photon_memory_size = m_photons.get_memory_size();
+    const size_t photon_map_memory_size = m_photon_map->get_memory_size();
+    const size_t pixel_stats_memory_size = m_pixel_stats.get_memory_size();
+    m_memory_account.set_size(photon_memory_size + photon_map_memory_size + pixel_stats_memory_size);
+
+    RENDERER_LOG_DEBUG(
+        "sppm photon attributes use %s (%s per photon), sppm photon map uses %s, "
+        "sppm pixel statistics use %s.",
+        pretty_size(photon_memory_size).c_str(),
+        pretty_size(SPPMPhotonVector::get_photon_data_size()).c_str(),
+        pretty_size(photon_map_memory_size).c_str(),
+        pretty_size(pixel_stats_memory_size).c_str());
+}
+
+void SPPMPassCallback::schedule_background_jobs(
+    const Frame&            frame,
+    JobQueue&               job_queue,
+    AbortSwitch&            abort_switch)
+{
+    // The photon tracing jobs only start once worker threads run out of tile jobs;
+    // the frame renderer waits for them at the end of the pass.
+    m_photons_scheduled =
+        m_pass_number + 1 < m_params.m_pass_count &&
+        !abort_switch.is_aborted();
+
+    if (m_photons_scheduled)
+    {
+        m_photon_tracer.schedule_photon_tracing(
+            hash_uint32(m_pass_number + 1),
+            job_queue,
+            abort_switch);
+    }
 }
 
 void SPPMPassCallback::post_render(
@@ -121,7 +203,22 @@ void SPPMPassCallback::post_render(
     JobQueue&               job_queue,
     AbortSwitch&            abort_switch)
 {
-    // Shrink the lookup radius for the next pass.
+    const ScopedEvent event("sppm pass cleanup", "sppm");
+
+    // Photons of the next pass may be incomplete if rendering was aborted.
+    // The pixel statistics of an incomplete pass are discarded as well.
+    if (abort_switch.is_aborted())
+    {
+        m_photons_scheduled = false;
+        m_pixel_stats.clear_lookups();
+    }
+    else
+    {
+        // Shrink the lookup radius of each pixel for the next pass.
+        m_pixel_stats.update(m_params.m_alpha);
+    }
+
+    // Shrink the global lookup radius for the next pass.
     const float k = (m_pass_number + m_params.m_alpha) / (m_pass_number + 1);
     assert(k <= 1.0);
     m_lookup_radius *= sqrt(k);
@@ -136,4 +233,55 @@ void SPPMPassCallback::post_render(
     ++m_pass_number;
 }
 
+void SPPMPassCallback::write_checkpoint(CheckpointWriter& writer) const
+{
+    writer.write(m_pass_number);
+    writer.write(m_lookup_radius);
+    m_pixel_stats.write_checkpoint(writer);
+}
+
+void SPPMPassCallback::read_checkpoint(CheckpointReader& reader)
+{
+    uint32 pass_number;
+    float lookup_radius;
+    reader.read(pass_number);
+    reader.read(lookup_radius);
+
+    try
+    {
+        m_pixel_stats.read_checkpoint(reader);
+    }
+    catch (const ExceptionIOError&)
+    {
+        // Per-pixel statistics will be reallocated by the first pass.
+        m_pixel_stats.reset(0, 0, m_initial_lookup_radius);
+        throw;
+    }
+
+    m_pass_number = pass_number;
+    m_lookup_radius = lookup_radius;
+
+    // The photons of the next pass are traced again, from the same seed.
+    m_photons_scheduled = false;
+}
+
+void SPPMPassCallback::reset()
+{
+    // The scene may have changed since the previous frame.
+    compute_initial_lookup_radius();
+
+    // Per-pixel statistics will be reallocated by the first pass.
+    m_pixel_stats.reset(0, 0, m_initial_lookup_radius);
+
+    m_pass_number = 0;
+    m_photons_scheduled = false;
+}
+
+void SPPMPassCallback::compute_initial_lookup_radius()
+{
+    const float scene_diameter = static_cast<float>(2.0 * m_scene.compute_radius());
+    const float diameter_factor = m_params.m_initial_radius_percents / 100.0f;
+    m_initial_lookup_radius = m_lookup_radius = scene_diameter * diameter_factor;
+}
+
 }   // namespace renderer
@@ -31,10 +31,12 @@
 #define APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPASSCALLBACK_H
 
 // appleseed.renderer headers.
+#include "renderer/global/globalmemory.h"
 #include "renderer/kernel/lighting/sppm/sppmparameters.h"
 #include "renderer/kernel/lighting/sppm/sppmphoton.h"
 #include "renderer/kernel/lighting/sppm/sppmphotonmap.h"
 #include "renderer/kernel/lighting/sppm/sppmphotontracer.h"
+#include "renderer/kernel/lighting/sppm/sppmpixelstatistics.h"
 #include "renderer/kernel/rendering/ipasscallback.h"
 
 // appleseed.foundation headers.
@@ -49,16 +51,18 @@
 #endif
 
 // Standard headers.
+#include <algorithm>
 #include <cstddef>
 #include <memory>
 
 // Forward declarations.
 namespace foundation    { class AbortSwitch; }
 namespace foundation    { class JobQueue; }
+namespace renderer      { class CheckpointReader; }
+namespace renderer      { class CheckpointWriter; }
 namespace renderer      { class Frame; }
 namespace renderer      { class LightSampler; }
 namespace renderer      { class Scene; }
-namespace renderer      { class SPPMPhotonData; }
 namespace renderer      { class TextureStore; }
 namespace renderer      { class TraceContext; }
 
@@ -93,17 +97,32 @@ class SPPMPassCallback
         foundation::JobQueue&       job_queue,
         foundation::AbortSwitch&    abort_switch) OVERRIDE;
 
+    // Trace the photons of the next pass while this pass is being rendered.
+    virtual void schedule_background_jobs(
+        const Frame&                frame,
+        foundation::JobQueue&       job_queue,
+        foundation::AbortSwitch&    abort_switch) OVERRIDE;
+
     // This method is called at the end of a pass.
     virtual void post_render(
         const Frame&                frame,
         foundation::JobQueue&       job_queue,
         foundation::AbortSwitch&    abort_switch) OVERRIDE;
 
+    // Write the pass number and the lookup radii to a checkpoint.
+    virtual void write_checkpoint(CheckpointWriter& writer) const OVERRIDE;
+
+    // Restore the pass number and the lookup radii from a checkpoint.
+    virtual void read_checkpoint(CheckpointReader& reader) OVERRIDE;
+
+    // Restart from the first pass with the initial lookup radius of the current scene.
+    virtual void reset() OVERRIDE;
+
     // Return the number of photons emitted for this pass.
     size_t get_emitted_photon_count() const;
 
-    // Return the i'th photon.
-    const SPPMPhotonData& get_photon_data(const size_t i) const;
+    // Return the photons of the current pass.
+    const SPPMPhotonVector& get_photons() const;
 
     // Return the current photon map.
     const SPPMPhotonMap& get_photon_map() const;
@@ -111,17 +130,32 @@ class SPPMPassCallback
     // Return the current lookup radius.
     float get_lookup_radius() const;
 
+    // Return the current lookup radius at a given pixel.
+    float get_lookup_radius(const int x, const int y) const;
+
+    // Record the number of photons found by a lookup at a given pixel. Thread-safe.
+    void record_lookup(
+        const int                   x,
+        const int                   y,
+        const size_t                photon_count) const;
+
   private:
+    const Scene&                    m_scene;
     const SPPMParameters            m_params;
     SPPMPhotonTracer                m_photon_tracer;
     foundation::uint32              m_pass_number;
+    bool                            m_photons_scheduled;    // were the photons of this pass traced during the previous pass?
     size_t                          m_emitted_photon_count;
     SPPMPhotonVector                m_photons;
     std::auto_ptr<SPPMPhotonMap>    m_photon_map;
+    MemoryAccount                   m_memory_account;
     float                           m_initial_lookup_radius;
     float                           m_lookup_radius;
+    SPPMPixelStatistics             m_pixel_stats;
     foundation::Stopwatch<foundation::DefaultWallclockTimer>
                                     m_stopwatch;
+
+    void compute_initial_lookup_radius();
 };
 
 
@@ -134,9 +168,9 @@ inline size_t SPPMPassCallback::get_emitted_photon_count() const
     return m_emitted_photon_count;
 }
 
-inline const SPPMPhotonData& SPPMPassCallback::get_photon_data(const size_t i) const
+inline const SPPMPhotonVector& SPPMPassCallback::get_photons() const
 {
-    return m_photons.m_data[i];
+    return m_photons;
 }
 
 inline const SPPMPhotonMap& SPPMPassCallback::get_photon_map() const
@@ -149,6 +183,29 @@ inline float SPPMPassCallback::get_lookup_radius() const
     return m_lookup_radius;
 }
 
+inline float SPPMPassCallback::get_lookup_radius(const int x, const int y) const
+{
+    if (m_pixel_stats.empty())
+        return m_lookup_radius;
+
+    // Pixels of the filter margin may lie outside the frame: use the radius of the closest pixel.
+    const int max_x = static_cast<int>(m_pixel_stats.get_width()) - 1;
+    const int max_y = static_cast<int>(m_pixel_stats.get_height()) - 1;
+    return
+        m_pixel_stats.get_radius(
+            std::min(std::max(x, 0), max_x),
+            std::min(std::max(y, 0), max_y));
+}
+
+inline void SPPMPassCallback::record_lookup(
+    const int                       x,
+    const int                       y,
+    const size_t                    photon_count) const
+{
+    if (m_pixel_stats.contains(x, y))
+        m_pixel_stats.record_lookup(x, y, photon_count);
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPASSCALLBACK_H
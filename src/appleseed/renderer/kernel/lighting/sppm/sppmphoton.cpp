@@ -31,8 +31,15 @@
 #include "sppmphoton.h"
 
 // appleseed.foundation headers.
+#include "foundation/math/hash.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/casts.h"
 #include "foundation/utility/memory.h"
 
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+
 using namespace foundation;
 
 namespace renderer
@@ -44,53 +51,90 @@ namespace renderer
 
 bool SPPMPhotonVector::empty() const
 {
-    assert(m_positions.empty() == m_data.empty());
+    assert(m_positions.empty() == m_fluxes.empty());
     return m_positions.empty();
 }
 
 size_t SPPMPhotonVector::size() const
 {
-    assert(m_positions.size() == m_data.size());
-    return m_positions.size();
+    assert(m_incoming.size() == m_fluxes.size());
+    assert(m_geometric_normals.size() == m_fluxes.size());
+    return m_fluxes.size();
 }
 
 size_t SPPMPhotonVector::get_memory_size() const
 {
     return
         m_positions.capacity() * sizeof(Vector3f) +
-        m_data.capacity() * sizeof(SPPMPhotonData);
+        m_incoming.capacity() * sizeof(uint32) +
+        m_geometric_normals.capacity() * sizeof(uint32) +
+        m_fluxes.capacity() * sizeof(SPPMPackedFlux);
+}
+
+size_t SPPMPhotonVector::get_photon_data_size()
+{
+    return 2 * sizeof(uint32) + sizeof(SPPMPackedFlux);
 }
 
 void SPPMPhotonVector::swap(SPPMPhotonVector& rhs)
 {
     m_positions.swap(rhs.m_positions);
-    m_data.swap(rhs.m_data);
+    m_incoming.swap(rhs.m_incoming);
+    m_geometric_normals.swap(rhs.m_geometric_normals);
+    m_fluxes.swap(rhs.m_fluxes);
 }
 
 void SPPMPhotonVector::clear_keep_memory()
 {
     foundation::clear_keep_memory(m_positions);
-    foundation::clear_keep_memory(m_data);
+    foundation::clear_keep_memory(m_incoming);
+    foundation::clear_keep_memory(m_geometric_normals);
+    foundation::clear_keep_memory(m_fluxes);
 }
 
 void SPPMPhotonVector::reserve(const size_t capacity)
 {
     m_positions.reserve(capacity);
-    m_data.reserve(capacity);
+    m_incoming.reserve(capacity);
+    m_geometric_normals.reserve(capacity);
+    m_fluxes.reserve(capacity);
+}
+
+void SPPMPhotonVector::resize(const size_t size)
+{
+    m_positions.resize(size);
+    m_incoming.resize(size);
+    m_geometric_normals.resize(size);
+    m_fluxes.resize(size);
 }
 
 void SPPMPhotonVector::push_back(const SPPMPhoton& photon)
 {
     m_positions.push_back(photon.m_position);
-    m_data.push_back(photon.m_data);
+    m_incoming.push_back(pack_unit_vector(photon.m_data.m_incoming));
+    m_geometric_normals.push_back(pack_unit_vector(photon.m_data.m_geometric_normal));
+
+    // Derive the rounding dither of the flux from the photon position.
+    const uint32 h =
+        mix_uint32(
+            binary_cast<uint32>(photon.m_position.x),
+            binary_cast<uint32>(photon.m_position.y),
+            binary_cast<uint32>(photon.m_position.z));
+    const float dither = static_cast<float>(h >> 8) * (1.0f / (1 << 24));
+
+    SPPMPackedFlux flux;
+    flux.pack(photon.m_data.m_flux, dither);
+    m_fluxes.push_back(flux);
 }
 
-void SPPMPhotonVector::append(const SPPMPhotonVector& rhs)
+void SPPMPhotonVector::copy_from(const SPPMPhotonVector& rhs, const size_t index)
 {
-    boost::mutex::scoped_lock lock(m_mutex);
+    assert(index + rhs.size() <= size());
 
-    m_positions.insert(m_positions.end(), rhs.m_positions.begin(), rhs.m_positions.end());
-    m_data.insert(m_data.end(), rhs.m_data.begin(), rhs.m_data.end());
+    std::copy(rhs.m_positions.begin(), rhs.m_positions.end(), m_positions.begin() + index);
+    std::copy(rhs.m_incoming.begin(), rhs.m_incoming.end(), m_incoming.begin() + index);
+    std::copy(rhs.m_geometric_normals.begin(), rhs.m_geometric_normals.end(), m_geometric_normals.begin() + index);
+    std::copy(rhs.m_fluxes.begin(), rhs.m_fluxes.end(), m_fluxes.begin() + index);
 }
 
 }   // namespace renderer
@@ -34,12 +34,14 @@
 #include "renderer/global/globaltypes.h"
 
 // appleseed.foundation headers.
+#include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
-
-// boost headers.
-#include "foundation/platform/thread.h"
+#include "foundation/platform/types.h"
 
 // Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <vector>
 
@@ -47,7 +49,7 @@ namespace renderer
 {
 
 //
-// A photon in the SPPM photon map.
+// A photon in the SPPM photon map, as produced by the photon tracer.
 //
 
 class SPPMPhotonData
@@ -66,16 +68,61 @@ class SPPMPhoton
 };
 
 
+//
+// Compact encodings of photon attributes.
+//
+// Unit vectors are mapped to the octahedron and stored with 16 bits per coordinate.
+// Spectral fluxes are stored with 8 bits per wavelength, relative to their largest
+// component. Reference:
+//
+//   A Survey of Efficient Representations for Independent Unit Vectors
+//   http://jcgt.org/published/0003/02/01/paper.pdf
+//
+
+// Encode a unit vector into 32 bits.
+foundation::uint32 pack_unit_vector(const foundation::Vector3f& v);
+
+// Decode a unit vector encoded with pack_unit_vector().
+foundation::Vector3f unpack_unit_vector(const foundation::uint32 code);
+
+//
+// A flux stored as 8-bit fractions of its largest component.
+//
+// Components are rounded up or down at random, with probabilities such that the
+// decoded flux is unbiased: components much smaller than the largest one are not
+// systematically lost but stored as zero or as the smallest nonzero fraction.
+//
+
+class SPPMPackedFlux
+{
+  public:
+    // Encode a nonnegative flux. @dither must be uniformly distributed in [0,1)
+    // over the photons for the rounding to be unbiased.
+    void pack(const Spectrum& flux, const float dither);
+
+    // Decode the flux.
+    void unpack(Spectrum& flux) const;
+
+  private:
+    float                   m_scale;
+    foundation::uint8       m_values[Spectrum::Samples];
+};
+
+
 //
 // A vector of photons.
 //
+// Photons are stored in compact form, with one array per attribute so that
+// the direction tests done during density estimation only touch direction data.
+//
 
 class SPPMPhotonVector
 {
   public:
     std::vector<foundation::Vector3f>   m_positions;
-    std::vector<SPPMPhotonData>         m_data;
-    boost::mutex                        m_mutex;
+    std::vector<foundation::uint32>     m_incoming;             // packed incoming directions
+    std::vector<foundation::uint32>     m_geometric_normals;    // packed geometric normals
+    std::vector<SPPMPackedFlux>         m_fluxes;
 
     bool empty() const;
     size_t size() const;
@@ -83,15 +130,132 @@ class SPPMPhotonVector
     // Return the size (in bytes) of this object in memory.
     size_t get_memory_size() const;
 
+    // Return the size (in bytes) of the attributes of one photon, excluding its position.
+    static size_t get_photon_data_size();
+
     void swap(SPPMPhotonVector& rhs);
     void clear_keep_memory();
     void reserve(const size_t capacity);
+    void resize(const size_t size);
     void push_back(const SPPMPhoton& photon);
 
-    // Thread-safe.
-    void append(const SPPMPhotonVector& rhs);
+    // Copy all the photons of another vector into this one, starting at a given index.
+    // Concurrent calls are safe as long as they write to disjoint ranges of photons.
+    void copy_from(const SPPMPhotonVector& rhs, const size_t index);
+
+    // Decode the attributes of the i'th photon.
+    foundation::Vector3f get_incoming(const size_t i) const;
+    foundation::Vector3f get_geometric_normal(const size_t i) const;
+    void get_flux(const size_t i, Spectrum& flux) const;
 };
 
+
+//
+// Compact encodings implementation.
+//
+
+inline foundation::uint32 pack_unit_vector(const foundation::Vector3f& v)
+{
+    const float rcp_norm = 1.0f / (std::abs(v.x) + std::abs(v.y) + std::abs(v.z));
+
+    float x = v.x * rcp_norm;
+    float y = v.y * rcp_norm;
+
+    // Fold the lower hemisphere over the upper one.
+    if (v.z < 0.0f)
+    {
+        const float fx = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        const float fy = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx;
+        y = fy;
+    }
+
+    const foundation::uint32 ix =
+        foundation::truncate<foundation::uint32>(foundation::saturate(x * 0.5f + 0.5f) * 65534.0f + 0.5f);
+    const foundation::uint32 iy =
+        foundation::truncate<foundation::uint32>(foundation::saturate(y * 0.5f + 0.5f) * 65534.0f + 0.5f);
+
+    return ix | (iy << 16);
+}
+
+inline foundation::Vector3f unpack_unit_vector(const foundation::uint32 code)
+{
+    const float x = static_cast<float>(code & 0xFFFFUL) * (2.0f / 65534.0f) - 1.0f;
+    const float y = static_cast<float>(code >> 16) * (2.0f / 65534.0f) - 1.0f;
+    const float z = 1.0f - std::abs(x) - std::abs(y);
+
+    foundation::Vector3f v(x, y, z);
+
+    // Unfold the lower hemisphere.
+    if (z < 0.0f)
+    {
+        v.x = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        v.y = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+    }
+
+    return foundation::normalize(v);
+}
+
+inline void SPPMPackedFlux::pack(const Spectrum& flux, const float dither)
+{
+    assert(dither >= 0.0f && dither < 1.0f);
+
+    float max_value = 0.0f;
+
+    for (size_t i = 0; i < Spectrum::Samples; ++i)
+        max_value = std::max(max_value, flux[i]);
+
+    if (max_value == 0.0f)
+    {
+        m_scale = 0.0f;
+        std::fill(m_values, m_values + Spectrum::Samples, 0);
+        return;
+    }
+
+    m_scale = max_value / 255.0f;
+
+    const float rcp_scale = 255.0f / max_value;
+
+    for (size_t i = 0; i < Spectrum::Samples; ++i)
+    {
+        assert(flux[i] >= 0.0f);
+        m_values[i] =
+            static_cast<foundation::uint8>(
+                std::min(
+                    foundation::truncate<int>(std::max(flux[i], 0.0f) * rcp_scale + dither),
+                    255));
+    }
+}
+
+inline void SPPMPackedFlux::unpack(Spectrum& flux) const
+{
+    for (size_t i = 0; i < Spectrum::Samples; ++i)
+        flux[i] = static_cast<float>(m_values[i]) * m_scale;
+
+    for (size_t i = Spectrum::Samples; i < Spectrum::StoredSamples; ++i)
+        flux[i] = 0.0f;
+}
+
+
+//
+// SPPMPhotonVector class implementation.
+//
+
+inline foundation::Vector3f SPPMPhotonVector::get_incoming(const size_t i) const
+{
+    return unpack_unit_vector(m_incoming[i]);
+}
+
+inline foundation::Vector3f SPPMPhotonVector::get_geometric_normal(const size_t i) const
+{
+    return unpack_unit_vector(m_geometric_normals[i]);
+}
+
+inline void SPPMPhotonVector::get_flux(const size_t i, Spectrum& flux) const
+{
+    m_fluxes[i].unpack(flux);
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPHOTON_H
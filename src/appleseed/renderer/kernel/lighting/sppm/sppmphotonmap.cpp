@@ -36,6 +36,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/platform/defaulttimers.h"
+#include "foundation/utility/job.h"
 #include "foundation/utility/statistics.h"
 #include "foundation/utility/string.h"
 
@@ -47,23 +48,44 @@ using namespace foundation;
 namespace renderer
 {
 
-SPPMPhotonMap::SPPMPhotonMap(SPPMPhotonVector& photons)
+SPPMPhotonMap::SPPMPhotonMap(
+    SPPMPhotonVector&               photons,
+    const SPPMParameters::PhotonMapType type,
+    const float                     lookup_radius,
+    JobQueue&                       job_queue)
+  : m_type(type)
 {
     const size_t photon_count = photons.size();
 
     if (photon_count > 0)
     {
         RENDERER_LOG_INFO(
-            "building sppm photon map from %s %s...",
+            "building sppm photon %s from %s %s...",
+            m_type == SPPMParameters::KdTree ? "map" : "grid",
             pretty_uint(photon_count).c_str(),
             photon_count > 1 ? "photons" : "photon");
 
-        knn::Builder3f builder(*this);
-        builder.build_move_points<DefaultWallclockTimer>(photons.m_positions);
-
         Statistics statistics;
-        statistics.insert_time("build time", builder.get_build_time());
-        statistics.merge(knn::TreeStatistics<knn::Tree3f>(*this));
+
+        if (m_type == SPPMParameters::KdTree)
+        {
+            knn::Builder3f builder(m_tree);
+            builder.build_move_points<DefaultWallclockTimer>(photons.m_positions, job_queue);
+
+            statistics.insert_time("build time", builder.get_build_time());
+            statistics.merge(knn::TreeStatistics<knn::Tree3f>(m_tree));
+        }
+        else
+        {
+            // With cells twice as large as the lookup radius, lookups within that radius
+            // visit at most 8 cells; lookups with larger radii visit more cells.
+            knn::GridBuilder3f builder(m_grid);
+            builder.build_move_points<DefaultWallclockTimer>(photons.m_positions, 2.0f * lookup_radius);
+
+            statistics.insert_time("build time", builder.get_build_time());
+            statistics.insert<double>("cell size", m_grid.get_cell_size());
+            statistics.insert("buckets", m_grid.get_bucket_count());
+        }
 
         RENDERER_LOG_DEBUG("%s",
             StatisticsVector::make(
@@ -79,7 +101,7 @@ SPPMPhotonMap::SPPMPhotonMap(SPPMPhotonVector& photons)
 
 size_t SPPMPhotonMap::get_memory_size() const
 {
-    return knn::Tree3f::get_memory_size();
+    return m_tree.get_memory_size() + m_grid.get_memory_size();
 }
 
 }   // namespace renderer
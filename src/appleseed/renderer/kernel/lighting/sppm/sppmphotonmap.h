@@ -30,29 +30,101 @@
 #ifndef APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPHOTONMAP_H
 #define APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPHOTONMAP_H
 
+// appleseed.renderer headers.
+#include "renderer/kernel/lighting/sppm/sppmparameters.h"
+
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/math/knn.h"
+#include "foundation/math/vector.h"
 
 // Standard headers.
 #include <cstddef>
 
 // Forward declarations.
-namespace renderer  { class SPPMPhotonVector; }
+namespace foundation    { class JobQueue; }
+namespace renderer      { class SPPMPhotonVector; }
 
 namespace renderer
 {
 
+//
+// The SPPM photon map is either a k-d tree or a hashed grid whose cell size
+// is derived from a typical lookup radius of the current pass.
+//
+
 class SPPMPhotonMap
-  : public foundation::knn::Tree3f
+  : public foundation::NonCopyable
 {
   public:
     // Constructor, *moves* the photon positions into the map.
-    explicit SPPMPhotonMap(SPPMPhotonVector& photons);
+    SPPMPhotonMap(
+        SPPMPhotonVector&               photons,
+        const SPPMParameters::PhotonMapType type,
+        const float                     lookup_radius,
+        foundation::JobQueue&           job_queue);
+
+    // Return true if the map does not contain any photon.
+    bool empty() const;
+
+    // Find the nearest photons to a given point within a given distance.
+    void find_nearest_photons(
+        const foundation::Vector3f&     point,
+        const float                     max_square_distance,
+        foundation::knn::Answer<float>& answer) const;
+
+    // Transform an internal index (as found in answers) to a photon index.
+    size_t remap(const size_t i) const;
+
+    // Return the position of a photon given its internal index.
+    const foundation::Vector3f& get_point(const size_t i) const;
 
     // Return the size (in bytes) of this object in memory.
     size_t get_memory_size() const;
+
+  private:
+    const SPPMParameters::PhotonMapType     m_type;
+    foundation::knn::Tree3f             m_tree;
+    foundation::knn::Grid3f             m_grid;
 };
 
+
+//
+// SPPMPhotonMap class implementation.
+//
+
+inline bool SPPMPhotonMap::empty() const
+{
+    return m_type == SPPMParameters::KdTree ? m_tree.empty() : m_grid.empty();
+}
+
+inline void SPPMPhotonMap::find_nearest_photons(
+    const foundation::Vector3f&         point,
+    const float                         max_square_distance,
+    foundation::knn::Answer<float>&     answer) const
+{
+    if (m_type == SPPMParameters::KdTree)
+    {
+        const foundation::knn::Query3f query(m_tree, answer);
+        query.run(point, max_square_distance);
+    }
+    else
+    {
+        const foundation::knn::GridQuery3f query(m_grid, answer);
+        query.run(point, max_square_distance);
+    }
+}
+
+inline size_t SPPMPhotonMap::remap(const size_t i) const
+{
+    return m_type == SPPMParameters::KdTree ? m_tree.remap(i) : m_grid.remap(i);
+}
+
+inline const foundation::Vector3f& SPPMPhotonMap::get_point(const size_t i) const
+{
+    return m_type == SPPMParameters::KdTree ? m_tree.get_point(i) : m_grid.get_point(i);
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPHOTONMAP_H
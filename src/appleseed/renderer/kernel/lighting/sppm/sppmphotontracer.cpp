@@ -65,6 +65,7 @@
 #include "foundation/platform/compiler.h"
 #include "foundation/platform/timer.h"
 #include "foundation/platform/types.h"
+#include "foundation/utility/eventtracer.h"
 #include "foundation/utility/job.h"
 #include "foundation/utility/statistics.h"
 #include "foundation/utility/stopwatch.h"
@@ -177,7 +178,7 @@ namespace
             const TraceContext&     trace_context,
             TextureStore&           texture_store,
             const SPPMParameters&   params,
-            SPPMPhotonVector&       global_photons,
+            SPPMPhotonVector&       photons,
             const size_t            photon_begin,
             const size_t            photon_end,
             const size_t            pass_hash,
@@ -190,7 +191,7 @@ namespace
           , m_texture_cache(texture_store)
           , m_intersector(trace_context, m_texture_cache /*, m_params.m_report_self_intersections*/)
           , m_params(params)
-          , m_global_photons(global_photons)
+          , m_photons(photons)
           , m_photon_begin(photon_begin)
           , m_photon_end(photon_end)
           , m_pass_hash(pass_hash)
@@ -219,18 +220,23 @@ namespace
 
         virtual void execute(const size_t thread_index) OVERRIDE
         {
-            const uint32 instance = hash_uint32(static_cast<uint32>(m_pass_hash + m_photon_begin));
-            MersenneTwister rng(instance);
+            const ScopedEvent event("trace light photons", "sppm");
+
+            // In QMC mode, the photons of a pass are successive points of a sequence scrambled per pass.
+            MersenneTwister rng(hash_uint32(static_cast<uint32>(m_pass_hash + m_photon_begin)));
             SamplingContext sampling_context(
                 rng,
+                m_params.m_sampling_mode,
                 4,                  // number of dimensions
                 0,                  // number of samples -- unknown
-                instance);          // initial instance number
+                m_photon_begin,     // initial instance number
+                hash_uint32(static_cast<uint32>(m_pass_hash)));     // scrambling seed
+
+            // Photons are stored into this job's own output slot, whose memory is kept from pass to pass.
+            m_photons.clear_keep_memory();
 
             for (size_t i = m_photon_begin; i < m_photon_end && !m_abort_switch.is_aborted(); ++i)
                 trace_light_photon(sampling_context);
-
-            m_global_photons.append(m_local_photons);
         }
 
       private:
@@ -239,12 +245,11 @@ namespace
         TextureCache                m_texture_cache;
         Intersector                 m_intersector;
         const SPPMParameters        m_params;
-        SPPMPhotonVector&           m_global_photons;
+        SPPMPhotonVector&           m_photons;
         const size_t                m_photon_begin;
         const size_t                m_photon_end;
         const size_t                m_pass_hash;
         AbortSwitch&                m_abort_switch;
-        SPPMPhotonVector            m_local_photons;
 #ifdef WITH_OSL
         OSLShaderGroupExec          m_shadergroup_exec;
 #endif
@@ -331,7 +336,7 @@ namespace
                 m_params.m_dl_mode == SPPMParameters::SPPM, // store direct lighting photons?
                 cast_indirect_light,
                 m_params.m_enable_caustics,
-                m_local_photons);
+                m_photons);
             PathTracer<PathVisitor, true> path_tracer(      // true = adjoint
                 path_visitor,
                 m_params.m_photon_tracing_rr_min_path_length,
@@ -387,7 +392,7 @@ namespace
                 m_params.m_dl_mode == SPPMParameters::SPPM, // store direct lighting photons?
                 cast_indirect_light,
                 m_params.m_enable_caustics,
-                m_local_photons);
+                m_photons);
             PathTracer<PathVisitor, true> path_tracer(      // true = adjoint
                 path_visitor,
                 m_params.m_photon_tracing_rr_min_path_length,
@@ -417,7 +422,7 @@ namespace
             const TraceContext&     trace_context,
             TextureStore&           texture_store,
             const SPPMParameters&   params,
-            SPPMPhotonVector&       global_photons,
+            SPPMPhotonVector&       photons,
             const size_t            photon_begin,
             const size_t            photon_end,
             const size_t            pass_hash,
@@ -431,7 +436,7 @@ namespace
           , m_texture_cache(texture_store)
           , m_intersector(trace_context, m_texture_cache /*, m_params.m_report_self_intersections*/)
           , m_params(params)
-          , m_global_photons(global_photons)
+          , m_photons(photons)
           , m_photon_begin(photon_begin)
           , m_photon_end(photon_end)
           , m_pass_hash(pass_hash)
@@ -462,18 +467,23 @@ namespace
 
         virtual void execute(const size_t thread_index) OVERRIDE
         {
-            const uint32 instance = hash_uint32(static_cast<uint32>(m_pass_hash + m_photon_begin));
-            MersenneTwister rng(instance);
+            const ScopedEvent event("trace environment photons", "sppm");
+
+            // In QMC mode, the photons of a pass are successive points of a sequence scrambled per pass.
+            MersenneTwister rng(hash_uint32(static_cast<uint32>(m_pass_hash + m_photon_begin)));
             SamplingContext sampling_context(
                 rng,
+                m_params.m_sampling_mode,
                 2,                  // number of dimensions
                 0,                  // number of samples -- unknown
-                instance);          // initial instance number
+                m_photon_begin,     // initial instance number
+                hash_uint32(static_cast<uint32>(m_pass_hash)));     // scrambling seed
+
+            // Photons are stored into this job's own output slot, whose memory is kept from pass to pass.
+            m_photons.clear_keep_memory();
 
             for (size_t i = m_photon_begin; i < m_photon_end && !m_abort_switch.is_aborted(); ++i)
                 trace_env_photon(sampling_context);
-
-            m_global_photons.append(m_local_photons);
         }
 
       private:
@@ -483,14 +493,13 @@ namespace
         TextureCache                m_texture_cache;
         Intersector                 m_intersector;
         const SPPMParameters        m_params;
-        SPPMPhotonVector&           m_global_photons;
+        SPPMPhotonVector&           m_photons;
         const size_t                m_photon_begin;
         const size_t                m_photon_end;
         const size_t                m_pass_hash;
         AbortSwitch&                m_abort_switch;
         const double                m_safe_scene_radius;
         const double                m_disk_point_prob;
-        SPPMPhotonVector            m_local_photons;
 #ifdef WITH_OSL
         OSLShaderGroupExec          m_shadergroup_exec;
 #endif
@@ -547,7 +556,7 @@ namespace
                 true,                                       // do store IBL photons
                 cast_indirect_light,
                 m_params.m_enable_caustics,
-                m_local_photons);
+                m_photons);
             PathTracer<PathVisitor, true> path_tracer(      // true = adjoint
                 path_visitor,
                 m_params.m_photon_tracing_rr_min_path_length,
@@ -561,6 +570,40 @@ namespace
                 ray);
         }
     };
+
+
+    //
+    // A job to move the photons of a photon tracing job to their final location.
+    //
+
+    class MovePhotonsJob
+      : public IJob
+    {
+      public:
+        MovePhotonsJob(
+            SPPMPhotonVector&       source,
+            SPPMPhotonVector&       destination,
+            const size_t            index)
+          : m_source(source)
+          , m_destination(destination)
+          , m_index(index)
+        {
+        }
+
+        virtual void execute(const size_t thread_index) OVERRIDE
+        {
+            const ScopedEvent event("move photons", "sppm");
+            m_destination.copy_from(m_source, m_index);
+
+            // Release the memory of the source right away.
+            SPPMPhotonVector().swap(m_source);
+        }
+
+      private:
+        SPPMPhotonVector&           m_source;
+        SPPMPhotonVector&           m_destination;
+        const size_t                m_index;
+    };
 }
 
 
@@ -582,6 +625,7 @@ SPPMPhotonTracer::SPPMPhotonTracer(
   , m_light_sampler(light_sampler)
   , m_trace_context(trace_context)
   , m_texture_store(texture_store)
+  , m_emitted_photon_count(0)
   , m_total_emitted_photon_count(0)
   , m_total_stored_photon_count(0)
 #ifdef WITH_OSL
@@ -590,30 +634,44 @@ SPPMPhotonTracer::SPPMPhotonTracer(
 {
 }
 
-size_t SPPMPhotonTracer::trace_photons(
-    SPPMPhotonVector&       photons,
+void SPPMPhotonTracer::schedule_photon_tracing(
     const size_t            pass_hash,
     JobQueue&               job_queue,
     AbortSwitch&            abort_switch)
 {
-    size_t job_count = 0;
-    size_t emitted_photon_count = 0;
+    const size_t packet_size = m_params.m_photon_packet_size;
+
+    const bool trace_light_photons = m_light_sampler.has_lights_or_emitting_triangles();
+    const bool trace_env_photons =
+        m_params.m_enable_ibl &&
+        m_scene.get_environment()->get_environment_edf() &&
+        !abort_switch.is_aborted();
+
+    const size_t light_job_count =
+        trace_light_photons ? (m_params.m_light_photon_count + packet_size - 1) / packet_size : 0;
+    const size_t env_job_count =
+        trace_env_photons ? (m_params.m_env_photon_count + packet_size - 1) / packet_size : 0;
+
+    // Allocate one output slot per job before any job is scheduled.
+    m_job_photons.resize(light_job_count + env_job_count);
+
+    size_t job_index = 0;
+    m_emitted_photon_count = 0;
 
     // Start stopwatch.
-    Stopwatch<DefaultWallclockTimer> stopwatch;
-    stopwatch.start();
+    m_stopwatch.start();
 
-    if (m_light_sampler.has_lights_or_emitting_triangles())
+    if (trace_light_photons)
     {
         RENDERER_LOG_INFO(
             "tracing %s sppm light %s...",
             pretty_uint(m_params.m_light_photon_count).c_str(),
             m_params.m_light_photon_count > 1 ? "photons" : "photon");
 
-        for (size_t i = 0; i < m_params.m_light_photon_count; i += m_params.m_photon_packet_size)
+        for (size_t i = 0; i < m_params.m_light_photon_count; i += packet_size)
         {
             const size_t photon_begin = i;
-            const size_t photon_end = min(i + m_params.m_photon_packet_size, m_params.m_light_photon_count);
+            const size_t photon_end = min(i + packet_size, m_params.m_light_photon_count);
 
             job_queue.schedule(
                 new LightPhotonTracingJob(
@@ -622,7 +680,7 @@ size_t SPPMPhotonTracer::trace_photons(
                     m_trace_context,
                     m_texture_store,
                     m_params,
-                    photons,
+                    m_job_photons[job_index++],
                     photon_begin,
                     photon_end,
                     pass_hash,
@@ -631,24 +689,21 @@ size_t SPPMPhotonTracer::trace_photons(
 #endif
                     abort_switch));
 
-            ++job_count;
-            emitted_photon_count += photon_end - photon_begin;
+            m_emitted_photon_count += photon_end - photon_begin;
         }
     }
 
-    if (m_params.m_enable_ibl &&
-        m_scene.get_environment()->get_environment_edf() &&
-        !abort_switch.is_aborted())
+    if (trace_env_photons)
     {
         RENDERER_LOG_INFO(
             "tracing %s sppm environment %s...",
             pretty_uint(m_params.m_env_photon_count).c_str(),
             m_params.m_env_photon_count > 1 ? "photons" : "photon");
 
-        for (size_t i = 0; i < m_params.m_env_photon_count; i += m_params.m_photon_packet_size)
+        for (size_t i = 0; i < m_params.m_env_photon_count; i += packet_size)
         {
             const size_t photon_begin = i;
-            const size_t photon_end = min(i + m_params.m_photon_packet_size, m_params.m_env_photon_count);
+            const size_t photon_end = min(i + packet_size, m_params.m_env_photon_count);
 
             job_queue.schedule(
                 new EnvironmentPhotonTracingJob(
@@ -657,7 +712,7 @@ size_t SPPMPhotonTracer::trace_photons(
                     m_trace_context,
                     m_texture_store,
                     m_params,
-                    photons,
+                    m_job_photons[job_index++],
                     photon_begin,
                     photon_end,
                     pass_hash,
@@ -666,22 +721,71 @@ size_t SPPMPhotonTracer::trace_photons(
 #endif
                     abort_switch));
 
-            ++job_count;
-            emitted_photon_count += photon_end - photon_begin;
+            m_emitted_photon_count += photon_end - photon_begin;
+        }
+    }
+
+    assert(job_index == m_job_photons.size());
+}
+
+size_t SPPMPhotonTracer::collect_photons(
+    SPPMPhotonVector&       photons,
+    JobQueue&               job_queue)
+{
+    assert(!job_queue.has_scheduled_or_running_jobs());
+
+    // This includes the time spent rendering the previous pass if photon tracing was overlapped with it.
+    const double tracing_time = m_stopwatch.measure().get_seconds();
+
+    size_t photon_count = 0;
+    size_t nonempty_job_count = 0;
+    for (size_t i = 0; i < m_job_photons.size(); ++i)
+    {
+        photon_count += m_job_photons[i].size();
+
+        if (!m_job_photons[i].empty())
+            ++nonempty_job_count;
+    }
+
+    const size_t job_count = m_job_photons.size();
+
+    if (nonempty_job_count <= 1)
+    {
+        // The photons of a single job can be swapped to their final location.
+        photons.clear_keep_memory();
+        for (size_t i = 0; i < m_job_photons.size(); ++i)
+        {
+            if (!m_job_photons[i].empty())
+                photons.swap(m_job_photons[i]);
+        }
+    }
+    else
+    {
+        // Move the photons of all jobs to their final location, in parallel.
+        photons.clear_keep_memory();
+        photons.resize(photon_count);
+        for (size_t i = 0, index = 0; i < m_job_photons.size(); ++i)
+        {
+            if (!m_job_photons[i].empty())
+            {
+                job_queue.schedule(new MovePhotonsJob(m_job_photons[i], photons, index));
+                index += m_job_photons[i].size();
+            }
         }
+        job_queue.wait_until_completion();
     }
 
-    // Wait until the photon tracing jobs have completed.
-    job_queue.wait_until_completion();
+    // The photon tracing jobs don't hold on to their photons beyond this point.
+    m_job_photons.clear();
 
     // Update photon tracing statistics.
-    m_total_emitted_photon_count += emitted_photon_count;
-    m_total_stored_photon_count += photons.size();
+    m_total_emitted_photon_count += m_emitted_photon_count;
+    m_total_stored_photon_count += photon_count;
 
     // Print photon tracing statistics.
     Statistics statistics;
     statistics.insert("tracing jobs", job_count);
-    statistics.insert_time("tracing time", stopwatch.measure().get_seconds());
+    statistics.insert_time("tracing time", tracing_time);
     statistics.insert("total emitted", m_total_emitted_photon_count);
     statistics.insert(
         "total stored",
@@ -693,7 +797,7 @@ size_t SPPMPhotonTracer::trace_photons(
             "sppm photon tracing statistics",
             statistics).to_string().c_str());
 
-    return emitted_photon_count;
+    return m_emitted_photon_count;
 }
 
 }   // namespace renderer
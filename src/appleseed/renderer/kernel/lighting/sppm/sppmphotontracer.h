@@ -32,9 +32,12 @@
 
 // appleseed.renderer headers.
 #include "renderer/kernel/lighting/sppm/sppmparameters.h"
+#include "renderer/kernel/lighting/sppm/sppmphoton.h"
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/timer.h"
+#include "foundation/utility/stopwatch.h"
 
 // OSL headers.
 #ifdef WITH_OSL
@@ -43,13 +46,13 @@
 
 // Standard headers.
 #include <cstddef>
+#include <vector>
 
 // Forward declarations.
 namespace foundation    { class AbortSwitch; }
 namespace foundation    { class JobQueue; }
 namespace renderer      { class LightSampler; }
 namespace renderer      { class Scene; }
-namespace renderer      { class SPPMPhotonVector; }
 namespace renderer      { class TextureStore; }
 namespace renderer      { class TraceContext; }
 
@@ -70,21 +73,31 @@ class SPPMPhotonTracer
 #endif
         const SPPMParameters&       params);
 
-    // Returns the total number of emitted photons.
-    size_t trace_photons(
-        SPPMPhotonVector&           photons,
+    // Schedule the jobs tracing the photons of a pass, without waiting for them to complete.
+    void schedule_photon_tracing(
         const size_t                pass_hash,
         foundation::JobQueue&       job_queue,
         foundation::AbortSwitch&    abort_switch);
 
+    // Gather the photons traced by the jobs scheduled by the last call to schedule_photon_tracing(),
+    // which must have completed, and release them from the jobs. Returns the number of photons
+    // emitted by these jobs.
+    size_t collect_photons(
+        SPPMPhotonVector&           photons,
+        foundation::JobQueue&       job_queue);
+
   private:
     const SPPMParameters            m_params;
     const Scene&                    m_scene;
     const LightSampler&             m_light_sampler;
     const TraceContext&             m_trace_context;
     TextureStore&                   m_texture_store;
+    std::vector<SPPMPhotonVector>   m_job_photons;      // one output slot per photon tracing job
+    size_t                          m_emitted_photon_count;
     size_t                          m_total_emitted_photon_count;
     size_t                          m_total_stored_photon_count;
+    foundation::Stopwatch<foundation::DefaultWallclockTimer>
+                                    m_stopwatch;
 #ifdef WITH_OSL
     OSL::ShadingSystem&             m_shading_system;
 #endif
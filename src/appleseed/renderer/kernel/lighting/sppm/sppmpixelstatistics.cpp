@@ -0,0 +1,185 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "sppmpixelstatistics.h"
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/checkpoint.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/scalar.h"
+
+// Standard headers.
+#include <algorithm>
+#include <vector>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// SPPMPixelStatistics class implementation.
+//
+
+SPPMPixelStatistics::SPPMPixelStatistics()
+  : m_width(0)
+  , m_height(0)
+  , m_max_radius(0.0f)
+{
+}
+
+void SPPMPixelStatistics::reset(
+    const size_t    width,
+    const size_t    height,
+    const float     initial_radius)
+{
+    const size_t pixel_count = width * height;
+
+    PixelStats pixel_stats;
+    pixel_stats.m_square_radius = initial_radius * initial_radius;
+    pixel_stats.m_photon_count = 0.0f;
+
+    m_width = width;
+    m_height = height;
+    m_max_radius = initial_radius;
+    m_pixels.assign(pixel_count, pixel_stats);
+
+    clear_lookups();
+}
+
+void SPPMPixelStatistics::update(const float alpha)
+{
+    const size_t pixel_count = m_pixels.size();
+
+    if (pixel_count == 0)
+        return;
+
+    float max_square_radius = 0.0f;
+
+    for (size_t i = 0; i < pixel_count; ++i)
+    {
+        PixelStats& pixel_stats = m_pixels[i];
+        const PassStats& pass_stats = m_pass[i];
+
+        if (pass_stats.m_photon_count > 0)
+        {
+            // Average number of photons found per lookup during this pass.
+            const float m =
+                static_cast<float>(pass_stats.m_photon_count) /
+                static_cast<float>(pass_stats.m_lookup_count);
+
+            const float n = pixel_stats.m_photon_count;
+            const float new_n = n + alpha * m;
+
+            pixel_stats.m_square_radius *= new_n / (n + m);
+            pixel_stats.m_photon_count = new_n;
+        }
+
+        max_square_radius = max(max_square_radius, pixel_stats.m_square_radius);
+    }
+
+    m_max_radius = sqrt(max_square_radius);
+
+    clear_lookups();
+}
+
+float SPPMPixelStatistics::compute_radius_percentile(const float fraction) const
+{
+    assert(fraction >= 0.0f && fraction <= 1.0f);
+
+    // Pixels that never found photons keep their initial radius: leave them out.
+    vector<float> square_radii;
+    square_radii.reserve(m_pixels.size());
+
+    for (size_t i = 0; i < m_pixels.size(); ++i)
+    {
+        if (m_pixels[i].m_photon_count > 0.0f)
+            square_radii.push_back(m_pixels[i].m_square_radius);
+    }
+
+    if (square_radii.empty())
+        return m_max_radius;
+
+    const size_t n =
+        min(
+            truncate<size_t>(fraction * square_radii.size()),
+            square_radii.size() - 1);
+
+    nth_element(square_radii.begin(), square_radii.begin() + n, square_radii.end());
+
+    return sqrt(square_radii[n]);
+}
+
+void SPPMPixelStatistics::clear_lookups()
+{
+    PassStats pass_stats;
+    pass_stats.m_photon_count = 0;
+    pass_stats.m_lookup_count = 0;
+
+    m_pass.assign(m_pixels.size(), pass_stats);
+}
+
+void SPPMPixelStatistics::write_checkpoint(CheckpointWriter& writer) const
+{
+    writer.write(static_cast<uint32>(m_width));
+    writer.write(static_cast<uint32>(m_height));
+    writer.write(m_max_radius);
+
+    if (!m_pixels.empty())
+        writer.write(&m_pixels[0], m_pixels.size() * sizeof(PixelStats));
+}
+
+void SPPMPixelStatistics::read_checkpoint(CheckpointReader& reader)
+{
+    uint32 width, height;
+    reader.read(width);
+    reader.read(height);
+    reader.read(m_max_radius);
+
+    m_width = width;
+    m_height = height;
+    m_pixels.resize(m_width * m_height);
+
+    if (!m_pixels.empty())
+        reader.read(&m_pixels[0], m_pixels.size() * sizeof(PixelStats));
+
+    clear_lookups();
+}
+
+size_t SPPMPixelStatistics::get_memory_size() const
+{
+    return
+          sizeof(*this)
+        + m_pixels.capacity() * sizeof(PixelStats)
+        + m_pass.capacity() * sizeof(PassStats);
+}
+
+}   // namespace renderer
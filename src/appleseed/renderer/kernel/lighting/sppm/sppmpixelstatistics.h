@@ -0,0 +1,204 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPIXELSTATISTICS_H
+#define APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPIXELSTATISTICS_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/thread.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Forward declarations.
+namespace renderer  { class CheckpointReader; }
+namespace renderer  { class CheckpointWriter; }
+
+namespace renderer
+{
+
+//
+// Per-pixel SPPM statistics: each pixel has its own lookup radius and accumulated
+// photon count, updated at the end of every pass with the progressive radius
+// reduction rule of Hachisuka and Jensen:
+//
+//   N' = N + alpha * M
+//   R'^2 = R^2 * (N + alpha * M) / (N + M)
+//
+// where M is the average number of photons found per lookup during the pass.
+//
+// Photon counts of the current pass are recorded with atomic operations since
+// pixels in tile margins may be rendered by several threads concurrently.
+//
+
+class SPPMPixelStatistics
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    SPPMPixelStatistics();
+
+    // Resize the statistics to a given resolution and reset all radii to a given value.
+    void reset(
+        const size_t    width,
+        const size_t    height,
+        const float     initial_radius);
+
+    // Return true if the statistics are empty.
+    bool empty() const;
+
+    // Return the resolution of the statistics.
+    size_t get_width() const;
+    size_t get_height() const;
+
+    // Return true if a given pixel is tracked by the statistics.
+    bool contains(const int x, const int y) const;
+
+    // Return the lookup radius of a given pixel.
+    float get_radius(const int x, const int y) const;
+
+    // Return the largest lookup radius over all pixels.
+    float get_max_radius() const;
+
+    // Return the lookup radius that a given fraction (in [0,1]) of the pixels that found
+    // photons do not exceed, or the largest lookup radius if no pixel found photons yet.
+    float compute_radius_percentile(const float fraction) const;
+
+    // Return the accumulated photon count of a given pixel.
+    float get_photon_count(const int x, const int y) const;
+
+    // Record a photon lookup at a given pixel. Thread-safe.
+    void record_lookup(
+        const int       x,
+        const int       y,
+        const size_t    photon_count) const;
+
+    // Update radii and photon counts with the lookups of the pass that just ended,
+    // then clear the lookups.
+    void update(const float alpha);
+
+    // Discard the lookups of the current pass.
+    void clear_lookups();
+
+    // Write the radii and accumulated photon counts to a checkpoint.
+    void write_checkpoint(CheckpointWriter& writer) const;
+
+    // Restore the radii and accumulated photon counts from a checkpoint and clear the lookups.
+    void read_checkpoint(CheckpointReader& reader);
+
+    // Return the size (in bytes) of the statistics.
+    size_t get_memory_size() const;
+
+  private:
+    struct PixelStats
+    {
+        float                       m_square_radius;    // square lookup radius
+        float                       m_photon_count;     // accumulated photon count
+    };
+
+    struct PassStats
+    {
+        foundation::uint32          m_photon_count;     // number of photons found during this pass
+        foundation::uint32          m_lookup_count;     // number of lookups performed during this pass
+    };
+
+    size_t                          m_width;
+    size_t                          m_height;
+    float                           m_max_radius;
+    std::vector<PixelStats>         m_pixels;
+    mutable std::vector<PassStats>  m_pass;
+
+    size_t pixel_index(const int x, const int y) const;
+};
+
+
+//
+// SPPMPixelStatistics class implementation.
+//
+
+inline bool SPPMPixelStatistics::empty() const
+{
+    return m_pixels.empty();
+}
+
+inline size_t SPPMPixelStatistics::get_width() const
+{
+    return m_width;
+}
+
+inline size_t SPPMPixelStatistics::get_height() const
+{
+    return m_height;
+}
+
+inline bool SPPMPixelStatistics::contains(const int x, const int y) const
+{
+    return
+        x >= 0 && static_cast<size_t>(x) < m_width &&
+        y >= 0 && static_cast<size_t>(y) < m_height;
+}
+
+inline size_t SPPMPixelStatistics::pixel_index(const int x, const int y) const
+{
+    assert(contains(x, y));
+    return static_cast<size_t>(y) * m_width + static_cast<size_t>(x);
+}
+
+inline float SPPMPixelStatistics::get_radius(const int x, const int y) const
+{
+    return std::sqrt(m_pixels[pixel_index(x, y)].m_square_radius);
+}
+
+inline float SPPMPixelStatistics::get_max_radius() const
+{
+    return m_max_radius;
+}
+
+inline float SPPMPixelStatistics::get_photon_count(const int x, const int y) const
+{
+    return m_pixels[pixel_index(x, y)].m_photon_count;
+}
+
+inline void SPPMPixelStatistics::record_lookup(
+    const int       x,
+    const int       y,
+    const size_t    photon_count) const
+{
+    PassStats& stats = m_pass[pixel_index(x, y)];
+    boost_atomic::atomic_add32(&stats.m_photon_count, static_cast<foundation::uint32>(photon_count));
+    boost_atomic::atomic_inc32(&stats.m_lookup_count);
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPIXELSTATISTICS_H
@@ -141,6 +141,8 @@ Tracer::Tracer(
   , m_assume_no_alpha_mapping(!uses_alpha_mapping(scene))
   , m_transmission_threshold(static_cast<double>(transparency_threshold))
   , m_max_iterations(max_iterations)
+  , m_probe_count(0)
+  , m_resolved_probe_count(0)
 {
     if (print_details)
     {
@@ -223,6 +225,9 @@ const ShadingPoint& Tracer::do_trace(
         point = shading_point_ptr->get_point();
     }
 
+    // Update statistics.
+    m_iterations.insert(iterations);
+
     return *shading_point_ptr;
 }
 
@@ -302,9 +307,22 @@ const ShadingPoint& Tracer::do_trace_between(
         point = shading_point_ptr->get_point();
     }
 
+    // Update statistics.
+    m_iterations.insert(iterations);
+
     return *shading_point_ptr;
 }
 
+StatisticsVector Tracer::get_statistics() const
+{
+    Statistics stats;
+    stats.insert("probe rays", m_probe_count);
+    stats.insert_percent("resolved by probe", m_resolved_probe_count, m_probe_count);
+    stats.insert("iterations per trace", m_iterations);
+
+    return StatisticsVector::make("tracer statistics", stats);
+}
+
 void Tracer::evaluate_alpha(
     const Material&     material,
     const ShadingPoint& shading_point,
@@ -37,7 +37,10 @@
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/population.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/statistics.h"
 
 // Standard headers.
 #include <cstddef>
@@ -140,6 +143,9 @@ class Tracer
         const foundation::Vector3d&     target,
         const ShadingRay::Type          ray_type);
 
+    // Retrieve performance statistics.
+    foundation::StatisticsVector get_statistics() const;
+
   private:
     const Intersector&                  m_intersector;
     TextureCache&                       m_texture_cache;
@@ -154,6 +160,19 @@ class Tracer
     const size_t                        m_max_iterations;
     ShadingPoint                        m_shading_points[2];
 
+    // Tracing statistics.
+    foundation::uint64                  m_probe_count;          // number of transmission queries tried with a probe ray
+    foundation::uint64                  m_resolved_probe_count; // number of transmission queries resolved by a probe ray
+    foundation::Population<foundation::uint64>
+                                        m_iterations;           // number of iterations per trace loop
+
+    // Trace a probe ray that resolves transparency during traversal. Return true
+    // if the transmission could be determined without going through the trace loop.
+    bool trace_probe(
+        const ShadingRay&               ray,
+        const ShadingPoint*             parent_shading_point,
+        double&                         transmission);
+
     const ShadingPoint& do_trace(
         const foundation::Vector3d&     origin,
         const foundation::Vector3d&     direction,
@@ -183,6 +202,29 @@ class Tracer
 // Tracer class implementation.
 //
 
+inline bool Tracer::trace_probe(
+    const ShadingRay&                   ray,
+    const ShadingPoint*                 parent_shading_point,
+    double&                             transmission)
+{
+    ++m_probe_count;
+
+    bool transparent_hit;
+    const bool opaque_hit =
+        m_intersector.trace_probe(
+            ray,
+            parent_shading_point,
+            transparent_hit);
+
+    // The probe ray is inconclusive if it gave up at a surface that may be partially transparent.
+    if (!opaque_hit && transparent_hit)
+        return false;
+
+    ++m_resolved_probe_count;
+    transmission = opaque_hit ? 0.0 : 1.0;
+    return true;
+}
+
 inline const ShadingPoint& Tracer::trace(
     const foundation::Vector3d&         origin,
     const foundation::Vector3d&         direction,
@@ -226,20 +268,21 @@ inline double Tracer::trace(
     const ShadingRay::Type              ray_type,
     const ShadingRay::DepthType         ray_depth)
 {
-    if (m_assume_no_alpha_mapping)
-    {
-        const ShadingRay ray(
-            origin,
-            direction,
-            time,
-            ray_type,
-            ray_depth);
+    const ShadingRay ray(
+        origin,
+        direction,
+        time,
+        ray_type,
+        ray_depth);
 
+    if (m_assume_no_alpha_mapping)
         return m_intersector.trace_probe(ray) ? 0.0 : 1.0;
-    }
     else
     {
         double transmission;
+        if (trace_probe(ray, 0, transmission))
+            return transmission;
+
         const ShadingPoint& shading_point =
             trace(
                 origin,
@@ -258,20 +301,21 @@ inline double Tracer::trace(
     const foundation::Vector3d&         direction,
     const ShadingRay::Type              type)
 {
-    if (m_assume_no_alpha_mapping)
-    {
-        const ShadingRay ray(
-            origin.get_biased_point(direction),
-            direction,
-            origin.get_time(),
-            type,
-            origin.get_ray().m_depth + 1);
+    const ShadingRay ray(
+        origin.get_biased_point(direction),
+        direction,
+        origin.get_time(),
+        type,
+        origin.get_ray().m_depth + 1);
 
+    if (m_assume_no_alpha_mapping)
         return m_intersector.trace_probe(ray, &origin) ? 0.0 : 1.0;
-    }
     else
     {
         double transmission;
+        if (trace_probe(ray, &origin, transmission))
+            return transmission;
+
         const ShadingPoint& shading_point =
             trace(
                 origin,
@@ -326,22 +370,23 @@ inline double Tracer::trace_between(
     const ShadingRay::Type              ray_type,
     const ShadingRay::DepthType         ray_depth)
 {
-    if (m_assume_no_alpha_mapping)
-    {
-        const ShadingRay ray(
-            origin,
-            target - origin,
-            0.0,                        // ray tmin
-            1.0 - 1.0e-6,               // ray tmax
-            time,
-            ray_type,
-            ray_depth);
+    const ShadingRay ray(
+        origin,
+        target - origin,
+        0.0,                            // ray tmin
+        1.0 - 1.0e-6,                   // ray tmax
+        time,
+        ray_type,
+        ray_depth);
 
+    if (m_assume_no_alpha_mapping)
         return m_intersector.trace_probe(ray) ? 0.0 : 1.0;
-    }
     else
     {
         double transmission;
+        if (trace_probe(ray, 0, transmission))
+            return transmission;
+
         const ShadingPoint& shading_point =
             trace_between(
                 origin,
@@ -360,24 +405,25 @@ inline double Tracer::trace_between(
     const foundation::Vector3d&         target,
     const ShadingRay::Type              type)
 {
-    if (m_assume_no_alpha_mapping)
-    {
-        const foundation::Vector3d direction = target - origin.get_point();
+    const foundation::Vector3d direction = target - origin.get_point();
 
-        const ShadingRay ray(
-            origin.get_biased_point(direction),
-            direction,
-            0.0,                        // ray tmin
-            1.0 - 1.0e-6,               // ray tmax
-            origin.get_time(),
-            type,
-            origin.get_ray().m_depth + 1);
+    const ShadingRay ray(
+        origin.get_biased_point(direction),
+        direction,
+        0.0,                            // ray tmin
+        1.0 - 1.0e-6,                   // ray tmax
+        origin.get_time(),
+        type,
+        origin.get_ray().m_depth + 1);
 
+    if (m_assume_no_alpha_mapping)
         return m_intersector.trace_probe(ray, &origin) ? 0.0 : 1.0;
-    }
     else
     {
         double transmission;
+        if (trace_probe(ray, &origin, transmission))
+            return transmission;
+
         const ShadingPoint& shading_point =
             trace_between(
                 origin,
@@ -0,0 +1,212 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "checkpoint.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/exceptions/exceptionioerror.h"
+#include "foundation/image/tile.h"
+
+// boost headers.
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+#include "boost/system/error_code.hpp"
+
+// Standard headers.
+#include <cstring>
+
+using namespace foundation;
+using namespace std;
+namespace bf = boost::filesystem;
+
+namespace renderer
+{
+
+namespace
+{
+    const char Signature[10] = { 'C', 'H', 'E', 'C', 'K', 'P', 'O', 'I', 'N', 'T' };
+    const uint16 Version = 1;
+
+    template <typename T>
+    void checked_write(BufferedFile& file, const T& object)
+    {
+        if (file.write(object) < sizeof(T))
+            throw ExceptionIOError("failed to write checkpoint");
+    }
+
+    template <typename T>
+    void checked_read(BufferedFile& file, T& object)
+    {
+        if (file.read(object) < sizeof(T))
+            throw ExceptionIOError("failed to read checkpoint");
+    }
+}
+
+
+//
+// CheckpointWriter class implementation.
+//
+
+CheckpointWriter::CheckpointWriter(
+    const string&           path,
+    const CheckpointType    type,
+    const size_t            frame_width,
+    const size_t            frame_height)
+  : m_path(path)
+  , m_temp_path(path + ".tmp")
+{
+    m_file.open(
+        m_temp_path.c_str(),
+        BufferedFile::BinaryType,
+        BufferedFile::WriteMode);
+
+    if (!m_file.is_open())
+        throw ExceptionIOError("failed to open checkpoint file for writing");
+
+    if (m_file.write(Signature, sizeof(Signature)) < sizeof(Signature))
+        throw ExceptionIOError("failed to write checkpoint");
+
+    checked_write(m_file, Version);
+    checked_write(m_file, static_cast<uint8>(type));
+    checked_write(m_file, static_cast<uint32>(frame_width));
+    checked_write(m_file, static_cast<uint32>(frame_height));
+
+    m_writer.reset(new LZ4CompressedWriterAdapter(m_file));
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    if (m_file.is_open())
+    {
+        m_writer.reset();
+        m_file.close();
+
+        boost::system::error_code ec;
+        bf::remove(m_temp_path, ec);
+    }
+}
+
+void CheckpointWriter::write(const void* data, const size_t size)
+{
+    if (m_writer->write(data, size) < size)
+        throw ExceptionIOError("failed to write checkpoint");
+}
+
+void CheckpointWriter::write_tile(const Tile& tile)
+{
+    write(static_cast<uint32>(tile.get_width()));
+    write(static_cast<uint32>(tile.get_height()));
+    write(static_cast<uint32>(tile.get_channel_count()));
+    write(static_cast<uint64>(tile.get_size()));
+    write(tile.get_storage(), tile.get_size());
+}
+
+void CheckpointWriter::commit()
+{
+    // Flush the compressed data before closing the file.
+    m_writer.reset();
+
+    if (!m_file.close())
+        throw ExceptionIOError("failed to write checkpoint");
+
+    boost::system::error_code ec;
+    bf::rename(m_temp_path, m_path, ec);
+
+    if (ec)
+        throw ExceptionIOError("failed to replace checkpoint file", ec.message().c_str());
+}
+
+
+//
+// CheckpointReader class implementation.
+//
+
+CheckpointReader::CheckpointReader(
+    const string&           path,
+    const CheckpointType    type,
+    const size_t            frame_width,
+    const size_t            frame_height)
+{
+    m_file.open(
+        path.c_str(),
+        BufferedFile::BinaryType,
+        BufferedFile::ReadMode);
+
+    if (!m_file.is_open())
+        throw ExceptionIOError("failed to open checkpoint file for reading");
+
+    char signature[sizeof(Signature)];
+    if (m_file.read(signature, sizeof(signature)) < sizeof(signature) ||
+        memcmp(signature, Signature, sizeof(Signature)) != 0)
+        throw ExceptionIOError("not a checkpoint file");
+
+    uint16 version;
+    checked_read(m_file, version);
+    if (version != Version)
+        throw ExceptionIOError("unsupported checkpoint version");
+
+    uint8 checkpoint_type;
+    checked_read(m_file, checkpoint_type);
+    if (checkpoint_type != static_cast<uint8>(type))
+        throw ExceptionIOError("checkpoint was written by a different frame renderer");
+
+    uint32 width, height;
+    checked_read(m_file, width);
+    checked_read(m_file, height);
+    if (width != frame_width || height != frame_height)
+        throw ExceptionIOError("checkpoint was written for a frame of different dimensions");
+
+    m_reader.reset(new LZ4CompressedReaderAdapter(m_file));
+}
+
+void CheckpointReader::read(void* data, const size_t size)
+{
+    if (m_reader->read(data, size) < size)
+        throw ExceptionIOError("failed to read checkpoint");
+}
+
+void CheckpointReader::read_tile(Tile& tile)
+{
+    uint32 width, height, channel_count;
+    uint64 size;
+    read(width);
+    read(height);
+    read(channel_count);
+    read(size);
+
+    if (width != tile.get_width() ||
+        height != tile.get_height() ||
+        channel_count != tile.get_channel_count() ||
+        size != tile.get_size())
+        throw ExceptionIOError("checkpoint does not match the render settings");
+
+    read(tile.get_storage(), tile.get_size());
+}
+
+}   // namespace renderer
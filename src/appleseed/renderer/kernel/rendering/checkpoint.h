@@ -0,0 +1,154 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_RENDERING_CHECKPOINT_H
+#define APPLESEED_RENDERER_KERNEL_RENDERING_CHECKPOINT_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/bufferedfile.h"
+
+// Standard headers.
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// Forward declarations.
+namespace foundation    { class Tile; }
+
+namespace renderer
+{
+
+//
+// Checkpoints store the accumulation state of a render in progress so that an
+// interrupted render can be resumed instead of restarted from scratch.
+//
+// A checkpoint file starts with an uncompressed header (signature, version,
+// type of frame renderer, frame dimensions), followed by LZ4-compressed data
+// whose layout is defined by the frame renderer that wrote the checkpoint.
+//
+// All methods throw foundation::ExceptionIOError when an I/O error occurs or
+// when the checkpoint does not match the render it is read into.
+//
+
+enum CheckpointType
+{
+    ProgressiveCheckpoint,              // written by the progressive frame renderer
+    MultiPassCheckpoint                 // written by the generic frame renderer in multi-pass mode
+};
+
+class CheckpointWriter
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor. The checkpoint is written to a temporary file that only
+    // replaces @path on commit(), such that an existing checkpoint survives
+    // if the process is killed while a new checkpoint is being written.
+    CheckpointWriter(
+        const std::string&          path,
+        const CheckpointType        type,
+        const size_t                frame_width,
+        const size_t                frame_height);
+
+    // Destructor, discards the checkpoint if it was not committed.
+    ~CheckpointWriter();
+
+    // Write raw data.
+    void write(const void* data, const size_t size);
+
+    // Write a plain old data object.
+    template <typename T>
+    void write(const T& object);
+
+    // Write the dimensions and the pixels of a tile.
+    void write_tile(const foundation::Tile& tile);
+
+    // Finish writing and replace the checkpoint file by the new checkpoint.
+    void commit();
+
+  private:
+    const std::string                               m_path;
+    const std::string                               m_temp_path;
+    foundation::BufferedFile                        m_file;
+    std::auto_ptr<foundation::WriterAdapter>        m_writer;
+};
+
+class CheckpointReader
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor. Opens the checkpoint and checks that it was written by the
+    // same type of frame renderer for a frame of the same dimensions.
+    CheckpointReader(
+        const std::string&          path,
+        const CheckpointType        type,
+        const size_t                frame_width,
+        const size_t                frame_height);
+
+    // Read raw data.
+    void read(void* data, const size_t size);
+
+    // Read a plain old data object.
+    template <typename T>
+    void read(T& object);
+
+    // Read the pixels of a tile. The tile must have the dimensions
+    // and the number of channels of the tile that was written.
+    void read_tile(foundation::Tile& tile);
+
+  private:
+    foundation::BufferedFile                        m_file;
+    std::auto_ptr<foundation::ReaderAdapter>        m_reader;
+};
+
+
+//
+// CheckpointWriter class implementation.
+//
+
+template <typename T>
+inline void CheckpointWriter::write(const T& object)
+{
+    write(&object, sizeof(T));
+}
+
+
+//
+// CheckpointReader class implementation.
+//
+
+template <typename T>
+inline void CheckpointReader::read(T& object)
+{
+    read(&object, sizeof(T));
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_RENDERING_CHECKPOINT_H
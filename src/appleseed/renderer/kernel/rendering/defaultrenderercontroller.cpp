@@ -60,6 +60,10 @@ void DefaultRendererController::on_rendering_abort()
 {
 }
 
+void DefaultRendererController::on_frame_setup()
+{
+}
+
 void DefaultRendererController::on_frame_begin()
 {
 }
@@ -76,4 +80,9 @@ DefaultRendererController::Status DefaultRendererController::on_progress()
     return ContinueRendering;
 }
 
+DefaultRendererController::Status DefaultRendererController::on_frame_complete()
+{
+    return TerminateRendering;
+}
+
 }   // namespace renderer
@@ -62,6 +62,9 @@ class DLLSYMBOL DefaultRendererController
     // This method is called after rendering was aborted.
     virtual void on_rendering_abort() OVERRIDE;
 
+    // This method is called before the scene is set up for a frame.
+    virtual void on_frame_setup() OVERRIDE;
+
     // This method is called before rendering a single frame.
     virtual void on_frame_begin() OVERRIDE;
 
@@ -70,6 +73,9 @@ class DLLSYMBOL DefaultRendererController
 
     // This method is called continuously during rendering.
     virtual Status on_progress() OVERRIDE;
+
+    // This method is called when a frame has been completely rendered.
+    virtual Status on_frame_complete() OVERRIDE;
 };
 
 }       // namespace renderer
@@ -76,4 +76,20 @@ void EphemeralShadingResultFrameBufferFactory::destroy(
     delete framebuffer;
 }
 
+void EphemeralShadingResultFrameBufferFactory::clear()
+{
+}
+
+void EphemeralShadingResultFrameBufferFactory::write_checkpoint(
+    CheckpointWriter&           writer) const
+{
+    // Framebuffers don't outlive a pass: nothing to write.
+}
+
+void EphemeralShadingResultFrameBufferFactory::read_checkpoint(
+    const Frame&                frame,
+    CheckpointReader&           reader)
+{
+}
+
 }   // namespace renderer
@@ -41,6 +41,8 @@
 #include <cstddef>
 
 // Forward declarations.
+namespace renderer  { class CheckpointReader; }
+namespace renderer  { class CheckpointWriter; }
 namespace renderer  { class Frame; }
 namespace renderer  { class ShadingResultFrameBuffer; }
 
@@ -62,6 +64,15 @@ class EphemeralShadingResultFrameBufferFactory
 
     virtual void destroy(
         ShadingResultFrameBuffer*   framebuffer) OVERRIDE;
+
+    virtual void clear() OVERRIDE;
+
+    virtual void write_checkpoint(
+        CheckpointWriter&           writer) const OVERRIDE;
+
+    virtual void read_checkpoint(
+        const Frame&                frame,
+        CheckpointReader&           reader) OVERRIDE;
 };
 
 }       // namespace renderer
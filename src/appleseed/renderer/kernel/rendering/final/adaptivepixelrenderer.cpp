@@ -44,6 +44,7 @@
 #include "renderer/kernel/shading/shadingfragment.h"
 #include "renderer/kernel/shading/shadingresult.h"
 #include "renderer/modeling/frame/frame.h"
+#include "renderer/utility/samplingmode.h"
 
 // appleseed.foundation headers.
 #include "foundation/image/color.h"
@@ -180,17 +181,20 @@ namespace
 
             m_scratch_fb->clear();
 
-            // Create a sampling context.
+            // Create a sampling context. In QMC mode, the samples of a pixel are
+            // successive points of a sequence scrambled per pixel.
             const size_t frame_width = frame.image().properties().m_canvas_width;
-            const size_t instance =
+            const uint32 pixel_seed =
                 mix_uint32(
                     static_cast<uint32>(pass_hash),
                     static_cast<uint32>(iy * frame_width + ix));
             SamplingContext sampling_context(
                 rng,
+                m_params.m_sampling_mode,
                 2,                      // number of dimensions
                 0,                      // number of samples -- unknown
-                instance);              // initial instance number
+                0,                      // initial instance number
+                pixel_seed);            // scrambling seed
 
             VariationTracker trackers[3];
 
@@ -309,16 +313,18 @@ namespace
       private:
         struct Parameters
         {
-            const size_t    m_min_samples;
-            const size_t    m_max_samples;
-            const float     m_max_variation;
-            const bool      m_diagnostics;
+            const size_t                m_min_samples;
+            const size_t                m_max_samples;
+            const float                 m_max_variation;
+            const bool                  m_diagnostics;
+            const SamplingContext::Mode m_sampling_mode;
 
             explicit Parameters(const ParamArray& params)
               : m_min_samples(params.get_required<size_t>("min_samples", 1))
               , m_max_samples(params.get_required<size_t>("max_samples", 1))
               , m_max_variation(pow(10.0f, -params.get_optional<float>("quality", 2.0f)))
               , m_diagnostics(params.get_optional<bool>("enable_diagnostics"))
+              , m_sampling_mode(get_sampling_context_mode(params))
             {
             }
         };
@@ -42,6 +42,7 @@
 #include "renderer/kernel/rendering/shadingresultframebuffer.h"
 #include "renderer/kernel/shading/shadingresult.h"
 #include "renderer/modeling/frame/frame.h"
+#include "renderer/utility/samplingmode.h"
 
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
@@ -123,16 +124,20 @@ namespace
             const int iy = pixel_context.m_iy;
             const size_t aov_count = frame.aov_images().size();
 
+            // In QMC mode, the samples of a pixel are successive points of a sequence scrambled per pixel.
+            const size_t frame_width = frame.image().properties().m_canvas_width;
+            const uint32 pixel_seed = hash_uint32(static_cast<uint32>(pass_hash + iy * frame_width + ix));
+
             if (m_params.m_decorrelate)
             {
                 // Create a sampling context.
-                const size_t frame_width = frame.image().properties().m_canvas_width;
-                const size_t instance = hash_uint32(static_cast<uint32>(pass_hash + iy * frame_width + ix));
                 SamplingContext sampling_context(
                     rng,
+                    m_params.m_sampling_mode,
                     2,                  // number of dimensions
                     0,                  // number of samples -- unknown
-                    instance);          // initial instance number
+                    0,                  // initial instance number
+                    pixel_seed);        // scrambling seed
 
                 for (size_t i = 0; i < m_sample_count; ++i)
                 {
@@ -180,11 +185,15 @@ namespace
                         // Create a sampling context. We start with an initial dimension of 1,
                         // as this seems to give less correlation artifacts than when the
                         // initial dimension is set to 0 or 2.
+                        // In QMC mode, the instance number is the sample number within the pixel.
+                        const bool qmc = m_params.m_sampling_mode == SamplingContext::QMCMode;
                         SamplingContext sampling_context(
                             rng,
+                            m_params.m_sampling_mode,
                             1,              // number of dimensions
                             instance,       // number of samples
-                            instance);      // initial instance number -- end of sequence
+                            qmc ? sy * m_sqrt_sample_count + sx : instance,     // initial instance number
+                            qmc ? pixel_seed : 0);                              // scrambling seed
 
                         // Render the sample.
                         ShadingResult shading_result(aov_count);
@@ -211,14 +220,16 @@ namespace
       private:
         struct Parameters
         {
-            const size_t    m_samples;
-            const bool      m_force_aa;
-            const bool      m_decorrelate;
+            const size_t                m_samples;
+            const bool                  m_force_aa;
+            const bool                  m_decorrelate;
+            const SamplingContext::Mode m_sampling_mode;
 
             explicit Parameters(const ParamArray& params)
               : m_samples(params.get_required<size_t>("samples", 1))
               , m_force_aa(params.get_optional<bool>("force_antialiasing", false))
               , m_decorrelate(params.get_optional<bool>("decorrelate_pixels", true))
+              , m_sampling_mode(get_sampling_context_mode(params))
             {
             }
         };
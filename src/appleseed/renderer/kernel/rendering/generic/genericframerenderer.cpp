@@ -34,15 +34,23 @@
 #include "renderer/global/globallogger.h"
 #include "renderer/kernel/rendering/generic/tilejob.h"
 #include "renderer/kernel/rendering/generic/tilejobfactory.h"
+#include "renderer/kernel/rendering/checkpoint.h"
 #include "renderer/kernel/rendering/framerendererbase.h"
 #include "renderer/kernel/rendering/ipasscallback.h"
+#include "renderer/kernel/rendering/ishadingresultframebufferfactory.h"
 #include "renderer/kernel/rendering/itilecallback.h"
 #include "renderer/kernel/rendering/itilerenderer.h"
+#include "renderer/modeling/frame/frame.h"
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
+#include "foundation/core/exceptions/exceptionioerror.h"
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
 #include "foundation/math/hash.h"
+#include "foundation/platform/compiler.h"
 #include "foundation/platform/thread.h"
+#include "foundation/platform/timer.h"
 #include "foundation/platform/types.h"
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/job.h"
@@ -64,6 +72,131 @@ namespace renderer
 
 namespace
 {
+    //
+    // Multi-pass checkpoints.
+    //
+    // A checkpoint contains the number of the next pass to render, the framebuffers
+    // in which passes are accumulated and the state of the pass callback, if any.
+    //
+
+    void write_checkpoint(
+        const string&                       path,
+        const Frame&                        frame,
+        const size_t                        next_pass,
+        const IShadingResultFrameBufferFactory&
+                                            framebuffer_factory,
+        const IPassCallback*                pass_callback)
+    {
+        const CanvasProperties& props = frame.image().properties();
+
+        try
+        {
+            CheckpointWriter writer(
+                path,
+                MultiPassCheckpoint,
+                props.m_canvas_width,
+                props.m_canvas_height);
+
+            writer.write(static_cast<uint32>(next_pass));
+            framebuffer_factory.write_checkpoint(writer);
+
+            writer.write(static_cast<uint8>(pass_callback ? 1 : 0));
+            if (pass_callback)
+                pass_callback->write_checkpoint(writer);
+
+            writer.commit();
+
+            RENDERER_LOG_DEBUG("wrote checkpoint %s.", path.c_str());
+        }
+        catch (const ExceptionIOError& e)
+        {
+            RENDERER_LOG_ERROR("failed to write checkpoint %s: %s.", path.c_str(), e.what());
+        }
+    }
+
+    // Return the number of the next pass to render, or 0 if the checkpoint could not be read.
+    size_t read_checkpoint(
+        const string&                       path,
+        const Frame&                        frame,
+        const size_t                        pass_count,
+        IShadingResultFrameBufferFactory&   framebuffer_factory,
+        IPassCallback*                      pass_callback)
+    {
+        const CanvasProperties& props = frame.image().properties();
+
+        try
+        {
+            CheckpointReader reader(
+                path,
+                MultiPassCheckpoint,
+                props.m_canvas_width,
+                props.m_canvas_height);
+
+            uint32 next_pass;
+            reader.read(next_pass);
+
+            if (next_pass >= pass_count)
+                throw ExceptionIOError("checkpoint has at least as many passes as the render");
+
+            framebuffer_factory.read_checkpoint(frame, reader);
+
+            uint8 has_pass_callback_state;
+            reader.read(has_pass_callback_state);
+
+            if ((has_pass_callback_state != 0) != (pass_callback != 0))
+                throw ExceptionIOError("checkpoint does not match the render settings");
+
+            // The pass callback leaves its state untouched if it fails to read it.
+            if (pass_callback)
+                pass_callback->read_checkpoint(reader);
+
+            return next_pass;
+        }
+        catch (const ExceptionIOError& e)
+        {
+            RENDERER_LOG_ERROR(
+                "failed to resume rendering from checkpoint %s: %s; starting over.",
+                path.c_str(),
+                e.what());
+
+            framebuffer_factory.clear();
+
+            return 0;
+        }
+    }
+
+
+    //
+    // A job creating the tile renderer of the worker thread executing it.
+    //
+
+    class CreateTileRendererJob
+      : public IJob
+    {
+      public:
+        CreateTileRendererJob(
+            ITileRendererFactory*   tile_renderer_factory,
+            vector<ITileRenderer*>& tile_renderers)
+          : m_tile_renderer_factory(tile_renderer_factory)
+          , m_tile_renderers(tile_renderers)
+        {
+        }
+
+        virtual void execute(const size_t thread_index) OVERRIDE
+        {
+            // Tile renderer factories are not required to be thread-safe.
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            m_tile_renderers[thread_index] = m_tile_renderer_factory->create(thread_index == 0);
+        }
+
+      private:
+        ITileRendererFactory*       m_tile_renderer_factory;
+        vector<ITileRenderer*>&     m_tile_renderers;
+        boost::mutex                m_mutex;
+    };
+
+
     //
     // Generic frame renderer.
     //
@@ -77,11 +210,15 @@ namespace
             ITileRendererFactory*   tile_renderer_factory,
             ITileCallbackFactory*   tile_callback_factory,
             IPassCallback*          pass_callback,
+            IShadingResultFrameBufferFactory*
+                                    framebuffer_factory,
             const ParamArray&       params)
           : m_frame(frame)
           , m_params(params)
           , m_pass_callback(pass_callback)
+          , m_framebuffer_factory(framebuffer_factory)
           , m_is_rendering(false)
+          , m_resume_pending(m_params.m_resume)
         {
             // We must have a renderer factory, but it's OK not to have a callback factory.
             assert(tile_renderer_factory);
@@ -92,12 +229,15 @@ namespace
                     global_logger(),
                     m_job_queue,
                     m_params.m_thread_count,
-                    JobManager::KeepRunningOnEmptyQueue));
+                    m_params.m_pin_threads
+                        ? JobManager::KeepRunningOnEmptyQueue | JobManager::PinWorkerThreads
+                        : JobManager::KeepRunningOnEmptyQueue));
 
-            // Instantiate tile renderers, one per rendering thread.
-            m_tile_renderers.reserve(m_params.m_thread_count);
-            for (size_t i = 0; i < m_params.m_thread_count; ++i)
-                m_tile_renderers.push_back(tile_renderer_factory->create(i == 0));
+            // Instantiate tile renderers, one per rendering thread, from within the rendering
+            // threads so that their memory is allocated close to the CPU core that uses it.
+            m_tile_renderers.assign(m_params.m_thread_count, 0);
+            CreateTileRendererJob create_tile_renderer_job(tile_renderer_factory, m_tile_renderers);
+            m_job_manager->execute_on_each_thread(create_tile_renderer_job);
 
             if (tile_callback_factory)
             {
@@ -107,6 +247,14 @@ namespace
                     m_tile_callbacks.push_back(tile_callback_factory->create());
             }
 
+            // Checkpoints store the framebuffers in which passes are accumulated.
+            m_checkpoint_enabled = !m_params.m_checkpoint_path.empty();
+            if (m_checkpoint_enabled && (m_params.m_pass_count < 2 || !m_framebuffer_factory))
+            {
+                RENDERER_LOG_WARNING("checkpoints are only supported in multi-pass mode.");
+                m_checkpoint_enabled = false;
+            }
+
             print_rendering_thread_count(m_params.m_thread_count);
         }
 
@@ -146,6 +294,32 @@ namespace
 
             m_abort_switch.clear();
 
+            // Continue from the checkpoint, if any, the first time the frame is rendered.
+            size_t first_pass = 0;
+            if (m_resume_pending)
+            {
+                m_resume_pending = false;
+
+                if (m_checkpoint_enabled)
+                {
+                    first_pass =
+                        read_checkpoint(
+                            m_params.m_checkpoint_path,
+                            m_frame,
+                            m_params.m_pass_count,
+                            *m_framebuffer_factory,
+                            m_pass_callback);
+
+                    if (first_pass > 0)
+                    {
+                        RENDERER_LOG_INFO(
+                            "resuming rendering from checkpoint %s at pass %s.",
+                            m_params.m_checkpoint_path.c_str(),
+                            pretty_uint(first_pass + 1).c_str());
+                    }
+                }
+            }
+
             // Start job execution.
             m_job_manager->start();
 
@@ -155,10 +329,14 @@ namespace
                 new PassManagerFunc(
                     m_frame,
                     m_params.m_tile_ordering,
+                    first_pass,
                     m_params.m_pass_count,
                     m_tile_renderers,
                     m_tile_callbacks,
                     m_pass_callback,
+                    m_checkpoint_enabled ? m_params.m_checkpoint_path : string(),
+                    m_params.m_checkpoint_interval,
+                    m_framebuffer_factory,
                     m_job_queue,
                     m_abort_switch,
                     m_is_rendering));
@@ -197,13 +375,21 @@ namespace
         struct Parameters
         {
             const size_t                        m_thread_count;     // number of rendering threads
+            const bool                          m_pin_threads;      // bind rendering threads to CPU cores?
             const TileJobFactory::TileOrdering  m_tile_ordering;    // tile rendering order
             const size_t                        m_pass_count;       // number of rendering passes
+            const string                        m_checkpoint_path;  // path to the checkpoint file
+            const double                        m_checkpoint_interval;  // time between two checkpoints, in seconds
+            const bool                          m_resume;           // resume rendering from the checkpoint file?
 
             explicit Parameters(const ParamArray& params)
               : m_thread_count(FrameRendererBase::get_rendering_thread_count(params))
+              , m_pin_threads(params.get_optional<bool>("pin_rendering_threads", false))
               , m_tile_ordering(get_tile_ordering(params))
               , m_pass_count(params.get_optional<size_t>("passes", 1))
+              , m_checkpoint_path(params.get_optional<string>("checkpoint_file", ""))
+              , m_checkpoint_interval(params.get_optional<double>("checkpoint_interval", 60.0))
+              , m_resume(params.get_optional<bool>("resume_from_checkpoint", false))
             {
             }
 
@@ -248,19 +434,27 @@ namespace
             PassManagerFunc(
                 const Frame&                        frame,
                 const TileJobFactory::TileOrdering  tile_ordering,
+                const size_t                        first_pass,
                 const size_t                        pass_count,
                 vector<ITileRenderer*>&             tile_renderers,
                 vector<ITileCallback*>&             tile_callbacks,
                 IPassCallback*                      pass_callback,
+                const string&                       checkpoint_path,
+                const double                        checkpoint_interval,
+                IShadingResultFrameBufferFactory*   framebuffer_factory,
                 JobQueue&                           job_queue,
                 AbortSwitch&                        abort_switch,
                 bool&                               is_rendering)
               : m_frame(frame)
               , m_tile_ordering(tile_ordering)
+              , m_first_pass(first_pass)
               , m_pass_count(pass_count)
               , m_tile_renderers(tile_renderers)
               , m_tile_callbacks(tile_callbacks)
               , m_pass_callback(pass_callback)
+              , m_checkpoint_path(checkpoint_path)
+              , m_checkpoint_interval(checkpoint_interval)
+              , m_framebuffer_factory(framebuffer_factory)
               , m_job_queue(job_queue)
               , m_abort_switch(abort_switch)
               , m_is_rendering(is_rendering)
@@ -269,7 +463,10 @@ namespace
 
             void operator()()
             {
-                for (size_t pass = 0; pass < m_pass_count && !m_abort_switch.is_aborted(); ++pass)
+                const uint64 timer_frequency = m_timer.frequency();
+                uint64 last_checkpoint_time = m_timer.read();
+
+                for (size_t pass = m_first_pass; pass < m_pass_count && !m_abort_switch.is_aborted(); ++pass)
                 {
                     if (m_pass_count > 1)
                         RENDERER_LOG_INFO("--- beginning pass %s ---", pretty_uint(pass + 1).c_str());
@@ -298,7 +495,11 @@ namespace
                     for (const_each<TileJobFactory::TileJobVector> i = tile_jobs; i; ++i)
                         m_job_queue.schedule(*i);
 
-                    // Wait until tile jobs have effectively stopped.
+                    // Let the pass callback schedule jobs behind the tile jobs.
+                    if (m_pass_callback)
+                        m_pass_callback->schedule_background_jobs(m_frame, m_job_queue, m_abort_switch);
+
+                    // Wait until tile jobs (and background jobs) have effectively stopped.
                     m_job_queue.wait_until_completion();
 
                     // Invoke the post-pass callback if there is one.
@@ -308,6 +509,27 @@ namespace
                         m_pass_callback->post_render(m_frame, m_job_queue, m_abort_switch);
                         assert(!m_job_queue.has_scheduled_or_running_jobs());
                     }
+
+                    // Checkpoint complete passes, except the last one.
+                    if (!m_checkpoint_path.empty() &&
+                        !m_abort_switch.is_aborted() &&
+                        pass + 1 < m_pass_count)
+                    {
+                        const uint64 time = m_timer.read();
+                        const double elapsed_seconds =
+                            static_cast<double>(time - last_checkpoint_time) / timer_frequency;
+
+                        if (elapsed_seconds >= m_checkpoint_interval)
+                        {
+                            write_checkpoint(
+                                m_checkpoint_path,
+                                m_frame,
+                                pass + 1,
+                                *m_framebuffer_factory,
+                                m_pass_callback);
+                            last_checkpoint_time = m_timer.read();
+                        }
+                    }
                 }
 
                 m_is_rendering = false;
@@ -316,14 +538,19 @@ namespace
           private:
             const Frame&                            m_frame;
             const TileJobFactory::TileOrdering      m_tile_ordering;
+            const size_t                            m_first_pass;
             vector<ITileRenderer*>&                 m_tile_renderers;
             vector<ITileCallback*>&                 m_tile_callbacks;
             IPassCallback*                          m_pass_callback;
+            const string                            m_checkpoint_path;
+            const double                            m_checkpoint_interval;
+            IShadingResultFrameBufferFactory*       m_framebuffer_factory;
             const size_t                            m_pass_count;
             JobQueue&                               m_job_queue;
             AbortSwitch&                            m_abort_switch;
             bool&                                   m_is_rendering;
             TileJobFactory                          m_tile_job_factory;
+            DefaultWallclockTimer                   m_timer;
         };
 
         const Frame&                m_frame;            // target framebuffer
@@ -336,10 +563,14 @@ namespace
         vector<ITileRenderer*>      m_tile_renderers;   // tile renderers, one per thread
         vector<ITileCallback*>      m_tile_callbacks;   // tile callbacks, none or one per thread
         IPassCallback*              m_pass_callback;
+        IShadingResultFrameBufferFactory*
+                                    m_framebuffer_factory;
 
         TileJobFactory              m_tile_job_factory;
 
         bool                        m_is_rendering;
+        bool                        m_checkpoint_enabled;
+        bool                        m_resume_pending;
         auto_ptr<PassManagerFunc>   m_pass_manager_func;
         auto_ptr<thread>            m_pass_manager_thread;
 
@@ -367,11 +598,14 @@ GenericFrameRendererFactory::GenericFrameRendererFactory(
     ITileRendererFactory*   tile_renderer_factory,
     ITileCallbackFactory*   tile_callback_factory,
     IPassCallback*          pass_callback,
+    IShadingResultFrameBufferFactory*
+                            framebuffer_factory,
     const ParamArray&       params)
   : m_frame(frame)
   , m_tile_renderer_factory(tile_renderer_factory)  
   , m_tile_callback_factory(tile_callback_factory)
   , m_pass_callback(pass_callback)
+  , m_framebuffer_factory(framebuffer_factory)
   , m_params(params)
 {
 }
@@ -389,6 +623,7 @@ IFrameRenderer* GenericFrameRendererFactory::create()
             m_tile_renderer_factory,
             m_tile_callback_factory,
             m_pass_callback,
+            m_framebuffer_factory,
             m_params);
 }
 
@@ -397,6 +632,8 @@ IFrameRenderer* GenericFrameRendererFactory::create(
     ITileRendererFactory*   tile_renderer_factory,
     ITileCallbackFactory*   tile_callback_factory,
     IPassCallback*          pass_callback,
+    IShadingResultFrameBufferFactory*
+                            framebuffer_factory,
     const ParamArray&       params)
 {
     return
@@ -405,6 +642,7 @@ IFrameRenderer* GenericFrameRendererFactory::create(
             tile_renderer_factory,
             tile_callback_factory,
             pass_callback,
+            framebuffer_factory,
             params);
 }
 
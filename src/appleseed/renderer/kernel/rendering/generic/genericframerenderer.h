@@ -40,6 +40,7 @@
 // Forward declarations.
 namespace renderer  { class Frame; }
 namespace renderer  { class IPassCallback; }
+namespace renderer  { class IShadingResultFrameBufferFactory; }
 namespace renderer  { class ITileCallbackFactory; }
 namespace renderer  { class ITileRendererFactory; }
 
@@ -60,6 +61,8 @@ class GenericFrameRendererFactory
         ITileRendererFactory*   tile_renderer_factory,
         ITileCallbackFactory*   tile_callback_factory,      // may be 0
         IPassCallback*          pass_callback,              // may be 0
+        IShadingResultFrameBufferFactory*
+                                framebuffer_factory,        // may be 0, required for checkpoints
         const ParamArray&       params);
 
     // Delete this instance.
@@ -74,6 +77,8 @@ class GenericFrameRendererFactory
         ITileRendererFactory*   tile_renderer_factory,
         ITileCallbackFactory*   tile_callback_factory,      // may be 0
         IPassCallback*          pass_callback,              // may be 0
+        IShadingResultFrameBufferFactory*
+                                framebuffer_factory,        // may be 0, required for checkpoints
         const ParamArray&       params);
 
   private:
@@ -81,6 +86,8 @@ class GenericFrameRendererFactory
     ITileRendererFactory*       m_tile_renderer_factory;
     ITileCallbackFactory*       m_tile_callback_factory;    // may be 0
     IPassCallback*              m_pass_callback;            // may be 0
+    IShadingResultFrameBufferFactory*
+                                m_framebuffer_factory;      // may be 0
     ParamArray                  m_params;
 };
 
@@ -40,6 +40,7 @@
 #include "renderer/kernel/shading/shadingfragment.h"
 #include "renderer/kernel/shading/shadingresult.h"
 #include "renderer/modeling/frame/frame.h"
+#include "renderer/utility/samplingmode.h"
 
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
@@ -77,7 +78,8 @@ namespace
             ISampleRendererFactory*         sample_renderer_factory,
             const size_t                    generator_index,
             const size_t                    generator_count,
-            const bool                      primary)
+            const bool                      primary,
+            const ParamArray&               params)
           : SampleGeneratorBase(generator_index, generator_count)
           , m_frame(frame)
           , m_canvas_width(frame.image().properties().m_canvas_width)
@@ -90,6 +92,7 @@ namespace
           , m_sample_renderer(sample_renderer_factory->create(primary))
           , m_window_width_next_pow2(next_power(static_cast<double>(m_window_width), 2.0))
           , m_window_height_next_pow3(next_power(static_cast<double>(m_window_height), 3.0))
+          , m_sampling_mode(get_sampling_context_mode(params))
         {
         }
 
@@ -131,13 +134,14 @@ namespace
 
         const double                        m_window_width_next_pow2;
         const double                        m_window_height_next_pow3;
+        const SamplingContext::Mode         m_sampling_mode;
 
         Population<uint64>                  m_total_sampling_dim;
         Population<uint64>                  m_total_sampling_inst;
 
         virtual size_t generate_samples(
             const size_t                    sequence_index,
-            SampleVector&                   samples) OVERRIDE
+            SampleBatch&                    samples) OVERRIDE
         {
             // Compute the sample position in NDC.
             const size_t Bases[2] = { 2, 3 };
@@ -165,11 +169,15 @@ namespace
 
             // Create a sampling context. We start with an initial dimension of 2,
             // corresponding to the Halton sequence used for the sample positions.
+            // In QMC mode, all samples are successive points of a single sequence
+            // shared by all sample generators, which use disjoint sequence indices.
             SamplingContext sampling_context(
                 m_rng,
+                m_sampling_mode,
                 2,                          // number of dimensions
                 sequence_index,             // number of samples
-                sequence_index);            // initial instance number
+                sequence_index,             // initial instance number
+                0);                         // scrambling seed
 
             // Render the sample.
             ShadingResult shading_result;
@@ -184,13 +192,13 @@ namespace
                 return 0;
 
             // Create a single sample.
-            Sample sample;
-            sample.m_position = sample_position;
-            sample.m_color[0] = shading_result.m_main.m_color[0];
-            sample.m_color[1] = shading_result.m_main.m_color[1];
-            sample.m_color[2] = shading_result.m_main.m_color[2];
-            sample.m_color[3] = shading_result.m_main.m_alpha[0];
-            samples.push_back(sample);
+            samples.push_back(
+                sample_position,
+                Color4f(
+                    shading_result.m_main.m_color[0],
+                    shading_result.m_main.m_color[1],
+                    shading_result.m_main.m_color[2],
+                    shading_result.m_main.m_alpha[0]));
 
             m_total_sampling_dim.insert(sampling_context.get_total_dimension());
             m_total_sampling_inst.insert(sampling_context.get_total_instance());
@@ -207,9 +215,11 @@ namespace
 
 GenericSampleGeneratorFactory::GenericSampleGeneratorFactory(
     const Frame&            frame,
-    ISampleRendererFactory* sample_renderer_factory)
+    ISampleRendererFactory* sample_renderer_factory,
+    const ParamArray&       params)
   : m_frame(frame)
   , m_sample_renderer_factory(sample_renderer_factory)
+  , m_params(params)
 {
 }
 
@@ -229,7 +239,8 @@ ISampleGenerator* GenericSampleGeneratorFactory::create(
             m_sample_renderer_factory,
             generator_index,
             generator_count,
-            primary);
+            primary,
+            m_params);
 }
 
 SampleAccumulationBuffer* GenericSampleGeneratorFactory::create_sample_accumulation_buffer()
@@ -240,6 +251,8 @@ SampleAccumulationBuffer* GenericSampleGeneratorFactory::create_sample_accumulat
         new LocalSampleAccumulationBuffer(
             props.m_canvas_width,
             props.m_canvas_height,
+            props.m_tile_width,
+            props.m_tile_height,
             m_frame.get_filter());
 }
 
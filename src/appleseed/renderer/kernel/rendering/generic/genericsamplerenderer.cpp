@@ -273,6 +273,7 @@ namespace
             StatisticsVector stats;
             stats.merge(m_texture_cache.get_statistics());
             stats.merge(m_intersector.get_statistics());
+            stats.merge(m_tracer.get_statistics());
             stats.merge(m_lighting_engine->get_statistics());
             return stats;
         }
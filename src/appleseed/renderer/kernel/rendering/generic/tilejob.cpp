@@ -39,6 +39,7 @@
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
 #include "foundation/image/tile.h"
+#include "foundation/utility/eventtracer.h"
 
 // Standard headers.
 #include <cassert>
@@ -81,6 +82,8 @@ void TileJob::execute(const size_t thread_index)
 {
     assert(thread_index < m_tile_renderers.size());
 
+    const ScopedEvent event("render tile", "rendering");
+
     // Retrieve the tile callback.
     ITileCallback* tile_callback =
         m_tile_callbacks.size() == m_tile_renderers.size()
@@ -31,6 +31,7 @@
 #include "globalsampleaccumulationbuffer.h"
 
 // appleseed.renderer headers.
+#include "renderer/kernel/rendering/checkpoint.h"
 #include "renderer/kernel/rendering/sample.h"
 #include "renderer/modeling/frame/frame.h"
 
@@ -41,6 +42,10 @@
 #include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
 #include "foundation/platform/thread.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <memory>
 
 using namespace foundation;
 using namespace std;
@@ -51,10 +56,15 @@ namespace renderer
 GlobalSampleAccumulationBuffer::GlobalSampleAccumulationBuffer(
     const size_t    width,
     const size_t    height,
+    const size_t    tile_width,
+    const size_t    tile_height,
     const Filter2d& filter)
-  : m_fb(width, height, 3, filter)
+  : SampleAccumulationBuffer(width, height, tile_width, tile_height)
+  , m_fb(width, height, 3, filter)
   , m_filter_rcp_norm_factor(static_cast<float>(1.0 / compute_normalization_factor(filter)))
+  , m_developed_sample_count(0)
 {
+    m_memory_account.set_size(m_fb.get_memory_size());
 }
 
 void GlobalSampleAccumulationBuffer::clear()
@@ -64,31 +74,43 @@ void GlobalSampleAccumulationBuffer::clear()
     SampleAccumulationBuffer::clear_no_lock();
 
     m_fb.clear();
+    m_developed_sample_count = 0;
 }
 
 void GlobalSampleAccumulationBuffer::store_samples(
-    const size_t    sample_count,
-    const Sample    samples[])
+    const SampleBatch&  samples)
 {
+    const size_t sample_count = samples.size();
+
+    if (sample_count == 0)
+        return;
+
     boost::mutex::scoped_lock lock(m_mutex);
 
-    const double fw = static_cast<double>(m_fb.get_width());
-    const double fh = static_cast<double>(m_fb.get_height());
-    const Sample* sample_end = samples + sample_count;
+    const float* x = samples.get_x();
+    const float* y = samples.get_y();
 
-    for (const Sample* sample_ptr = samples; sample_ptr < sample_end; ++sample_ptr)
+    // Splat the normalized samples into the framebuffer.
+    const float* values[3] =
     {
-        const double fx = sample_ptr->m_position.x * fw;
-        const double fy = sample_ptr->m_position.y * fh;
+        samples.get_channel(0),
+        samples.get_channel(1),
+        samples.get_channel(2)
+    };
+    m_fb.add(sample_count, x, y, values, m_filter_rcp_norm_factor);
 
-        Color3f value = sample_ptr->m_color.rgb();
-        value *= m_filter_rcp_norm_factor;
+    const double fw = static_cast<double>(m_fb.get_width());
+    const double fh = static_cast<double>(m_fb.get_height());
+    const double xradius = m_fb.get_filter().get_xradius();
+    const double yradius = m_fb.get_filter().get_yradius();
 
-        m_fb.add(fx, fy, &value[0]);
-    }
+    for (size_t i = 0; i < sample_count; ++i)
+        mark_dirty_no_lock(x[i] * fw, y[i] * fh, xradius, yradius);
 }
 
-void GlobalSampleAccumulationBuffer::develop_to_frame(Frame& frame)
+void GlobalSampleAccumulationBuffer::develop_to_frame(
+    Frame&                  frame,
+    TileCoordinateArray&    tiles)
 {
     boost::mutex::scoped_lock lock(m_mutex);
 
@@ -99,19 +121,30 @@ void GlobalSampleAccumulationBuffer::develop_to_frame(Frame& frame)
     assert(frame_props.m_canvas_height == m_fb.get_height());
     assert(frame_props.m_channel_count == 4);
 
+    // Pixel values are normalized by the total number of samples: when it
+    // changed, every tile of the frame changed too, whether or not it
+    // received new samples.
+    if (m_sample_count != m_developed_sample_count)
+    {
+        mark_all_dirty_no_lock();
+        m_developed_sample_count = m_sample_count;
+    }
+
+    collect_dirty_tiles_no_lock(tiles);
+
     const float scale = 1.0f / m_sample_count;
 
-    for (size_t ty = 0; ty < frame_props.m_tile_count_y; ++ty)
+    for (size_t i = 0; i < tiles.size(); ++i)
     {
-        for (size_t tx = 0; tx < frame_props.m_tile_count_x; ++tx)
-        {
-            Tile& tile = image.tile(tx, ty);
+        const size_t tx = tiles[i].x;
+        const size_t ty = tiles[i].y;
 
-            const size_t x = tx * frame_props.m_tile_width;
-            const size_t y = ty * frame_props.m_tile_height;
+        Tile& tile = image.tile(tx, ty);
 
-            develop_to_tile(tile, x, y, tx, ty, scale);
-        }
+        const size_t x = tx * frame_props.m_tile_width;
+        const size_t y = ty * frame_props.m_tile_height;
+
+        develop_to_tile(tile, x, y, tx, ty, scale);
     }
 }
 
@@ -122,6 +155,35 @@ void GlobalSampleAccumulationBuffer::increment_sample_count(const uint64 delta_s
     m_sample_count += delta_sample_count;
 }
 
+void GlobalSampleAccumulationBuffer::write_checkpoint(CheckpointWriter& writer) const
+{
+    uint64 sample_count;
+    auto_ptr<Tile> fb;
+
+    // Copy the framebuffer under the lock, but compress and write it after releasing it
+    // such that worker threads are not kept from storing samples during disk I/O.
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        sample_count = m_sample_count;
+        fb.reset(new Tile(m_fb));
+    }
+
+    writer.write(sample_count);
+    writer.write_tile(*fb);
+}
+
+void GlobalSampleAccumulationBuffer::read_checkpoint(CheckpointReader& reader)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    reader.read(m_sample_count);
+    reader.read_tile(m_fb);
+
+    m_developed_sample_count = 0;
+    mark_all_dirty_no_lock();
+}
+
 void GlobalSampleAccumulationBuffer::develop_to_tile(
     Tile&           tile,
     const size_t    origin_x,
@@ -44,8 +44,10 @@
 
 // Forward declarations.
 namespace foundation    { class Tile; }
+namespace renderer      { class CheckpointReader; }
+namespace renderer      { class CheckpointWriter; }
 namespace renderer      { class Frame; }
-namespace renderer      { class Sample; }
+namespace renderer      { class SampleBatch; }
 
 namespace renderer
 {
@@ -58,6 +60,8 @@ class GlobalSampleAccumulationBuffer
     GlobalSampleAccumulationBuffer(
         const size_t                width,
         const size_t                height,
+        const size_t                tile_width,
+        const size_t                tile_height,
         const foundation::Filter2d& filter);
 
     // Reset the buffer to its initial state. Thread-safe.
@@ -65,11 +69,18 @@ class GlobalSampleAccumulationBuffer
 
     // Store @samples into the buffer. Thread-safe.
     virtual void store_samples(
-        const size_t                sample_count,
-        const Sample                samples[]) OVERRIDE;
+        const SampleBatch&          samples) OVERRIDE;
 
-    // Develop the buffer to a frame. Thread-safe.
-    virtual void develop_to_frame(Frame& frame) OVERRIDE;
+    // Develop the dirty tiles of the buffer to a frame. Thread-safe.
+    virtual void develop_to_frame(
+        Frame&                      frame,
+        TileCoordinateArray&        tiles) OVERRIDE;
+
+    // Write the contents of the buffer to a checkpoint. Thread-safe.
+    virtual void write_checkpoint(CheckpointWriter& writer) const OVERRIDE;
+
+    // Restore the contents of the buffer from a checkpoint. Thread-safe.
+    virtual void read_checkpoint(CheckpointReader& reader) OVERRIDE;
 
     // Increment the number of samples used for pixel values renormalization. Thread-safe.
     void increment_sample_count(const foundation::uint64 delta_sample_count);
@@ -77,6 +88,7 @@ class GlobalSampleAccumulationBuffer
   private:
     foundation::FilteredTile        m_fb;
     const float                     m_filter_rcp_norm_factor;
+    foundation::uint64              m_developed_sample_count;
 
     void develop_to_tile(
         foundation::Tile&           tile,
@@ -39,6 +39,8 @@
 // Forward declarations.
 namespace foundation    { class AbortSwitch; }
 namespace foundation    { class JobQueue; }
+namespace renderer      { class CheckpointReader; }
+namespace renderer      { class CheckpointWriter; }
 namespace renderer      { class Frame; }
 
 namespace renderer
@@ -54,17 +56,37 @@ class DLLSYMBOL IPassCallback
   : public foundation::IUnknown
 {
   public:
-    // This method is called at the beginning of a pass.
+    // This method is called at the beginning of a pass, before the tile jobs are scheduled.
     virtual void pre_render(
         const Frame&                frame,
         foundation::JobQueue&       job_queue,
         foundation::AbortSwitch&    abort_switch) = 0;
 
+    // This method is called once the tile jobs of a pass are scheduled. Jobs scheduled
+    // by this method are picked up by the worker threads as they run out of tile jobs;
+    // they are guaranteed to have completed by the time post_render() is called.
+    virtual void schedule_background_jobs(
+        const Frame&                frame,
+        foundation::JobQueue&       job_queue,
+        foundation::AbortSwitch&    abort_switch) {}
+
     // This method is called at the end of a pass.
     virtual void post_render(
         const Frame&                frame,
         foundation::JobQueue&       job_queue,
         foundation::AbortSwitch&    abort_switch) = 0;
+
+    // Write the state carried over from one pass to the next to a checkpoint.
+    // This method is called between passes.
+    virtual void write_checkpoint(CheckpointWriter& writer) const {}
+
+    // Restore the state written by write_checkpoint() before rendering resumes.
+    // Throws foundation::ExceptionIOError on failure.
+    virtual void read_checkpoint(CheckpointReader& reader) {}
+
+    // Discard the state carried over from one pass to the next so that the
+    // next frame of a sequence is rendered from scratch.
+    virtual void reset() {}
 };
 
 }       // namespace renderer
@@ -56,6 +56,11 @@ class DLLSYMBOL IRendererController
     // This method is called after rendering was aborted.
     virtual void on_rendering_abort() = 0;
 
+    // This method is called before the scene is set up for a frame, that is, before scene
+    // entities inputs are bound and before the acceleration structures and the light sampler
+    // are built or updated. Changes to the scene geometry must be made in this method.
+    virtual void on_frame_setup() = 0;
+
     // This method is called before rendering a single frame.
     virtual void on_frame_begin() = 0;
 
@@ -82,6 +87,12 @@ class DLLSYMBOL IRendererController
 
     // This method is called continuously during rendering.
     virtual Status on_progress() = 0;
+
+    // This method is called when a frame has been completely rendered, before on_frame_end().
+    // Return TerminateRendering to end the frame sequence, RestartRendering to render another
+    // frame while keeping the rendering components alive, or ReinitializeRendering to render
+    // another frame after rebuilding them.
+    virtual Status on_frame_complete() = 0;
 };
 
 }       // namespace renderer
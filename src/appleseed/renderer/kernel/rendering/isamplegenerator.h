@@ -55,6 +55,14 @@ class ISampleGenerator
     // Reset the sample generator to its initial state.
     virtual void reset() = 0;
 
+    // Reset the sample generator, then skip the sequence indices below @sequence_offset
+    // such as not to regenerate samples of a render resumed from a checkpoint.
+    virtual void resume(const size_t sequence_offset) = 0;
+
+    // Return a sequence index larger than all the ones of the samples stored so far.
+    // May be called from another thread while samples are being generated.
+    virtual size_t get_sequence_end() const = 0;
+
     // Generate a given number of samples and accumulate them into a buffer.
     virtual void generate_samples(
         const size_t                sample_count,
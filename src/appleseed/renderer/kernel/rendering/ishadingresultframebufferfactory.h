@@ -38,6 +38,8 @@
 #include <cstddef>
 
 // Forward declarations.
+namespace renderer  { class CheckpointReader; }
+namespace renderer  { class CheckpointWriter; }
 namespace renderer  { class Frame; }
 namespace renderer  { class ShadingResultFrameBuffer; }
 
@@ -56,6 +58,19 @@ class IShadingResultFrameBufferFactory
 
     virtual void destroy(
         ShadingResultFrameBuffer*   framebuffer) = 0;
+
+    // Release the framebuffers that persist from one pass to the next, if any.
+    virtual void clear() = 0;
+
+    // Write the framebuffers that persist from one pass to the next to a checkpoint.
+    virtual void write_checkpoint(
+        CheckpointWriter&           writer) const = 0;
+
+    // Restore the framebuffers written by write_checkpoint().
+    // Throws foundation::ExceptionIOError on failure.
+    virtual void read_checkpoint(
+        const Frame&                frame,
+        CheckpointReader&           reader) = 0;
 };
 
 }       // namespace renderer
@@ -32,6 +32,8 @@
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/iunknown.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/containers/array.h"
 
 // appleseed.main headers.
 #include "main/dllsymbol.h"
@@ -45,6 +47,13 @@ namespace renderer  { class Frame; }
 namespace renderer
 {
 
+//
+// An array of tile coordinates.
+//
+
+DECLARE_ARRAY(TileCoordinateArray, foundation::Vector2u);
+
+
 //
 // Tile callback interface.
 //
@@ -76,6 +85,13 @@ class DLLSYMBOL ITileCallback
     // Only whole-frame (progressive) renderers call this method.
     virtual void post_render(
         const Frame*    frame) = 0;
+
+    // This method is called after a pass of a progressive renderer with the
+    // coordinates of the tiles that changed since the previous pass. Tiles
+    // that are not listed hold the same pixels as after the previous call.
+    virtual void post_render(
+        const Frame*                frame,
+        const TileCoordinateArray&  tiles) = 0;
 };
 
 
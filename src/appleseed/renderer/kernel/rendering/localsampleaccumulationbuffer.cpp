@@ -31,10 +31,12 @@
 #include "localsampleaccumulationbuffer.h"
 
 // appleseed.renderer headers.
+#include "renderer/kernel/rendering/checkpoint.h"
 #include "renderer/kernel/rendering/sample.h"
 #include "renderer/modeling/frame/frame.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/exceptions/exceptionioerror.h"
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/color.h"
 #include "foundation/image/filteredtile.h"
@@ -44,10 +46,12 @@
 #include "foundation/math/aabb.h"
 #include "foundation/math/scalar.h"
 #include "foundation/platform/thread.h"
+#include "foundation/platform/types.h"
 
 // Standard headers.
 #include <algorithm>
 #include <cassert>
+#include <vector>
 
 using namespace foundation;
 using namespace std;
@@ -72,11 +76,18 @@ namespace renderer
 //   pushing samples to and the level that is displayed.  As soon as a level contains enough
 //   samples, it becomes the new active level.
 //
+//   While a coarse level is displayed, every sample affects a large area of the frame and
+//   the displayed level may change at any time, so all tiles are considered dirty. Once
+//   the highest resolution level is active, only the tiles touched by samples are dirty.
+//
 
 LocalSampleAccumulationBuffer::LocalSampleAccumulationBuffer(
     const size_t    width,
     const size_t    height,
+    const size_t    tile_width,
+    const size_t    tile_height,
     const Filter2d& filter)
+  : SampleAccumulationBuffer(width, height, tile_width, tile_height)
 {
     const size_t MinSize = 32;
 
@@ -94,6 +105,8 @@ LocalSampleAccumulationBuffer::LocalSampleAccumulationBuffer(
 
         m_remaining_pixels.push_back(level_width * level_height);
 
+        m_memory_account.set_size(m_memory_account.get_size() + m_levels.back()->get_memory_size());
+
         if (level_width <= MinSize * 2 || level_height <= MinSize * 2)
             break;
 
@@ -127,55 +140,89 @@ void LocalSampleAccumulationBuffer::clear()
 }
 
 void LocalSampleAccumulationBuffer::store_samples(
-    const size_t    sample_count,
-    const Sample    samples[])
+    const SampleBatch&  samples)
 {
+    const size_t sample_count = samples.size();
+
+    if (sample_count == 0)
+        return;
+
     boost::mutex::scoped_lock lock(m_mutex);
 
-    const Sample* sample_end = samples + sample_count;
+    const float* x = samples.get_x();
+    const float* y = samples.get_y();
 
     if (m_active_level == 0)
     {
         FilteredTile* level = m_levels[0];
 
+        // Splat the samples into the highest resolution level.
+        const float* values[4] =
+        {
+            samples.get_channel(0),
+            samples.get_channel(1),
+            samples.get_channel(2),
+            samples.get_channel(3)
+        };
+        level->add(sample_count, x, y, values);
+
         const double level_width = static_cast<double>(level->get_width());
         const double level_height = static_cast<double>(level->get_height());
+        const double xradius = level->get_filter().get_xradius();
+        const double yradius = level->get_filter().get_yradius();
 
-        for (const Sample* sample_ptr = samples; sample_ptr < sample_end; ++sample_ptr)
-        {
-            const double fx = sample_ptr->m_position.x * level_width;
-            const double fy = sample_ptr->m_position.y * level_height;
-
-            level->add(fx, fy, &sample_ptr->m_color[0]);
-        }
+        for (size_t i = 0; i < sample_count; ++i)
+            mark_dirty_no_lock(x[i] * level_width, y[i] * level_height, xradius, yradius);
     }
     else
     {
-        for (const Sample* sample_ptr = samples; sample_ptr < sample_end; ++sample_ptr)
+        mark_all_dirty_no_lock();
+
+        size_t begin = 0;
+
+        while (begin < sample_count)
         {
-            for (size_t level_index = 0; level_index <= m_active_level; ++level_index)
-            {
-                FilteredTile* level = m_levels[level_index];
+            // Find the number of samples stored before a level gets completed, and the
+            // finest level completed by the last of these samples, if any.
+            size_t count = sample_count - begin;
+            size_t completed_level = m_active_level + 1;
 
-                const double fx = sample_ptr->m_position.x * level->get_width();
-                const double fy = sample_ptr->m_position.y * level->get_height();
+            for (size_t level_index = m_active_level + 1; level_index-- > 0; )
+            {
+                const size_t remaining_pixels = m_remaining_pixels[level_index];
 
-                level->add(fx, fy, &sample_ptr->m_color[0]);
+                if (remaining_pixels > 0 && remaining_pixels <= count)
+                {
+                    count = remaining_pixels;
+                    completed_level = level_index;
+                }
+            }
 
-                size_t& remaining_pixels = m_remaining_pixels[level_index];
+            const float* values[4] =
+            {
+                samples.get_channel(0) + begin,
+                samples.get_channel(1) + begin,
+                samples.get_channel(2) + begin,
+                samples.get_channel(3) + begin
+            };
 
-                if (remaining_pixels > 0)
-                    --remaining_pixels;
+            for (size_t level_index = 0; level_index <= m_active_level; ++level_index)
+            {
+                // Levels coarser than the completed level don't receive the sample that completes it.
+                const size_t level_sample_count =
+                    level_index > completed_level ? count - 1 : count;
 
-                if (remaining_pixels == 0)
-                {
-                    // We just completed this level: make it the new active level.
-                    m_active_level = level_index;
+                m_levels[level_index]->add(level_sample_count, x + begin, y + begin, values);
 
-                    // No need to fill the coarser levels anymore.
-                    break;
-                }
+                size_t& remaining_pixels = m_remaining_pixels[level_index];
+                remaining_pixels -= min(remaining_pixels, level_sample_count);
             }
+
+            // Make the completed level the new active level.
+            if (completed_level < m_active_level)
+                m_active_level = completed_level;
+
+            begin += count;
         }
     }
 
@@ -234,7 +281,9 @@ namespace
     }
 }
 
-void LocalSampleAccumulationBuffer::develop_to_frame(Frame& frame)
+void LocalSampleAccumulationBuffer::develop_to_frame(
+    Frame&                  frame,
+    TileCoordinateArray&    tiles)
 {
     boost::mutex::scoped_lock lock(m_mutex);
 
@@ -250,25 +299,104 @@ void LocalSampleAccumulationBuffer::develop_to_frame(Frame& frame)
 
     const FilteredTile& level = find_display_level();
 
-    for (size_t ty = 0; ty < frame_props.m_tile_count_y; ++ty)
+    collect_dirty_tiles_no_lock(tiles);
+
+    for (size_t i = 0; i < tiles.size(); ++i)
     {
-        for (size_t tx = 0; tx < frame_props.m_tile_count_x; ++tx)
+        const size_t tx = tiles[i].x;
+        const size_t ty = tiles[i].y;
+
+        Tile& tile = image.tile(tx, ty);
+
+        const size_t origin_x = tx * frame_props.m_tile_width;
+        const size_t origin_y = ty * frame_props.m_tile_height;
+
+        develop_to_tile(
+            tile,
+            frame_props.m_canvas_width,
+            frame_props.m_canvas_height,
+            level,
+            origin_x, origin_y,
+            crop_window,
+            undo_premultiplied_alpha);
+    }
+}
+
+void LocalSampleAccumulationBuffer::write_checkpoint(CheckpointWriter& writer) const
+{
+    uint64 sample_count;
+    size_t active_level;
+    vector<uint64> remaining_pixels;
+    vector<vector<uint8> > level_pixels;
+
+    // Copy the levels under the lock, but compress and write them after releasing it
+    // such that worker threads are not kept from storing samples during disk I/O.
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        sample_count = m_sample_count;
+        active_level = m_active_level;
+
+        // Levels coarser than the active level are not used anymore.
+        level_pixels.resize(active_level + 1);
+        for (size_t level_index = 0; level_index <= active_level; ++level_index)
         {
-            Tile& tile = image.tile(tx, ty);
-
-            const size_t origin_x = tx * frame_props.m_tile_width;
-            const size_t origin_y = ty * frame_props.m_tile_height;
-
-            develop_to_tile(
-                tile,
-                frame_props.m_canvas_width,
-                frame_props.m_canvas_height,
-                level,
-                origin_x, origin_y,
-                crop_window,
-                undo_premultiplied_alpha);
+            const FilteredTile& level = *m_levels[level_index];
+            remaining_pixels.push_back(static_cast<uint64>(m_remaining_pixels[level_index]));
+            level_pixels[level_index].assign(level.get_storage(), level.get_storage() + level.get_size());
         }
     }
+
+    writer.write(sample_count);
+    writer.write(static_cast<uint32>(m_levels.size()));
+    writer.write(static_cast<uint32>(active_level));
+
+    for (size_t level_index = 0; level_index <= active_level; ++level_index)
+    {
+        const FilteredTile& level = *m_levels[level_index];
+
+        writer.write(remaining_pixels[level_index]);
+        writer.write_tile(
+            Tile(
+                level.get_width(),
+                level.get_height(),
+                level.get_channel_count(),
+                level.get_pixel_format(),
+                &level_pixels[level_index][0]));
+    }
+}
+
+void LocalSampleAccumulationBuffer::read_checkpoint(CheckpointReader& reader)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    uint32 level_count, active_level;
+    reader.read(m_sample_count);
+    reader.read(level_count);
+    reader.read(active_level);
+
+    if (level_count != m_levels.size() || active_level >= level_count)
+        throw ExceptionIOError("checkpoint does not match the render settings");
+
+    for (size_t level_index = 0; level_index < m_levels.size(); ++level_index)
+    {
+        if (level_index <= active_level)
+        {
+            uint64 remaining_pixels;
+            reader.read(remaining_pixels);
+            reader.read_tile(*m_levels[level_index]);
+            m_remaining_pixels[level_index] = static_cast<size_t>(remaining_pixels);
+        }
+        else
+        {
+            m_levels[level_index]->clear();
+            m_remaining_pixels[level_index] = m_levels[level_index]->get_pixel_count();
+        }
+    }
+
+    m_active_level = active_level;
+
+    mark_all_dirty_no_lock();
 }
 
 const FilteredTile& LocalSampleAccumulationBuffer::find_display_level() const
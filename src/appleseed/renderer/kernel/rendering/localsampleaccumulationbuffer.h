@@ -43,8 +43,10 @@
 
 // Forward declarations.
 namespace foundation    { class FilteredTile; }
+namespace renderer      { class CheckpointReader; }
+namespace renderer      { class CheckpointWriter; }
 namespace renderer      { class Frame; }
-namespace renderer      { class Sample; }
+namespace renderer      { class SampleBatch; }
 
 namespace renderer
 {
@@ -57,6 +59,8 @@ class LocalSampleAccumulationBuffer
     LocalSampleAccumulationBuffer(
         const size_t                        width,
         const size_t                        height,
+        const size_t                        tile_width,
+        const size_t                        tile_height,
         const foundation::Filter2d&         filter);
 
     // Destructor.
@@ -67,11 +71,18 @@ class LocalSampleAccumulationBuffer
 
     // Store @samples into the buffer. Thread-safe.
     virtual void store_samples(
-        const size_t                        sample_count,
-        const Sample                        samples[]) OVERRIDE;
+        const SampleBatch&                  samples) OVERRIDE;
 
-    // Develop the buffer to a frame. Thread-safe.
-    virtual void develop_to_frame(Frame& frame) OVERRIDE;
+    // Develop the dirty tiles of the buffer to a frame. Thread-safe.
+    virtual void develop_to_frame(
+        Frame&                              frame,
+        TileCoordinateArray&                tiles) OVERRIDE;
+
+    // Write the contents of the buffer to a checkpoint. Thread-safe.
+    virtual void write_checkpoint(CheckpointWriter& writer) const OVERRIDE;
+
+    // Restore the contents of the buffer from a checkpoint. Thread-safe.
+    virtual void read_checkpoint(CheckpointReader& reader) OVERRIDE;
 
   private:
     std::vector<foundation::FilteredTile*>  m_levels;
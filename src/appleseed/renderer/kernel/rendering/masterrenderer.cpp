@@ -30,6 +30,8 @@
 #include "masterrenderer.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globalmemory.h"
+#include "renderer/kernel/intersection/tracecontext.h"
 #include "renderer/kernel/lighting/drt/drtlightingengine.h"
 #include "renderer/kernel/lighting/lighttracing/lighttracingsamplegenerator.h"
 #include "renderer/kernel/lighting/pt/ptlightingengine.h"
@@ -77,8 +79,11 @@
 // appleseed.foundation headers.
 #include "foundation/platform/compiler.h"
 #include "foundation/platform/thread.h"
+#include "foundation/utility/eventtracer.h"
 #include "foundation/utility/job/abortswitch.h"
 #include "foundation/utility/searchpaths.h"
+#include "foundation/utility/statistics.h"
+#include "foundation/utility/stopwatch.h"
 
 // boost headers.
 #include "boost/filesystem/path.hpp"
@@ -105,14 +110,19 @@ MasterRenderer::MasterRenderer(
     const ParamArray&       params,
     IRendererController*    renderer_controller,
     ITileCallbackFactory*   tile_callback_factory,
-    AbortSwitch*            abort_switch)
+    AbortSwitch*            abort_switch,
+    TextureStore*           texture_store)
   : m_project(project)
   , m_params(params)
   , m_renderer_controller(renderer_controller)
   , m_tile_callback_factory(tile_callback_factory)
   , m_abort_switch(abort_switch)
+  , m_phase_times()
+  , m_ray_stats()
   , m_serial_renderer_controller(0)
   , m_serial_tile_callback_factory(0)
+  , m_texture_store(texture_store)
+  , m_owned_texture_store(0)
 #ifdef WITH_OSL
   , m_texture_cache_size(0)
 #endif
@@ -124,12 +134,17 @@ MasterRenderer::MasterRenderer(
     const ParamArray&       params,
     IRendererController*    renderer_controller,
     ITileCallback*          tile_callback,
-    AbortSwitch*            abort_switch)
+    AbortSwitch*            abort_switch,
+    TextureStore*           texture_store)
   : m_project(project)
   , m_params(params)
   , m_abort_switch(abort_switch)
+  , m_phase_times()
+  , m_ray_stats()
   , m_serial_renderer_controller(new SerialRendererController(renderer_controller, tile_callback))
   , m_serial_tile_callback_factory(new SerialTileCallbackFactory(m_serial_renderer_controller))
+  , m_texture_store(texture_store)
+  , m_owned_texture_store(0)
 {
     m_renderer_controller = m_serial_renderer_controller;
     m_tile_callback_factory = m_serial_tile_callback_factory;
@@ -137,6 +152,7 @@ MasterRenderer::MasterRenderer(
 
 MasterRenderer::~MasterRenderer()
 {
+    delete m_owned_texture_store;
     delete m_serial_tile_callback_factory;
     delete m_serial_renderer_controller;
 }
@@ -151,11 +167,26 @@ const ParamArray& MasterRenderer::get_parameters() const
     return m_params;
 }
 
+const MasterRenderer::PhaseTimes& MasterRenderer::get_phase_times() const
+{
+    return m_phase_times;
+}
+
+const RayStatistics& MasterRenderer::get_ray_statistics() const
+{
+    return m_ray_stats;
+}
+
 bool MasterRenderer::render()
 {
+    m_phase_times = PhaseTimes();
+    m_ray_stats.clear();
+
     try
     {
         do_render();
+        print_phase_times();
+        print_ray_statistics();
         return true;
     }
     catch (const bad_alloc&)
@@ -186,8 +217,22 @@ void MasterRenderer::do_render()
     {
         m_renderer_controller->on_rendering_begin();
 
+        // Intersectors merge their ray statistics into the trace context when they are destroyed,
+        // that is, when the rendering components go out of scope at the end of the frame sequence.
+        const RayStatistics initial_ray_stats =
+            m_project.has_trace_context()
+                ? m_project.get_trace_context().get_ray_statistics()
+                : RayStatistics();
+
         const IRendererController::Status status = initialize_and_render_frame_sequence();
 
+        if (m_project.has_trace_context())
+        {
+            RayStatistics ray_stats = m_project.get_trace_context().get_ray_statistics();
+            ray_stats -= initial_ray_stats;
+            m_ray_stats += ray_stats;
+        }
+
         switch (status)
         {
           case IRendererController::TerminateRendering:
@@ -208,6 +253,8 @@ void MasterRenderer::do_render()
 
 namespace
 {
+    typedef Stopwatch<DefaultWallclockTimer> StopwatchType;
+
     void copy_param(
         ParamArray&             dest,
         const ParamArray&       source,
@@ -217,6 +264,28 @@ namespace
             dest.strings().insert(param_name, source.strings().get(param_name));
     }
 
+    // Binds a texture store to a scene for the duration of a render.
+    class TextureStoreBinding
+      : public NonCopyable
+    {
+      public:
+        TextureStoreBinding(
+            TextureStore&       texture_store,
+            const Scene&        scene)
+          : m_texture_store(texture_store)
+        {
+            m_texture_store.bind_scene(scene);
+        }
+
+        ~TextureStoreBinding()
+        {
+            m_texture_store.unbind_scene();
+        }
+
+      private:
+        TextureStore&           m_texture_store;
+    };
+
 #ifdef WITH_OSL
 
     void destroy_osl_shading_system(
@@ -354,25 +423,52 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
 
 #endif  // WITH_OSL
 
+    StopwatchType stopwatch;
+
+    // Let the renderer controller modify the scene before anything is derived from it.
+    m_renderer_controller->on_frame_setup();
+
+    const Scene& scene = *m_project.get_scene();
+
+    // Create the texture store the first time it is needed, it is then kept across renders.
+    if (m_texture_store == 0)
+    {
+        m_owned_texture_store = new TextureStore(m_params.child("texture_store"));
+        m_texture_store = m_owned_texture_store;
+    }
+
+    TextureStore& texture_store = *m_texture_store;
+    texture_store.set_memory_limit(
+        m_params.child("texture_store").get_optional<size_t>(
+            "max_size",
+            texture_store.get_memory_limit()));
+
+    // Bind the texture store before entity inputs: binding makes textures whose file was
+    // modified reopen it, and texture sources retrieve texture properties when created.
+    const TextureStoreBinding texture_store_binding(texture_store, scene);
+
     // We start by binding entities inputs. This must be done before creating/updating the trace context.
-    if (!bind_scene_entities_inputs())
+    stopwatch.start();
+    const bool inputs_bound = bind_scene_entities_inputs();
+    m_phase_times.m_input_binding += stopwatch.measure().get_seconds();
+    if (!inputs_bound)
         return IRendererController::AbortRendering;
 
     m_project.create_aov_images();
-    m_project.update_trace_context();
 
-    const Scene& scene = *m_project.get_scene();
+    stopwatch.start();
+    m_project.update_trace_context();
+    m_phase_times.m_trace_context += stopwatch.measure().get_seconds();
 
     Frame& frame = *m_project.get_frame();
     frame.print_settings();
 
     const TraceContext& trace_context = m_project.get_trace_context();
 
-    // Create the texture store.
-    TextureStore texture_store(scene, m_params.child("texture_store"));
-
     // Create the light sampler.
+    stopwatch.start();
     LightSampler light_sampler(scene, m_params.child("light_sampler"));
+    m_phase_times.m_light_sampler += stopwatch.measure().get_seconds();
 
     // Create the shading engine.
     ShadingEngine shading_engine(m_params.child("shading_engine"));
@@ -402,7 +498,11 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
         }
         else if (value == "sppm")
         {
-            const SPPMParameters params(m_params.child("sppm"));
+            ParamArray sppm_params = m_params.child("sppm");
+            copy_param(sppm_params, m_params, "sampling_mode");
+            copy_param(sppm_params, m_params.child("generic_frame_renderer"), "passes");
+
+            const SPPMParameters params(sppm_params);
 
             SPPMPassCallback* sppm_pass_callback =
                 new SPPMPassCallback(
@@ -483,13 +583,20 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
 
         if (value == "generic")
         {
+            ParamArray params = m_params.child("generic_sample_generator");
+            copy_param(params, m_params, "sampling_mode");
+
             sample_generator_factory.reset(
                 new GenericSampleGeneratorFactory(
                     frame,
-                    sample_renderer_factory.get()));
+                    sample_renderer_factory.get(),
+                    params));
         }
         else if (value == "lighttracing")
         {
+            ParamArray params = m_params.child("lighttracing_sample_generator");
+            copy_param(params, m_params, "sampling_mode");
+
             sample_generator_factory.reset(
                 new LightTracingSampleGeneratorFactory(
                     scene,
@@ -500,7 +607,7 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
 #ifdef WITH_OSL
                     *shading_system,
 #endif
-                    m_params.child("lighttracing_sample_generator")));
+                    params));
         }
         else if (!value.empty())
         {
@@ -522,18 +629,24 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
 
         if (value == "uniform")
         {
+            ParamArray params = m_params.child("uniform_pixel_renderer");
+            copy_param(params, m_params, "sampling_mode");
+
             pixel_renderer_factory.reset(
                 new UniformPixelRendererFactory(
                     sample_renderer_factory.get(),
-                    m_params.child("uniform_pixel_renderer")));
+                    params));
         }
         else if (value == "adaptive")
         {
+            ParamArray params = m_params.child("adaptive_pixel_renderer");
+            copy_param(params, m_params, "sampling_mode");
+
             pixel_renderer_factory.reset(
                 new AdaptivePixelRendererFactory(
                     frame,
                     sample_renderer_factory.get(),
-                    m_params.child("adaptive_pixel_renderer")));
+                    params));
         }
         else if (!value.empty())
         {
@@ -621,6 +734,10 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
         {
             ParamArray params = m_params.child("generic_frame_renderer");
             copy_param(params, m_params, "rendering_threads");
+            copy_param(params, m_params, "pin_rendering_threads");
+            copy_param(params, m_params, "checkpoint_file");
+            copy_param(params, m_params, "checkpoint_interval");
+            copy_param(params, m_params, "resume_from_checkpoint");
 
             frame_renderer.reset(
                 GenericFrameRendererFactory::create(
@@ -628,12 +745,17 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
                     tile_renderer_factory.get(),
                     m_tile_callback_factory,
                     pass_callback.get(),
+                    shading_result_framebuffer_factory.get(),
                     params));
         }
         else if (value == "progressive")
         {
             ParamArray params = m_params.child("progressive_frame_renderer");
             copy_param(params, m_params, "rendering_threads");
+            copy_param(params, m_params, "pin_rendering_threads");
+            copy_param(params, m_params, "checkpoint_file");
+            copy_param(params, m_params, "checkpoint_interval");
+            copy_param(params, m_params, "resume_from_checkpoint");
 
             frame_renderer.reset(
                 ProgressiveFrameRendererFactory::create(
@@ -655,7 +777,9 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
     // Execute the main rendering loop.
     const IRendererController::Status status =
         render_frame_sequence(
-            frame_renderer.get()
+            frame_renderer.get(),
+            pass_callback.get(),
+            shading_result_framebuffer_factory.get()
 #ifdef WITH_OSL
             , *shading_system
 #endif
@@ -664,31 +788,76 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
     // Print texture store performance statistics.
     RENDERER_LOG_DEBUG("%s", texture_store.get_statistics().to_string().c_str());
 
+    // Print memory usage statistics.
+    RENDERER_LOG_INFO("%s",
+        StatisticsVector::make(
+            "memory statistics",
+            get_memory_statistics()).to_string().c_str());
+
     return status;
 }
 
 IRendererController::Status MasterRenderer::render_frame_sequence(
-    IFrameRenderer*         frame_renderer
+    IFrameRenderer*         frame_renderer,
+    IPassCallback*          pass_callback,
+    IShadingResultFrameBufferFactory*
+                            framebuffer_factory
 #ifdef WITH_OSL
     , OSL::ShadingSystem&   shading_system
 #endif
     )
 {
+    StopwatchType stopwatch;
+    bool scene_modified = false;
+
     while (true)
     {
         assert(!frame_renderer->is_rendering());
 
+        // When moving to the next frame of a sequence, let the renderer controller modify the
+        // scene more deeply (e.g. move assembly instances or swap objects), then bind inputs
+        // again and update the trace context: only the acceleration structures of modified
+        // assemblies are rebuilt. The first frame was set up when the rendering components
+        // were created.
+        if (scene_modified)
+        {
+            m_renderer_controller->on_frame_setup();
+
+            stopwatch.start();
+            const bool inputs_bound = bind_scene_entities_inputs();
+            m_phase_times.m_input_binding += stopwatch.measure().get_seconds();
+
+            if (!inputs_bound)
+                return IRendererController::AbortRendering;
+
+            stopwatch.start();
+            m_project.update_trace_context();
+            m_phase_times.m_trace_context += stopwatch.measure().get_seconds();
+
+            // Passes of the new frame must not accumulate on top of the previous frame.
+            if (pass_callback)
+                pass_callback->reset();
+            if (framebuffer_factory)
+                framebuffer_factory->clear();
+        }
+
         // The on_frame_begin() method of the renderer controller might alter the scene
         // (e.g. transform the camera), thus it needs to be called before the on_frame_begin()
         // of the scene which assumes the scene is up-to-date and ready to be rendered.
         m_renderer_controller->on_frame_begin();
 
         // Prepare the scene for rendering. Don't proceed if that failed.
+        stopwatch.start();
 #ifdef WITH_OSL
-        if (!m_project.get_scene()->on_frame_begin(m_project, &shading_system, m_abort_switch))
+        const bool scene_prepared =
+            m_project.get_scene()->on_frame_begin(m_project, &shading_system, m_abort_switch);
 #else
-        if (!m_project.get_scene()->on_frame_begin(m_project, m_abort_switch))
+        const bool scene_prepared =
+            m_project.get_scene()->on_frame_begin(m_project, m_abort_switch);
 #endif
+        m_phase_times.m_frame_preparation += stopwatch.measure().get_seconds();
+
+        if (!scene_prepared)
         {
             m_renderer_controller->on_frame_end();
             return IRendererController::AbortRendering;
@@ -701,9 +870,12 @@ IRendererController::Status MasterRenderer::render_frame_sequence(
             return m_renderer_controller->on_progress();
         }
 
+        stopwatch.start();
         frame_renderer->start_rendering();
 
-        const IRendererController::Status status = wait_for_event(frame_renderer);
+        bool frame_completed;
+        const IRendererController::Status status =
+            wait_for_event(frame_renderer, frame_completed);
 
         switch (status)
         {
@@ -722,6 +894,8 @@ IRendererController::Status MasterRenderer::render_frame_sequence(
 
         assert(!frame_renderer->is_rendering());
 
+        m_phase_times.m_rendering += stopwatch.measure().get_seconds();
+
         m_project.get_scene()->on_frame_end(m_project);
         m_renderer_controller->on_frame_end();
 
@@ -733,6 +907,7 @@ IRendererController::Status MasterRenderer::render_frame_sequence(
             return status;
 
           case IRendererController::RestartRendering:
+            scene_modified = frame_completed;
             break;
 
           assert_otherwise;
@@ -740,8 +915,12 @@ IRendererController::Status MasterRenderer::render_frame_sequence(
     }
 }
 
-IRendererController::Status MasterRenderer::wait_for_event(IFrameRenderer* frame_renderer) const
+IRendererController::Status MasterRenderer::wait_for_event(
+    IFrameRenderer*         frame_renderer,
+    bool&                   frame_completed) const
 {
+    frame_completed = false;
+
     while (frame_renderer->is_rendering())
     {
         // Make sure to retrieve the status *after* having checked the abort switch.
@@ -754,11 +933,41 @@ IRendererController::Status MasterRenderer::wait_for_event(IFrameRenderer* frame
             return status;
     }
 
-    return IRendererController::TerminateRendering;
+    // The frame was completely rendered, let the renderer controller decide what comes next.
+    frame_completed = true;
+    const IRendererController::Status status = m_renderer_controller->on_frame_complete();
+    assert(status != IRendererController::ContinueRendering);
+
+    return status;
+}
+
+void MasterRenderer::print_phase_times() const
+{
+    Statistics stats;
+    stats.insert_time("input binding", m_phase_times.m_input_binding);
+    stats.insert_time("trace context", m_phase_times.m_trace_context);
+    stats.insert_time("light sampler", m_phase_times.m_light_sampler);
+    stats.insert_time("frame preparation", m_phase_times.m_frame_preparation);
+    stats.insert_time("rendering", m_phase_times.m_rendering);
+
+    RENDERER_LOG_DEBUG("%s",
+        StatisticsVector::make(
+            "rendering phases statistics",
+            stats).to_string().c_str());
+}
+
+void MasterRenderer::print_ray_statistics() const
+{
+    RENDERER_LOG_DEBUG("%s",
+        StatisticsVector::make(
+            "ray statistics",
+            m_ray_stats.get_statistics(m_phase_times.m_rendering)).to_string().c_str());
 }
 
 bool MasterRenderer::bind_scene_entities_inputs() const
 {
+    const ScopedEvent event("bind inputs", "rendering");
+
     InputBinder input_binder;
     input_binder.bind(*m_project.get_scene());
     return input_binder.get_error_count() == 0;
@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/global.h"
+#include "renderer/kernel/intersection/raystatistics.h"
 #include "renderer/kernel/rendering/irenderercontroller.h"
 
 // appleseed.main headers.
@@ -50,10 +51,13 @@
 // Forward declarations.
 namespace foundation    { class AbortSwitch; }
 namespace renderer      { class IFrameRenderer; }
+namespace renderer      { class IPassCallback; }
+namespace renderer      { class IShadingResultFrameBufferFactory; }
 namespace renderer      { class ITileCallbackFactory; }
 namespace renderer      { class ITileCallback; }
 namespace renderer      { class Project; }
 namespace renderer      { class SerialRendererController; }
+namespace renderer      { class TextureStore; }
 
 namespace renderer
 {
@@ -66,13 +70,16 @@ class DLLSYMBOL MasterRenderer
   : public foundation::NonCopyable
 {
   public:
-    // Constructor.
+    // Constructor. If @texture_store is provided, it is used by all renders
+    // instead of the texture store owned by the master renderer; in both cases
+    // texture tiles loaded by a render are reused by the following ones.
     MasterRenderer(
         Project&                    project,
         const ParamArray&           params,
         IRendererController*        renderer_controller,
         ITileCallbackFactory*       tile_callback_factory = 0,
-        foundation::AbortSwitch*    abort_switch = 0);
+        foundation::AbortSwitch*    abort_switch = 0,
+        TextureStore*               texture_store = 0);
 
     // Constructor for serial tile callbacks.
     MasterRenderer(
@@ -80,7 +87,8 @@ class DLLSYMBOL MasterRenderer
         const ParamArray&           params,
         IRendererController*        renderer_controller,
         ITileCallback*              tile_callback,
-        foundation::AbortSwitch*    abort_switch = 0);
+        foundation::AbortSwitch*    abort_switch = 0,
+        TextureStore*               texture_store = 0);
 
     // Destructor.
     ~MasterRenderer();
@@ -92,17 +100,39 @@ class DLLSYMBOL MasterRenderer
     // Render the project. Return true on success, false otherwise.
     bool render();
 
+    // Durations (in seconds) of the phases of the last call to render().
+    struct PhaseTimes
+    {
+        double  m_input_binding;                // binding scene entities inputs
+        double  m_trace_context;                // building or updating acceleration structures
+        double  m_light_sampler;                // building the light sampler
+        double  m_frame_preparation;            // preparing the scene for rendering
+        double  m_rendering;                    // rendering frames
+    };
+
+    // Return the phase times of the last call to render().
+    const PhaseTimes& get_phase_times() const;
+
+    // Return the statistics of the rays traced during the last call to render().
+    const RayStatistics& get_ray_statistics() const;
+
   private:
     Project&                        m_project;
     ParamArray                      m_params;
     IRendererController*            m_renderer_controller;
     ITileCallbackFactory*           m_tile_callback_factory;
     foundation::AbortSwitch*        m_abort_switch;
+    PhaseTimes                      m_phase_times;
+    RayStatistics                   m_ray_stats;
 
     // Storage for serial tile callbacks.
     SerialRendererController*       m_serial_renderer_controller;
     ITileCallbackFactory*           m_serial_tile_callback_factory;
 
+    // Texture store kept across renders.
+    TextureStore*                   m_texture_store;
+    TextureStore*                   m_owned_texture_store;
+
 #ifdef WITH_OSL
     boost::shared_ptr<OIIO::TextureSystem>  m_texture_system;
     std::size_t                             m_texture_cache_size;
@@ -115,18 +145,29 @@ class DLLSYMBOL MasterRenderer
     IRendererController::Status initialize_and_render_frame_sequence();
 
     // Render a frame sequence until the sequence is completed or rendering is aborted.
+    // The pass callback and the framebuffer factory, if any, are reset between frames.
     IRendererController::Status render_frame_sequence(
-        IFrameRenderer*             frame_renderer
+        IFrameRenderer*             frame_renderer,
+        IPassCallback*              pass_callback,
+        IShadingResultFrameBufferFactory*
+                                    framebuffer_factory
 #ifdef WITH_OSL
         , OSL::ShadingSystem&       shading_system
 #endif
         );
 
     // Wait until the the frame is completed or rendering is aborted.
-    IRendererController::Status wait_for_event(IFrameRenderer* frame_renderer) const;
+    // frame_completed is set to true if the frame was completely rendered.
+    IRendererController::Status wait_for_event(
+        IFrameRenderer*             frame_renderer,
+        bool&                       frame_completed) const;
 
     // Bind all scene entities inputs. Return true on success, false otherwise.
     bool bind_scene_entities_inputs() const;
+
+    // Print the phase times and the ray statistics of the last call to render().
+    void print_phase_times() const;
+    void print_ray_statistics() const;
 };
 
 }       // namespace renderer
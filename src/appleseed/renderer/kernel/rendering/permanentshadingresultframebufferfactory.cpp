@@ -32,13 +32,18 @@
 
 // appleseed.renderer headers.
 #include "renderer/kernel/aov/imagestack.h"
+#include "renderer/kernel/rendering/checkpoint.h"
 #include "renderer/kernel/rendering/shadingresultframebuffer.h"
 #include "renderer/modeling/frame/frame.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/exceptions/exceptionioerror.h"
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
 #include "foundation/image/tile.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
 
 using namespace foundation;
 
@@ -61,8 +66,7 @@ PermanentShadingResultFrameBufferFactory::PermanentShadingResultFrameBufferFacto
 
 PermanentShadingResultFrameBufferFactory::~PermanentShadingResultFrameBufferFactory()
 {
-    for (size_t i = 0; i < m_framebuffers.size(); ++i)
-        delete m_framebuffers[i];
+    clear();
 }
 
 ShadingResultFrameBuffer* PermanentShadingResultFrameBufferFactory::create(
@@ -97,4 +101,79 @@ void PermanentShadingResultFrameBufferFactory::destroy(
 {
 }
 
+void PermanentShadingResultFrameBufferFactory::clear()
+{
+    for (size_t i = 0; i < m_framebuffers.size(); ++i)
+    {
+        delete m_framebuffers[i];
+        m_framebuffers[i] = 0;
+    }
+}
+
+void PermanentShadingResultFrameBufferFactory::write_checkpoint(
+    CheckpointWriter&           writer) const
+{
+    writer.write(static_cast<uint32>(m_framebuffers.size()));
+
+    for (size_t i = 0; i < m_framebuffers.size(); ++i)
+    {
+        const ShadingResultFrameBuffer* framebuffer = m_framebuffers[i];
+
+        // Tiles are only allocated once they have been rendered.
+        writer.write(static_cast<uint8>(framebuffer ? 1 : 0));
+
+        if (framebuffer)
+        {
+            const AABB2u& crop_window = framebuffer->get_crop_window();
+            writer.write(static_cast<uint32>(crop_window.min.x));
+            writer.write(static_cast<uint32>(crop_window.min.y));
+            writer.write(static_cast<uint32>(crop_window.max.x));
+            writer.write(static_cast<uint32>(crop_window.max.y));
+            writer.write_tile(*framebuffer);
+        }
+    }
+}
+
+void PermanentShadingResultFrameBufferFactory::read_checkpoint(
+    const Frame&                frame,
+    CheckpointReader&           reader)
+{
+    uint32 framebuffer_count;
+    reader.read(framebuffer_count);
+
+    if (framebuffer_count != m_framebuffers.size())
+        throw ExceptionIOError("checkpoint does not match the render settings");
+
+    clear();
+
+    const size_t tile_count_x = frame.image().properties().m_tile_count_x;
+
+    for (size_t i = 0; i < m_framebuffers.size(); ++i)
+    {
+        uint8 allocated;
+        reader.read(allocated);
+
+        if (!allocated)
+            continue;
+
+        uint32 min_x, min_y, max_x, max_y;
+        reader.read(min_x);
+        reader.read(min_y);
+        reader.read(max_x);
+        reader.read(max_y);
+
+        const Tile& tile = frame.image().tile(i % tile_count_x, i / tile_count_x);
+
+        m_framebuffers[i] =
+            new ShadingResultFrameBuffer(
+                tile.get_width(),
+                tile.get_height(),
+                frame.aov_images().size(),
+                AABB2u(Vector2u(min_x, min_y), Vector2u(max_x, max_y)),
+                frame.get_filter());
+
+        reader.read_tile(*m_framebuffers[i]);
+    }
+}
+
 }   // namespace renderer
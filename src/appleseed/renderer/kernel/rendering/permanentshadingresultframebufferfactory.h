@@ -42,6 +42,8 @@
 #include <vector>
 
 // Forward declarations.
+namespace renderer  { class CheckpointReader; }
+namespace renderer  { class CheckpointWriter; }
 namespace renderer  { class Frame; }
 namespace renderer  { class ShadingResultFrameBuffer; }
 
@@ -71,6 +73,15 @@ class PermanentShadingResultFrameBufferFactory
     virtual void destroy(
         ShadingResultFrameBuffer*   framebuffer) OVERRIDE;
 
+    virtual void clear() OVERRIDE;
+
+    virtual void write_checkpoint(
+        CheckpointWriter&           writer) const OVERRIDE;
+
+    virtual void read_checkpoint(
+        const Frame&                frame,
+        CheckpointReader&           reader) OVERRIDE;
+
   private:
     std::vector<ShadingResultFrameBuffer*> m_framebuffers;
 };
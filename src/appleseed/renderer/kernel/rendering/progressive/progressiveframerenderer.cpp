@@ -33,6 +33,7 @@
 // appleseed.renderer headers.
 #include "renderer/kernel/rendering/progressive/samplecounter.h"
 #include "renderer/kernel/rendering/progressive/samplegeneratorjob.h"
+#include "renderer/kernel/rendering/checkpoint.h"
 #include "renderer/kernel/rendering/framerendererbase.h"
 #include "renderer/kernel/rendering/isamplegenerator.h"
 #include "renderer/kernel/rendering/itilecallback.h"
@@ -41,11 +42,13 @@
 #include "renderer/modeling/project/project.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/exceptions/exceptionioerror.h"
 #include "foundation/image/analysis.h"
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/genericimagefilereader.h"
 #include "foundation/image/image.h"
 #include "foundation/math/fixedsizehistory.h"
+#include "foundation/platform/compiler.h"
 #include "foundation/platform/thread.h"
 #include "foundation/platform/timer.h"
 #include "foundation/utility/foreach.h"
@@ -56,6 +59,8 @@
 #include "foundation/utility/string.h"
 
 // Standard headers.
+#include <algorithm>
+#include <string>
 #include <vector>
 
 using namespace boost;
@@ -67,10 +72,128 @@ namespace renderer
 
 namespace
 {
-    typedef vector<ISampleGenerator*> SampleGeneratorVector;
+    typedef SampleGeneratorJob::SampleGeneratorVector SampleGeneratorVector;
     typedef vector<ITileCallback*> TileCallbackVector;
 
 
+    //
+    // Progressive checkpoints.
+    //
+    // A checkpoint contains the accumulation buffer and the sequence index past
+    // which the sample generators must continue when the render is resumed.
+    //
+
+    void write_checkpoint(
+        const string&                   path,
+        const Frame&                    frame,
+        const SampleAccumulationBuffer& buffer,
+        const SampleGeneratorVector&    sample_generators)
+    {
+        const CanvasProperties& props = frame.image().properties();
+
+        try
+        {
+            CheckpointWriter writer(
+                path,
+                ProgressiveCheckpoint,
+                props.m_canvas_width,
+                props.m_canvas_height);
+
+            // Samples are stored into the buffer under its lock after the sample generators
+            // advanced their sequence index: reading the indices after writing the buffer
+            // guarantees that no sample of the checkpoint is generated again after resuming.
+            buffer.write_checkpoint(writer);
+
+            uint64 sequence_end = 0;
+            for (size_t i = 0; i < sample_generators.size(); ++i)
+                sequence_end = max<uint64>(sequence_end, sample_generators[i]->get_sequence_end());
+            writer.write(sequence_end);
+
+            writer.commit();
+
+            RENDERER_LOG_DEBUG("wrote checkpoint %s.", path.c_str());
+        }
+        catch (const ExceptionIOError& e)
+        {
+            RENDERER_LOG_ERROR("failed to write checkpoint %s: %s.", path.c_str(), e.what());
+        }
+    }
+
+    bool read_checkpoint(
+        const string&                   path,
+        const Frame&                    frame,
+        SampleAccumulationBuffer&       buffer,
+        SampleGeneratorVector&          sample_generators)
+    {
+        const CanvasProperties& props = frame.image().properties();
+
+        try
+        {
+            CheckpointReader reader(
+                path,
+                ProgressiveCheckpoint,
+                props.m_canvas_width,
+                props.m_canvas_height);
+
+            buffer.read_checkpoint(reader);
+
+            uint64 sequence_end;
+            reader.read(sequence_end);
+
+            for (size_t i = 0; i < sample_generators.size(); ++i)
+                sample_generators[i]->resume(static_cast<size_t>(sequence_end));
+
+            return true;
+        }
+        catch (const ExceptionIOError& e)
+        {
+            RENDERER_LOG_ERROR(
+                "failed to resume rendering from checkpoint %s: %s; starting over.",
+                path.c_str(),
+                e.what());
+
+            buffer.clear();
+
+            return false;
+        }
+    }
+
+
+    //
+    // A job creating the sample generator of the worker thread executing it.
+    //
+
+    class CreateSampleGeneratorJob
+      : public IJob
+    {
+      public:
+        CreateSampleGeneratorJob(
+            ISampleGeneratorFactory*    generator_factory,
+            SampleGeneratorVector&      sample_generators)
+          : m_generator_factory(generator_factory)
+          , m_sample_generators(sample_generators)
+        {
+        }
+
+        virtual void execute(const size_t thread_index) OVERRIDE
+        {
+            // Sample generator factories are not required to be thread-safe.
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            m_sample_generators[thread_index] =
+                m_generator_factory->create(
+                    thread_index,
+                    m_sample_generators.size(),
+                    thread_index == 0);
+        }
+
+      private:
+        ISampleGeneratorFactory*    m_generator_factory;
+        SampleGeneratorVector&      m_sample_generators;
+        boost::mutex                m_mutex;
+    };
+
+
     //
     // Progressive frame renderer.
     //
@@ -88,6 +211,7 @@ namespace
           , m_params(params)
           , m_sample_counter(m_params.m_max_sample_count)
           , m_ref_image_avg_lum(0.0)
+          , m_resume_pending(m_params.m_resume && !m_params.m_checkpoint_path.empty())
         {
             // We must have a generator factory, but it's OK not to have a callback factory.
             assert(generator_factory);
@@ -101,17 +225,15 @@ namespace
                     global_logger(),
                     m_job_queue,
                     m_params.m_thread_count,
-                    JobManager::KeepRunningOnEmptyQueue));
+                    m_params.m_pin_threads
+                        ? JobManager::KeepRunningOnEmptyQueue | JobManager::PinWorkerThreads
+                        : JobManager::KeepRunningOnEmptyQueue));
 
-            // Instantiate sample generators, one per rendering thread.
-            for (size_t i = 0; i < m_params.m_thread_count; ++i)
-            {
-                m_sample_generators.push_back(
-                    generator_factory->create(
-                        i,
-                        m_params.m_thread_count,
-                        i == 0));
-            }
+            // Instantiate sample generators, one per rendering thread, from within the rendering
+            // threads so that their memory is allocated close to the CPU core that uses it.
+            m_sample_generators.assign(m_params.m_thread_count, 0);
+            CreateSampleGeneratorJob create_sample_generator_job(generator_factory, m_sample_generators);
+            m_job_manager->execute_on_each_thread(create_sample_generator_job);
 
             // Instantiate tile callbacks, one per rendering thread.
             if (callback_factory)
@@ -154,13 +276,17 @@ namespace
 
         virtual ~ProgressiveFrameRenderer()
         {
-            // Tell the statistics printing thread to stop.
+            // Tell the statistics printing and checkpointing threads to stop.
             m_abort_switch.abort();
 
             // Wait until the statistics printing thread is terminated.
             if (m_statistics_thread.get() && m_statistics_thread->joinable())
                 m_statistics_thread->join();
 
+            // Wait until the checkpointing thread is terminated.
+            if (m_checkpoint_thread.get() && m_checkpoint_thread->joinable())
+                m_checkpoint_thread->join();
+
             // Delete tile callbacks.
             for (const_each<TileCallbackVector> i = m_tile_callbacks; i; ++i)
                 (*i)->release();
@@ -195,6 +321,13 @@ namespace
             for (size_t i = 0; i < m_sample_generators.size(); ++i)
                 m_sample_generators[i]->reset();
 
+            // Continue from the checkpoint, if any, the first time the frame is rendered.
+            if (m_resume_pending)
+            {
+                m_resume_pending = false;
+                resume_from_checkpoint();
+            }
+
             // Schedule the first batch of jobs.
             for (size_t i = 0; i < m_sample_generators.size(); ++i)
             {
@@ -202,7 +335,7 @@ namespace
                     new SampleGeneratorJob(
                         m_frame,
                         *m_buffer.get(),
-                        m_sample_generators[i],
+                        m_sample_generators,
                         m_sample_counter,
                         m_tile_callbacks.empty() ? 0 : m_tile_callbacks[i],
                         m_job_queue,
@@ -226,6 +359,21 @@ namespace
                     m_abort_switch));
             ThreadFunctionWrapper<StatisticsFunc> wrapper(m_statistics_func.get());
             m_statistics_thread.reset(new thread(wrapper));
+
+            // Create and start the checkpointing thread.
+            if (!m_params.m_checkpoint_path.empty())
+            {
+                m_checkpoint_func.reset(
+                    new CheckpointFunc(
+                        m_params.m_checkpoint_path,
+                        m_params.m_checkpoint_interval,
+                        m_frame,
+                        *m_buffer.get(),
+                        m_sample_generators,
+                        m_abort_switch));
+                ThreadFunctionWrapper<CheckpointFunc> checkpoint_wrapper(m_checkpoint_func.get());
+                m_checkpoint_thread.reset(new thread(checkpoint_wrapper));
+            }
         }
 
         virtual void stop_rendering()
@@ -233,12 +381,16 @@ namespace
             // First, delete scheduled jobs to prevent worker threads from picking them up.
             m_job_queue.clear_scheduled_jobs();
 
-            // Tell rendering jobs and the statistics printing thread to stop.
+            // Tell rendering jobs, the statistics printing and checkpointing threads to stop.
             m_abort_switch.abort();
 
             // Wait until the statistics printing thread has stopped.
             m_statistics_thread->join();
 
+            // Wait until the checkpointing thread has stopped.
+            if (m_checkpoint_thread.get())
+                m_checkpoint_thread->join();
+
             // Wait until rendering jobs have effectively stopped.
             m_job_queue.wait_until_completion();
         }
@@ -249,6 +401,16 @@ namespace
 
             m_job_manager->stop();
 
+            // Checkpoint the final state such that the render can be refined later.
+            if (!m_params.m_checkpoint_path.empty())
+            {
+                write_checkpoint(
+                    m_params.m_checkpoint_path,
+                    m_frame,
+                    *m_buffer.get(),
+                    m_sample_generators);
+            }
+
             m_statistics_func->write_rms_deviation_file();
 
             print_sample_generators_stats();
@@ -263,15 +425,23 @@ namespace
         struct Parameters
         {
             const size_t    m_thread_count;             // number of rendering threads
+            const bool      m_pin_threads;              // bind rendering threads to CPU cores?
             const uint64    m_max_sample_count;         // maximum total number of samples to compute
             const bool      m_print_luminance_stats;    // compute and print luminance statistics?
             const string    m_ref_image_path;           // path to the reference image
+            const string    m_checkpoint_path;          // path to the checkpoint file
+            const double    m_checkpoint_interval;      // time between two checkpoints, in seconds
+            const bool      m_resume;                   // resume rendering from the checkpoint file?
 
             explicit Parameters(const ParamArray& params)
               : m_thread_count(FrameRendererBase::get_rendering_thread_count(params))
+              , m_pin_threads(params.get_optional<bool>("pin_rendering_threads", false))
               , m_max_sample_count(params.get_optional<uint64>("max_samples", numeric_limits<uint64>::max()))
               , m_print_luminance_stats(params.get_optional<bool>("print_luminance_statistics", false))
               , m_ref_image_path(params.get_optional<string>("reference_image", ""))
+              , m_checkpoint_path(params.get_optional<string>("checkpoint_file", ""))
+              , m_checkpoint_interval(params.get_optional<double>("checkpoint_interval", 60.0))
+              , m_resume(params.get_optional<bool>("resume_from_checkpoint", false))
             {
             }
         };
@@ -416,6 +586,58 @@ namespace
             }
         };
 
+        class CheckpointFunc
+          : public NonCopyable
+        {
+          public:
+            CheckpointFunc(
+                const string&                   path,
+                const double                    interval,
+                const Frame&                    frame,
+                const SampleAccumulationBuffer& buffer,
+                const SampleGeneratorVector&    sample_generators,
+                AbortSwitch&                    abort_switch)
+              : m_path(path)
+              , m_interval(interval)
+              , m_frame(frame)
+              , m_buffer(buffer)
+              , m_sample_generators(sample_generators)
+              , m_abort_switch(abort_switch)
+              , m_timer_frequency(m_timer.frequency())
+              , m_last_time(m_timer.read())
+            {
+            }
+
+            void operator()()
+            {
+                while (!m_abort_switch.is_aborted())
+                {
+                    const uint64 time = m_timer.read();
+                    const double elapsed_seconds = static_cast<double>(time - m_last_time) / m_timer_frequency;
+
+                    if (elapsed_seconds >= m_interval)
+                    {
+                        write_checkpoint(m_path, m_frame, m_buffer, m_sample_generators);
+                        m_last_time = m_timer.read();
+                    }
+
+                    foundation::sleep(50);  // needs full qualification
+                }
+            }
+
+          private:
+            const string                    m_path;
+            const double                    m_interval;
+            const Frame&                    m_frame;
+            const SampleAccumulationBuffer& m_buffer;
+            const SampleGeneratorVector&    m_sample_generators;
+            AbortSwitch&                    m_abort_switch;
+
+            DefaultWallclockTimer           m_timer;
+            uint64                          m_timer_frequency;
+            uint64                          m_last_time;
+        };
+
         Frame&                              m_frame;
         const Parameters                    m_params;
         SampleCounter                       m_sample_counter;
@@ -435,6 +657,34 @@ namespace
         auto_ptr<StatisticsFunc>            m_statistics_func;
         auto_ptr<thread>                    m_statistics_thread;
 
+        bool                                m_resume_pending;
+        auto_ptr<CheckpointFunc>            m_checkpoint_func;
+        auto_ptr<thread>                    m_checkpoint_thread;
+
+        void resume_from_checkpoint()
+        {
+            if (!read_checkpoint(
+                    m_params.m_checkpoint_path,
+                    m_frame,
+                    *m_buffer.get(),
+                    m_sample_generators))
+                return;
+
+            m_sample_counter.set(m_buffer->get_sample_count());
+
+            RENDERER_LOG_INFO(
+                "resuming rendering from checkpoint %s with %s samples.",
+                m_params.m_checkpoint_path.c_str(),
+                pretty_uint(m_buffer->get_sample_count()).c_str());
+
+            // Display the restored image right away, even if no sample is left to render.
+            TileCoordinateArray tiles;
+            m_buffer->develop_to_frame(m_frame, tiles);
+
+            if (!m_tile_callbacks.empty())
+                m_tile_callbacks[0]->post_render(&m_frame, tiles);
+        }
+
         void print_sample_generators_stats() const
         {
             assert(!m_sample_generators.empty());
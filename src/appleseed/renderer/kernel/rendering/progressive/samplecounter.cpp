@@ -54,6 +54,13 @@ void SampleCounter::clear()
     m_sample_count = 0;
 }
 
+void SampleCounter::set(const uint64 sample_count)
+{
+    Spinlock::ScopedLock lock(m_spinlock);
+
+    m_sample_count = min(sample_count, m_max_sample_count);
+}
+
 uint64 SampleCounter::read() const
 {
     Spinlock::ScopedLock lock(m_spinlock);
@@ -53,6 +53,8 @@ class SampleCounter
 
     void clear();
 
+    void set(const foundation::uint64 sample_count);
+
     foundation::uint64 read() const;
 
     size_t reserve(const size_t sample_count);
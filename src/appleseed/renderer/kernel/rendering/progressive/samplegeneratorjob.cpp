@@ -40,9 +40,11 @@
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
+#include "foundation/utility/eventtracer.h"
 
 // Standard headers.
 #include <algorithm>
+#include <cassert>
 
 using namespace foundation;
 using namespace std;
@@ -74,7 +76,8 @@ namespace
 SampleGeneratorJob::SampleGeneratorJob(
     Frame&                      frame,
     SampleAccumulationBuffer&   buffer,
-    ISampleGenerator*           sample_generator,
+    const SampleGeneratorVector&
+                                sample_generators,
     SampleCounter&              sample_counter,
     ITileCallback*              tile_callback,
     JobQueue&                   job_queue,
@@ -84,7 +87,7 @@ SampleGeneratorJob::SampleGeneratorJob(
     AbortSwitch&                abort_switch)
   : m_frame(frame)
   , m_buffer(buffer)
-  , m_sample_generator(sample_generator)
+  , m_sample_generators(sample_generators)
   , m_sample_counter(sample_counter)
   , m_tile_callback(tile_callback)
   , m_job_queue(job_queue)
@@ -97,6 +100,12 @@ SampleGeneratorJob::SampleGeneratorJob(
 
 void SampleGeneratorJob::execute(const size_t thread_index)
 {
+    assert(thread_index < m_sample_generators.size());
+
+    const ScopedEvent event("generate samples", "rendering");
+
+    ISampleGenerator* sample_generator = m_sample_generators[thread_index];
+
     const size_t sample_count =
         m_sample_counter.reserve(compute_sample_count(m_pass));
 
@@ -120,19 +129,21 @@ void SampleGeneratorJob::execute(const size_t thread_index)
         // on screen during navigation. todo: this needs to change as it will
         // freeze rendering if the first pass cannot generate samples.
         AbortSwitch no_abort;
-        m_sample_generator->generate_samples(sample_count, m_buffer, no_abort);
+        sample_generator->generate_samples(sample_count, m_buffer, no_abort);
     }
     else
     {
-        m_sample_generator->generate_samples(sample_count, m_buffer, m_abort_switch);
+        sample_generator->generate_samples(sample_count, m_buffer, m_abort_switch);
     }
 
     if (m_job_index == 0)
     {
-        m_buffer.develop_to_frame(m_frame);
+        // Only develop and display the tiles that changed during this pass.
+        TileCoordinateArray tiles;
+        m_buffer.develop_to_frame(m_frame, tiles);
 
         if (m_tile_callback)
-            m_tile_callback->post_render(&m_frame);
+            m_tile_callback->post_render(&m_frame, tiles);
     }
 
     // This job reschedules itself automatically.
@@ -142,7 +153,7 @@ void SampleGeneratorJob::execute(const size_t thread_index)
             new SampleGeneratorJob(
                 m_frame,
                 m_buffer,
-                m_sample_generator,
+                m_sample_generators,
                 m_sample_counter,
                 m_tile_callback,
                 m_job_queue,
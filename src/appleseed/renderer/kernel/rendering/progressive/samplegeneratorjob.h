@@ -35,6 +35,7 @@
 
 // Standard headers.
 #include <cstddef>
+#include <vector>
 
 // Forward declarations.
 namespace renderer  { class Frame; }
@@ -50,11 +51,14 @@ class SampleGeneratorJob
   : public foundation::IJob
 {
   public:
-    // Constructor.
+    typedef std::vector<ISampleGenerator*> SampleGeneratorVector;
+
+    // Constructor. The job uses the sample generator of the thread executing it.
     SampleGeneratorJob(
         Frame&                      frame,
         SampleAccumulationBuffer&   buffer,
-        ISampleGenerator*           sample_generator,
+        const SampleGeneratorVector&
+                                    sample_generators,
         SampleCounter&              sample_counter,
         ITileCallback*              tile_callback,
         foundation::JobQueue&       job_queue,
@@ -69,7 +73,7 @@ class SampleGeneratorJob
   private:
     Frame&                          m_frame;
     SampleAccumulationBuffer&       m_buffer;
-    ISampleGenerator*               m_sample_generator;
+    const SampleGeneratorVector&    m_sample_generators;
     SampleCounter&                  m_sample_counter;
     ITileCallback*                  m_tile_callback;
     foundation::JobQueue&           m_job_queue;
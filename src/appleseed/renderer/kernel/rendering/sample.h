@@ -34,16 +34,154 @@
 #include "foundation/image/color.h"
 #include "foundation/math/vector.h"
 
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
 namespace renderer
 {
 
-class Sample
+//
+// A batch of image samples stored as a structure of arrays: the coordinates of the
+// sample positions (in normalized device coordinates) and the channels of the sample
+// colors are stored in separate single precision arrays. Consumers can thus process
+// a whole batch with loops over contiguous values that compilers can vectorize.
+//
+// All arrays share a single allocation, so that appending a sample involves a single
+// capacity check.
+//
+
+class SampleBatch
 {
   public:
-    foundation::Vector2d    m_position;
-    foundation::Color4f     m_color;
+    // Number of color channels of a sample (RGBA).
+    static const size_t ChannelCount = 4;
+
+    // Constructor.
+    SampleBatch();
+
+    // Remove all samples, keeping the allocated memory.
+    void clear();
+
+    // Allocate memory for a given number of samples.
+    void reserve(const size_t capacity);
+
+    // Return the number of samples in the batch.
+    size_t size() const;
+
+    // Return true if the batch is empty.
+    bool empty() const;
+
+    // Append a sample to the batch.
+    void push_back(
+        const foundation::Vector2d& position,
+        const foundation::Color4f&  color);
+
+    // Access the coordinates of the sample positions.
+    const float* get_x() const;
+    const float* get_y() const;
+
+    // Access a given color channel of the samples.
+    const float* get_channel(const size_t channel) const;
+
+  private:
+    // Number of arrays: x and y coordinates, then the color channels.
+    static const size_t ArrayCount = 2 + ChannelCount;
+
+    size_t              m_size;
+    size_t              m_capacity;
+    std::vector<float>  m_storage;      // ArrayCount arrays of m_capacity values each
+
+    void grow();
 };
 
+
+//
+// SampleBatch class implementation.
+//
+
+inline SampleBatch::SampleBatch()
+  : m_size(0)
+  , m_capacity(0)
+{
+}
+
+inline void SampleBatch::clear()
+{
+    m_size = 0;
+}
+
+inline void SampleBatch::reserve(const size_t capacity)
+{
+    if (capacity <= m_capacity)
+        return;
+
+    std::vector<float> storage(ArrayCount * capacity);
+
+    for (size_t i = 0; i < ArrayCount; ++i)
+    {
+        std::copy(
+            m_storage.begin() + i * m_capacity,
+            m_storage.begin() + i * m_capacity + m_size,
+            storage.begin() + i * capacity);
+    }
+
+    m_storage.swap(storage);
+    m_capacity = capacity;
+}
+
+inline void SampleBatch::grow()
+{
+    reserve(std::max<size_t>(2 * m_capacity, 64));
+}
+
+inline size_t SampleBatch::size() const
+{
+    return m_size;
+}
+
+inline bool SampleBatch::empty() const
+{
+    return m_size == 0;
+}
+
+inline void SampleBatch::push_back(
+    const foundation::Vector2d& position,
+    const foundation::Color4f&  color)
+{
+    if (m_size == m_capacity)
+        grow();
+
+    float* ptr = &m_storage[m_size++];
+
+    ptr[0] = static_cast<float>(position.x);
+    ptr[m_capacity] = static_cast<float>(position.y);
+
+    for (size_t i = 0; i < ChannelCount; ++i)
+        ptr[(2 + i) * m_capacity] = color[i];
+}
+
+inline const float* SampleBatch::get_x() const
+{
+    assert(!empty());
+    return &m_storage[0];
+}
+
+inline const float* SampleBatch::get_y() const
+{
+    assert(!empty());
+    return &m_storage[m_capacity];
+}
+
+inline const float* SampleBatch::get_channel(const size_t channel) const
+{
+    assert(!empty());
+    assert(channel < ChannelCount);
+    return &m_storage[(2 + channel) * m_capacity];
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_RENDERING_SAMPLE_H
@@ -0,0 +1,133 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "sampleaccumulationbuffer.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// SampleAccumulationBuffer class implementation.
+//
+// Tiles are flagged as dirty when samples are stored into them so that
+// progressive renderers only need to develop, and their tile callbacks
+// only need to display, the tiles that changed since the previous pass.
+//
+
+SampleAccumulationBuffer::SampleAccumulationBuffer(
+    const size_t    width,
+    const size_t    height,
+    const size_t    tile_width,
+    const size_t    tile_height)
+  : m_sample_count(0)
+  , m_memory_account(MemoryCategoryFrameBuffers)
+  , m_width(width)
+  , m_height(height)
+  , m_tile_width(tile_width)
+  , m_tile_height(tile_height)
+  , m_tile_count_x((width + tile_width - 1) / tile_width)
+  , m_tile_count_y((height + tile_height - 1) / tile_height)
+  , m_dirty_tiles(m_tile_count_x * m_tile_count_y, 0)
+  , m_all_dirty(true)
+{
+    assert(tile_width > 0);
+    assert(tile_height > 0);
+}
+
+void SampleAccumulationBuffer::clear_no_lock()
+{
+    m_sample_count = 0;
+    m_all_dirty = true;
+}
+
+void SampleAccumulationBuffer::mark_dirty_no_lock(
+    const double    x,
+    const double    y,
+    const double    xradius,
+    const double    yradius)
+{
+    if (m_all_dirty)
+        return;
+
+    // Find the pixels affected by this sample, the same way FilteredTile::add() does.
+    const double dx = x - 0.5;
+    const double dy = y - 0.5;
+    const double min_x = max(ceil(dx - xradius), 0.0);
+    const double min_y = max(ceil(dy - yradius), 0.0);
+    const double max_x = min(floor(dx + xradius), static_cast<double>(m_width - 1));
+    const double max_y = min(floor(dy + yradius), static_cast<double>(m_height - 1));
+
+    if (min_x > max_x || min_y > max_y)
+        return;
+
+    const size_t min_tx = static_cast<size_t>(min_x) / m_tile_width;
+    const size_t min_ty = static_cast<size_t>(min_y) / m_tile_height;
+    const size_t max_tx = static_cast<size_t>(max_x) / m_tile_width;
+    const size_t max_ty = static_cast<size_t>(max_y) / m_tile_height;
+
+    for (size_t ty = min_ty; ty <= max_ty; ++ty)
+    {
+        for (size_t tx = min_tx; tx <= max_tx; ++tx)
+            m_dirty_tiles[ty * m_tile_count_x + tx] = 1;
+    }
+}
+
+void SampleAccumulationBuffer::collect_dirty_tiles_no_lock(TileCoordinateArray& tiles)
+{
+    tiles.clear();
+
+    for (size_t ty = 0; ty < m_tile_count_y; ++ty)
+    {
+        for (size_t tx = 0; tx < m_tile_count_x; ++tx)
+        {
+            uint8& dirty = m_dirty_tiles[ty * m_tile_count_x + tx];
+
+            if (m_all_dirty || dirty)
+            {
+                tiles.push_back(Vector2u(tx, ty));
+                dirty = 0;
+            }
+        }
+    }
+
+    m_all_dirty = false;
+}
+
+}   // namespace renderer
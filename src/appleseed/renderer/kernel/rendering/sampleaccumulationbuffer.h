@@ -30,6 +30,10 @@
 #ifndef APPLESEED_RENDERER_KERNEL_RENDERING_SAMPLEACCUMULATIONBUFFER_H
 #define APPLESEED_RENDERER_KERNEL_RENDERING_SAMPLEACCUMULATIONBUFFER_H
 
+// appleseed.renderer headers.
+#include "renderer/global/globalmemory.h"
+#include "renderer/kernel/rendering/itilecallback.h"
+
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
 #include "foundation/platform/thread.h"
@@ -37,10 +41,13 @@
 
 // Standard headers.
 #include <cstddef>
+#include <vector>
 
 // Forward declarations.
+namespace renderer  { class CheckpointReader; }
+namespace renderer  { class CheckpointWriter; }
 namespace renderer  { class Frame; }
-namespace renderer  { class Sample; }
+namespace renderer  { class SampleBatch; }
 
 namespace renderer
 {
@@ -49,6 +56,14 @@ class SampleAccumulationBuffer
   : public foundation::NonCopyable
 {
   public:
+    // Constructor. @width and @height are the dimensions of the frame,
+    // @tile_width and @tile_height are the dimensions of its tiles.
+    SampleAccumulationBuffer(
+        const size_t                width,
+        const size_t                height,
+        const size_t                tile_width,
+        const size_t                tile_height);
+
     // Destructor.
     virtual ~SampleAccumulationBuffer() {}
 
@@ -60,22 +75,59 @@ class SampleAccumulationBuffer
 
     // Store @samples into the buffer. Thread-safe.
     virtual void store_samples(
-        const size_t        sample_count,
-        const Sample        samples[]) = 0;
+        const SampleBatch&          samples) = 0;
+
+    // Develop to a frame the tiles that changed since the last call, or all
+    // tiles after the buffer was cleared. The coordinates of the developed
+    // tiles are returned in @tiles. Thread-safe.
+    virtual void develop_to_frame(
+        Frame&                      frame,
+        TileCoordinateArray&        tiles) = 0;
 
-    // Develop the buffer to a frame. Thread-safe.
-    virtual void develop_to_frame(Frame& frame) = 0;
+    // Write the contents of the buffer to a checkpoint. Thread-safe.
+    virtual void write_checkpoint(CheckpointWriter& writer) const = 0;
+
+    // Restore the contents of the buffer from a checkpoint and mark all
+    // tiles as dirty. Throws foundation::ExceptionIOError on failure,
+    // in which case the buffer must be cleared. Thread-safe.
+    virtual void read_checkpoint(CheckpointReader& reader) = 0;
 
   protected:
-    mutable boost::mutex    m_mutex;
-    foundation::uint64      m_sample_count;
+    mutable boost::mutex            m_mutex;
+    foundation::uint64              m_sample_count;
+    MemoryAccount                   m_memory_account;
 
+    // Reset the sample count and mark all tiles as dirty.
     void clear_no_lock();
+
+    // Mark as dirty the tiles touched by a sample at (@x, @y) in continuous
+    // frame space, given the radii of the reconstruction filter in pixels.
+    void mark_dirty_no_lock(
+        const double                x,
+        const double                y,
+        const double                xradius,
+        const double                yradius);
+
+    // Mark all tiles as dirty.
+    void mark_all_dirty_no_lock();
+
+    // Store the coordinates of all dirty tiles into @tiles and mark all tiles as clean.
+    void collect_dirty_tiles_no_lock(TileCoordinateArray& tiles);
+
+  private:
+    const size_t                    m_width;
+    const size_t                    m_height;
+    const size_t                    m_tile_width;
+    const size_t                    m_tile_height;
+    const size_t                    m_tile_count_x;
+    const size_t                    m_tile_count_y;
+    std::vector<foundation::uint8>  m_dirty_tiles;
+    bool                            m_all_dirty;
 };
 
 
 //
-// SampleAccumulationBufferclass implementation.
+// SampleAccumulationBuffer class implementation.
 //
 
 inline foundation::uint64 SampleAccumulationBuffer::get_sample_count() const
@@ -85,9 +137,9 @@ inline foundation::uint64 SampleAccumulationBuffer::get_sample_count() const
     return m_sample_count;
 }
 
-inline void SampleAccumulationBuffer::clear_no_lock()
+inline void SampleAccumulationBuffer::mark_all_dirty_no_lock()
 {
-    m_sample_count = 0;
+    m_all_dirty = true;
 }
 
 }       // namespace renderer
@@ -35,7 +35,6 @@
 
 // appleseed.foundation headers.
 #include "foundation/utility/job.h"
-#include "foundation/utility/memory.h"
 
 // Standard headers.
 #include <cassert>
@@ -63,6 +62,24 @@ void SampleGeneratorBase::reset()
 {
     m_sequence_index = m_generator_index * SampleBatchSize;
     m_current_batch_size = 0;
+
+    publish_sequence_end();
+}
+
+void SampleGeneratorBase::resume(const size_t sequence_offset)
+{
+    reset();
+
+    m_sequence_index += sequence_offset;
+
+    publish_sequence_end();
+}
+
+size_t SampleGeneratorBase::get_sequence_end() const
+{
+    boost::mutex::scoped_lock lock(m_sequence_end_mutex);
+
+    return m_sequence_end;
 }
 
 void SampleGeneratorBase::generate_samples(
@@ -72,7 +89,7 @@ void SampleGeneratorBase::generate_samples(
 {
     assert(sample_count > 0);
 
-    clear_keep_memory(m_samples);
+    m_samples.clear();
     m_samples.reserve(sample_count);
 
     size_t stored_sample_count = 0;
@@ -93,8 +110,19 @@ void SampleGeneratorBase::generate_samples(
         }
     }
 
+    // Publish the sequence index before storing the samples, such that a checkpoint
+    // that contains these samples never records an earlier sequence index.
+    publish_sequence_end();
+
     if (stored_sample_count > 0)
-        buffer.store_samples(stored_sample_count, &m_samples[0]);
+        buffer.store_samples(m_samples);
+}
+
+void SampleGeneratorBase::publish_sequence_end()
+{
+    boost::mutex::scoped_lock lock(m_sequence_end_mutex);
+
+    m_sequence_end = m_sequence_index;
 }
 
 }   // namespace renderer
@@ -34,9 +34,11 @@
 #include "renderer/kernel/rendering/isamplegenerator.h"
 #include "renderer/kernel/rendering/sample.h"
 
+// boost headers.
+#include "boost/thread/mutex.hpp"
+
 // Standard headers.
 #include <cstddef>
-#include <vector>
 
 // Forward declarations.
 namespace foundation    { class AbortSwitch; }
@@ -60,6 +62,13 @@ class SampleGeneratorBase
     // Reset the sample generator to its initial state.
     virtual void reset();
 
+    // Reset the sample generator and skip the sequence indices below @sequence_offset.
+    virtual void resume(const size_t sequence_offset);
+
+    // Return a sequence index larger than all the ones of the samples stored so far.
+    // Thread-safe: may be called while samples are being generated.
+    virtual size_t get_sequence_end() const;
+
     // Generate a given number of samples and accumulate them into a buffer.
     virtual void generate_samples(
         const size_t                sample_count,
@@ -67,20 +76,22 @@ class SampleGeneratorBase
         foundation::AbortSwitch&    abort_switch);
 
   protected:
-    typedef std::vector<Sample> SampleVector;
-
-    // Generate one or multiple samples for a given sequence index and store them in @samples.
-    // Return the number of samples that were stored.
+    // Generate one or multiple samples for a given sequence index and append them to @samples.
+    // Return the number of samples that were appended.
     virtual size_t generate_samples(
         const size_t                sequence_index,
-        SampleVector&               samples) = 0;
+        SampleBatch&                samples) = 0;
 
   private:
     const size_t                    m_generator_index;
     const size_t                    m_stride;
     size_t                          m_sequence_index;
     size_t                          m_current_batch_size;
-    SampleVector                    m_samples;
+    SampleBatch                     m_samples;
+    mutable boost::mutex            m_sequence_end_mutex;
+    size_t                          m_sequence_end;         // m_sequence_index as of the last stored samples
+
+    void publish_sequence_end();
 };
 
 }       // namespace renderer
@@ -71,6 +71,11 @@ void SerialRendererController::on_rendering_abort()
     m_controller->on_rendering_abort();
 }
 
+void SerialRendererController::on_frame_setup()
+{
+    m_controller->on_frame_setup();
+}
+
 void SerialRendererController::on_frame_begin()
 {
     m_controller->on_frame_begin();
@@ -96,6 +101,11 @@ SerialRendererController::Status SerialRendererController::on_progress()
     return m_controller->on_progress();
 }
 
+SerialRendererController::Status SerialRendererController::on_frame_complete()
+{
+    return m_controller->on_frame_complete();
+}
+
 void SerialRendererController::add_pre_render_tile_callback(
     const size_t            x,
     const size_t            y,
@@ -148,6 +158,24 @@ void SerialRendererController::add_post_render_tile_callback(const Frame* frame)
     m_pending_callbacks.push_back(callback);
 }
 
+void SerialRendererController::add_post_render_tile_callback(
+    const Frame*                frame,
+    const TileCoordinateArray&  tiles)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    PendingTileCallback callback;
+    callback.m_type = PendingTileCallback::PostRenderTiles;
+    callback.m_frame = frame;
+    callback.m_x = 0;
+    callback.m_y = 0;
+    callback.m_width = 0;
+    callback.m_height = 0;
+    callback.m_tiles = tiles;
+
+    m_pending_callbacks.push_back(callback);
+}
+
 void SerialRendererController::exec_callback(const PendingTileCallback& call)
 {
     switch (call.m_type)
@@ -164,6 +192,10 @@ void SerialRendererController::exec_callback(const PendingTileCallback& call)
         m_tile_callback->post_render(call.m_frame);
         break;
 
+      case PendingTileCallback::PostRenderTiles:
+        m_tile_callback->post_render(call.m_frame, call.m_tiles);
+        break;
+
       assert_otherwise;
     }
 }
@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/kernel/rendering/irenderercontroller.h"
+#include "renderer/kernel/rendering/itilecallback.h"
 
 // appleseed.foundation headers.
 #include "foundation/platform/compiler.h"
@@ -43,7 +44,6 @@
 
 // Forward declarations.
 namespace renderer  { class Frame; }
-namespace renderer  { class ITileCallback; }
 
 namespace renderer
 {
@@ -66,10 +66,12 @@ class SerialRendererController
     virtual void on_rendering_begin() OVERRIDE;
     virtual void on_rendering_success() OVERRIDE;
     virtual void on_rendering_abort() OVERRIDE;
+    virtual void on_frame_setup() OVERRIDE;
     virtual void on_frame_begin() OVERRIDE;
     virtual void on_frame_end() OVERRIDE;
 
     virtual Status on_progress() OVERRIDE;
+    virtual Status on_frame_complete() OVERRIDE;
 
     void add_pre_render_tile_callback(
         const size_t    x,
@@ -84,6 +86,10 @@ class SerialRendererController
 
     void add_post_render_tile_callback(const Frame* frame);
 
+    void add_post_render_tile_callback(
+        const Frame*                frame,
+        const TileCoordinateArray&  tiles);
+
   private:
     struct PendingTileCallback
     {
@@ -91,15 +97,17 @@ class SerialRendererController
         {
             PreRender,
             PostRenderTile,
-            PostRender
+            PostRender,
+            PostRenderTiles
         };
 
-        CallbackType    m_type;
-        const Frame*    m_frame;
-        size_t          m_x;
-        size_t          m_y;
-        size_t          m_width;
-        size_t          m_height;
+        CallbackType        m_type;
+        const Frame*        m_frame;
+        size_t              m_x;
+        size_t              m_y;
+        size_t              m_width;
+        size_t              m_height;
+        TileCoordinateArray m_tiles;
     };
 
     IRendererController*                m_controller;
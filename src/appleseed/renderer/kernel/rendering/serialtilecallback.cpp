@@ -77,6 +77,13 @@ namespace
             m_controller->add_post_render_tile_callback(frame);
         }
 
+        virtual void post_render(
+            const Frame*                frame,
+            const TileCoordinateArray&  tiles) OVERRIDE
+        {
+            m_controller->add_post_render_tile_callback(frame, tiles);
+        }
+
       private:
         SerialRendererController* m_controller;
     };
@@ -75,6 +75,15 @@ class TileCallbackBase
         const Frame*    frame) OVERRIDE
     {
     }
+
+    // This method is called after a pass of a progressive renderer.
+    // By default, the whole frame is considered to have changed.
+    virtual void post_render(
+        const Frame*                frame,
+        const TileCoordinateArray&  tiles) OVERRIDE
+    {
+        post_render(frame);
+    }
 };
 
 }       // namespace renderer
@@ -43,14 +43,26 @@
 #include "renderer/utility/transformsequence.h"
 
 // appleseed.foundation headers.
+#include "foundation/math/hash.h"
 #include "foundation/math/intersection.h"
+#include "foundation/math/matrix.h"
 #include "foundation/math/sampling.h"
 #include "foundation/math/transform.h"
+#include "foundation/platform/compiler.h"
+#include "foundation/platform/timer.h"
+#include "foundation/utility/casts.h"
 #include "foundation/utility/foreach.h"
+#include "foundation/utility/job.h"
 #include "foundation/utility/lazy.h"
+#include "foundation/utility/stopwatch.h"
+#include "foundation/utility/string.h"
+
+// boost headers.
+#include "boost/filesystem/operations.hpp"
 
 // Standard headers.
 #include <algorithm>
+#include <vector>
 
 using namespace foundation;
 using namespace std;
@@ -62,30 +74,63 @@ namespace renderer
 // AOVoxelTree class implementation.
 //
 
-AOVoxelTree::AOVoxelTree(
-    const Scene&    scene,
-    const GScalar   max_extent_fraction)
+namespace
 {
-    assert(max_extent_fraction > GScalar(0.0));
+    // Compute the maximum extent of a leaf, in world space.
+    GScalar compute_max_extent(
+        const GAABB3&   scene_bbox,
+        const GScalar   max_extent_fraction)
+    {
+        return max_extent_fraction * max_value(scene_bbox.extent());
+    }
 
-    // Print a progress message.
-    RENDERER_LOG_INFO("building ambient occlusion voxel tree...");
+    // Mix the entries of a transform into a hash.
+    uint64 mix_transform(
+        uint64              hash,
+        const Transformd&   transform)
+    {
+        const Matrix4d& m = transform.get_local_to_parent();
 
-    // Compute the bounding box of the scene.
-    const GAABB3 scene_bbox = scene.compute_bbox();
+        for (size_t i = 0; i < 16; ++i)
+            hash = mix_uint64(hash, binary_cast<uint64>(m[i]));
 
-    // Compute the maximum extent of a leaf, in world space.
-    const GScalar max_extent = max_extent_fraction * max_value(scene_bbox.extent());
+        return hash;
+    }
+}
 
-    // Build the tree.
-    BuilderType builder(m_tree, scene_bbox, max_extent);
-    build(scene, builder);
-    builder.complete();
+AOVoxelTree::AOVoxelTree(
+    const Scene&    scene,
+    const GScalar   max_extent_fraction,
+    JobQueue*       job_queue)
+{
+    build(scene, max_extent_fraction, job_queue);
+}
 
-    // Print statistics.
-    TreeStatisticsType tree_stats(m_tree, builder);
-    RENDERER_LOG_DEBUG("ambient occlusion voxel tree statistics:");
-    tree_stats.print(global_logger());
+AOVoxelTree::AOVoxelTree(
+    const Scene&    scene,
+    const GScalar   max_extent_fraction,
+    JobQueue*       job_queue,
+    const string&   cache_filename)
+{
+    if (boost::filesystem::exists(cache_filename))
+    {
+        if (load_tree_from_disk(cache_filename))
+        {
+            // The cached tree must have been built from the same geometry with the same leaf size.
+            const GAABB3 scene_bbox = scene.compute_bbox();
+            if (m_tree.get_bbox() == scene_bbox &&
+                m_tree.get_max_extent() == compute_max_extent(scene_bbox, max_extent_fraction) &&
+                m_tree.get_signature() == compute_geometry_signature(scene))
+                return;
+
+            RENDERER_LOG_WARNING(
+                "ambient occlusion voxel tree file %s does not match the scene or the voxel size, rebuilding the tree.",
+                cache_filename.c_str());
+        }
+    }
+
+    build(scene, max_extent_fraction, job_queue);
+    dump_tree_to_disk(cache_filename);
 }
 
 void AOVoxelTree::dump_solid_leaves_to_disk(const string& filename) const
@@ -108,7 +153,7 @@ void AOVoxelTree::dump_solid_leaves_to_disk(const string& filename) const
     }
 }
 
-void AOVoxelTree::dump_tree_to_disk(const string& filename) const
+bool AOVoxelTree::dump_tree_to_disk(const string& filename) const
 {
     RENDERER_LOG_INFO(
         "writing ambient occlusion voxel tree file %s...",
@@ -119,12 +164,42 @@ void AOVoxelTree::dump_tree_to_disk(const string& filename) const
         RENDERER_LOG_INFO(
             "wrote ambient occlusion voxel tree file %s.",
             filename.c_str());
+        return true;
     }
     else
     {
         RENDERER_LOG_ERROR(
             "failed to write ambient occlusion voxel tree file %s: i/o error.",
             filename.c_str());
+        return false;
+    }
+}
+
+bool AOVoxelTree::load_tree_from_disk(const string& filename)
+{
+    RENDERER_LOG_INFO(
+        "reading ambient occlusion voxel tree file %s...",
+        filename.c_str());
+
+    Stopwatch<DefaultWallclockTimer> stopwatch;
+    stopwatch.start();
+
+    if (m_tree.load_tree_from_disk(filename))
+    {
+        stopwatch.measure();
+
+        RENDERER_LOG_INFO(
+            "read ambient occlusion voxel tree file %s in %s.",
+            filename.c_str(),
+            pretty_time(stopwatch.get_seconds()).c_str());
+        return true;
+    }
+    else
+    {
+        RENDERER_LOG_ERROR(
+            "failed to read ambient occlusion voxel tree file %s: i/o error or invalid file.",
+            filename.c_str());
+        return false;
     }
 }
 
@@ -170,8 +245,126 @@ namespace
     };
 }
 
+//
+// Job building the subtree of one octant of the voxel tree.
+//
+
+class AOVoxelTree::BuildOctantJob
+  : public IJob
+{
+  public:
+    BuildOctantJob(
+        const Scene&    scene,
+        const GAABB3&   bbox,
+        const GScalar   max_extent,
+        TreeType&       octant)
+      : m_scene(scene)
+      , m_bbox(bbox)
+      , m_max_extent(max_extent)
+      , m_octant(octant)
+    {
+    }
+
+    virtual void execute(const size_t thread_index) OVERRIDE
+    {
+        BuilderType builder(m_octant, m_bbox, m_max_extent);
+        push_triangles(m_scene, m_bbox, builder);
+    }
+
+  private:
+    const Scene&        m_scene;
+    const GAABB3        m_bbox;
+    const GScalar       m_max_extent;
+    TreeType&           m_octant;
+};
+
 void AOVoxelTree::build(
     const Scene&    scene,
+    const GScalar   max_extent_fraction,
+    JobQueue*       job_queue)
+{
+    assert(max_extent_fraction > GScalar(0.0));
+
+    // Print a progress message.
+    RENDERER_LOG_INFO(
+        job_queue
+            ? "building ambient occlusion voxel tree in parallel..."
+            : "building ambient occlusion voxel tree...");
+
+    // Compute the bounding box of the scene.
+    const GAABB3 scene_bbox = scene.compute_bbox();
+
+    // Compute the maximum extent of a leaf, in world space.
+    const GScalar max_extent = compute_max_extent(scene_bbox, max_extent_fraction);
+
+    BuilderType builder(m_tree, scene_bbox, max_extent);
+
+    if (job_queue)
+    {
+        // Split the tree into octants and build them in parallel.
+        const size_t OctantDepth = 3;
+        vector<size_t> leaf_indices;
+        vector<GAABB3> leaf_bboxes;
+        builder.subdivide_top_levels(OctantDepth, leaf_indices, leaf_bboxes);
+
+        const size_t octant_count = leaf_indices.size();
+        assert(octant_count <= 1 << OctantDepth);
+        TreeType octants[1 << OctantDepth];
+
+        // The queue may be shared with other jobs: only wait for the octant jobs.
+        JobCounter job_counter;
+        for (size_t i = 0; i < octant_count; ++i)
+            job_counter.schedule(*job_queue, new BuildOctantJob(scene, leaf_bboxes[i], max_extent, octants[i]));
+        job_counter.wait_until_completion();
+
+        for (size_t i = 0; i < octant_count; ++i)
+            builder.graft(leaf_indices[i], octants[i]);
+    }
+    else push_triangles(scene, scene_bbox, builder);
+
+    builder.complete();
+    m_tree.set_signature(compute_geometry_signature(scene));
+
+    RENDERER_LOG_INFO(
+        "built ambient occlusion voxel tree in %s.",
+        pretty_time(builder.get_build_time()).c_str());
+
+    // Print statistics.
+    TreeStatisticsType tree_stats(m_tree, builder);
+    RENDERER_LOG_DEBUG("ambient occlusion voxel tree statistics:");
+    tree_stats.print(global_logger());
+}
+
+uint64 AOVoxelTree::compute_geometry_signature(const Scene& scene)
+{
+    // The voxel tree is built using the scene geometry at the middle of the shutter interval.
+    const double time = scene.get_camera()->get_shutter_middle_time();
+
+    uint64 signature = 0;
+
+    for (const_each<AssemblyInstanceContainer> i = scene.assembly_instances(); i; ++i)
+    {
+        const AssemblyInstance& assembly_instance = *i;
+        const Assembly& assembly = assembly_instance.get_assembly();
+
+        signature = mix_uint64(signature, assembly.get_version_id());
+        signature = mix_transform(signature, assembly_instance.transform_sequence().evaluate(time));
+
+        for (const_each<ObjectInstanceContainer> j = assembly.object_instances(); j; ++j)
+        {
+            const ObjectInstance& object_instance = *j;
+
+            signature = mix_uint64(signature, object_instance.get_object().get_version_id());
+            signature = mix_transform(signature, object_instance.get_transform());
+        }
+    }
+
+    return signature;
+}
+
+void AOVoxelTree::push_triangles(
+    const Scene&    scene,
+    const GAABB3&   bbox,
     BuilderType&    builder)
 {
     // The voxel tree is built using the scene geometry at the middle of the shutter interval.
@@ -200,6 +393,11 @@ void AOVoxelTree::build(
             // Retrieve the object.
             Object& object = object_instance.get_object();
 
+            // Skip object instances that don't overlap the bounding box.
+            const GAABB3 object_bbox = object.compute_local_bbox();
+            if (!object_bbox.is_valid() || !GAABB3::overlap(bbox, transform.to_parent(object_bbox)))
+                continue;
+
             // Retrieve the region kit of the object.
             Access<RegionKit> region_kit(&object.get_region_kit());
 
@@ -230,9 +428,10 @@ void AOVoxelTree::build(
                     const GVector3 v1(transform.point_to_parent(v1_os));
                     const GVector3 v2(transform.point_to_parent(v2_os));
 
-                    // Push the triangle into the tree.
+                    // Push the triangle into the tree if it intersects the bounding box.
                     TriangleIntersector intersector(v0, v1, v2);
-                    builder.push(intersector);
+                    if (intersector.intersect(bbox))
+                        builder.push(intersector);
                 }
             }
         }
@@ -37,8 +37,14 @@
 // appleseed.foundation headers.
 #include "foundation/math/basis.h"
 #include "foundation/math/voxel.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cstddef>
+#include <string>
 
 // Forward declarations.
+namespace foundation    { class JobQueue; }
 namespace renderer      { class Scene; }
 
 namespace renderer
@@ -51,10 +57,24 @@ namespace renderer
 class AOVoxelTree
 {
   public:
-    // Constructor, build the tree for a given scene.
+    // Constructor, build the tree for a given scene. If a job queue is provided, the eight
+    // octants of the tree are built in parallel by jobs scheduled on this queue, which must
+    // be serviced by a running job manager.
     AOVoxelTree(
-        const Scene&        scene,
-        const GScalar       max_extent_fraction);
+        const Scene&            scene,
+        const GScalar           max_extent_fraction,
+        foundation::JobQueue*   job_queue = 0);
+
+    // Constructor, load the tree from a file written by dump_tree_to_disk() if it exists and
+    // was built from the current geometry of the scene with the same leaf size, otherwise build
+    // the tree and write it to this file. The geometry is identified by the versions of objects
+    // and assemblies and by the transforms of their instances; versions only identify changes
+    // made in the current session, the file must be deleted when a scene file is edited.
+    AOVoxelTree(
+        const Scene&            scene,
+        const GScalar           max_extent_fraction,
+        foundation::JobQueue*   job_queue,
+        const std::string&      cache_filename);
 
     // Return the maximum leaf node diagonal length.
     GScalar get_max_diag_length() const;
@@ -63,7 +83,12 @@ class AOVoxelTree
     void dump_solid_leaves_to_disk(const std::string& filename) const;
 
     // Dump the entire tree to disk, in proprietary binary format.
-    void dump_tree_to_disk(const std::string& filename) const;
+    // Return true on success, false otherwise.
+    bool dump_tree_to_disk(const std::string& filename) const;
+
+    // Load the tree from a file written by dump_tree_to_disk().
+    // Return true on success, false otherwise (the tree is then left empty).
+    bool load_tree_from_disk(const std::string& filename);
 
   private:
     friend class AOVoxelTreeIntersector;
@@ -76,12 +101,24 @@ class AOVoxelTree
         BuilderType
     > TreeStatisticsType;
 
+    class BuildOctantJob;
+
     // Voxel tree.
     TreeType                m_tree;
 
     // Build the tree.
     void build(
+        const Scene&            scene,
+        const GScalar           max_extent_fraction,
+        foundation::JobQueue*   job_queue);
+
+    // Compute a signature of the geometry of a scene.
+    static foundation::uint64 compute_geometry_signature(const Scene& scene);
+
+    // Push the scene triangles intersecting a given bounding box into a builder.
+    static void push_triangles(
         const Scene&        scene,
+        const GAABB3&       bbox,
         BuilderType&        builder);
 };
 
@@ -37,6 +37,7 @@
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
 #include "foundation/utility/attributeset.h"
+#include "foundation/utility/containers/adoptablearray.h"
 #include "foundation/utility/lazy.h"
 #include "foundation/utility/numerictype.h"
 #include "foundation/utility/poolallocator.h"
@@ -62,9 +63,10 @@ class StaticTessellation
     typedef Primitive PrimitiveType;
 
     // Vertex and primitive array types.
+    // These arrays can reference externally owned buffers, see foundation::AdoptableArray.
     // todo: use paged arrays?
-    typedef std::vector<GVector3> VectorArray;
-    typedef std::vector<PrimitiveType> PrimitiveArray;
+    typedef foundation::AdoptableArray<GVector3> VectorArray;
+    typedef foundation::AdoptableArray<PrimitiveType> PrimitiveArray;
 
     // Primary features.
     VectorArray                 m_vertices;
@@ -113,6 +115,9 @@ class StaticTessellation
     // Compute the local space bounding box of the tessellation over the shutter interval.
     GAABB3 compute_local_bbox() const;
 
+    // Return the size (in bytes) of this object in memory.
+    size_t get_memory_size() const;
+
   private:
     foundation::AttributeSet::ChannelID m_uv_0_cid;         // UV coordinates set #0
     foundation::AttributeSet::ChannelID m_ms_count_cid;     // motion segment count
@@ -279,6 +284,22 @@ GAABB3 StaticTessellation<Primitive>::compute_local_bbox() const
     return bbox;
 }
 
+template <typename Primitive>
+size_t StaticTessellation<Primitive>::get_memory_size() const
+{
+    // Attribute sets account for their own size.
+    return
+          sizeof(m_vertices) + m_vertices.size() * sizeof(GVector3)
+        + sizeof(m_vertex_normals) + m_vertex_normals.size() * sizeof(GVector3)
+        + sizeof(m_primitives) + m_primitives.size() * sizeof(PrimitiveType)
+        + m_tessellation_attributes.get_memory_size()
+        + m_primitive_attributes.get_memory_size()
+        + m_vertex_attributes.get_memory_size()
+        + sizeof(m_uv_0_cid)
+        + sizeof(m_ms_count_cid)
+        + sizeof(m_vp_cid);
+}
+
 template <typename Primitive>
 void StaticTessellation<Primitive>::create_uv_0_attribute()
 {
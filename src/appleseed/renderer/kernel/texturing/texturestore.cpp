@@ -42,6 +42,7 @@
 #include "foundation/image/colorspace.h"
 #include "foundation/image/tile.h"
 #include "foundation/platform/types.h"
+#include "foundation/utility/eventtracer.h"
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/memory.h"
 #include "foundation/utility/statistics.h"
@@ -64,19 +65,113 @@ namespace renderer
 TextureStore::TextureStore(
     const Scene&        scene,
     const ParamArray&   params)
-  : m_tile_swapper(scene, params)
+  : m_tile_swapper(params)
   , m_tile_cache(m_tile_swapper)
+  , m_retained_tile_count(0)
+  , m_reused_tile_count(0)
 {
+    bind_scene(scene);
+}
+
+TextureStore::TextureStore(const ParamArray& params)
+  : m_tile_swapper(params)
+  , m_tile_cache(m_tile_swapper)
+  , m_retained_tile_count(0)
+  , m_reused_tile_count(0)
+{
+}
+
+void TextureStore::bind_scene(const Scene& scene)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    m_tile_swapper.bind_scene(&scene);
+    m_tile_swapper.begin_session();
+
+    drop_modified_textures(~0, scene.textures());
+    drop_modified_textures(scene.assemblies());
+
+    m_tile_cache.clear_statistics();
+    m_retained_tile_count = m_tile_swapper.get_tile_count();
+    m_reused_tile_count = 0;
+}
+
+void TextureStore::unbind_scene()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    m_tile_swapper.bind_scene(0);
+}
+
+void TextureStore::clear()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    m_tile_cache.clear();
+}
+
+size_t TextureStore::get_memory_limit() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    return m_tile_swapper.get_memory_limit();
+}
+
+void TextureStore::set_memory_limit(const size_t memory_limit)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    m_tile_swapper.set_memory_limit(memory_limit);
 }
 
 StatisticsVector TextureStore::get_statistics() const
 {
+    boost::mutex::scoped_lock lock(m_mutex);
+
     Statistics stats = make_single_stage_cache_stats(m_tile_cache);
+    stats.insert("sessions", m_tile_swapper.get_session());
+    stats.insert("retained tiles", m_retained_tile_count);
+    stats.insert("reused tiles", m_reused_tile_count);
+    stats.insert("tiles", m_tile_swapper.get_tile_count());
+    stats.insert_size("size", m_tile_swapper.get_memory_size());
     stats.insert_size("peak size", m_tile_swapper.get_peak_memory_size());
+    stats.insert_size("max size", m_tile_swapper.get_memory_limit());
 
     return StatisticsVector::make("texture store statistics", stats);
 }
 
+void TextureStore::drop_modified_textures(
+    const UniqueID              assembly_uid,
+    const TextureContainer&     textures)
+{
+    for (size_t i = 0; i < textures.size(); ++i)
+    {
+        Texture* texture = textures.get_by_index(i);
+
+        if (texture->update_source())
+        {
+            RENDERER_LOG_DEBUG(
+                "texture \"%s\" was modified, dropping its tiles from the texture store.",
+                texture->get_name());
+
+            const UniqueID texture_uid = texture->get_uid();
+
+            m_tile_cache.invalidate(
+                TileKey(assembly_uid, texture_uid, 0),
+                TileKey(assembly_uid, texture_uid + 1, 0));
+        }
+    }
+}
+
+void TextureStore::drop_modified_textures(const AssemblyContainer& assemblies)
+{
+    for (const_each<AssemblyContainer> i = assemblies; i; ++i)
+    {
+        drop_modified_textures(i->get_uid(), i->textures());
+        drop_modified_textures(i->assemblies());
+    }
+}
+
 
 //
 // TextureStore::TileSwapper class implementation.
@@ -143,27 +238,40 @@ namespace
     }
 }
 
-TextureStore::TileSwapper::TileSwapper(
-    const Scene&        scene,
-    const ParamArray&   params)
-  : m_scene(scene)
+TextureStore::TileSwapper::TileSwapper(const ParamArray& params)
+  : m_scene(0)
   , m_params(params)
+  , m_memory_limit(m_params.m_memory_limit)
+  , m_session(0)
+  , m_tile_count(0)
   , m_memory_size(0)
   , m_peak_memory_size(0)
+  , m_memory_account(MemoryCategoryTextures)
+{
+}
+
+void TextureStore::TileSwapper::bind_scene(const Scene* scene)
+{
+    m_scene = scene;
+
+    m_assemblies.clear();
+
+    if (m_scene)
+        gather_assemblies(m_scene->assemblies());
+}
+
+void TextureStore::TileSwapper::begin_session()
 {
-    gather_assemblies(scene.assemblies());
+    ++m_session;
 }
 
 void TextureStore::TileSwapper::load(const TileKey& key, TileRecord& record)
 {
-    // Fetch the texture container.
-    const TextureContainer& textures =
-        key.m_assembly_uid == ~0
-            ? m_scene.textures()
-            : m_assemblies[key.m_assembly_uid]->textures();
+    const ScopedEvent event("load texture tile", "texturing");
 
     // Fetch the texture.
-    Texture* texture = textures.get_by_uid(key.m_texture_uid);
+    Texture* texture = find_texture(key);
+    assert(texture);
 
     if (m_params.m_track_tile_loading)
     {
@@ -178,6 +286,7 @@ void TextureStore::TileSwapper::load(const TileKey& key, TileRecord& record)
     // Load the tile.
     record.m_tile = texture->load_tile(key.get_tile_x(), key.get_tile_y());
     record.m_owners = 0;
+    record.m_session = m_session;
 
     // Convert the tile to the linear RGB color space.
     switch (texture->get_color_space())
@@ -197,26 +306,28 @@ void TextureStore::TileSwapper::load(const TileKey& key, TileRecord& record)
     }
 
     // Track the amount of memory used by the tile cache.
+    ++m_tile_count;
     m_memory_size += record.m_tile->get_memory_size();
     m_peak_memory_size = max(m_peak_memory_size, m_memory_size);
+    m_memory_account.set_size(m_memory_size);
 
     if (m_params.m_track_store_size)
     {
-        if (m_memory_size > m_params.m_memory_limit)
+        if (m_memory_size > m_memory_limit)
         {
             RENDERER_LOG_DEBUG(
                 "texture store size is %s, exceeding capacity %s by %s",
                 pretty_size(m_memory_size).c_str(),
-                pretty_size(m_params.m_memory_limit).c_str(),
-                pretty_size(m_memory_size - m_params.m_memory_limit).c_str());
+                pretty_size(m_memory_limit).c_str(),
+                pretty_size(m_memory_size - m_memory_limit).c_str());
         }
         else
         {
             RENDERER_LOG_DEBUG(
                 "texture store size is %s, below capacity %s by %s",
                 pretty_size(m_memory_size).c_str(),
-                pretty_size(m_params.m_memory_limit).c_str(),
-                pretty_size(m_params.m_memory_limit - m_memory_size).c_str());
+                pretty_size(m_memory_limit).c_str(),
+                pretty_size(m_memory_limit - m_memory_size).c_str());
         }
     }
 }
@@ -229,17 +340,21 @@ bool TextureStore::TileSwapper::unload(const TileKey& key, TileRecord& record)
 
     // Track the amount of memory used by the tile cache.
     const size_t tile_memory_size = record.m_tile->get_memory_size();
+    assert(m_tile_count > 0);
     assert(m_memory_size >= tile_memory_size);
+    --m_tile_count;
     m_memory_size -= tile_memory_size;
-
-    // Fetch the texture container.
-    const TextureContainer& textures =
-        key.m_assembly_uid == ~0
-            ? m_scene.textures()
-            : m_assemblies[key.m_assembly_uid]->textures();
+    m_memory_account.set_size(m_memory_size);
 
     // Fetch the texture.
-    Texture* texture = textures.get_by_uid(key.m_texture_uid);
+    Texture* texture = find_texture(key);
+
+    // The texture is gone or the store is not bound to its scene: delete the tile.
+    if (texture == 0)
+    {
+        delete record.m_tile;
+        return true;
+    }
 
     if (m_params.m_track_tile_unloading)
     {
@@ -267,6 +382,28 @@ void TextureStore::TileSwapper::gather_assemblies(const AssemblyContainer& assem
     }
 }
 
+Texture* TextureStore::TileSwapper::find_texture(const TileKey& key) const
+{
+    if (m_scene == 0)
+        return 0;
+
+    // Fetch the texture container.
+    const TextureContainer* textures = &m_scene->textures();
+
+    if (key.m_assembly_uid != ~0)
+    {
+        const AssemblyMap::const_iterator i = m_assemblies.find(key.m_assembly_uid);
+
+        if (i == m_assemblies.end())
+            return 0;
+
+        textures = &i->second->textures();
+    }
+
+    // Fetch the texture.
+    return textures->get_by_uid(key.m_texture_uid);
+}
+
 
 //
 // TextureStore::TileSwapper::Parameters class implementation.
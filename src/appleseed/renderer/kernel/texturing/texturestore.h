@@ -31,6 +31,7 @@
 #define APPLESEED_RENDERER_KERNEL_TEXTURING_TEXTURESTORE_H
 
 // appleseed.renderer headers.
+#include "renderer/global/globalmemory.h"
 #include "renderer/modeling/scene/containers.h"
 
 // appleseed.foundation headers.
@@ -40,6 +41,9 @@
 #include "foundation/utility/cache.h"
 #include "foundation/utility/uid.h"
 
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
 // boost headers.
 #include "boost/cstdint.hpp"
 
@@ -54,6 +58,7 @@ namespace foundation    { class Tile; }
 namespace renderer      { class Assemblies; }
 namespace renderer      { class ParamArray; }
 namespace renderer      { class Scene; }
+namespace renderer      { class Texture; }
 
 namespace renderer
 {
@@ -61,8 +66,16 @@ namespace renderer
 //
 // A shared store for texture tiles (the backend of the thread-local texture cache).
 //
+// A texture store may outlive the renders that use it: an application can bind the
+// same store to a scene at the beginning of every render and unbind it at the end,
+// so that tiles loaded by one render are reused by the next ones instead of being
+// reloaded from disk. Tiles are identified by the unique IDs of their texture and
+// assembly, hence tiles of textures that were removed or replaced in the meantime
+// are never served again; they are simply evicted when the store is full. Tiles of
+// textures whose file was modified on disk are dropped when the store is bound.
+//
 
-class TextureStore
+class DLLSYMBOL TextureStore
   : public foundation::NonCopyable
 {
   public:
@@ -104,20 +117,40 @@ class TextureStore
     {
         foundation::Tile*           m_tile;
         volatile boost::uint32_t    m_owners;
+        size_t                      m_session;      // last session in which this tile was acquired
     };
 
-    // Constructor.
+    // Constructor, binds the store to a given scene.
     TextureStore(
         const Scene&        scene,
         const ParamArray&   params = ParamArray());
 
+    // Constructor, the store is initially not bound to any scene.
+    explicit TextureStore(const ParamArray& params = ParamArray());
+
+    // Bind the store to a scene and start a new session. Tiles loaded in previous
+    // sessions are kept, except those of textures whose source was modified since
+    // (see Texture::update_source()). The scene must outlive the binding. Thread-safe.
+    void bind_scene(const Scene& scene);
+
+    // Unbind the store from its scene. Tiles evicted while the store is unbound
+    // are deleted without notifying their texture. Thread-safe.
+    void unbind_scene();
+
+    // Unload all tiles. Thread-safe.
+    void clear();
+
+    // Get or set the maximum amount of memory (in bytes) used by the tiles. Thread-safe.
+    size_t get_memory_limit() const;
+    void set_memory_limit(const size_t memory_limit);
+
     // Acquire an element from the cache. Thread-safe.
     TileRecord& acquire(const TileKey& key);
 
     // Release a previously-acquired element. Thread-safe.
     void release(TileRecord& record) const;
 
-    // Retrieve performance statistics.
+    // Retrieve performance and reuse statistics of the current session.
     foundation::StatisticsVector get_statistics() const;
 
   private:
@@ -126,9 +159,16 @@ class TextureStore
     {
       public:
         // Constructor.
-        TileSwapper(
-            const Scene&        scene,
-            const ParamArray&   params);
+        explicit TileSwapper(const ParamArray& params);
+
+        // Bind the swapper to a scene, or unbind it if @scene is null.
+        void bind_scene(const Scene* scene);
+
+        // Start a new session.
+        void begin_session();
+
+        // Return the index of the current session.
+        size_t get_session() const;
 
         // Load a cache line.
         void load(const TileKey& key, TileRecord& record);
@@ -139,6 +179,16 @@ class TextureStore
         // Return true if the cache is full, false otherwise.
         bool is_full(const size_t element_count) const;
 
+        // Get or set the maximum memory size in bytes of the tile cache.
+        size_t get_memory_limit() const;
+        void set_memory_limit(const size_t memory_limit);
+
+        // Return the number of tiles in the tile cache.
+        size_t get_tile_count() const;
+
+        // Return the memory size in bytes of the tile cache.
+        size_t get_memory_size() const;
+
         // Return the peak memory size in bytes of the tile cache.
         size_t get_peak_memory_size() const;
 
@@ -155,13 +205,20 @@ class TextureStore
 
         typedef std::map<foundation::UniqueID, const Assembly*> AssemblyMap;
 
-        const Scene&        m_scene;
+        const Scene*        m_scene;
         const Parameters    m_params;
+        size_t              m_memory_limit;
+        size_t              m_session;
+        size_t              m_tile_count;
         size_t              m_memory_size;
         size_t              m_peak_memory_size;
+        MemoryAccount       m_memory_account;
         AssemblyMap         m_assemblies;
 
         void gather_assemblies(const AssemblyContainer& assemblies);
+
+        // Find the texture of a given tile in the bound scene, return 0 if not found.
+        Texture* find_texture(const TileKey& key) const;
     };
 
     typedef foundation::LRUCache<
@@ -170,9 +227,17 @@ class TextureStore
         TileSwapper
     > TileCache;
 
-    boost::mutex    m_mutex;
-    TileSwapper     m_tile_swapper;
-    TileCache       m_tile_cache;
+    mutable boost::mutex    m_mutex;
+    TileSwapper             m_tile_swapper;
+    TileCache               m_tile_cache;
+    size_t                  m_retained_tile_count;
+    size_t                  m_reused_tile_count;
+
+    // Drop the tiles of the textures whose source was modified.
+    void drop_modified_textures(
+        const foundation::UniqueID  assembly_uid,
+        const TextureContainer&     textures);
+    void drop_modified_textures(const AssemblyContainer& assemblies);
 };
 
 
@@ -186,6 +251,14 @@ inline TextureStore::TileRecord& TextureStore::acquire(const TileKey& key)
 
     TileRecord& record = m_tile_cache.get(key);
 
+    // Count the tiles loaded in a previous session that are used again.
+    const size_t session = m_tile_swapper.get_session();
+    if (record.m_session != session)
+    {
+        record.m_session = session;
+        ++m_reused_tile_count;
+    }
+
     boost_atomic::atomic_inc32(&record.m_owners);
 
     return record;
@@ -280,9 +353,35 @@ inline bool TextureStore::TileKey::operator<(const TileKey& rhs) const
 // TextureStore::TileSwapper class implementation.
 //
 
+inline size_t TextureStore::TileSwapper::get_session() const
+{
+    return m_session;
+}
+
 inline bool TextureStore::TileSwapper::is_full(const size_t element_count) const
 {
-    return m_memory_size >= m_params.m_memory_limit;
+    return m_memory_size >= m_memory_limit;
+}
+
+inline size_t TextureStore::TileSwapper::get_memory_limit() const
+{
+    return m_memory_limit;
+}
+
+inline void TextureStore::TileSwapper::set_memory_limit(const size_t memory_limit)
+{
+    assert(memory_limit > 0);
+    m_memory_limit = memory_limit;
+}
+
+inline size_t TextureStore::TileSwapper::get_tile_count() const
+{
+    return m_tile_count;
+}
+
+inline size_t TextureStore::TileSwapper::get_memory_size() const
+{
+    return m_memory_size;
 }
 
 inline size_t TextureStore::TileSwapper::get_peak_memory_size() const
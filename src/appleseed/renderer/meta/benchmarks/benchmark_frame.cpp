@@ -33,8 +33,10 @@
 
 // appleseed.foundation headers.
 #include "foundation/image/color.h"
+#include "foundation/image/image.h"
 #include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
+#include "foundation/platform/system.h"
 #include "foundation/utility/autoreleaseptr.h"
 #include "foundation/utility/benchmark.h"
 
@@ -51,6 +53,8 @@ BENCHMARK_SUITE(Renderer_Modeling_Frame)
     {
         auto_release_ptr<Frame> m_frame;
         auto_ptr<Tile>          m_tile;
+        auto_ptr<Tile>          m_half_tile;
+        auto_ptr<Image>         m_image;
 
         Fixture()
           : m_frame(
@@ -61,8 +65,12 @@ BENCHMARK_SUITE(Renderer_Modeling_Frame)
                         .insert("pixel_format", "float")
                         .insert("color_space", "srgb")))
           , m_tile(new Tile(32, 32, 4, PixelFormatFloat))
+          , m_half_tile(new Tile(32, 32, 4, PixelFormatHalf))
+          , m_image(new Image(m_frame->image()))
         {
             m_tile->clear(Color4f(0.8f, -0.3f, 0.6f, 0.5f));
+            m_half_tile->clear(Color4f(0.8f, -0.3f, 0.6f, 0.5f));
+            m_image->clear(Color4f(0.8f, -0.3f, 0.6f, 0.5f));
         }
     };
 
@@ -70,4 +78,14 @@ BENCHMARK_SUITE(Renderer_Modeling_Frame)
     {
         m_frame->transform_to_output_color_space(*m_tile.get());
     }
+
+    BENCHMARK_CASE_F(TransformToOutputColorSpace_GivenHalfTile_AndFrameColorSpaceIsSRGB, Fixture)
+    {
+        m_frame->transform_to_output_color_space(*m_half_tile.get());
+    }
+
+    BENCHMARK_CASE_F(TransformToOutputColorSpace_GivenImage_AndFrameColorSpaceIsSRGB, Fixture)
+    {
+        m_frame->transform_to_output_color_space(*m_image.get(), System::get_logical_cpu_core_count());
+    }
 }
@@ -0,0 +1,127 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/input/inputarray.h"
+#include "renderer/modeling/input/scalarsource.h"
+#include "renderer/modeling/input/source.h"
+#include "renderer/modeling/scene/scene.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/benchmark.h"
+#include "foundation/utility/string.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <string>
+
+using namespace foundation;
+using namespace renderer;
+
+BENCHMARK_SUITE(Renderer_Modeling_Input_InputArray)
+{
+    class VaryingScalarSource
+      : public Source
+    {
+      public:
+        VaryingScalarSource()
+          : Source(false)
+        {
+        }
+
+        virtual void evaluate(
+            TextureCache&       texture_cache,
+            const Vector2d&     uv,
+            double&             scalar) const OVERRIDE
+        {
+            scalar = uv[0] * uv[1];
+        }
+    };
+
+    // Mimics a layered material: many constant inputs, a few textured ones.
+    void declare_inputs(InputArray& inputs)
+    {
+        for (size_t i = 0; i < 32; ++i)
+        {
+            const std::string name = "scalar" + to_string(i);
+            inputs.declare(name.c_str(), InputFormatScalar);
+            inputs.find(name.c_str()).bind(
+                i % 8 == 0
+                    ? static_cast<Source*>(new VaryingScalarSource())
+                    : static_cast<Source*>(new ScalarSource(static_cast<double>(i))));
+        }
+
+        for (size_t i = 0; i < 8; ++i)
+        {
+            const std::string name = "color" + to_string(i);
+            inputs.declare(name.c_str(), InputFormatSpectralReflectance);
+        }
+    }
+
+    struct Fixture
+    {
+        auto_release_ptr<Scene>     m_scene;
+        TextureStore                m_texture_store;
+        TextureCache                m_texture_cache;
+        InputArray                  m_inputs;
+        InputArray                  m_planned_inputs;
+        Vector2d                    m_uv;
+        SSE_ALIGN uint8             m_values[4 * 1024];
+
+        Fixture()
+          : m_scene(SceneFactory::create())
+          , m_texture_store(m_scene.ref())
+          , m_texture_cache(m_texture_store)
+          , m_uv(0.3, 0.7)
+        {
+            declare_inputs(m_inputs);
+            declare_inputs(m_planned_inputs);
+
+            assert(m_inputs.compute_data_size() <= sizeof(m_values));
+
+            m_planned_inputs.build_evaluation_plan();
+        }
+    };
+
+    BENCHMARK_CASE_F(Evaluate_WithoutEvaluationPlan, Fixture)
+    {
+        m_inputs.evaluate(m_texture_cache, m_uv, m_values);
+    }
+
+    BENCHMARK_CASE_F(Evaluate_WithEvaluationPlan, Fixture)
+    {
+        m_planned_inputs.evaluate(m_texture_cache, m_uv, m_values);
+    }
+}
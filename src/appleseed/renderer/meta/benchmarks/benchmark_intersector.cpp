@@ -0,0 +1,291 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/intersector.h"
+#include "renderer/kernel/intersection/tracecontext.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/object/meshobject.h"
+#include "renderer/modeling/object/object.h"
+#include "renderer/modeling/object/triangle.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/project-builtin/cornellboxproject.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/objectinstance.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/scalar.h"
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/containers/dictionary.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/benchmark.h"
+#include "foundation/utility/foreach.h"
+
+// Standard headers.
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+BENCHMARK_SUITE(Renderer_Kernel_Intersection_Intersector)
+{
+    enum AccelerationStructure
+    {
+        UseRegionTree,          // flushable assembly: region tree, then one triangle tree per region
+        UseTriangleTree,        // one lazily built triangle tree per assembly
+        UseFlatTriangleTree     // one triangle tree per assembly, built when the assembly tree is updated
+    };
+
+    const size_t RayCountX = 64;
+    const size_t RayCountY = 64;
+
+    void configure_assemblies(Scene& scene, const AccelerationStructure acceleration_structure)
+    {
+        if (acceleration_structure != UseFlatTriangleTree)
+            return;
+
+        for (each<AssemblyContainer> i = scene.assemblies(); i; ++i)
+            i->get_parameters().insert_path("acceleration_structure.flat", true);
+    }
+
+    // Cast a grid of rays from a given origin toward a rectangle parallel to the XY plane.
+    void generate_rays(
+        const Vector3d&         origin,
+        const Vector3d&         target_min,
+        const Vector3d&         target_max,
+        vector<ShadingRay>&     rays)
+    {
+        rays.reserve(RayCountX * RayCountY);
+
+        for (size_t y = 0; y < RayCountY; ++y)
+        {
+            for (size_t x = 0; x < RayCountX; ++x)
+            {
+                const Vector3d target(
+                    lerp(target_min.x, target_max.x, (x + 0.5) / RayCountX),
+                    lerp(target_min.y, target_max.y, (y + 0.5) / RayCountY),
+                    target_min.z);
+
+                rays.push_back(
+                    ShadingRay(
+                        origin,
+                        normalize(target - origin),
+                        0.0,
+                        ShadingRay::CameraRay));
+            }
+        }
+    }
+
+    auto_release_ptr<Project> create_large_mesh_project(const AccelerationStructure acceleration_structure)
+    {
+        auto_release_ptr<Project> project(ProjectFactory::create("project"));
+        project->set_scene(SceneFactory::create());
+
+        auto_release_ptr<Assembly> assembly(
+            AssemblyFactory::create(
+                "assembly",
+                ParamArray().insert("flushable", acceleration_structure == UseRegionTree)));
+
+        // Create a wavy height field made of 2 * 400 * 400 triangles.
+        const size_t Resolution = 400;
+        auto_release_ptr<MeshObject> object(MeshObjectFactory::create("mesh", ParamArray()));
+
+        vector<GVector3> vertices;
+        vertices.reserve((Resolution + 1) * (Resolution + 1));
+
+        for (size_t y = 0; y <= Resolution; ++y)
+        {
+            for (size_t x = 0; x <= Resolution; ++x)
+            {
+                const GScalar fx = static_cast<GScalar>(x) / Resolution;
+                const GScalar fy = static_cast<GScalar>(y) / Resolution;
+                const GScalar fz = static_cast<GScalar>(0.05 * sin(40.0 * fx) * cos(40.0 * fy));
+                vertices.push_back(GVector3(fx, fy, fz));
+            }
+        }
+
+        vector<Triangle> triangles;
+        triangles.reserve(2 * Resolution * Resolution);
+
+        for (size_t y = 0; y < Resolution; ++y)
+        {
+            for (size_t x = 0; x < Resolution; ++x)
+            {
+                const size_t v0 = y * (Resolution + 1) + x;
+                const size_t v1 = v0 + 1;
+                const size_t v2 = v0 + Resolution + 1;
+                const size_t v3 = v2 + 1;
+                triangles.push_back(Triangle(v0, v1, v3, 0));
+                triangles.push_back(Triangle(v0, v3, v2, 0));
+            }
+        }
+
+        object->push_vertices(&vertices[0], vertices.size());
+        object->push_triangles(&triangles[0], triangles.size());
+        object->push_material_slot("material");
+
+        assembly->objects().insert(auto_release_ptr<Object>(object));
+        assembly->object_instances().insert(
+            ObjectInstanceFactory::create(
+                "mesh_inst",
+                ParamArray(),
+                "mesh",
+                Transformd::identity(),
+                StringDictionary()));
+
+        project->get_scene()->assembly_instances().insert(
+            AssemblyInstanceFactory::create(
+                "assembly_inst",
+                ParamArray(),
+                "assembly"));
+        project->get_scene()->assemblies().insert(assembly);
+
+        configure_assemblies(*project->get_scene(), acceleration_structure);
+
+        return project;
+    }
+
+    auto_release_ptr<Project> create_cornell_box_project(const AccelerationStructure acceleration_structure)
+    {
+        auto_release_ptr<Project> project(CornellBoxProjectFactory::create());
+        configure_assemblies(*project->get_scene(), acceleration_structure);
+        return project;
+    }
+
+    struct FixtureBase
+    {
+        auto_release_ptr<Project>   m_project;
+        auto_ptr<TraceContext>      m_trace_context;
+        auto_ptr<TextureStore>      m_texture_store;
+        auto_ptr<TextureCache>      m_texture_cache;
+        auto_ptr<Intersector>       m_intersector;
+        vector<ShadingRay>          m_rays;
+        size_t                      m_hit_count;
+
+        explicit FixtureBase(auto_release_ptr<Project> project)
+          : m_project(project)
+          , m_hit_count(0)
+        {
+            Scene& scene = *m_project->get_scene();
+
+            InputBinder input_binder;
+            input_binder.bind(scene);
+
+            m_trace_context.reset(new TraceContext(scene));
+            m_texture_store.reset(new TextureStore(scene));
+            m_texture_cache.reset(new TextureCache(*m_texture_store));
+            m_intersector.reset(new Intersector(*m_trace_context, *m_texture_cache));
+        }
+
+        void trace_rays()
+        {
+            for (size_t i = 0; i < m_rays.size(); ++i)
+            {
+                ShadingPoint shading_point;
+                if (m_intersector->trace(m_rays[i], shading_point))
+                    ++m_hit_count;
+            }
+        }
+    };
+
+    template <AccelerationStructure Structure>
+    struct CornellBoxFixture
+      : public FixtureBase
+    {
+        CornellBoxFixture()
+          : FixtureBase(create_cornell_box_project(Structure))
+        {
+            generate_rays(
+                Vector3d(0.278, 0.273, -0.800),
+                Vector3d(0.0, 0.0, 0.559),
+                Vector3d(0.556, 0.548, 0.559),
+                m_rays);
+
+            // Build the acceleration structures.
+            trace_rays();
+        }
+    };
+
+    template <AccelerationStructure Structure>
+    struct LargeMeshFixture
+      : public FixtureBase
+    {
+        LargeMeshFixture()
+          : FixtureBase(create_large_mesh_project(Structure))
+        {
+            generate_rays(
+                Vector3d(0.5, 0.5, 2.0),
+                Vector3d(0.0, 0.0, 0.0),
+                Vector3d(1.0, 1.0, 0.0),
+                m_rays);
+
+            // Build the acceleration structures.
+            trace_rays();
+        }
+    };
+
+    BENCHMARK_CASE_F(Trace_CornellBox_TriangleTree, CornellBoxFixture<UseTriangleTree>)
+    {
+        trace_rays();
+    }
+
+    BENCHMARK_CASE_F(Trace_CornellBox_FlatTriangleTree, CornellBoxFixture<UseFlatTriangleTree>)
+    {
+        trace_rays();
+    }
+
+    BENCHMARK_CASE_F(Trace_LargeMesh_RegionTree, LargeMeshFixture<UseRegionTree>)
+    {
+        trace_rays();
+    }
+
+    BENCHMARK_CASE_F(Trace_LargeMesh_TriangleTree, LargeMeshFixture<UseTriangleTree>)
+    {
+        trace_rays();
+    }
+
+    BENCHMARK_CASE_F(Trace_LargeMesh_FlatTriangleTree, LargeMeshFixture<UseFlatTriangleTree>)
+    {
+        trace_rays();
+    }
+}
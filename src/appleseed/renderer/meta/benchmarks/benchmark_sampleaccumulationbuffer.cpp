@@ -0,0 +1,93 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/globalsampleaccumulationbuffer.h"
+#include "renderer/kernel/rendering/localsampleaccumulationbuffer.h"
+#include "renderer/kernel/rendering/sample.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/color.h"
+#include "foundation/math/filter.h"
+#include "foundation/math/rng.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/benchmark.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+BENCHMARK_SUITE(Renderer_Kernel_Rendering_SampleAccumulationBuffer)
+{
+    //
+    // Each case stores a batch of 1024 samples: the number of samples stored
+    // per second is 1024 times the number of iterations per second.
+    //
+
+    struct Fixture
+    {
+        static const size_t SampleCount = 1024;
+
+        const GaussianFilter2<double>   m_filter;
+        GlobalSampleAccumulationBuffer  m_global_buffer;
+        LocalSampleAccumulationBuffer   m_local_buffer;
+        SampleBatch                     m_samples;
+
+        Fixture()
+          : m_filter(1.5, 1.5, 8.0)
+          , m_global_buffer(1280, 720, 32, 32, m_filter)
+          , m_local_buffer(1280, 720, 32, 32, m_filter)
+        {
+            m_global_buffer.clear();
+            m_local_buffer.clear();
+
+            MersenneTwister rng;
+
+            m_samples.reserve(SampleCount);
+
+            for (size_t i = 0; i < SampleCount; ++i)
+            {
+                const Vector2d position(rand_double2(rng), rand_double2(rng));
+                const Color4f color(rand_float1(rng), rand_float1(rng), rand_float1(rng), 1.0f);
+                m_samples.push_back(position, color);
+            }
+        }
+    };
+
+    BENCHMARK_CASE_F(StoreSamples_Given1024Samples_GlobalBuffer, Fixture)
+    {
+        m_global_buffer.store_samples(m_samples);
+    }
+
+    BENCHMARK_CASE_F(StoreSamples_Given1024Samples_LocalBuffer, Fixture)
+    {
+        m_local_buffer.store_samples(m_samples);
+    }
+}
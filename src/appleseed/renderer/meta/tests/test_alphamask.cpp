@@ -0,0 +1,139 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/intersection/alphamask.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+#include "foundation/utility/bitmask.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Intersection_AlphaMask)
+{
+    bool matches_bit_mask(const AlphaMask& mask, const BitMask2& bits)
+    {
+        const size_t width = bits.get_width();
+        const size_t height = bits.get_height();
+
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                const Vector2f uv(
+                    (x + 0.5f) / width,
+                    (y + 0.5f) / height);
+
+                if (mask.is_opaque(uv) != bits.get(x, y))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    TEST_CASE(Constructor_GivenFullyOpaqueBitMask_StoresNoMixedBlock)
+    {
+        BitMask2 bits(40, 24);
+        bits.clear();
+
+        for (size_t y = 0; y < 24; ++y)
+        {
+            for (size_t x = 0; x < 40; ++x)
+                bits.set(x, y);
+        }
+
+        const AlphaMask mask(bits, true, 0.0);
+
+        EXPECT_EQ(6, mask.get_block_count());
+        EXPECT_EQ(0, mask.get_mixed_block_count());
+        EXPECT_TRUE(matches_bit_mask(mask, bits));
+    }
+
+    TEST_CASE(Constructor_GivenFullyTransparentBitMask_StoresNoMixedBlock)
+    {
+        BitMask2 bits(40, 24);
+        bits.clear();
+
+        const AlphaMask mask(bits, true, 1.0);
+
+        EXPECT_EQ(6, mask.get_block_count());
+        EXPECT_EQ(0, mask.get_mixed_block_count());
+        EXPECT_TRUE(matches_bit_mask(mask, bits));
+    }
+
+    TEST_CASE(IsOpaque_GivenCheckerboardBitMask_MatchesBitMask)
+    {
+        BitMask2 bits(37, 21);
+        bits.clear();
+
+        for (size_t y = 0; y < 21; ++y)
+        {
+            for (size_t x = 0; x < 37; ++x)
+                bits.set(x, y, ((x ^ y) & 1) != 0);
+        }
+
+        const AlphaMask mask(bits, true, 0.5);
+
+        EXPECT_EQ(mask.get_block_count(), mask.get_mixed_block_count());
+        EXPECT_TRUE(matches_bit_mask(mask, bits));
+    }
+
+    TEST_CASE(IsOpaque_GivenSingleOpaqueTexel_StoresSingleMixedBlock)
+    {
+        BitMask2 bits(64, 64);
+        bits.clear();
+        bits.set(21, 45);
+
+        const AlphaMask mask(bits, true, 1.0);
+
+        EXPECT_EQ(16, mask.get_block_count());
+        EXPECT_EQ(1, mask.get_mixed_block_count());
+        EXPECT_TRUE(matches_bit_mask(mask, bits));
+    }
+
+    TEST_CASE(IsOpaque_GivenUVOutsideUnitSquare_ClampsToMaskEdges)
+    {
+        BitMask2 bits(4, 4);
+        bits.clear();
+        bits.set(0, 0);
+        bits.set(3, 3);
+
+        const AlphaMask mask(bits, true, 0.875);
+
+        EXPECT_TRUE(mask.is_opaque(Vector2f(-1.0f, -1.0f)));
+        EXPECT_TRUE(mask.is_opaque(Vector2f(2.0f, 2.0f)));
+        EXPECT_FALSE(mask.is_opaque(Vector2f(-1.0f, 2.0f)));
+    }
+}
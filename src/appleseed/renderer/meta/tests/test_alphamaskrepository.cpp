@@ -0,0 +1,88 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/intersection/alphamask.h"
+#include "renderer/kernel/intersection/alphamaskrepository.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/input/scalarsource.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/test.h"
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Intersection_AlphaMaskRepository)
+{
+    struct Fixture
+    {
+        TextureStore            m_texture_store;
+        TextureCache            m_texture_cache;
+        AlphaMaskRepository     m_repository;
+
+        Fixture()
+          : m_texture_cache(m_texture_store)
+        {
+        }
+    };
+
+    TEST_CASE_F(Acquire_GivenSameAlphaMapTwice_ReturnsSharedAlphaMask, Fixture)
+    {
+        const ScalarSource alpha_map(0.0);
+
+        const AlphaMask* mask1 = m_repository.acquire(alpha_map, m_texture_cache);
+        const AlphaMask* mask2 = m_repository.acquire(alpha_map, m_texture_cache);
+
+        EXPECT_EQ(mask1, mask2);
+        EXPECT_EQ(1, m_repository.get_mask_count());
+
+        m_repository.release(mask2);
+        m_repository.release(mask1);
+
+        EXPECT_EQ(0, m_repository.get_mask_count());
+    }
+
+    TEST_CASE_F(Acquire_AfterInvalidate_RebuildsAlphaMask, Fixture)
+    {
+        const ScalarSource alpha_map(0.0);
+
+        const AlphaMask* mask1 = m_repository.acquire(alpha_map, m_texture_cache);
+        m_repository.invalidate();
+        const AlphaMask* mask2 = m_repository.acquire(alpha_map, m_texture_cache);
+
+        EXPECT_NEQ(mask1, mask2);
+        EXPECT_EQ(2, m_repository.get_mask_count());
+
+        m_repository.release(mask1);
+        m_repository.release(mask2);
+
+        EXPECT_EQ(0, m_repository.get_mask_count());
+    }
+}
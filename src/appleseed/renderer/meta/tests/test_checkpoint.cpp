@@ -0,0 +1,178 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/checkpoint.h"
+#include "renderer/kernel/rendering/localsampleaccumulationbuffer.h"
+#include "renderer/kernel/rendering/sample.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/exceptions/exceptionioerror.h"
+#include "foundation/image/color.h"
+#include "foundation/math/filter.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Rendering_Checkpoint)
+{
+    const char* Filename = "unit tests/outputs/test_checkpoint.bin";
+
+    string read_file(const char* filename)
+    {
+        ifstream file(filename, ios::binary);
+        return string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    }
+
+    void write_value(const uint32 value)
+    {
+        CheckpointWriter writer(Filename, ProgressiveCheckpoint, 64, 32);
+        writer.write(value);
+        writer.commit();
+    }
+
+    TEST_CASE(ReadValue_GivenCommittedCheckpoint_ReturnsWrittenValue)
+    {
+        write_value(42);
+
+        CheckpointReader reader(Filename, ProgressiveCheckpoint, 64, 32);
+        uint32 value;
+        reader.read(value);
+
+        EXPECT_EQ(42, value);
+    }
+
+    TEST_CASE(CheckpointWriter_GivenCheckpointIsNotCommitted_LeavesExistingCheckpointUntouched)
+    {
+        write_value(42);
+
+        {
+            CheckpointWriter writer(Filename, ProgressiveCheckpoint, 64, 32);
+            writer.write(static_cast<uint32>(7));
+        }
+
+        CheckpointReader reader(Filename, ProgressiveCheckpoint, 64, 32);
+        uint32 value;
+        reader.read(value);
+
+        EXPECT_EQ(42, value);
+    }
+
+    TEST_CASE(CheckpointReader_GivenDifferentCheckpointType_ThrowsExceptionIOError)
+    {
+        write_value(42);
+
+        EXPECT_EXCEPTION(ExceptionIOError,
+        {
+            CheckpointReader reader(Filename, MultiPassCheckpoint, 64, 32);
+        });
+    }
+
+    TEST_CASE(CheckpointReader_GivenDifferentFrameDimensions_ThrowsExceptionIOError)
+    {
+        write_value(42);
+
+        EXPECT_EXCEPTION(ExceptionIOError,
+        {
+            CheckpointReader reader(Filename, ProgressiveCheckpoint, 32, 64);
+        });
+    }
+
+    TEST_CASE(CheckpointReader_GivenMissingFile_ThrowsExceptionIOError)
+    {
+        EXPECT_EXCEPTION(ExceptionIOError,
+        {
+            CheckpointReader reader("unit tests/outputs/missing_checkpoint.bin", ProgressiveCheckpoint, 64, 32);
+        });
+    }
+
+    TEST_CASE(ReadValue_PastEndOfCheckpoint_ThrowsExceptionIOError)
+    {
+        write_value(42);
+
+        CheckpointReader reader(Filename, ProgressiveCheckpoint, 64, 32);
+        uint32 value;
+        reader.read(value);
+
+        EXPECT_EXCEPTION(ExceptionIOError,
+        {
+            reader.read(value);
+        });
+    }
+
+    TEST_CASE(ReadCheckpoint_GivenLocalSampleAccumulationBuffer_RestoresBufferContents)
+    {
+        const BoxFilter2<double> filter(1.0, 1.0);
+
+        LocalSampleAccumulationBuffer buffer(64, 32, 16, 16, filter);
+        buffer.clear();
+
+        for (size_t i = 0; i < 5000; ++i)
+        {
+            SampleBatch samples;
+            samples.push_back(
+                Vector2d((i % 97) / 97.0, (i % 31) / 31.0),
+                Color4f(static_cast<float>(i % 7)));
+            buffer.store_samples(samples);
+        }
+
+        {
+            CheckpointWriter writer(Filename, ProgressiveCheckpoint, 64, 32);
+            buffer.write_checkpoint(writer);
+            writer.commit();
+        }
+
+        const string expected = read_file(Filename);
+
+        LocalSampleAccumulationBuffer restored_buffer(64, 32, 16, 16, filter);
+        restored_buffer.clear();
+
+        {
+            CheckpointReader reader(Filename, ProgressiveCheckpoint, 64, 32);
+            restored_buffer.read_checkpoint(reader);
+        }
+
+        {
+            CheckpointWriter writer(Filename, ProgressiveCheckpoint, 64, 32);
+            restored_buffer.write_checkpoint(writer);
+            writer.commit();
+        }
+
+        EXPECT_EQ(5000, restored_buffer.get_sample_count());
+        EXPECT_TRUE(expected == read_file(Filename));
+    }
+}
@@ -27,9 +27,128 @@
 // THE SOFTWARE.
 //
 
+// appleseed.renderer headers.
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/utility/paramarray.h"
+
 // appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/color.h"
+#include "foundation/image/colorspace.h"
+#include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
+#include "foundation/image/tile.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/iostreamop.h"
 #include "foundation/utility/test.h"
 
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
 TEST_SUITE(Renderer_Modeling_Frame_Frame)
 {
+    auto_release_ptr<Frame> create_frame(
+        const char*     pixel_format,
+        const char*     color_space)
+    {
+        return
+            FrameFactory::create(
+                "frame",
+                ParamArray()
+                    .insert("resolution", "100 60")
+                    .insert("tile_size", "16 16")
+                    .insert("pixel_format", pixel_format)
+                    .insert("color_space", color_space)
+                    .insert("gamma_correction", "2.2")
+                    .insert("clamping", "true"));
+    }
+
+    void fill_image(Image& image)
+    {
+        const CanvasProperties& props = image.properties();
+
+        for (size_t y = 0; y < props.m_canvas_height; ++y)
+        {
+            for (size_t x = 0; x < props.m_canvas_width; ++x)
+            {
+                image.set_pixel(
+                    x, y,
+                    Color4f(
+                        static_cast<float>(x) / props.m_canvas_width * 1.5f,
+                        static_cast<float>(y) / props.m_canvas_height,
+                        0.25f,
+                        0.5f));
+            }
+        }
+    }
+
+    bool transform_image_matches_transform_tiles(const char* pixel_format)
+    {
+        auto_release_ptr<Frame> frame = create_frame(pixel_format, "srgb");
+
+        Image image(frame->image());
+        fill_image(image);
+
+        Image expected(image);
+        const CanvasProperties& props = expected.properties();
+        for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+        {
+            for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
+                frame->transform_to_output_color_space(expected.tile(tx, ty));
+        }
+
+        frame->transform_to_output_color_space(image, 4);
+
+        for (size_t y = 0; y < props.m_canvas_height; ++y)
+        {
+            for (size_t x = 0; x < props.m_canvas_width; ++x)
+            {
+                Color4f expected_color, color;
+                expected.get_pixel(x, y, expected_color);
+                image.get_pixel(x, y, color);
+
+                if (expected_color != color)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    TEST_CASE(TransformToOutputColorSpace_GivenFloatImage_MatchesTileByTileTransform)
+    {
+        EXPECT_TRUE(transform_image_matches_transform_tiles("float"));
+    }
+
+    TEST_CASE(TransformToOutputColorSpace_GivenHalfImage_MatchesTileByTileTransform)
+    {
+        EXPECT_TRUE(transform_image_matches_transform_tiles("half"));
+    }
+
+    TEST_CASE(TransformToOutputColorSpace_GivenCIEXYZFloatTile_ConvertsColorAndPreservesAlpha)
+    {
+        auto_release_ptr<Frame> frame =
+            FrameFactory::create(
+                "frame",
+                ParamArray()
+                    .insert("resolution", "16 16")
+                    .insert("tile_size", "16 16")
+                    .insert("pixel_format", "float")
+                    .insert("color_space", "ciexyz"));
+
+        Tile tile(4, 4, 4, PixelFormatFloat);
+        tile.clear(Color4f(0.2f, 0.5f, 0.7f, 0.3f));
+
+        frame->transform_to_output_color_space(tile);
+
+        Color4f color;
+        tile.get_pixel(0, color);
+
+        const Color3f expected = linear_rgb_to_ciexyz(Color3f(0.2f, 0.5f, 0.7f));
+        EXPECT_FEQ_EPS(expected, color.rgb(), 1.0e-5f);
+        EXPECT_EQ(0.3f, color[3]);
+    }
 }
@@ -0,0 +1,252 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/rendering/generic/genericsamplegenerator.h"
+#include "renderer/kernel/rendering/isamplegenerator.h"
+#include "renderer/kernel/rendering/isamplerenderer.h"
+#include "renderer/kernel/rendering/sampleaccumulationbuffer.h"
+#include "renderer/kernel/shading/shadingresult.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/color.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/job.h"
+#include "foundation/utility/statistics.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Rendering_Generic_GenericSampleGenerator)
+{
+    // A sample renderer that records the sample positions and the first two dimensions it draws past them.
+    class RecordingSampleRenderer
+      : public ISampleRenderer
+    {
+      public:
+        RecordingSampleRenderer(
+            vector<Vector2d>&       image_points,
+            vector<Vector2d>&       samples)
+          : m_image_points(image_points)
+          , m_samples(samples)
+        {
+        }
+
+        virtual void release() OVERRIDE
+        {
+            delete this;
+        }
+
+        virtual void render_sample(
+            SamplingContext&        sampling_context,
+            const PixelContext&     pixel_context,
+            const Vector2d&         image_point,
+            ShadingResult&          shading_result) OVERRIDE
+        {
+            m_image_points.push_back(image_point);
+
+            SamplingContext child_sampling_context = sampling_context.split(2, 1);
+            m_samples.push_back(child_sampling_context.next_vector2<2>());
+
+            shading_result.set_main_to_linear_rgba(Color4f(0.0f));
+        }
+
+        virtual StatisticsVector get_statistics() const OVERRIDE
+        {
+            return StatisticsVector();
+        }
+
+      private:
+        vector<Vector2d>&           m_image_points;
+        vector<Vector2d>&           m_samples;
+    };
+
+    class RecordingSampleRendererFactory
+      : public ISampleRendererFactory
+    {
+      public:
+        vector<Vector2d>            m_image_points;
+        vector<Vector2d>            m_samples;
+
+        virtual void release() OVERRIDE
+        {
+            delete this;
+        }
+
+        virtual ISampleRenderer* create(const bool primary) OVERRIDE
+        {
+            return new RecordingSampleRenderer(m_image_points, m_samples);
+        }
+    };
+
+    // The sample positions cover a 2^i x 3^j crop window: every sequence index yields a sample.
+    auto_release_ptr<Frame> create_frame()
+    {
+        return
+            FrameFactory::create(
+                "frame",
+                ParamArray()
+                    .insert("resolution", "2 3")
+                    .insert("crop_window", "0 0 1 2"));
+    }
+
+    // Generate samples with a given sample generator, as a progressive frame renderer worker would.
+    void generate_samples(
+        GenericSampleGeneratorFactory&  sample_generator_factory,
+        ISampleGenerator&               sample_generator,
+        const size_t                    sample_count)
+    {
+        auto_ptr<SampleAccumulationBuffer> buffer(
+            sample_generator_factory.create_sample_accumulation_buffer());
+        buffer->clear();
+
+        AbortSwitch abort_switch;
+        sample_generator.generate_samples(sample_count, *buffer, abort_switch);
+    }
+
+    TEST_CASE(GenerateSamples_QMCMode_SamplesOfSuccessiveSequenceIndicesAreStratified)
+    {
+        const size_t SampleCount = 64;     // 8 x 8 strata
+
+        auto_release_ptr<Frame> frame(create_frame());
+
+        RecordingSampleRendererFactory sample_renderer_factory;
+        GenericSampleGeneratorFactory sample_generator_factory(
+            frame.ref(),
+            &sample_renderer_factory,
+            ParamArray().insert("sampling_mode", "qmc"));
+
+        auto_release_ptr<ISampleGenerator> sample_generator(
+            sample_generator_factory.create(0, 1, true));
+        generate_samples(sample_generator_factory, sample_generator.ref(), SampleCount);
+
+        const vector<Vector2d>& samples = sample_renderer_factory.m_samples;
+        ASSERT_EQ(SampleCount, samples.size());
+
+        vector<size_t> strata(SampleCount, 0);
+
+        for (size_t i = 0; i < SampleCount; ++i)
+        {
+            const size_t x = truncate<size_t>(samples[i][0] * 8.0);
+            const size_t y = truncate<size_t>(samples[i][1] * 8.0);
+            ++strata[y * 8 + x];
+        }
+
+        for (size_t i = 0; i < SampleCount; ++i)
+            EXPECT_EQ(1, strata[i]);
+    }
+
+    TEST_CASE(Resume_GivenSequenceEndOfInterruptedRender_ContinuesUninterruptedRender)
+    {
+        const size_t SampleCount = 100;
+
+        auto_release_ptr<Frame> frame(create_frame());
+        const ParamArray params = ParamArray().insert("sampling_mode", "qmc");
+
+        // Render all samples at once.
+        RecordingSampleRendererFactory expected_factory;
+        GenericSampleGeneratorFactory expected_generator_factory(frame.ref(), &expected_factory, params);
+        auto_release_ptr<ISampleGenerator> expected_generator(expected_generator_factory.create(0, 1, true));
+        generate_samples(expected_generator_factory, expected_generator.ref(), 2 * SampleCount);
+
+        // Render half of the samples, then resume with a new sample generator.
+        RecordingSampleRendererFactory interrupted_factory;
+        GenericSampleGeneratorFactory interrupted_generator_factory(frame.ref(), &interrupted_factory, params);
+        auto_release_ptr<ISampleGenerator> interrupted_generator(interrupted_generator_factory.create(0, 1, true));
+        generate_samples(interrupted_generator_factory, interrupted_generator.ref(), SampleCount);
+
+        RecordingSampleRendererFactory resumed_factory;
+        GenericSampleGeneratorFactory resumed_generator_factory(frame.ref(), &resumed_factory, params);
+        auto_release_ptr<ISampleGenerator> resumed_generator(resumed_generator_factory.create(0, 1, true));
+        resumed_generator->resume(interrupted_generator->get_sequence_end());
+        generate_samples(resumed_generator_factory, resumed_generator.ref(), SampleCount);
+
+        ASSERT_EQ(2 * SampleCount, expected_factory.m_image_points.size());
+        ASSERT_EQ(SampleCount, resumed_factory.m_image_points.size());
+
+        for (size_t i = 0; i < SampleCount; ++i)
+        {
+            EXPECT_EQ(expected_factory.m_image_points[SampleCount + i], resumed_factory.m_image_points[i]);
+            EXPECT_EQ(expected_factory.m_samples[SampleCount + i], resumed_factory.m_samples[i]);
+        }
+    }
+
+    TEST_CASE(Resume_GivenSequenceEndOfMultipleSampleGenerators_DoesNotRegenerateSamples)
+    {
+        const size_t GeneratorCount = 3;
+        const size_t SampleCounts[GeneratorCount] = { 300, 100, 200 };
+
+        auto_release_ptr<Frame> frame(create_frame());
+        const ParamArray params = ParamArray().insert("sampling_mode", "qmc");
+
+        RecordingSampleRendererFactory interrupted_factory;
+        GenericSampleGeneratorFactory interrupted_generator_factory(frame.ref(), &interrupted_factory, params);
+        size_t sequence_end = 0;
+
+        for (size_t i = 0; i < GeneratorCount; ++i)
+        {
+            auto_release_ptr<ISampleGenerator> generator(
+                interrupted_generator_factory.create(i, GeneratorCount, i == 0));
+            generate_samples(interrupted_generator_factory, generator.ref(), SampleCounts[i]);
+            sequence_end = max(sequence_end, generator->get_sequence_end());
+        }
+
+        RecordingSampleRendererFactory resumed_factory;
+        GenericSampleGeneratorFactory resumed_generator_factory(frame.ref(), &resumed_factory, params);
+
+        for (size_t i = 0; i < GeneratorCount; ++i)
+        {
+            auto_release_ptr<ISampleGenerator> generator(
+                resumed_generator_factory.create(i, GeneratorCount, i == 0));
+            generator->resume(sequence_end);
+            generate_samples(resumed_generator_factory, generator.ref(), SampleCounts[i]);
+        }
+
+        // Every sequence index yields a distinct sample position.
+        const vector<Vector2d>& interrupted = interrupted_factory.m_image_points;
+        const vector<Vector2d>& resumed = resumed_factory.m_image_points;
+
+        for (size_t i = 0; i < resumed.size(); ++i)
+            EXPECT_TRUE(find(interrupted.begin(), interrupted.end(), resumed[i]) == interrupted.end());
+    }
+}
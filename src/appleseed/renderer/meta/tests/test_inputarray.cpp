@@ -28,16 +28,25 @@
 //
 
 // appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
 #include "renderer/modeling/input/inputarray.h"
 #include "renderer/modeling/input/scalarsource.h"
 #include "renderer/modeling/input/source.h"
+#include "renderer/modeling/scene/scene.h"
 
 // appleseed.foundation headers.
+#include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/autoreleaseptr.h"
 #include "foundation/utility/test.h"
 
 // Standard headers.
 #include <string>
 
+using namespace foundation;
 using namespace renderer;
 using namespace std;
 
@@ -95,4 +104,92 @@ TEST_SUITE(Renderer_Modeling_Input_InputArray)
 
         EXPECT_EQ(expected_source, source);
     }
+
+    class VaryingScalarSource
+      : public Source
+    {
+      public:
+        VaryingScalarSource()
+          : Source(false)
+        {
+        }
+
+        virtual void evaluate(
+            TextureCache&       texture_cache,
+            const Vector2d&     uv,
+            double&             scalar) const OVERRIDE
+        {
+            scalar = uv[0] + uv[1];
+        }
+    };
+
+    DECLARE_INPUT_VALUES(InputValues)
+    {
+        double      m_uniform_scalar;
+        Spectrum    m_unbound_color;
+        Alpha       m_unbound_alpha;
+        double      m_varying_scalar;
+        double      m_unbound_scalar;
+    };
+
+    struct Fixture
+    {
+        auto_release_ptr<Scene> m_scene;
+        TextureStore            m_texture_store;
+        TextureCache            m_texture_cache;
+        InputArray              m_inputs;
+
+        Fixture()
+          : m_scene(SceneFactory::create())
+          , m_texture_store(m_scene.ref())
+          , m_texture_cache(m_texture_store)
+        {
+            m_inputs.declare("uniform_scalar", InputFormatScalar);
+            m_inputs.declare("unbound_color", InputFormatSpectralReflectance);
+            m_inputs.declare("varying_scalar", InputFormatScalar);
+            m_inputs.declare("unbound_scalar", InputFormatScalar);
+
+            m_inputs.find("uniform_scalar").bind(new ScalarSource(2.0));
+            m_inputs.find("varying_scalar").bind(new VaryingScalarSource());
+        }
+    };
+
+    TEST_CASE_F(BuildEvaluationPlan_CollectsVaryingInputsOnly, Fixture)
+    {
+        m_inputs.build_evaluation_plan();
+
+        ASSERT_TRUE(m_inputs.has_evaluation_plan());
+        EXPECT_EQ(1, m_inputs.get_varying_input_count());
+    }
+
+    TEST_CASE_F(Bind_GivenEvaluationPlan_DiscardsEvaluationPlan, Fixture)
+    {
+        m_inputs.build_evaluation_plan();
+
+        m_inputs.find("unbound_scalar").bind(new VaryingScalarSource());
+
+        EXPECT_FALSE(m_inputs.has_evaluation_plan());
+    }
+
+    TEST_CASE_F(Evaluate_GivenEvaluationPlan_MatchesEvaluationWithoutPlan, Fixture)
+    {
+        ASSERT_EQ(sizeof(InputValues), m_inputs.compute_data_size());
+
+        InputValues expected;
+        m_inputs.evaluate(m_texture_cache, Vector2d(0.25, 0.5), &expected);
+
+        m_inputs.build_evaluation_plan();
+
+        InputValues values;
+        m_inputs.evaluate(m_texture_cache, Vector2d(0.25, 0.5), &values);
+
+        EXPECT_EQ(2.0, values.m_uniform_scalar);
+        EXPECT_EQ(0.75, values.m_varying_scalar);
+        EXPECT_EQ(0.0, values.m_unbound_scalar);
+        EXPECT_EQ(expected.m_uniform_scalar, values.m_uniform_scalar);
+        EXPECT_TRUE(expected.m_unbound_color == values.m_unbound_color);
+        EXPECT_TRUE(expected.m_unbound_alpha == values.m_unbound_alpha);
+        EXPECT_EQ(expected.m_varying_scalar, values.m_varying_scalar);
+        EXPECT_EQ(expected.m_unbound_scalar, values.m_unbound_scalar);
+    }
 }
@@ -0,0 +1,211 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/itilecallback.h"
+#include "renderer/kernel/rendering/localsampleaccumulationbuffer.h"
+#include "renderer/kernel/rendering/sample.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/color.h"
+#include "foundation/image/image.h"
+#include "foundation/image/tile.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/string.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Rendering_LocalSampleAccumulationBuffer)
+{
+    struct Fixture
+    {
+        auto_release_ptr<Frame>         m_frame;
+        LocalSampleAccumulationBuffer   m_buffer;
+
+        Fixture()
+          : m_frame(
+                FrameFactory::create("frame",
+                    ParamArray()
+                        .insert("resolution", "64 64")
+                        .insert("tile_size", "16 16")))
+          , m_buffer(64, 64, 16, 16, m_frame->get_filter())
+        {
+            m_buffer.clear();
+        }
+
+        void store_sample(const double x, const double y)
+        {
+            SampleBatch samples;
+            samples.push_back(Vector2d(x / 64.0, y / 64.0), Color4f(1.0f));
+
+            m_buffer.store_samples(samples);
+        }
+    };
+
+    TEST_CASE_F(DevelopToFrame_AfterClear_DevelopsAllTiles, Fixture)
+    {
+        TileCoordinateArray tiles;
+        m_buffer.develop_to_frame(m_frame.ref(), tiles);
+
+        EXPECT_EQ(16, tiles.size());
+    }
+
+    TEST_CASE_F(DevelopToFrame_GivenNoNewSamples_DevelopsNoTile, Fixture)
+    {
+        TileCoordinateArray tiles;
+        m_buffer.develop_to_frame(m_frame.ref(), tiles);
+        m_buffer.develop_to_frame(m_frame.ref(), tiles);
+
+        EXPECT_TRUE(tiles.empty());
+    }
+
+    TEST_CASE_F(DevelopToFrame_GivenSampleAtCenterOfTile_DevelopsThisTileOnly, Fixture)
+    {
+        TileCoordinateArray tiles;
+        m_buffer.develop_to_frame(m_frame.ref(), tiles);
+
+        store_sample(24.0, 40.0);
+        m_buffer.develop_to_frame(m_frame.ref(), tiles);
+
+        ASSERT_EQ(1, tiles.size());
+        EXPECT_EQ(Vector2u(1, 2), tiles[0]);
+    }
+
+    TEST_CASE_F(DevelopToFrame_GivenSampleAtCornerOfFourTiles_DevelopsFourTiles, Fixture)
+    {
+        TileCoordinateArray tiles;
+        m_buffer.develop_to_frame(m_frame.ref(), tiles);
+
+        store_sample(32.0, 16.0);
+        m_buffer.develop_to_frame(m_frame.ref(), tiles);
+
+        ASSERT_EQ(4, tiles.size());
+        EXPECT_EQ(Vector2u(1, 0), tiles[0]);
+        EXPECT_EQ(Vector2u(2, 0), tiles[1]);
+        EXPECT_EQ(Vector2u(1, 1), tiles[2]);
+        EXPECT_EQ(Vector2u(2, 1), tiles[3]);
+    }
+
+    // Store samples in batches of a given size into one buffer and one by one into another,
+    // and return whether both buffers develop to the same image.
+    bool store_batches_matches_store_individual_samples(
+        const size_t    resolution,
+        const size_t    sample_count,
+        const size_t    batch_size)
+    {
+        auto_release_ptr<Frame> frame =
+            FrameFactory::create("frame",
+                ParamArray()
+                    .insert("resolution", to_string(resolution) + " " + to_string(resolution))
+                    .insert("tile_size", "16 16")
+                    .insert("pixel_format", "float"));
+
+        LocalSampleAccumulationBuffer batch_buffer(resolution, resolution, 16, 16, frame->get_filter());
+        LocalSampleAccumulationBuffer single_buffer(resolution, resolution, 16, 16, frame->get_filter());
+        batch_buffer.clear();
+        single_buffer.clear();
+
+        SampleBatch batch;
+
+        for (size_t i = 0; i < sample_count; ++i)
+        {
+            const Vector2d position((i % 53) / 53.0, (i % 37) / 37.0);
+            const Color4f color(
+                static_cast<float>(i % 3),
+                static_cast<float>(i % 5),
+                static_cast<float>(i % 7),
+                1.0f);
+
+            batch.push_back(position, color);
+
+            if (batch.size() == batch_size || i + 1 == sample_count)
+            {
+                batch_buffer.store_samples(batch);
+                batch.clear();
+            }
+
+            SampleBatch single;
+            single.push_back(position, color);
+            single_buffer.store_samples(single);
+        }
+
+        if (batch_buffer.get_sample_count() != sample_count)
+            return false;
+
+        TileCoordinateArray tiles;
+        batch_buffer.develop_to_frame(frame.ref(), tiles);
+        const Image expected(frame->image());
+        single_buffer.develop_to_frame(frame.ref(), tiles);
+        const Image& result = frame->image();
+
+        const CanvasProperties& props = expected.properties();
+
+        for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+        {
+            for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
+            {
+                const Tile& expected_tile = expected.tile(tx, ty);
+                const Tile& result_tile = result.tile(tx, ty);
+
+                for (size_t i = 0; i < expected_tile.get_pixel_count(); ++i)
+                {
+                    Color4f expected_color, result_color;
+                    expected_tile.get_pixel(i, expected_color);
+                    result_tile.get_pixel(i, result_color);
+
+                    if (expected_color != result_color)
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    TEST_CASE(StoreSamples_GivenLargeBatch_AccumulatesSameValuesAsIndividualSamples)
+    {
+        EXPECT_TRUE(store_batches_matches_store_individual_samples(64, 300, 300));
+    }
+
+    TEST_CASE(StoreSamples_GivenBatchesCompletingCoarseLevels_AccumulatesSameValuesAsIndividualSamples)
+    {
+        // Levels of 256x256, 128x128 and 64x64 pixels: the levels get completed,
+        // from the coarsest to the finest, in the middle of batches of 97 samples.
+        EXPECT_TRUE(store_batches_matches_store_individual_samples(256, 70000, 97));
+    }
+}
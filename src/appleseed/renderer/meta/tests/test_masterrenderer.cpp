@@ -0,0 +1,206 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/defaultrenderercontroller.h"
+#include "renderer/kernel/rendering/masterrenderer.h"
+#include "renderer/modeling/environment/environment.h"
+#include "renderer/modeling/environment/environment.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/modeling/project/configuration.h"
+#include "renderer/modeling/project/configurationcontainer.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/project-builtin/cornellboxproject.h"
+#include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/utility/paramarray.h"
+#include "renderer/utility/transformsequence.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/color.h"
+#include "foundation/image/image.h"
+#include "foundation/image/tile.h"
+#include "foundation/math/matrix.h"
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Rendering_MasterRenderer)
+{
+    // Return the largest pixel component of the main image of a frame.
+    float get_max_pixel_value(const Frame& frame)
+    {
+        const Image& image = frame.image();
+        const CanvasProperties& props = image.properties();
+
+        float max_value = 0.0f;
+
+        for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+        {
+            for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
+            {
+                const Tile& tile = image.tile(tx, ty);
+
+                for (size_t i = 0; i < tile.get_pixel_count(); ++i)
+                {
+                    Color4f color;
+                    tile.get_pixel(i, color);
+                    max_value = max(max_value, max(color[0], max(color[1], color[2])));
+                }
+            }
+        }
+
+        return max_value;
+    }
+
+    // Render two frames; the Cornell Box is moved out of sight before the second one.
+    class MoveAssemblyInstanceRendererController
+      : public DefaultRendererController
+    {
+      public:
+        MoveAssemblyInstanceRendererController(
+            Project&        project,
+            const Status    next_frame_status)
+          : m_project(project)
+          , m_next_frame_status(next_frame_status)
+        {
+        }
+
+        virtual void on_frame_setup() OVERRIDE
+        {
+            if (m_frame_max_values.size() == 1)
+            {
+                AssemblyInstance* assembly_instance =
+                    m_project.get_scene()->assembly_instances().get_by_name("assembly_inst");
+
+                assembly_instance->transform_sequence().clear();
+                assembly_instance->transform_sequence().set_transform(
+                    0.0,
+                    Transformd::from_local_to_parent(
+                        Matrix4d::translation(Vector3d(1000.0, 0.0, 0.0))));
+            }
+        }
+
+        virtual Status on_frame_complete() OVERRIDE
+        {
+            m_frame_max_values.push_back(get_max_pixel_value(*m_project.get_frame()));
+
+            return m_frame_max_values.size() < 2 ? m_next_frame_status : TerminateRendering;
+        }
+
+        vector<float>       m_frame_max_values;
+
+      private:
+        Project&            m_project;
+        const Status        m_next_frame_status;
+    };
+
+    auto_release_ptr<Project> create_project()
+    {
+        auto_release_ptr<Project> project(CornellBoxProjectFactory::create());
+
+        // The built-in Cornell box doesn't define any environment.
+        project->get_scene()->set_environment(
+            EnvironmentFactory::create("environment", ParamArray()));
+
+        ParamArray params = project->get_frame()->get_parameters();
+        params.insert("resolution", "16 16");
+        params.insert("tile_size", "16 16");
+        params.insert("pixel_format", "float");
+        project->set_frame(FrameFactory::create("beauty", params));
+
+        return project;
+    }
+
+    ParamArray get_rendering_parameters(const Project& project)
+    {
+        const Configuration* configuration = project.configurations().get_by_name("final");
+
+        ParamArray params = configuration->get_base()->get_parameters();
+        params.merge(configuration->get_parameters());
+        params.insert_path("rendering_threads", 1);
+        params.insert_path("frame_renderer", "generic");
+        params.insert_path("tile_renderer", "generic");
+        params.insert_path("pixel_renderer", "uniform");
+        params.insert_path("uniform_pixel_renderer.samples", 4);
+        params.insert_path("sample_renderer", "generic");
+        params.insert_path("lighting_engine", "pt");
+
+        return params;
+    }
+
+    void render_two_frames(
+        const IRendererController::Status   next_frame_status,
+        vector<float>&                      frame_max_values)
+    {
+        auto_release_ptr<Project> project(create_project());
+        MoveAssemblyInstanceRendererController renderer_controller(project.ref(), next_frame_status);
+
+        MasterRenderer renderer(
+            project.ref(),
+            get_rendering_parameters(project.ref()),
+            &renderer_controller);
+
+        renderer.render();
+
+        frame_max_values = renderer_controller.m_frame_max_values;
+    }
+
+    TEST_CASE(Render_GivenAssemblyInstanceMovedBeforeRestartedFrame_RendersMovedAssemblyInstance)
+    {
+        vector<float> frame_max_values;
+        render_two_frames(IRendererController::RestartRendering, frame_max_values);
+
+        ASSERT_EQ(2, frame_max_values.size());
+        EXPECT_GT(0.0f, frame_max_values[0]);
+        EXPECT_EQ(0.0f, frame_max_values[1]);
+    }
+
+    TEST_CASE(Render_GivenAssemblyInstanceMovedBeforeReinitializedFrame_RendersMovedAssemblyInstance)
+    {
+        vector<float> frame_max_values;
+        render_two_frames(IRendererController::ReinitializeRendering, frame_max_values);
+
+        ASSERT_EQ(2, frame_max_values.size());
+        EXPECT_GT(0.0f, frame_max_values[0]);
+        EXPECT_EQ(0.0f, frame_max_values[1]);
+    }
+}
@@ -0,0 +1,106 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/intersection/raystatistics.h"
+#include "renderer/kernel/shading/shadingray.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/test.h"
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Intersection_RayStatistics)
+{
+    TEST_CASE(GetCategory_GivenCameraRay_ReturnsCameraRays)
+    {
+        EXPECT_EQ(RayStatistics::CameraRays, RayStatistics::get_category(ShadingRay::CameraRay));
+    }
+
+    TEST_CASE(GetCategory_GivenDiffuseGlossyOrSpecularRay_ReturnsIndirectRays)
+    {
+        EXPECT_EQ(RayStatistics::IndirectRays, RayStatistics::get_category(ShadingRay::DiffuseRay));
+        EXPECT_EQ(RayStatistics::IndirectRays, RayStatistics::get_category(ShadingRay::GlossyRay));
+        EXPECT_EQ(RayStatistics::IndirectRays, RayStatistics::get_category(ShadingRay::SpecularRay));
+    }
+
+    TEST_CASE(GetCategory_GivenShadowRay_ReturnsShadowRays)
+    {
+        EXPECT_EQ(RayStatistics::ShadowRays, RayStatistics::get_category(ShadingRay::ShadowRay));
+    }
+
+    TEST_CASE(GetCategory_GivenLightRay_ReturnsLightRays)
+    {
+        EXPECT_EQ(RayStatistics::LightRays, RayStatistics::get_category(ShadingRay::LightRay));
+    }
+
+    TEST_CASE(GetCategory_GivenNoRayType_ReturnsOtherRays)
+    {
+        EXPECT_EQ(RayStatistics::OtherRays, RayStatistics::get_category(0));
+    }
+
+    TEST_CASE(OperatorPlusEqual_MergesAllCounters)
+    {
+        RayStatistics a;
+        a.count_ray(ShadingRay::CameraRay);
+        a.count_ray(ShadingRay::DiffuseRay);
+        a.m_leaf_visit_count = 3;
+        a.m_triangle_test_count = 10;
+
+        RayStatistics b;
+        b.count_ray(ShadingRay::CameraRay);
+        b.count_ray(ShadingRay::ShadowRay);
+        b.m_leaf_visit_count = 2;
+        b.m_triangle_test_count = 5;
+
+        a += b;
+
+        EXPECT_EQ(2, a.m_ray_counts[RayStatistics::CameraRays]);
+        EXPECT_EQ(1, a.m_ray_counts[RayStatistics::IndirectRays]);
+        EXPECT_EQ(1, a.m_ray_counts[RayStatistics::ShadowRays]);
+        EXPECT_EQ(4, a.get_total_ray_count());
+        EXPECT_EQ(5, a.m_leaf_visit_count);
+        EXPECT_EQ(15, a.m_triangle_test_count);
+    }
+
+    TEST_CASE(OperatorMinusEqual_GivenEarlierSnapshot_ReturnsDifference)
+    {
+        RayStatistics initial;
+        initial.count_ray(ShadingRay::LightRay);
+
+        RayStatistics current = initial;
+        current.count_ray(ShadingRay::LightRay);
+        current.count_ray(ShadingRay::GlossyRay);
+        current -= initial;
+
+        EXPECT_EQ(1, current.m_ray_counts[RayStatistics::LightRays]);
+        EXPECT_EQ(1, current.m_ray_counts[RayStatistics::IndirectRays]);
+        EXPECT_EQ(2, current.get_total_ray_count());
+    }
+}
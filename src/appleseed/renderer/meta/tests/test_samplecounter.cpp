@@ -54,6 +54,25 @@ TEST_SUITE(Renderer_Kernel_Rendering_Progressive_SampleCounter)
         EXPECT_EQ(0, sample_counter.read());
     }
 
+    TEST_CASE(Set_GivenSampleCountBelowMaxSampleCount_SetsSampleCount)
+    {
+        SampleCounter sample_counter(3);
+
+        sample_counter.set(2);
+
+        EXPECT_EQ(2, sample_counter.read());
+        EXPECT_EQ(1, sample_counter.reserve(3));
+    }
+
+    TEST_CASE(Set_GivenSampleCountAboveMaxSampleCount_ClampsSampleCount)
+    {
+        SampleCounter sample_counter(3);
+
+        sample_counter.set(5);
+
+        EXPECT_EQ(3, sample_counter.read());
+    }
+
     TEST_CASE(Reserve_ReserveOneGivenMaxSampleCountIsZero_ReturnsZero)
     {
         SampleCounter sample_counter(0);
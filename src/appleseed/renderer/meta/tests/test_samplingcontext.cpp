@@ -0,0 +1,170 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/intersector.h"
+#include "renderer/kernel/intersection/tracecontext.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/project-builtin/cornellboxproject.h"
+#include "renderer/modeling/scene/scene.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/rng.h"
+#include "foundation/math/sampling.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/makevector.h"
+#include "foundation/utility/maplefile.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Global_SamplingContext)
+{
+    //
+    // Estimate the ambient occlusion at a point of the floor of the built-in Cornell box,
+    // between the two blocks, with increasing numbers of samples and with both sampling
+    // modes, and compare the RMS error of the estimates.
+    //
+
+    const size_t TrialCount = 32;
+    const size_t Log2MaxSampleCount = 10;
+    const size_t ReferenceSampleCount = 1 << 16;
+    const double OcclusionDistance = 0.3;
+
+    struct Fixture
+    {
+        auto_release_ptr<Project>   m_project;
+        auto_ptr<TraceContext>      m_trace_context;
+        auto_ptr<TextureStore>      m_texture_store;
+        auto_ptr<TextureCache>      m_texture_cache;
+        auto_ptr<Intersector>       m_intersector;
+
+        Fixture()
+          : m_project(CornellBoxProjectFactory::create())
+        {
+            Scene& scene = *m_project->get_scene();
+
+            InputBinder input_binder;
+            input_binder.bind(scene);
+
+            m_trace_context.reset(new TraceContext(scene));
+            m_texture_store.reset(new TextureStore(scene));
+            m_texture_cache.reset(new TextureCache(*m_texture_store));
+            m_intersector.reset(new Intersector(*m_trace_context, *m_texture_cache));
+        }
+
+        double estimate_occlusion(
+            const SamplingContext::Mode mode,
+            const size_t                sample_count,
+            const size_t                trial) const
+        {
+            const Vector3d origin(0.255, 1.0e-4, 0.280);
+
+            MersenneTwister rng(static_cast<uint32>(trial));
+            SamplingContext sampling_context(rng, mode, 2, sample_count, 0, static_cast<uint32>(trial));
+
+            size_t occluded = 0;
+
+            for (size_t i = 0; i < sample_count; ++i)
+            {
+                // The floor's normal is the Y axis, like the hemisphere's.
+                const Vector2d s = sampling_context.next_vector2<2>();
+                const Vector3d direction = sample_hemisphere_cosine(s);
+
+                const ShadingRay ray(
+                    origin,
+                    direction,
+                    0.0,
+                    OcclusionDistance,
+                    0.0,
+                    ShadingRay::ProbeRay);
+
+                if (m_intersector->trace_probe(ray))
+                    ++occluded;
+            }
+
+            return static_cast<double>(occluded) / sample_count;
+        }
+    };
+
+    TEST_CASE_F(AmbientOcclusion_QMCModeConvergesFasterThanRNGMode, Fixture)
+    {
+        const double reference =
+            estimate_occlusion(SamplingContext::QMCMode, ReferenceSampleCount, TrialCount);
+
+        vector<double> abscissa;
+        vector<double> rng_rmse;
+        vector<double> qmc_rmse;
+
+        for (size_t m = 2; m <= Log2MaxSampleCount; ++m)
+        {
+            const size_t sample_count = size_t(1) << m;
+
+            double rng_sse = 0.0;
+            double qmc_sse = 0.0;
+
+            for (size_t t = 0; t < TrialCount; ++t)
+            {
+                rng_sse += square(estimate_occlusion(SamplingContext::RNGMode, sample_count, t) - reference);
+                qmc_sse += square(estimate_occlusion(SamplingContext::QMCMode, sample_count, t) - reference);
+            }
+
+            abscissa.push_back(static_cast<double>(sample_count));
+            rng_rmse.push_back(sqrt(rng_sse / TrialCount));
+            qmc_rmse.push_back(sqrt(qmc_sse / TrialCount));
+        }
+
+        EXPECT_TRUE(qmc_rmse.back() < qmc_rmse.front());
+        EXPECT_TRUE(qmc_rmse.back() < rng_rmse.back());
+
+        MapleFile file("unit tests/outputs/test_samplingcontext_cornellbox_ao.mpl");
+        file.define("rng_rmse", abscissa, rng_rmse);
+        file.define("qmc_rmse", abscissa, qmc_rmse);
+        file.plot(
+            make_vector(
+                MaplePlotDef("rng_rmse").set_legend("RMS Error (RNG)").set_color("blue"),
+                MaplePlotDef("qmc_rmse").set_legend("RMS Error (QMC)").set_color("red")));
+    }
+}
@@ -0,0 +1,199 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/lighting/sppm/sppmphoton.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/rng.h"
+#include "foundation/math/sampling.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cmath>
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Lighting_SPPM_SPPMPhoton)
+{
+    TEST_CASE(PackUnitVector_GivenAxes_RoundTripsExactly)
+    {
+        const Vector3f Axes[] =
+        {
+            Vector3f(1.0f, 0.0f, 0.0f),
+            Vector3f(-1.0f, 0.0f, 0.0f),
+            Vector3f(0.0f, 1.0f, 0.0f),
+            Vector3f(0.0f, -1.0f, 0.0f),
+            Vector3f(0.0f, 0.0f, 1.0f),
+            Vector3f(0.0f, 0.0f, -1.0f)
+        };
+
+        for (size_t i = 0; i < 6; ++i)
+            EXPECT_FEQ(Axes[i], unpack_unit_vector(pack_unit_vector(Axes[i])));
+    }
+
+    TEST_CASE(PackUnitVector_GivenRandomUnitVectors_RoundTripsWithinTolerance)
+    {
+        MersenneTwister rng;
+
+        float max_error = 0.0f;
+
+        for (size_t i = 0; i < 10000; ++i)
+        {
+            Vector2f s;
+            s[0] = rand_float2(rng);
+            s[1] = rand_float2(rng);
+
+            const Vector3f v = sample_sphere_uniform(s);
+            const Vector3f w = unpack_unit_vector(pack_unit_vector(v));
+
+            max_error = std::max(max_error, norm(v - w));
+        }
+
+        EXPECT_LT(1.0e-4f, max_error);
+    }
+
+    TEST_CASE(PackedFlux_GivenZeroFlux_UnpacksToZero)
+    {
+        SPPMPackedFlux packed;
+        packed.pack(Spectrum(0.0f), 0.5f);
+
+        Spectrum flux(1.0f);
+        packed.unpack(flux);
+
+        EXPECT_EQ(Spectrum(0.0f), flux);
+    }
+
+    TEST_CASE(PackedFlux_GivenFlux_RoundTripsWithinQuantizationError)
+    {
+        Spectrum flux;
+        for (size_t i = 0; i < Spectrum::Samples; ++i)
+            flux[i] = 10.0f * std::sin(static_cast<float>(i)) * std::sin(static_cast<float>(i));
+
+        const float max_component = max_value(flux);
+
+        MersenneTwister rng;
+
+        for (size_t j = 0; j < 100; ++j)
+        {
+            SPPMPackedFlux packed;
+            packed.pack(flux, rand_float2(rng));
+
+            Spectrum result;
+            packed.unpack(result);
+
+            for (size_t i = 0; i < Spectrum::Samples; ++i)
+                EXPECT_LT(max_component / 255.0f * 1.001f, std::abs(flux[i] - result[i]));
+        }
+    }
+
+    TEST_CASE(PackedFlux_GivenComponentsFarBelowQuantizationStep_PreservesAverageFlux)
+    {
+        Spectrum flux(0.0f);
+        flux[0] = 1.0f;
+        flux[1] = 1.0e-3f;
+        flux[2] = 1.0e-4f;
+
+        MersenneTwister rng;
+
+        const size_t PackCount = 100000;
+        Spectrum sum(0.0f);
+
+        for (size_t j = 0; j < PackCount; ++j)
+        {
+            SPPMPackedFlux packed;
+            packed.pack(flux, rand_float2(rng));
+
+            Spectrum result;
+            packed.unpack(result);
+            sum += result;
+        }
+
+        sum /= static_cast<float>(PackCount);
+
+        EXPECT_FEQ_EPS(1.0f, sum[0], 1.0e-4f);
+        EXPECT_FEQ_EPS(1.0e-3f, sum[1], 0.05f);
+        EXPECT_FEQ_EPS(1.0e-4f, sum[2], 0.1f);
+        EXPECT_EQ(0.0f, sum[3]);
+    }
+
+    TEST_CASE(GetPhotonDataSize_IsSmallerThanUncompressedPhotonData)
+    {
+        EXPECT_LT(sizeof(SPPMPhotonData) / 3, SPPMPhotonVector::get_photon_data_size());
+    }
+
+    TEST_CASE(PushBack_ThenGetAttributes_ReturnsPhotonAttributes)
+    {
+        SPPMPhoton photon;
+        photon.m_position = Vector3f(1.0f, 2.0f, 3.0f);
+        photon.m_data.m_incoming = normalize(Vector3f(0.3f, -0.4f, 0.5f));
+        photon.m_data.m_geometric_normal = Vector3f(0.0f, 0.0f, -1.0f);
+        photon.m_data.m_flux = Spectrum(0.5f);
+
+        SPPMPhotonVector photons;
+        photons.push_back(photon);
+
+        ASSERT_EQ(1, photons.size());
+        EXPECT_EQ(photon.m_position, photons.m_positions[0]);
+        EXPECT_FEQ_EPS(photon.m_data.m_incoming, photons.get_incoming(0), 1.0e-4f);
+        EXPECT_FEQ_EPS(photon.m_data.m_geometric_normal, photons.get_geometric_normal(0), 1.0e-4f);
+
+        Spectrum flux;
+        photons.get_flux(0, flux);
+        EXPECT_FEQ(photon.m_data.m_flux, flux);
+    }
+
+    TEST_CASE(CopyFrom_GivenIndex_CopiesPhotonsAtIndex)
+    {
+        SPPMPhoton photon;
+        photon.m_data.m_incoming = Vector3f(0.0f, 1.0f, 0.0f);
+        photon.m_data.m_geometric_normal = Vector3f(0.0f, 0.0f, 1.0f);
+        photon.m_data.m_flux = Spectrum(1.0f);
+
+        SPPMPhotonVector source;
+        photon.m_position = Vector3f(1.0f, 0.0f, 0.0f);
+        source.push_back(photon);
+        photon.m_position = Vector3f(2.0f, 0.0f, 0.0f);
+        source.push_back(photon);
+
+        SPPMPhotonVector photons;
+        photons.resize(4);
+        photons.copy_from(source, 1);
+
+        ASSERT_EQ(4, photons.size());
+        EXPECT_EQ(Vector3f(1.0f, 0.0f, 0.0f), photons.m_positions[1]);
+        EXPECT_EQ(Vector3f(2.0f, 0.0f, 0.0f), photons.m_positions[2]);
+        EXPECT_EQ(source.m_incoming[1], photons.m_incoming[2]);
+        EXPECT_EQ(source.m_geometric_normals[1], photons.m_geometric_normals[2]);
+    }
+}
@@ -0,0 +1,192 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/lighting/sppm/sppmpixelstatistics.h"
+#include "renderer/kernel/rendering/checkpoint.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cmath>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Lighting_SPPM_SPPMPixelStatistics)
+{
+    TEST_CASE(Reset_SetsAllRadiiToInitialRadius)
+    {
+        SPPMPixelStatistics stats;
+        stats.reset(4, 3, 2.0f);
+
+        EXPECT_EQ(4, stats.get_width());
+        EXPECT_EQ(3, stats.get_height());
+        EXPECT_FEQ(2.0f, stats.get_radius(0, 0));
+        EXPECT_FEQ(2.0f, stats.get_radius(3, 2));
+        EXPECT_FEQ(2.0f, stats.get_max_radius());
+    }
+
+    TEST_CASE(Contains_GivenPixelOutsideResolution_ReturnsFalse)
+    {
+        SPPMPixelStatistics stats;
+        stats.reset(4, 3, 1.0f);
+
+        EXPECT_TRUE(stats.contains(3, 2));
+        EXPECT_FALSE(stats.contains(-1, 0));
+        EXPECT_FALSE(stats.contains(4, 0));
+        EXPECT_FALSE(stats.contains(0, 3));
+    }
+
+    TEST_CASE(Update_GivenNoLookup_LeavesRadiusUnchanged)
+    {
+        SPPMPixelStatistics stats;
+        stats.reset(2, 2, 1.0f);
+
+        stats.update(0.7f);
+
+        EXPECT_FEQ(1.0f, stats.get_radius(1, 1));
+        EXPECT_FEQ(0.0f, stats.get_photon_count(1, 1));
+    }
+
+    TEST_CASE(Update_GivenFirstPassLookups_ShrinksSquareRadiusByAlpha)
+    {
+        SPPMPixelStatistics stats;
+        stats.reset(2, 2, 1.0f);
+
+        stats.record_lookup(1, 0, 10);
+        stats.record_lookup(1, 0, 30);
+        stats.update(0.5f);
+
+        // M = 20, N' = 0 + 0.5 * 20 = 10, R'^2 = 1 * 10 / 20.
+        EXPECT_FEQ(10.0f, stats.get_photon_count(1, 0));
+        EXPECT_FEQ(std::sqrt(0.5f), stats.get_radius(1, 0));
+        EXPECT_FEQ(1.0f, stats.get_radius(0, 0));
+        EXPECT_FEQ(1.0f, stats.get_max_radius());
+    }
+
+    TEST_CASE(Update_GivenSecondPassLookups_AppliesProgressiveReductionRule)
+    {
+        SPPMPixelStatistics stats;
+        stats.reset(1, 1, 1.0f);
+
+        stats.record_lookup(0, 0, 20);
+        stats.update(0.5f);
+
+        stats.record_lookup(0, 0, 10);
+        stats.update(0.5f);
+
+        // N = 10, M = 10, N' = 10 + 0.5 * 10 = 15, R'^2 = 0.5 * 15 / 20.
+        EXPECT_FEQ(15.0f, stats.get_photon_count(0, 0));
+        EXPECT_FEQ(std::sqrt(0.375f), stats.get_radius(0, 0));
+        EXPECT_FEQ(std::sqrt(0.375f), stats.get_max_radius());
+    }
+
+    TEST_CASE(ComputeRadiusPercentile_GivenNoPixelWithPhotons_ReturnsMaxRadius)
+    {
+        SPPMPixelStatistics stats;
+        stats.reset(2, 2, 1.0f);
+
+        EXPECT_FEQ(1.0f, stats.compute_radius_percentile(0.5f));
+    }
+
+    TEST_CASE(ComputeRadiusPercentile_IgnoresPixelsWithoutPhotons)
+    {
+        SPPMPixelStatistics stats;
+        stats.reset(4, 1, 1.0f);
+
+        // R'^2 = 1 * (0.5 * M) / M = 0.5 for the first three pixels; the last one keeps its initial radius.
+        stats.record_lookup(0, 0, 10);
+        stats.record_lookup(1, 0, 20);
+        stats.record_lookup(2, 0, 30);
+        stats.update(0.5f);
+
+        EXPECT_FEQ(1.0f, stats.get_max_radius());
+        EXPECT_FEQ(std::sqrt(0.5f), stats.compute_radius_percentile(1.0f));
+    }
+
+    TEST_CASE(ComputeRadiusPercentile_ReturnsRadiusNotExceededByGivenFractionOfPixels)
+    {
+        SPPMPixelStatistics stats;
+        stats.reset(4, 1, 1.0f);
+
+        // R'^2 = alpha for pixels that found photons in a single pass.
+        stats.record_lookup(0, 0, 10);
+        stats.update(0.5f);
+        stats.record_lookup(0, 0, 10);
+        stats.record_lookup(1, 0, 10);
+        stats.record_lookup(2, 0, 10);
+        stats.record_lookup(3, 0, 10);
+        stats.update(0.5f);
+
+        // Pixel 0 went through two passes and has a smaller radius than the other three.
+        EXPECT_FEQ(stats.get_radius(0, 0), stats.compute_radius_percentile(0.0f));
+        EXPECT_FEQ(std::sqrt(0.5f), stats.compute_radius_percentile(0.5f));
+        EXPECT_FEQ(std::sqrt(0.5f), stats.compute_radius_percentile(1.0f));
+    }
+
+    TEST_CASE(ClearLookups_DiscardsLookupsOfCurrentPass)
+    {
+        SPPMPixelStatistics stats;
+        stats.reset(1, 1, 1.0f);
+
+        stats.record_lookup(0, 0, 20);
+        stats.clear_lookups();
+        stats.update(0.5f);
+
+        EXPECT_FEQ(1.0f, stats.get_radius(0, 0));
+    }
+
+    TEST_CASE(ReadCheckpoint_RestoresRadiiAndPhotonCounts)
+    {
+        const char* Filename = "unit tests/outputs/test_sppmpixelstatistics.bin";
+
+        SPPMPixelStatistics stats;
+        stats.reset(4, 3, 1.0f);
+        stats.record_lookup(2, 1, 20);
+        stats.update(0.5f);
+
+        {
+            CheckpointWriter writer(Filename, MultiPassCheckpoint, 4, 3);
+            stats.write_checkpoint(writer);
+            writer.commit();
+        }
+
+        SPPMPixelStatistics restored_stats;
+        CheckpointReader reader(Filename, MultiPassCheckpoint, 4, 3);
+        restored_stats.read_checkpoint(reader);
+
+        EXPECT_EQ(4, restored_stats.get_width());
+        EXPECT_EQ(3, restored_stats.get_height());
+        EXPECT_FEQ(stats.get_radius(2, 1), restored_stats.get_radius(2, 1));
+        EXPECT_FEQ(stats.get_photon_count(2, 1), restored_stats.get_photon_count(2, 1));
+        EXPECT_FEQ(1.0f, restored_stats.get_radius(0, 0));
+        EXPECT_FEQ(1.0f, restored_stats.get_max_radius());
+    }
+}
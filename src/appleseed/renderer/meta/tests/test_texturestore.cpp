@@ -29,10 +29,25 @@
 
 // appleseed.renderer headers.
 #include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/modeling/texture/texture.h"
+#include "renderer/utility/paramarray.h"
+#include "renderer/utility/testutils.h"
 
 // appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/colorspace.h"
+#include "foundation/image/pixel.h"
+#include "foundation/image/tile.h"
+#include "foundation/utility/autoreleaseptr.h"
 #include "foundation/utility/test.h"
+#include "foundation/utility/uid.h"
 
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
 using namespace renderer;
 
 TEST_SUITE(Renderer_Kernel_Texturing_TextureStore_TileKey)
@@ -47,3 +62,164 @@ TEST_SUITE(Renderer_Kernel_Texturing_TextureStore_TileKey)
         EXPECT_EQ(56565, key.get_tile_y());
     }
 }
+
+TEST_SUITE(Renderer_Kernel_Texturing_TextureStore)
+{
+    class CountingTexture
+      : public Texture
+    {
+      public:
+        bool                    m_modified;
+
+        CountingTexture(
+            const char*     name,
+            size_t&         load_count)
+          : Texture(name, ParamArray())
+          , m_modified(false)
+          , m_props(
+                64, 32,
+                32, 32,
+                4,
+                PixelFormatFloat)
+          , m_load_count(load_count)
+        {
+        }
+
+        virtual void release() OVERRIDE
+        {
+            delete this;
+        }
+
+        virtual const char* get_model() const OVERRIDE
+        {
+            return "counting_texture";
+        }
+
+        virtual ColorSpace get_color_space() const OVERRIDE
+        {
+            return ColorSpaceLinearRGB;
+        }
+
+        virtual const CanvasProperties& properties() OVERRIDE
+        {
+            return m_props;
+        }
+
+        virtual Tile* load_tile(
+            const size_t    tile_x,
+            const size_t    tile_y) OVERRIDE
+        {
+            ++m_load_count;
+
+            return
+                new Tile(
+                    m_props.m_tile_width,
+                    m_props.m_tile_height,
+                    m_props.m_channel_count,
+                    m_props.m_pixel_format);
+        }
+
+        virtual void unload_tile(
+            const size_t    tile_x,
+            const size_t    tile_y,
+            const Tile*     tile) OVERRIDE
+        {
+            delete tile;
+        }
+
+        virtual bool update_source() OVERRIDE
+        {
+            const bool modified = m_modified;
+            m_modified = false;
+            return modified;
+        }
+
+      private:
+        const CanvasProperties  m_props;
+        size_t&                 m_load_count;
+    };
+
+    struct Fixture
+      : public TestFixtureBase
+    {
+        size_t              m_load_count;
+        UniqueID            m_texture_uid;
+        CountingTexture*    m_texture;
+
+        Fixture()
+          : m_load_count(0)
+        {
+            auto_release_ptr<Texture> texture(new CountingTexture("texture", m_load_count));
+            m_texture_uid = texture->get_uid();
+            m_texture = static_cast<CountingTexture*>(texture.get());
+            m_scene.textures().insert(texture);
+        }
+
+        void acquire_and_release_tile(TextureStore& texture_store, const size_t tile_x)
+        {
+            TextureStore::TileRecord& record =
+                texture_store.acquire(TextureStore::TileKey(~0, m_texture_uid, tile_x, 0));
+
+            texture_store.release(record);
+        }
+    };
+
+    TEST_CASE_F(Acquire_GivenTileLoadedDuringPreviousBinding_ReusesTile, Fixture)
+    {
+        TextureStore texture_store;
+
+        texture_store.bind_scene(m_scene);
+        acquire_and_release_tile(texture_store, 0);
+        texture_store.unbind_scene();
+
+        texture_store.bind_scene(m_scene);
+        acquire_and_release_tile(texture_store, 0);
+        texture_store.unbind_scene();
+
+        EXPECT_EQ(1, m_load_count);
+    }
+
+    TEST_CASE_F(Acquire_GivenTextureModifiedSincePreviousBinding_ReloadsTile, Fixture)
+    {
+        TextureStore texture_store;
+
+        texture_store.bind_scene(m_scene);
+        acquire_and_release_tile(texture_store, 0);
+        acquire_and_release_tile(texture_store, 1);
+        texture_store.unbind_scene();
+
+        m_texture->m_modified = true;
+
+        texture_store.bind_scene(m_scene);
+        acquire_and_release_tile(texture_store, 0);
+        acquire_and_release_tile(texture_store, 1);
+        texture_store.unbind_scene();
+
+        EXPECT_EQ(4, m_load_count);
+    }
+
+    TEST_CASE_F(Acquire_GivenStoreAtMemoryLimit_EvictsLeastRecentlyUsedTile, Fixture)
+    {
+        TextureStore texture_store;
+        texture_store.set_memory_limit(1);
+
+        texture_store.bind_scene(m_scene);
+        acquire_and_release_tile(texture_store, 0);
+        acquire_and_release_tile(texture_store, 1);
+        acquire_and_release_tile(texture_store, 0);
+        texture_store.unbind_scene();
+
+        EXPECT_EQ(3, m_load_count);
+    }
+
+    TEST_CASE_F(Clear_UnloadsAllTiles, Fixture)
+    {
+        TextureStore texture_store(m_scene);
+
+        acquire_and_release_tile(texture_store, 0);
+        texture_store.clear();
+        acquire_and_release_tile(texture_store, 0);
+
+        EXPECT_EQ(2, m_load_count);
+    }
+}
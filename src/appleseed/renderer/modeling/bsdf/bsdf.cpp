@@ -72,6 +72,8 @@ bool BSDF::on_frame_begin(
     const Assembly&     assembly,
     AbortSwitch*        abort_switch)
 {
+    m_inputs.build_evaluation_plan();
+
     return true;
 }
 
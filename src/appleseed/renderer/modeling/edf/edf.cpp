@@ -86,6 +86,8 @@ bool EDF::on_frame_begin(
             get_path().c_str());
     }
 
+    m_inputs.build_evaluation_plan();
+
     return true;
 }
 
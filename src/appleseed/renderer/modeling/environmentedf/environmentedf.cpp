@@ -61,6 +61,8 @@ bool EnvironmentEDF::on_frame_begin(
     const Project&      project,
     AbortSwitch*        abort_switch)
 {
+    m_inputs.build_evaluation_plan();
+
     return true;
 }
 
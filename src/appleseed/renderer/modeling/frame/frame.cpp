@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globalmemory.h"
 #include "renderer/kernel/aov/imagestack.h"
 #include "renderer/utility/paramarray.h"
 
@@ -53,9 +54,11 @@
 #include "foundation/platform/sse.h"
 #endif
 #include "foundation/platform/timer.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/containers/dictionary.h"
 #include "foundation/utility/containers/specializedarrays.h"
 #include "foundation/utility/iostreamop.h"
+#include "foundation/utility/job.h"
 #include "foundation/utility/otherwise.h"
 #include "foundation/utility/stopwatch.h"
 #include "foundation/utility/string.h"
@@ -64,9 +67,11 @@
 #include "boost/filesystem/path.hpp"
 
 // Standard headers.
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <string>
+#include <vector>
 
 using namespace boost;
 using namespace foundation;
@@ -108,8 +113,11 @@ struct Frame::Impl
     auto_ptr<Image>         m_image;
     auto_ptr<ImageStack>    m_aov_images;
 
+    MemoryAccount           m_memory_account;
+
     Impl()
       : m_lighting_conditions(IlluminantCIED65, XYZCMFCIE196410Deg)
+      , m_memory_account(MemoryCategoryFrameBuffers)
     {
     }
 };
@@ -137,6 +145,9 @@ Frame::Frame(
     // Retrieve the image properties.
     m_props = impl->m_image->properties();
 
+    // Account for the memory used by the image once all its tiles are allocated.
+    impl->m_memory_account.set_size(m_props.m_pixel_count * m_props.m_pixel_size);
+
     // Create the image stack for AOVs.
     impl->m_aov_images.reset(
         new ImageStack(
@@ -231,6 +242,77 @@ const AABB2u& Frame::get_crop_window() const
 
 namespace
 {
+#ifdef APPLESEED_USE_SSE
+
+    // The columns of the linear RGB to CIE XYZ matrix, derived from linear_rgb_to_ciexyz().
+    struct LinearRGBToCIEXYZMatrix
+    {
+        __m128 m_columns[3];
+
+        LinearRGBToCIEXYZMatrix()
+        {
+            for (size_t i = 0; i < 3; ++i)
+            {
+                Color3f linear_rgb(0.0f);
+                linear_rgb[i] = 1.0f;
+
+                const Color3f ciexyz = linear_rgb_to_ciexyz(linear_rgb);
+                m_columns[i] = _mm_set_ps(0.0f, ciexyz[2], ciexyz[1], ciexyz[0]);
+            }
+        }
+    };
+
+    template <
+        int  ColorSpace,
+        bool Clamp,
+        bool GammaCorrect
+    >
+    FORCE_INLINE __m128 transform_color(
+        const __m128                    linear_rgb,
+        const LinearRGBToCIEXYZMatrix&  rgb_to_xyz,
+        const __m128                    rcp_target_gamma)
+    {
+        __m128 color = linear_rgb;
+
+        // Apply color space conversion.
+        switch (ColorSpace)
+        {
+          case ColorSpaceSRGB:
+            color = fast_linear_rgb_to_srgb(color);
+            break;
+
+          case ColorSpaceCIEXYZ:
+            color =
+                _mm_add_ps(
+                    _mm_add_ps(
+                        _mm_mul_ps(
+                            _mm_shuffle_ps(color, color, _MM_SHUFFLE(0, 0, 0, 0)),
+                            rgb_to_xyz.m_columns[0]),
+                        _mm_mul_ps(
+                            _mm_shuffle_ps(color, color, _MM_SHUFFLE(1, 1, 1, 1)),
+                            rgb_to_xyz.m_columns[1])),
+                    _mm_mul_ps(
+                        _mm_shuffle_ps(color, color, _MM_SHUFFLE(2, 2, 2, 2)),
+                        rgb_to_xyz.m_columns[2]));
+            break;
+
+          default:;
+        }
+
+        // Apply clamping.
+        // todo: mark clamped pixels in the diagnostic map.
+        if (Clamp)
+            color = _mm_min_ps(_mm_max_ps(color, _mm_set1_ps(0.0f)), _mm_set1_ps(1.0f));
+        else color = _mm_max_ps(color, _mm_set1_ps(0.0f));
+
+        // Apply gamma correction.
+        if (GammaCorrect)
+            color = fast_pow(color, rcp_target_gamma);
+
+        // Leave the alpha channel unmodified.
+        return _mm_shuffle_ps(color, _mm_unpackhi_ps(color, linear_rgb), _MM_SHUFFLE(3, 0, 1, 0));
+    }
+
     template <
         int  ColorSpace,
         bool Clamp,
@@ -240,6 +322,8 @@ namespace
     {
         assert(tile.get_channel_count() == 4);
 
+        const LinearRGBToCIEXYZMatrix rgb_to_xyz;
+        const __m128 mrcp_target_gamma = _mm_set1_ps(rcp_target_gamma);
         const size_t pixel_count = tile.get_pixel_count();
 
         for (size_t i = 0; i < pixel_count; ++i)
@@ -248,39 +332,19 @@ namespace
             SSE_ALIGN Color4f color;
             tile.get_pixel(i, color);
 
-            // Apply color space conversion.
-            switch (ColorSpace)
-            {
-              case ColorSpaceSRGB:
-                color.rgb() = fast_linear_rgb_to_srgb(color.rgb());
-                break;
-
-              case ColorSpaceCIEXYZ:
-                color.rgb() = linear_rgb_to_ciexyz(color.rgb());
-                break;
-
-              default:;
-            }
-
-            // Apply clamping.
-            // todo: mark clamped pixels in the diagnostic map.
-            color = Clamp ? saturate(color) : clamp_low(color, 0.0f);
-
-            // Apply gamma correction.
-            if (GammaCorrect)
-            {
-                const float old_alpha = color[3];
-                fast_pow(&color[0], rcp_target_gamma);
-                color[3] = old_alpha;
-            }
+            // Transform the pixel color.
+            _mm_store_ps(
+                &color[0],
+                transform_color<ColorSpace, Clamp, GammaCorrect>(
+                    _mm_load_ps(&color[0]),
+                    rgb_to_xyz,
+                    mrcp_target_gamma));
 
             // Store the pixel color.
             tile.set_pixel(i, color);
         }
     }
 
-#ifdef APPLESEED_USE_SSE
-
     template <
         int  ColorSpace,
         bool Clamp,
@@ -288,38 +352,87 @@ namespace
     >
     void transform_float_tile(Tile& tile, const float rcp_target_gamma)
     {
-        assert(ColorSpace == ColorSpaceLinearRGB || ColorSpace == ColorSpaceSRGB);
         assert(tile.get_channel_count() == 4);
 
+        const LinearRGBToCIEXYZMatrix rgb_to_xyz;
+        const __m128 mrcp_target_gamma = _mm_set1_ps(rcp_target_gamma);
+
         float* pixel_ptr = reinterpret_cast<float*>(tile.pixel(0));
         float* pixel_end = pixel_ptr + tile.get_pixel_count() * 4;
 
         for (; pixel_ptr < pixel_end; pixel_ptr += 4)
         {
-            // Load the pixel color.
-            __m128 color = _mm_load_ps(pixel_ptr);
-            __m128 original_color = color;
+            _mm_store_ps(
+                pixel_ptr,
+                transform_color<ColorSpace, Clamp, GammaCorrect>(
+                    _mm_load_ps(pixel_ptr),
+                    rgb_to_xyz,
+                    mrcp_target_gamma));
+        }
+    }
 
-            // Apply color space conversion.
-            if (ColorSpace == ColorSpaceSRGB)
-                color = fast_linear_rgb_to_srgb(color);
+#else
 
-            // Apply clamping.
-            // todo: mark clamped pixels in the diagnostic map.
-            if (Clamp)
-                color = _mm_min_ps(_mm_max_ps(color, _mm_set1_ps(0.0f)), _mm_set1_ps(1.0f));
-            else color = _mm_max_ps(color, _mm_set1_ps(0.0f));
+    template <
+        int  ColorSpace,
+        bool Clamp,
+        bool GammaCorrect
+    >
+    inline Color4f transform_color(
+        const Color4f&  linear_rgb,
+        const float     rcp_target_gamma)
+    {
+        Color4f color(linear_rgb);
 
-            // Apply gamma correction.
-            if (GammaCorrect)
-                color = fast_pow(color, _mm_set1_ps(rcp_target_gamma));
+        // Apply color space conversion.
+        switch (ColorSpace)
+        {
+          case ColorSpaceSRGB:
+            color.rgb() = fast_linear_rgb_to_srgb(color.rgb());
+            break;
 
-            // Store the pixel color (leave the alpha channel unmodified).
-            _mm_store_ps(pixel_ptr, _mm_shuffle_ps(color, _mm_unpackhi_ps(color, original_color), _MM_SHUFFLE(3, 0, 1, 0)));
+          case ColorSpaceCIEXYZ:
+            color.rgb() = linear_rgb_to_ciexyz(color.rgb());
+            break;
+
+          default:;
         }
+
+        // Apply clamping.
+        // todo: mark clamped pixels in the diagnostic map.
+        color = Clamp ? saturate(color) : clamp_low(color, 0.0f);
+
+        // Apply gamma correction.
+        if (GammaCorrect)
+            fast_pow(&color[0], rcp_target_gamma);
+
+        // Leave the alpha channel unmodified.
+        color[3] = linear_rgb[3];
+
+        return color;
     }
 
-#else
+    template <
+        int  ColorSpace,
+        bool Clamp,
+        bool GammaCorrect
+    >
+    void transform_generic_tile(Tile& tile, const float rcp_target_gamma)
+    {
+        assert(tile.get_channel_count() == 4);
+
+        const size_t pixel_count = tile.get_pixel_count();
+
+        for (size_t i = 0; i < pixel_count; ++i)
+        {
+            Color4f color;
+            tile.get_pixel(i, color);
+
+            tile.set_pixel(
+                i,
+                transform_color<ColorSpace, Clamp, GammaCorrect>(color, rcp_target_gamma));
+        }
+    }
 
     template <
         int  ColorSpace,
@@ -328,39 +441,44 @@ namespace
     >
     void transform_float_tile(Tile& tile, const float rcp_target_gamma)
     {
-        assert(ColorSpace == ColorSpaceLinearRGB || ColorSpace == ColorSpaceSRGB);
         assert(tile.get_channel_count() == 4);
 
         Color4f* pixel_ptr = reinterpret_cast<Color4f*>(tile.pixel(0));
         Color4f* pixel_end = pixel_ptr + tile.get_pixel_count();
 
         for (; pixel_ptr < pixel_end; ++pixel_ptr)
-        {
-            // Load the pixel color.
-            Color4f color(*pixel_ptr);
+            *pixel_ptr = transform_color<ColorSpace, Clamp, GammaCorrect>(*pixel_ptr, rcp_target_gamma);
+    }
 
-            // Apply color space conversion.
-            if (ColorSpace == ColorSpaceSRGB)
-                color.rgb() = fast_linear_rgb_to_srgb(color.rgb());
+#endif
 
-            // Apply clamping.
-            // todo: mark clamped pixels in the diagnostic map.
-            color = Clamp ? saturate(color) : clamp_low(color, 0.0f);
+    class TransformTileRowJob
+      : public IJob
+    {
+      public:
+        TransformTileRowJob(
+            const Frame&    frame,
+            Image&          image,
+            const size_t    tile_y)
+          : m_frame(frame)
+          , m_image(image)
+          , m_tile_y(tile_y)
+        {
+        }
 
-            // Apply gamma correction.
-            if (GammaCorrect)
-            {
-                const float old_alpha = color[3];
-                fast_pow(&color[0], rcp_target_gamma);
-                color[3] = old_alpha;
-            }
+        virtual void execute(const size_t thread_index) OVERRIDE
+        {
+            const size_t tile_count_x = m_image.properties().m_tile_count_x;
 
-            // Store the pixel color.
-            *pixel_ptr = color;
+            for (size_t tx = 0; tx < tile_count_x; ++tx)
+                m_frame.transform_to_output_color_space(m_image.tile(tx, m_tile_y));
         }
-    }
 
-#endif
+      private:
+        const Frame&        m_frame;
+        Image&              m_image;
+        const size_t        m_tile_y;
+    };
 }
 
 void Frame::transform_to_output_color_space(Tile& tile) const
@@ -406,7 +524,7 @@ void Frame::transform_to_output_color_space(Tile& tile) const
             break;
 
           case ColorSpaceCIEXYZ:
-            TRANSFORM_GENERIC_TILE(ColorSpaceCIEXYZ);
+            TRANSFORM_FLOAT_TILE(ColorSpaceCIEXYZ);
             break;
 
           assert_otherwise;
@@ -436,15 +554,36 @@ void Frame::transform_to_output_color_space(Tile& tile) const
     #undef TRANSFORM_GENERIC_TILE
 }
 
-void Frame::transform_to_output_color_space(Image& image) const
+void Frame::transform_to_output_color_space(
+    Image&          image,
+    const size_t    thread_count) const
 {
     const CanvasProperties& image_props = image.properties();
 
-    for (size_t ty = 0; ty < image_props.m_tile_count_y; ++ty)
+    if (min(thread_count, image_props.m_tile_count_y) <= 1)
     {
-        for (size_t tx = 0; tx < image_props.m_tile_count_x; ++tx)
-            transform_to_output_color_space(image.tile(tx, ty));
+        for (size_t ty = 0; ty < image_props.m_tile_count_y; ++ty)
+        {
+            for (size_t tx = 0; tx < image_props.m_tile_count_x; ++tx)
+                transform_to_output_color_space(image.tile(tx, ty));
+        }
+
+        return;
     }
+
+    // Transform rows of tiles in parallel.
+    JobQueue job_queue;
+    JobManager job_manager(
+        global_logger(),
+        job_queue,
+        min(thread_count, image_props.m_tile_count_y),
+        JobManager::KeepRunningOnEmptyQueue);
+
+    for (size_t ty = 0; ty < image_props.m_tile_count_y; ++ty)
+        job_queue.schedule(new TransformTileRowJob(*this, image, ty));
+
+    job_manager.start();
+    job_queue.wait_until_completion();
 }
 
 void Frame::clear_main_image()
@@ -452,12 +591,14 @@ void Frame::clear_main_image()
     impl->m_image->clear(Color4f(0.0));
 }
 
-bool Frame::write_main_image(const char* file_path) const
+bool Frame::write_main_image(
+    const char*     file_path,
+    const size_t    thread_count) const
 {
     assert(file_path);
 
     Image transformed_image(*impl->m_image);
-    transform_to_output_color_space(transformed_image);
+    transform_to_output_color_space(transformed_image, thread_count);
 
     const ImageAttributes image_attributes =
         ImageAttributes::create_default_attributes();
@@ -465,39 +606,152 @@ bool Frame::write_main_image(const char* file_path) const
     return write_image(file_path, transformed_image, image_attributes);
 }
 
-bool Frame::write_aov_images(const char* file_path) const
+namespace
 {
-    assert(file_path);
+    bool write_image_file(
+        const char*             file_path,
+        const Image&            image,
+        const ImageAttributes&  image_attributes)
+    {
+        assert(file_path);
 
-    const ImageAttributes image_attributes =
-        ImageAttributes::create_default_attributes();
+        Stopwatch<DefaultWallclockTimer> stopwatch;
+        stopwatch.start();
 
-    bool result = true;
+        try
+        {
+            try
+            {
+                GenericImageFileWriter writer;
+                writer.write(file_path, image, image_attributes);
+            }
+            catch (const ExceptionUnsupportedFileFormat&)
+            {
+                const string extension = lower_case(filesystem::path(file_path).extension().string());
 
-    if (!impl->m_aov_images->empty())
+                RENDERER_LOG_ERROR(
+                    "file format '%s' not supported, writing the image in OpenEXR format "
+                    "(but keeping the filename unmodified).",
+                    extension.c_str());
+
+                EXRImageFileWriter writer;
+                writer.write(file_path, image, image_attributes);
+            }
+        }
+        catch (const ExceptionUnsupportedImageFormat&)
+        {
+            RENDERER_LOG_ERROR(
+                "failed to write image file %s: unsupported image format.",
+                file_path);
+
+            return false;
+        }
+        catch (const ExceptionIOError&)
+        {
+            RENDERER_LOG_ERROR(
+                "failed to write image file %s: i/o error.",
+                file_path);
+
+            return false;
+        }
+        catch (const Exception& e)
+        {
+            RENDERER_LOG_ERROR(
+                "failed to write image file %s: %s.",
+                file_path,
+                e.what());
+
+            return false;
+        }
+
+        stopwatch.measure();
+
+        RENDERER_LOG_INFO(
+            "wrote image file %s in %s.",
+            file_path,
+            pretty_time(stopwatch.get_seconds()).c_str());
+
+        return true;
+    }
+
+    class WriteAOVImageJob
+      : public IJob
     {
-        const filesystem::path boost_file_path(file_path);
-        const filesystem::path directory = boost_file_path.parent_path();
-        const string base_file_name = boost_file_path.stem().string();
-        const string extension = boost_file_path.extension().string();
+      public:
+        WriteAOVImageJob(
+            const string&           file_path,
+            const Image&            image,
+            const ImageAttributes&  image_attributes,
+            uint8&                  result)
+          : m_file_path(file_path)
+          , m_image(image)
+          , m_image_attributes(image_attributes)
+          , m_result(result)
+        {
+        }
 
-        for (size_t i = 0; i < impl->m_aov_images->size(); ++i)
+        virtual void execute(const size_t thread_index) OVERRIDE
         {
-            const string aov_name = impl->m_aov_images->get_name(i);
-            const string aov_file_name = base_file_name + "." + aov_name + extension;
-            const string aov_safe_file_name = make_safe_filename(aov_file_name);
-            const string aov_file_path = (directory / aov_safe_file_name).string();
-
-            // Note: AOVs are always in the linear color space.
-            if (!write_image(
-                    aov_file_path.c_str(),
-                    impl->m_aov_images->get_image(i),
-                    image_attributes))
-                result = false;
+            m_result = write_image_file(m_file_path.c_str(), m_image, m_image_attributes) ? 1 : 0;
         }
+
+      private:
+        const string            m_file_path;
+        const Image&            m_image;
+        const ImageAttributes&  m_image_attributes;
+        uint8&                  m_result;
+    };
+}
+
+bool Frame::write_aov_images(
+    const char*     file_path,
+    const size_t    thread_count) const
+{
+    assert(file_path);
+
+    const ImageAttributes image_attributes =
+        ImageAttributes::create_default_attributes();
+
+    const size_t aov_count = impl->m_aov_images->size();
+
+    if (aov_count == 0)
+        return true;
+
+    const filesystem::path boost_file_path(file_path);
+    const filesystem::path directory = boost_file_path.parent_path();
+    const string base_file_name = boost_file_path.stem().string();
+    const string extension = boost_file_path.extension().string();
+
+    // Encode and write the AOV images concurrently.
+    JobQueue job_queue;
+    JobManager job_manager(
+        global_logger(),
+        job_queue,
+        max<size_t>(min(thread_count, aov_count), 1),
+        JobManager::KeepRunningOnEmptyQueue);
+
+    vector<uint8> results(aov_count, 0);
+
+    for (size_t i = 0; i < aov_count; ++i)
+    {
+        const string aov_name = impl->m_aov_images->get_name(i);
+        const string aov_file_name = base_file_name + "." + aov_name + extension;
+        const string aov_safe_file_name = make_safe_filename(aov_file_name);
+        const string aov_file_path = (directory / aov_safe_file_name).string();
+
+        // Note: AOVs are always in the linear color space.
+        job_queue.schedule(
+            new WriteAOVImageJob(
+                aov_file_path,
+                impl->m_aov_images->get_image(i),
+                image_attributes,
+                results[i]));
     }
 
-    return result;
+    job_manager.start();
+    job_queue.wait_until_completion();
+
+    return find(results.begin(), results.end(), 0) == results.end();
 }
 
 bool Frame::archive(
@@ -676,68 +930,9 @@ bool Frame::write_image(
     const Image&            image,
     const ImageAttributes&  image_attributes) const
 {
-    assert(file_path);
-
-    Stopwatch<DefaultWallclockTimer> stopwatch;
-    stopwatch.start();
-
-    try
-    {
-        try
-        {
-            GenericImageFileWriter writer;
-            writer.write(file_path, image, image_attributes);
-        }
-        catch (const ExceptionUnsupportedFileFormat&)
-        {
-            const string extension = lower_case(filesystem::path(file_path).extension().string());
-
-            RENDERER_LOG_ERROR(
-                "file format '%s' not supported, writing the image in OpenEXR format "
-                "(but keeping the filename unmodified).",
-                extension.c_str());
-
-            EXRImageFileWriter writer;
-            writer.write(file_path, image, image_attributes);
-        }
-    }
-    catch (const ExceptionUnsupportedImageFormat&)
-    {
-        RENDERER_LOG_ERROR(
-            "failed to write image file %s: unsupported image format.",
-            file_path);
-
-        return false;
-    }
-    catch (const ExceptionIOError&)
-    {
-        RENDERER_LOG_ERROR(
-            "failed to write image file %s: i/o error.",
-            file_path);
-
-        return false;
-    }
-    catch (const Exception& e)
-    {
-        RENDERER_LOG_ERROR(
-            "failed to write image file %s: %s.",
-            file_path,
-            e.what());
-
-        return false;
-    }
-
-    stopwatch.measure();
-
-    RENDERER_LOG_INFO(
-        "wrote image file %s in %s.",
-        file_path,
-        pretty_time(stopwatch.get_seconds()).c_str());
-
-    return true;
+    return write_image_file(file_path, image, image_attributes);
 }
 
-
 //
 // FrameFactory class implementation.
 //
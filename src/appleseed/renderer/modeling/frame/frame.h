@@ -105,8 +105,11 @@ class DLLSYMBOL Frame
     const foundation::AABB2u& get_crop_window() const;
 
     // Convert a tile or an image from linear RGB to the output color space.
+    // The rows of tiles of an image are converted in parallel on thread_count threads.
     void transform_to_output_color_space(foundation::Tile& tile) const;
-    void transform_to_output_color_space(foundation::Image& image) const;
+    void transform_to_output_color_space(
+        foundation::Image&  image,
+        const size_t        thread_count = 1) const;
 
     // Return the normalized device coordinates of a given sample.
     foundation::Vector2d get_sample_position(
@@ -128,10 +131,14 @@ class DLLSYMBOL Frame
     // Clear the main image to transparent black.
     void clear_main_image();
 
-    // Write the main image / the AOV images to disk.
+    // Write the main image / the AOV images to disk, using up to thread_count threads.
     // Return true if successful, false otherwise.
-    bool write_main_image(const char* file_path) const;
-    bool write_aov_images(const char* file_path) const;
+    bool write_main_image(
+        const char*         file_path,
+        const size_t        thread_count = 1) const;
+    bool write_aov_images(
+        const char*         file_path,
+        const size_t        thread_count = 1) const;
 
     // Archive the frame to a given directory on disk. If output_path is provided,
     // the full path to the output file will be returned. The returned string must
@@ -40,6 +40,7 @@
 #include "foundation/utility/memory.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <string>
@@ -78,6 +79,31 @@ namespace
         return align(x, offset_of<Target>());
     }
 
+    // Evaluate a source into a properly aligned value of a given format.
+    void evaluate_source(
+        const Source&       source,
+        const InputFormat   format,
+        TextureCache&       texture_cache,
+        const Vector2d&     uv,
+        uint8*              ptr)
+    {
+        switch (format)
+        {
+          case InputFormatScalar:
+            source.evaluate(texture_cache, uv, *reinterpret_cast<double*>(ptr));
+            break;
+
+          case InputFormatSpectralReflectance:
+          case InputFormatSpectralIlluminance:
+            source.evaluate(
+                texture_cache,
+                uv,
+                *reinterpret_cast<Spectrum*>(ptr),
+                *reinterpret_cast<Alpha*>(ptr + sizeof(Spectrum)));
+            break;
+        }
+    }
+
     struct Input
     {
         string          m_name;
@@ -87,6 +113,27 @@ namespace
         Source*         m_source;
         Entity*         m_entity;
 
+        bool is_varying() const
+        {
+            return m_source && !m_source->is_uniform();
+        }
+
+        size_t get_offset(const size_t size) const
+        {
+            switch (m_format)
+            {
+              case InputFormatScalar:
+                return align_to<double>(size);
+
+              case InputFormatSpectralReflectance:
+              case InputFormatSpectralIlluminance:
+                return align_to<Spectrum>(size);
+            }
+
+            assert(!"Invalid input format.");
+            return size;
+        }
+
         size_t add_size(size_t size) const
         {
             switch (m_format)
@@ -117,11 +164,10 @@ namespace
               case InputFormatScalar:
                 {
                     ptr = align_to<double>(ptr);
-                    double* out_scalar = reinterpret_cast<double*>(ptr);
 
                     if (m_source)
-                        m_source->evaluate(texture_cache, uv, *out_scalar);
-                    else *out_scalar = 0.0;
+                        evaluate_source(*m_source, m_format, texture_cache, uv, ptr);
+                    else *reinterpret_cast<double*>(ptr) = 0.0;
 
                     ptr += sizeof(double);
                 }
@@ -131,15 +177,13 @@ namespace
               case InputFormatSpectralIlluminance:
                 {
                     ptr = align_to<Spectrum>(ptr);
-                    Spectrum* out_spectrum = reinterpret_cast<Spectrum*>(ptr);
-                    Alpha* out_alpha = reinterpret_cast<Alpha*>(ptr + sizeof(Spectrum));
 
                     if (m_source)
-                        m_source->evaluate(texture_cache, uv, *out_spectrum, *out_alpha);
+                        evaluate_source(*m_source, m_format, texture_cache, uv, ptr);
                     else
                     {
-                        out_spectrum->set(0.0f);
-                        out_alpha->set(0.0f);
+                        reinterpret_cast<Spectrum*>(ptr)->set(0.0f);
+                        reinterpret_cast<Alpha*>(ptr + sizeof(Spectrum))->set(0.0f);
                     }
 
                     ptr += sizeof(Spectrum);
@@ -194,11 +238,53 @@ namespace
     };
 
     typedef vector<Input> InputVector;
+
+    // An input that must be evaluated at every shading point.
+    struct VaryingInput
+    {
+        const Source*   m_source;
+        InputFormat     m_format;
+        size_t          m_offset;
+    };
+
+    typedef vector<VaryingInput> VaryingInputVector;
 }
 
 struct InputArray::Impl
 {
-    InputVector m_inputs;
+    InputVector         m_inputs;
+
+    // Evaluation plan.
+    bool                m_has_plan;
+    uint8*              m_uniform_values;       // values of all inputs, holes at varying inputs
+    size_t              m_uniform_values_size;  // in bytes
+    VaryingInputVector  m_varying_inputs;
+
+    Impl()
+      : m_has_plan(false)
+      , m_uniform_values(0)
+      , m_uniform_values_size(0)
+    {
+    }
+
+    ~Impl()
+    {
+        clear_plan();
+    }
+
+    void clear_plan()
+    {
+        m_has_plan = false;
+
+        if (m_uniform_values)
+        {
+            aligned_free(m_uniform_values);
+            m_uniform_values = 0;
+        }
+
+        m_uniform_values_size = 0;
+        clear_release_memory(m_varying_inputs);
+    }
 };
 
 InputArray::InputArray()
@@ -233,6 +319,7 @@ void InputArray::declare(
     input.m_entity = 0;
 
     impl->m_inputs.push_back(input);
+    impl->clear_plan();
 }
 
 InputArray::iterator InputArray::begin()
@@ -337,8 +424,19 @@ void InputArray::evaluate(
     assert(is_aligned(ptr, 16));
 #endif
 
-    for (const_each<InputVector> i = impl->m_inputs; i; ++i)
-        ptr = i->evaluate(texture_cache, uv, ptr);
+    if (impl->m_has_plan)
+    {
+        // Copy the uniform values in one go, then fill the holes.
+        memcpy(ptr, impl->m_uniform_values, impl->m_uniform_values_size);
+
+        for (const_each<VaryingInputVector> i = impl->m_varying_inputs; i; ++i)
+            evaluate_source(*i->m_source, i->m_format, texture_cache, uv, ptr + i->m_offset);
+    }
+    else
+    {
+        for (const_each<InputVector> i = impl->m_inputs; i; ++i)
+            ptr = i->evaluate(texture_cache, uv, ptr);
+    }
 }
 
 void InputArray::evaluate_uniforms(
@@ -357,6 +455,46 @@ void InputArray::evaluate_uniforms(
         ptr = i->evaluate_uniform(ptr);
 }
 
+void InputArray::build_evaluation_plan()
+{
+    impl->clear_plan();
+
+    // Evaluate all uniform inputs once and for all.
+    const size_t data_size = compute_data_size();
+    impl->m_uniform_values = static_cast<uint8*>(aligned_malloc(max<size_t>(data_size, 1), 16));
+    evaluate_uniforms(impl->m_uniform_values);
+
+    // Collect the inputs that need to be evaluated at every shading point.
+    size_t size = 0;
+
+    for (const_each<InputVector> i = impl->m_inputs; i; ++i)
+    {
+        if (i->is_varying())
+        {
+            VaryingInput varying_input;
+            varying_input.m_source = i->m_source;
+            varying_input.m_format = i->m_format;
+            varying_input.m_offset = i->get_offset(size);
+            impl->m_varying_inputs.push_back(varying_input);
+        }
+
+        size = i->add_size(size);
+    }
+
+    impl->m_uniform_values_size = size;
+    impl->m_has_plan = true;
+}
+
+bool InputArray::has_evaluation_plan() const
+{
+    return impl->m_has_plan;
+}
+
+size_t InputArray::get_varying_input_count() const
+{
+    return impl->m_has_plan ? impl->m_varying_inputs.size() : 0;
+}
+
 
 //
 // InputArray::const_iterator class implementation.
@@ -483,6 +621,8 @@ void InputArray::iterator::bind(Source* source)
     Input& input = m_input_array->impl->m_inputs[m_input_index];
     delete input.m_source;
     input.m_source = source;
+
+    m_input_array->impl->clear_plan();
 }
 
 void InputArray::iterator::bind(Entity* entity)
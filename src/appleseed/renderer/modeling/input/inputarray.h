@@ -184,6 +184,18 @@ class DLLSYMBOL InputArray
     // Compute the cumulated size in bytes of the input values.
     size_t compute_data_size() const;
 
+    // Precompute the values of all uniform inputs and the list of varying inputs,
+    // such that evaluate() only needs to copy a block of memory and evaluate the
+    // varying inputs. The plan is discarded when an input is declared or bound.
+    void build_evaluation_plan();
+
+    // Return true if an evaluation plan is currently in use.
+    bool has_evaluation_plan() const;
+
+    // Return the number of inputs evaluated at every shading point by the
+    // current evaluation plan, or 0 if there is no evaluation plan.
+    size_t get_varying_input_count() const;
+
     // Evaluate all inputs into a preallocated block of memory.
     // The address 'values + offset' must be 16-byte aligned.
     void evaluate(
@@ -116,6 +116,8 @@ bool Light::on_frame_begin(
             get_path().c_str());
     }
 
+    m_inputs.build_evaluation_plan();
+
     return true;
 }
 
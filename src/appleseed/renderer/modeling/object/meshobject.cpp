@@ -31,6 +31,7 @@
 #include "meshobject.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globalmemory.h"
 #include "renderer/kernel/tessellation/statictessellation.h"
 #include "renderer/modeling/object/iregion.h"
 #include "renderer/modeling/object/triangle.h"
@@ -89,10 +90,12 @@ struct MeshObject::Impl
     RegionKit                   m_region_kit;
     mutable Lazy<RegionKit>     m_lazy_region_kit;
     vector<string>              m_material_slots;
+    MemoryAccount               m_memory_account;
 
     Impl()
       : m_region(&m_tess)
       , m_lazy_region_kit(&m_region_kit)
+      , m_memory_account(MemoryCategoryGeometry)
     {
         m_region_kit.push_back(&m_region);
     }
@@ -128,6 +131,10 @@ GAABB3 MeshObject::compute_local_bbox() const
 
 Lazy<RegionKit>& MeshObject::get_region_kit()
 {
+    // The region kit is requested when the acceleration structures are built,
+    // at which point the mesh is complete: account for its memory now.
+    impl->m_memory_account.set_size(impl->m_tess.get_memory_size());
+
     return impl->m_lazy_region_kit;
 }
 
@@ -143,6 +150,18 @@ size_t MeshObject::push_vertex(const GVector3& vertex)
     return index;
 }
 
+size_t MeshObject::push_vertices(const GVector3* vertices, const size_t count)
+{
+    const size_t index = impl->m_tess.m_vertices.size();
+    impl->m_tess.m_vertices.append(vertices, count);
+    return index;
+}
+
+void MeshObject::adopt_vertices(GVector3* vertices, const size_t count, IUnknown* owner)
+{
+    impl->m_tess.m_vertices.adopt(vertices, count, owner);
+}
+
 size_t MeshObject::get_vertex_count() const
 {
     return impl->m_tess.m_vertices.size();
@@ -167,6 +186,23 @@ size_t MeshObject::push_vertex_normal(const GVector3& normal)
     return index;
 }
 
+size_t MeshObject::push_vertex_normals(const GVector3* normals, const size_t count)
+{
+#ifndef NDEBUG
+    for (size_t i = 0; i < count; ++i)
+        assert(is_normalized(normals[i]));
+#endif
+
+    const size_t index = impl->m_tess.m_vertex_normals.size();
+    impl->m_tess.m_vertex_normals.append(normals, count);
+    return index;
+}
+
+void MeshObject::adopt_vertex_normals(GVector3* normals, const size_t count, IUnknown* owner)
+{
+    impl->m_tess.m_vertex_normals.adopt(normals, count, owner);
+}
+
 size_t MeshObject::get_vertex_normal_count() const
 {
     return impl->m_tess.m_vertex_normals.size();
@@ -182,6 +218,16 @@ size_t MeshObject::push_tex_coords(const GVector2& tex_coords)
     return impl->m_tess.push_uv_vertex(tex_coords);
 }
 
+size_t MeshObject::push_tex_coords(const GVector2* tex_coords, const size_t count)
+{
+    const size_t index = impl->m_tess.get_uv_vertex_count();
+
+    for (size_t i = 0; i < count; ++i)
+        impl->m_tess.push_uv_vertex(tex_coords[i]);
+
+    return index;
+}
+
 size_t MeshObject::get_tex_coords_count() const
 {
     return impl->m_tess.get_uv_vertex_count();
@@ -204,6 +250,18 @@ size_t MeshObject::push_triangle(const Triangle& triangle)
     return index;
 }
 
+size_t MeshObject::push_triangles(const Triangle* triangles, const size_t count)
+{
+    const size_t index = impl->m_tess.m_primitives.size();
+    impl->m_tess.m_primitives.append(triangles, count);
+    return index;
+}
+
+void MeshObject::adopt_triangles(Triangle* triangles, const size_t count, IUnknown* owner)
+{
+    impl->m_tess.m_primitives.adopt(triangles, count, owner);
+}
+
 size_t MeshObject::get_triangle_count() const
 {
     return impl->m_tess.m_primitives.size();
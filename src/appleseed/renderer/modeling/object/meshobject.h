@@ -47,6 +47,7 @@
 #include <cstddef>
 
 // Forward declarations.
+namespace foundation    { class IUnknown; }
 namespace renderer  { class ParamArray; }
 namespace renderer  { class Triangle; }
 
@@ -75,26 +76,45 @@ class DLLSYMBOL MeshObject
     // Return the region kit of the object.
     virtual foundation::Lazy<RegionKit>& get_region_kit() OVERRIDE;
 
+    //
+    // The bulk insertion methods below (push_vertices(), push_vertex_normals(), etc.)
+    // append a contiguous array of elements and return the index of the first one.
+    //
+    // The adoption methods (adopt_vertices(), adopt_vertex_normals(), adopt_triangles())
+    // replace all existing elements by an externally owned array, without copying it.
+    // The array must remain valid until owner->release() is called, which happens when
+    // the mesh object no longer references it (when the object is destroyed, when the
+    // array is adopted again, or when elements are inserted, in which case the array is
+    // first copied). If owner is 0, the array must outlive the mesh object.
+    //
+
     // Insert and access vertices.
     void reserve_vertices(const size_t count);
     size_t push_vertex(const GVector3& vertex);
+    size_t push_vertices(const GVector3* vertices, const size_t count);
+    void adopt_vertices(GVector3* vertices, const size_t count, foundation::IUnknown* owner = 0);
     size_t get_vertex_count() const;
     const GVector3& get_vertex(const size_t index) const;
 
     // Insert and access vertex normals.
     void reserve_vertex_normals(const size_t count);
     size_t push_vertex_normal(const GVector3& normal);      // the normal must be unit-length
+    size_t push_vertex_normals(const GVector3* normals, const size_t count);
+    void adopt_vertex_normals(GVector3* normals, const size_t count, foundation::IUnknown* owner = 0);
     size_t get_vertex_normal_count() const;
     const GVector3& get_vertex_normal(const size_t index) const;
 
     // Insert and access texture coordinates.
     size_t push_tex_coords(const GVector2& tex_coords);
+    size_t push_tex_coords(const GVector2* tex_coords, const size_t count);
     size_t get_tex_coords_count() const;
     GVector2 get_tex_coords(const size_t index) const;
 
     // Insert and access triangles.
     void reserve_triangles(const size_t count);
     size_t push_triangle(const Triangle& triangle);
+    size_t push_triangles(const Triangle* triangles, const size_t count);
+    void adopt_triangles(Triangle* triangles, const size_t count, foundation::IUnknown* owner = 0);
     size_t get_triangle_count() const;
     const Triangle& get_triangle(const size_t index) const;
 
@@ -38,6 +38,7 @@
 #include "renderer/utility/paramarray.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/core/exceptions/exceptionioerror.h"
 #include "foundation/math/scalar.h"
 #include "foundation/math/triangulator.h"
@@ -48,6 +49,7 @@
 #include "foundation/mesh/objmeshfilereader.h"
 #include "foundation/platform/compiler.h"
 #include "foundation/platform/defaulttimers.h"
+#include "foundation/platform/thread.h"
 #include "foundation/platform/types.h"
 #include "foundation/utility/autoreleaseptr.h"
 #include "foundation/utility/foreach.h"
@@ -441,6 +443,15 @@ namespace
                 reader.get_obj_options() | OBJMeshFileReader::FavorSpeedOverPrecision);
         }
 
+        // Parallel parsing is opt-in since it doesn't honor the number of rendering threads.
+        if (params.get_optional<bool>("obj_parallel_parsing", false))
+        {
+            reader.set_obj_options(
+                reader.get_obj_options() | OBJMeshFileReader::ParseInParallel);
+            reader.set_obj_thread_count(
+                params.get_optional<size_t>("obj_parsing_threads", 0));
+        }
+
         MeshObjectBuilder builder(params, base_object_name);
 
         Stopwatch<DefaultWallclockTimer> stopwatch;
@@ -678,6 +689,32 @@ namespace
 
         return true;
     }
+
+    // Total time spent reading mesh files, in seconds.
+    boost::mutex g_total_read_time_mutex;
+    double g_total_read_time = 0.0;
+
+    // Add the lifetime of an instance of this class to the total time spent reading mesh files.
+    class ScopedReadTimer
+      : public NonCopyable
+    {
+      public:
+        ScopedReadTimer()
+        {
+            m_stopwatch.start();
+        }
+
+        ~ScopedReadTimer()
+        {
+            m_stopwatch.measure();
+
+            boost::mutex::scoped_lock lock(g_total_read_time_mutex);
+            g_total_read_time += m_stopwatch.get_seconds();
+        }
+
+      private:
+        Stopwatch<DefaultWallclockTimer> m_stopwatch;
+    };
 }
 
 bool MeshObjectReader::read(
@@ -688,6 +725,8 @@ bool MeshObjectReader::read(
 {
     assert(base_object_name);
 
+    const ScopedReadTimer read_timer;
+
     // Tag objects with the name of their parent.
     ParamArray completed_params(params);
     completed_params.insert("__base_object_name", base_object_name);
@@ -762,4 +801,16 @@ bool MeshObjectReader::read(
     return true;
 }
 
+double MeshObjectReader::get_total_read_time()
+{
+    boost::mutex::scoped_lock lock(g_total_read_time_mutex);
+    return g_total_read_time;
+}
+
+void MeshObjectReader::reset_total_read_time()
+{
+    boost::mutex::scoped_lock lock(g_total_read_time_mutex);
+    g_total_read_time = 0.0;
+}
+
 }   // namespace renderer
@@ -66,6 +66,13 @@ class DLLSYMBOL MeshObjectReader
         const char*                     base_object_name,
         const ParamArray&               params,
         MeshObjectArray&                objects);
+
+    // Return the total time (in seconds) spent in read() since the program
+    // started or since the last call to reset_total_read_time(). Thread-safe.
+    static double get_total_read_time();
+
+    // Reset the total time spent in read(). Thread-safe.
+    static void reset_total_read_time();
 };
 
 }       // namespace renderer
@@ -140,6 +140,7 @@ auto_release_ptr<Configuration> BaseConfigurationFactory::create_base_final()
 
     parameters.insert("sample_renderer", "generic");
     parameters.insert("lighting_engine", "pt");
+    parameters.insert("sampling_mode", "rng");
 
     return configuration;
 }
@@ -154,6 +155,7 @@ auto_release_ptr<Configuration> BaseConfigurationFactory::create_base_interactiv
     parameters.insert("sample_generator", "generic");
     parameters.insert("sample_renderer", "generic");
     parameters.insert("lighting_engine", "pt");
+    parameters.insert("sampling_mode", "rng");
 
     return configuration;
 }
@@ -90,6 +90,7 @@
 #include "foundation/math/transform.h"
 #include "foundation/platform/defaulttimers.h"
 #include "foundation/utility/containers/dictionary.h"
+#include "foundation/utility/eventtracer.h"
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/iterators.h"
 #include "foundation/utility/memory.h"
@@ -2889,6 +2890,8 @@ auto_release_ptr<Project> ProjectFileReader::read(
     Stopwatch<DefaultWallclockTimer> stopwatch;
     stopwatch.start();
 
+    const ScopedEvent event("read project file", "project");
+
     EventCounters event_counters;
     auto_release_ptr<Project> project(
         load_project_file(
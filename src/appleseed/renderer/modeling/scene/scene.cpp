@@ -40,6 +40,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/math/vector.h"
+#include "foundation/utility/eventtracer.h"
 #include "foundation/utility/job/abortswitch.h"
 #include "foundation/utility/foreach.h"
 
@@ -224,6 +225,8 @@ bool Scene::on_frame_begin(
 #endif            
     AbortSwitch*            abort_switch)
 {
+    const ScopedEvent event("prepare scene", "rendering");
+
     bool success = true;
 
     if (impl->m_camera.get())
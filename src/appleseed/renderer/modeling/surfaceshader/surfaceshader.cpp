@@ -62,6 +62,8 @@ bool SurfaceShader::on_frame_begin(
     const Assembly&     assembly,
     AbortSwitch*        abort_switch)
 {
+    m_inputs.build_evaluation_plan();
+
     return true;
 }
 
@@ -47,12 +47,18 @@
 #include "foundation/utility/makevector.h"
 #include "foundation/utility/searchpaths.h"
 
+// boost headers.
+#include "boost/filesystem/operations.hpp"
+#include "boost/system/error_code.hpp"
+
 // Standard headers.
 #include <cstddef>
+#include <ctime>
 #include <string>
 
 using namespace foundation;
 using namespace std;
+namespace bf = boost::filesystem;
 
 namespace renderer
 {
@@ -75,6 +81,7 @@ namespace
             const SearchPaths&  search_paths)
           : Texture(name, params)
           , m_reader(&global_logger())
+          , m_file_time(0)
         {
             extract_parameters(search_paths);
         }
@@ -118,6 +125,19 @@ namespace
             delete tile;
         }
 
+        virtual bool update_source() OVERRIDE
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            if (!m_reader.is_open() || get_file_time() == m_file_time)
+                return false;
+
+            // The file will be reopened the next time it is needed.
+            m_reader.close();
+
+            return true;
+        }
+
       private:
         string                              m_filepath;
         ColorSpace                          m_color_space;
@@ -125,6 +145,7 @@ namespace
         mutable boost::mutex                m_mutex;
         GenericProgressiveImageFileReader   m_reader;
         CanvasProperties                    m_props;
+        time_t                              m_file_time;    // last write time of the file when it was opened
 
         void extract_parameters(const SearchPaths& search_paths)
         {
@@ -155,10 +176,19 @@ namespace
                     "opening texture file %s and reading metadata...",
                     m_filepath.c_str());
 
+                m_file_time = get_file_time();
                 m_reader.open(m_filepath.c_str());
                 m_reader.read_canvas_properties(m_props);
             }
         }
+
+        // Return the last write time of the texture file, or 0 if it cannot be retrieved.
+        time_t get_file_time() const
+        {
+            boost::system::error_code ec;
+            const time_t file_time = bf::last_write_time(m_filepath, ec);
+            return ec ? 0 : file_time;
+        }
     };
 }
 
@@ -57,4 +57,9 @@ Texture::Texture(
     set_name(name);
 }
 
+bool Texture::update_source()
+{
+    return false;
+}
+
 }   // namespace renderer
@@ -86,6 +86,12 @@ class DLLSYMBOL Texture
         const size_t            tile_x,
         const size_t            tile_y,
         const foundation::Tile* tile) = 0;
+
+    // Check whether the source of the texture (e.g. its file on disk) was modified
+    // since the texture started reading it. If so, the texture reads the modified
+    // source from now on, tiles loaded from it until now are stale, and true is
+    // returned. The default implementation returns false.
+    virtual bool update_source();
 };
 
 }       // namespace renderer